@@ -470,26 +470,122 @@ static int add_cell_index(long cell_index, long *cumsum_index, long **latlon_cel
     return 0;
 }
 
-/* latitude_edges and longitude_edges should contain just 2 elements (bounds of the cell) */
-static double find_weight_for_polygon_and_cell(long num_points, double *poly_latitude, double *poly_longitude,
-                                               double *temp_latitude, double *temp_longitude,
-                                               double *latitude_edges, double *longitude_edges)
+/* Cell lookup for a strictly ascending list of grid edges.
+ * For (nearly) uniformly spaced edges the cell index is calculated directly, otherwise a binary search is used.
+ */
+typedef struct cell_lookup_struct
+{
+    long num_edges;
+    const double *edges;
+    int regular;
+    double scale;       /* number of cells per unit of the edge values */
+    long index; /* last found index (used as initial guess for the binary search) */
+} cell_lookup;
+
+static void cell_lookup_init(cell_lookup *lookup, long num_edges, const double *edges)
+{
+    long i;
+
+    lookup->num_edges = num_edges;
+    lookup->edges = edges;
+    lookup->scale = (num_edges - 1) / (edges[num_edges - 1] - edges[0]);
+    lookup->index = -1;
+
+    /* the grid is regular if each edge is within a quarter of a cell of its uniformly spaced position */
+    lookup->regular = 1;
+    for (i = 1; i < num_edges - 1; i++)
+    {
+        if (fabs((edges[i] - edges[0]) * lookup->scale - i) > 0.25)
+        {
+            lookup->regular = 0;
+            break;
+        }
+    }
+}
+
+/* return the index i for which edges[i] <= value < edges[i + 1], or -1 if there is no such cell (or value is NaN) */
+static long cell_lookup_find(cell_lookup *lookup, double value)
+{
+    const double *edges = lookup->edges;
+    long last = lookup->num_edges - 1;
+
+    if (!(value >= edges[0] && value < edges[last]))
+    {
+        return -1;
+    }
+
+    if (lookup->regular)
+    {
+        lookup->index = (long)((value - edges[0]) * lookup->scale);
+        if (lookup->index > last - 1)
+        {
+            lookup->index = last - 1;
+        }
+        /* the calculated index can be off by one because of rounding; correct this using the actual edge values */
+        while (value < edges[lookup->index])
+        {
+            lookup->index--;
+        }
+        while (value >= edges[lookup->index + 1])
+        {
+            lookup->index++;
+        }
+    }
+    else
+    {
+        harp_interpolate_find_index(lookup->num_edges, edges, value, &lookup->index);
+    }
+
+    return lookup->index;
+}
+
+/* determine the range of cells [first, last] for which edges[k] < max_value and edges[k + 1] > min_value
+ * (for min_value == max_value this is the cell for which edges[k] <= value < edges[k + 1]).
+ * returns 0 if there is no such cell.
+ */
+static int cell_lookup_find_range(cell_lookup *lookup, double min_value, double max_value, long *first, long *last)
+{
+    const double *edges = lookup->edges;
+    long num_cells = lookup->num_edges - 1;
+
+    if (!(min_value < edges[num_cells] && (max_value > edges[0] || (max_value == edges[0] && min_value == max_value))))
+    {
+        return 0;
+    }
+
+    *first = min_value < edges[0] ? 0 : cell_lookup_find(lookup, min_value);
+    if (max_value >= edges[num_cells])
+    {
+        *last = num_cells - 1;
+    }
+    else
+    {
+        *last = cell_lookup_find(lookup, max_value);
+        if (edges[*last] == max_value && min_value < max_value)
+        {
+            (*last)--;
+        }
+    }
+
+    return *first <= *last;
+}
+
+/* clip a closed polygon to the latitude range [latitude_edges[0], latitude_edges[1]].
+ * the clipped polygon is stored (closed) in clip_latitude/clip_longitude, which should be able to hold 2 * num_points
+ * points. returns the number of points of the clipped polygon (or 0 if it has no area).
+ */
+static long clip_polygon_to_latitude_range(long num_points, const double *poly_latitude, const double *poly_longitude,
+                                           double *clip_latitude, double *clip_longitude, const double *latitude_edges)
 {
     double latitude, longitude, next_latitude, next_longitude;
-    double cell_area, poly_area;
-    long offset = num_points;
-    long num_temp = 0;
+    long num_clip = 0;
     long i;
 
     if (num_points < 3)
     {
-        return 0.0;
+        return 0;
     }
 
-    /* we start with filling temp_latitude and temp_longitude at offset 'num_points' */
-    /* this allows us to use the same temp buffers in-place for the longitude clamping in the second step */
-
-    /* clamp to latitude range */
     for (i = 0; i < num_points - 1; i++)
     {
         latitude = poly_latitude[i];
@@ -515,48 +611,67 @@ static double find_weight_for_polygon_and_cell(long num_points, double *poly_lat
         }
         if (latitude >= latitude_edges[0] && latitude <= latitude_edges[1])
         {
-            temp_latitude[offset + num_temp] = latitude;
-            temp_longitude[offset + num_temp] = longitude;
-            num_temp++;
+            clip_latitude[num_clip] = latitude;
+            clip_longitude[num_clip] = longitude;
+            num_clip++;
             if (next_latitude < latitude_edges[0])
             {
-                temp_longitude[offset + num_temp] = longitude + (latitude_edges[0] - latitude) *
+                clip_longitude[num_clip] = longitude + (latitude_edges[0] - latitude) *
                     (next_longitude - longitude) / (next_latitude - latitude);
-                temp_latitude[offset + num_temp] = latitude_edges[0];
-                num_temp++;
+                clip_latitude[num_clip] = latitude_edges[0];
+                num_clip++;
             }
             else if (next_latitude > latitude_edges[1])
             {
-                temp_longitude[offset + num_temp] = longitude + (latitude_edges[1] - latitude) *
+                clip_longitude[num_clip] = longitude + (latitude_edges[1] - latitude) *
                     (next_longitude - longitude) / (next_latitude - latitude);
-                temp_latitude[offset + num_temp] = latitude_edges[1];
-                num_temp++;
+                clip_latitude[num_clip] = latitude_edges[1];
+                num_clip++;
             }
         }
     }
 
-    if (num_temp < 3)
+    if (num_clip < 3)
     {
-        return 0.0;
+        return 0;
     }
 
-    if (temp_latitude[offset] != temp_latitude[offset + num_temp - 1] ||
-        temp_longitude[offset] != temp_longitude[offset + num_temp - 1])
+    if (clip_latitude[0] != clip_latitude[num_clip - 1] || clip_longitude[0] != clip_longitude[num_clip - 1])
     {
-        temp_latitude[offset + num_temp] = temp_latitude[offset];
-        temp_longitude[offset + num_temp] = temp_longitude[offset];
-        num_temp++;
+        clip_latitude[num_clip] = clip_latitude[0];
+        clip_longitude[num_clip] = clip_longitude[0];
+        num_clip++;
+    }
+
+    return num_clip;
+}
+
+/* latitude_edges and longitude_edges should contain just 2 elements (bounds of the cell).
+ * the polygon should already be clipped to the latitude range of the cell (see clip_polygon_to_latitude_range()).
+ * temp_latitude/temp_longitude should be able to hold 2 * num_points points.
+ */
+static double find_weight_for_polygon_and_cell(long num_points, const double *poly_latitude,
+                                               const double *poly_longitude, double *temp_latitude,
+                                               double *temp_longitude, const double *latitude_edges,
+                                               const double *longitude_edges)
+{
+    double latitude, longitude, next_latitude, next_longitude;
+    double cell_area, poly_area;
+    long num_temp = 0;
+    long i;
+
+    if (num_points < 3)
+    {
+        return 0.0;
     }
 
     /* clamp to longitude range */
-    num_points = num_temp;
-    num_temp = 0;
     for (i = 0; i < num_points - 1; i++)
     {
-        latitude = temp_latitude[offset + i];
-        longitude = temp_longitude[offset + i];
-        next_latitude = temp_latitude[offset + i + 1];
-        next_longitude = temp_longitude[offset + i + 1];
+        latitude = poly_latitude[i];
+        longitude = poly_longitude[i];
+        next_latitude = poly_latitude[i + 1];
+        next_longitude = poly_longitude[i + 1];
 
         if (longitude < longitude_edges[0])
         {
@@ -627,99 +742,276 @@ static double find_weight_for_polygon_and_cell(long num_points, double *poly_lat
     return poly_area / cell_area;
 }
 
-static int find_matching_cells_and_weights_for_bounds(harp_variable *latitude_bounds, harp_variable *longitude_bounds,
-                                                      long num_latitude_edges, double *latitude_edges,
-                                                      long num_longitude_edges, double *longitude_edges,
-                                                      long *num_latlon_index, long **latlon_cell_index,
-                                                      double **latlon_weight)
+/* return whether the point lies inside the (closed) polygon (using the even-odd rule) */
+static int point_in_polygon(long num_points, const double *poly_latitude, const double *poly_longitude,
+                            double latitude, double longitude)
+{
+    int inside = 0;
+    long i;
+
+    for (i = 0; i < num_points - 1; i++)
+    {
+        if ((poly_latitude[i] > latitude) != (poly_latitude[i + 1] > latitude))
+        {
+            if (poly_longitude[i] + (latitude - poly_latitude[i]) * (poly_longitude[i + 1] - poly_longitude[i]) /
+                (poly_latitude[i + 1] - poly_latitude[i]) < longitude)
+            {
+                inside = !inside;
+            }
+        }
+    }
+
+    return inside;
+}
+
+/* Add all grid cells that overlap with the (closed) polygon, together with their overlap fraction.
+ * The grid is processed one latitude row at a time. For each row we determine which cells are crossed by an edge of
+ * the polygon. Only those cells get an exact weight by clipping the polygon against the cell. The cells in between are
+ * either fully inside the polygon (weight 1) or fully outside, which is determined with a single point in polygon test.
+ * 'range' should be able to hold 2 * num_points elements.
+ */
+static int add_cells_for_polygon(long num_points, const double *poly_latitude, const double *poly_longitude,
+                                 double latitude_min, double latitude_max, cell_lookup *latitude_lookup,
+                                 cell_lookup *longitude_lookup, double *row_latitude, double *row_longitude,
+                                 double *temp_latitude, double *temp_longitude, long *range, long *num_latlon_index,
+                                 long *cumsum_index, long **latlon_cell_index, double **latlon_weight)
+{
+    const double *latitude_edges = latitude_lookup->edges;
+    const double *longitude_edges = longitude_lookup->edges;
+    long num_longitude_cells = longitude_lookup->num_edges - 1;
+    long first_row, last_row;
+    long i, j, k;
+
+    if (!cell_lookup_find_range(latitude_lookup, latitude_min, latitude_max, &first_row, &last_row))
+    {
+        return 0;
+    }
+
+    for (j = first_row; j <= last_row; j++)
+    {
+        double row_min = latitude_edges[j];
+        double row_max = latitude_edges[j + 1];
+        long num_row_points;
+        long num_ranges = 0;
+
+        num_row_points = clip_polygon_to_latitude_range(num_points, poly_latitude, poly_longitude, row_latitude,
+                                                        row_longitude, &latitude_edges[j]);
+
+        /* determine the range of cells that each polygon edge crosses within this row */
+        for (i = 0; i < num_points - 1; i++)
+        {
+            double latitude = poly_latitude[i];
+            double longitude = poly_longitude[i];
+            double next_latitude = poly_latitude[i + 1];
+            double next_longitude = poly_longitude[i + 1];
+            double longitude_min, longitude_max;
+            long first, last;
+
+            if ((latitude < row_min && next_latitude < row_min) || (latitude > row_max && next_latitude > row_max))
+            {
+                continue;
+            }
+            if (latitude != next_latitude)
+            {
+                double slope = (next_longitude - longitude) / (next_latitude - latitude);
+
+                if (latitude < row_min || latitude > row_max)
+                {
+                    double edge = latitude < row_min ? row_min : row_max;
+
+                    longitude += (edge - latitude) * slope;
+                }
+                if (next_latitude < row_min || next_latitude > row_max)
+                {
+                    double edge = next_latitude < row_min ? row_min : row_max;
+
+                    next_longitude = poly_longitude[i] + (edge - poly_latitude[i]) * slope;
+                }
+            }
+            if (longitude < next_longitude)
+            {
+                longitude_min = longitude;
+                longitude_max = next_longitude;
+            }
+            else
+            {
+                longitude_min = next_longitude;
+                longitude_max = longitude;
+            }
+            if (cell_lookup_find_range(longitude_lookup, longitude_min, longitude_max, &first, &last))
+            {
+                /* insert sorted by first cell */
+                for (k = num_ranges; k > 0 && range[2 * (k - 1)] > first; k--)
+                {
+                    range[2 * k] = range[2 * (k - 1)];
+                    range[2 * k + 1] = range[2 * (k - 1) + 1];
+                }
+                range[2 * k] = first;
+                range[2 * k + 1] = last;
+                num_ranges++;
+            }
+        }
+
+        /* merge overlapping ranges */
+        if (num_ranges > 0)
+        {
+            long num_merged = 1;
+
+            for (k = 1; k < num_ranges; k++)
+            {
+                if (range[2 * k] <= range[2 * (num_merged - 1) + 1] + 1)
+                {
+                    if (range[2 * k + 1] > range[2 * (num_merged - 1) + 1])
+                    {
+                        range[2 * (num_merged - 1) + 1] = range[2 * k + 1];
+                    }
+                }
+                else
+                {
+                    range[2 * num_merged] = range[2 * k];
+                    range[2 * num_merged + 1] = range[2 * k + 1];
+                    num_merged++;
+                }
+            }
+            num_ranges = num_merged;
+        }
+
+        /* process the gaps between the ranges (including before the first and after the last range) and the ranges */
+        for (i = 0; i <= num_ranges; i++)
+        {
+            long gap_first = i == 0 ? 0 : range[2 * (i - 1) + 1] + 1;
+            long gap_last = i == num_ranges ? num_longitude_cells - 1 : range[2 * i] - 1;
+
+            /* cells that are not crossed by the polygon boundary are either all inside or all outside the polygon */
+            if (gap_first <= gap_last &&
+                point_in_polygon(num_points, poly_latitude, poly_longitude, (row_min + row_max) / 2,
+                                 (longitude_edges[gap_first] + longitude_edges[gap_first + 1]) / 2))
+            {
+                for (k = gap_first; k <= gap_last; k++)
+                {
+                    (*num_latlon_index)++;
+                    if (add_cell_index(j * num_longitude_cells + k, cumsum_index, latlon_cell_index, latlon_weight)
+                        != 0)
+                    {
+                        return -1;
+                    }
+                }
+            }
+
+            if (i == num_ranges)
+            {
+                break;
+            }
+
+            /* cells crossed by the polygon boundary */
+            for (k = range[2 * i]; k <= range[2 * i + 1]; k++)
+            {
+                (*num_latlon_index)++;
+                if (add_cell_index(j * num_longitude_cells + k, cumsum_index, latlon_cell_index, latlon_weight) != 0)
+                {
+                    return -1;
+                }
+                (*latlon_weight)[(*cumsum_index) - 1] =
+                    find_weight_for_polygon_and_cell(num_row_points, row_latitude, row_longitude, temp_latitude,
+                                                     temp_longitude, &latitude_edges[j], &longitude_edges[k]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* determine matching cells and weights for samples [first_sample, first_sample + num_samples).
+ * the matching cells for all samples in the range are stored in (newly allocated) latlon_cell_index/latlon_weight
+ * arrays and their total number in num_latlon_cells.
+ */
+static int find_matching_cells_and_weights_for_sample_range(harp_variable *latitude_bounds,
+                                                            harp_variable *longitude_bounds, long num_latitude_edges,
+                                                            double *latitude_edges, long num_longitude_edges,
+                                                            double *longitude_edges, long first_sample,
+                                                            long num_samples, long *num_latlon_index,
+                                                            long *num_latlon_cells, long **latlon_cell_index,
+                                                            double **latlon_weight)
 {
+    cell_lookup latitude_lookup;
+    cell_lookup longitude_lookup;
+    double *row_poly_latitude = NULL;
+    double *row_poly_longitude = NULL;
     double *temp_poly_latitude = NULL;
     double *temp_poly_longitude = NULL;
     double *poly_latitude = NULL;
     double *poly_longitude = NULL;
-    long num_latitude_cells = num_latitude_edges - 1;
-    long num_longitude_cells = num_longitude_edges - 1;
-    long *min_lat_id = NULL, *max_lat_id = NULL;        /* min/max grid latitude index for each longitude grid row */
-    long *min_lon_id = NULL, *max_lon_id = NULL;        /* min/max grid longitude index for each latitude grid row */
+    long *range = NULL;
     long cumsum_index = 0;
-    long num_elements;
     long max_num_vertices;
-    long i, j, k;
+    long max_num_points;
+    long i, k;
 
-    num_elements = latitude_bounds->dimension[0];
-    max_num_vertices = latitude_bounds->dimension[latitude_bounds->num_dimensions - 1];
+    *latlon_cell_index = NULL;
+    *latlon_weight = NULL;
 
-    if (longitude_bounds->dimension[latitude_bounds->num_dimensions - 1] != max_num_vertices)
-    {
-        harp_set_error(HARP_ERROR_INVALID_VARIABLE, "latitude_bounds and longitude_bounds variables should have the "
-                       "same length for the inpendent dimension");
-        return -1;
-    }
+    max_num_vertices = latitude_bounds->dimension[latitude_bounds->num_dimensions - 1];
 
     /* add 1 point to allow closing the polygon (i.e. repeat first point at the end) */
     /* and allow room for 2 more points to close polygons that cover a pole */
-    poly_latitude = malloc((max_num_vertices + 3) * sizeof(double));
+    max_num_points = max_num_vertices + 3;
+    poly_latitude = malloc(max_num_points * sizeof(double));
     if (poly_latitude == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (max_num_vertices + 3) * sizeof(double), __FILE__, __LINE__);
+                       max_num_points * sizeof(double), __FILE__, __LINE__);
         goto error;
     }
-    poly_longitude = malloc((max_num_vertices + 3) * sizeof(double));
+    poly_longitude = malloc(max_num_points * sizeof(double));
     if (poly_longitude == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (max_num_vertices + 3) * sizeof(double), __FILE__, __LINE__);
-        goto error;
-    }
-    /* the temporary polygon is used for calculating the overlap fraction with a cell */
-    /* it needs to be able to hold three times the amount of points as the input polygon */
-    temp_poly_latitude = malloc(3 * (max_num_vertices + 3) * sizeof(double));
-    if (temp_poly_latitude == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       3 * (max_num_vertices + 3) * sizeof(double), __FILE__, __LINE__);
+                       max_num_points * sizeof(double), __FILE__, __LINE__);
         goto error;
     }
-    temp_poly_longitude = malloc(3 * (max_num_vertices + 3) * sizeof(double));
-    if (temp_poly_longitude == NULL)
+    /* the row polygon holds the polygon clipped to a latitude row of the grid */
+    row_poly_latitude = malloc(2 * max_num_points * sizeof(double));
+    if (row_poly_latitude == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       3 * (max_num_vertices + 3) * sizeof(double), __FILE__, __LINE__);
+                       2 * max_num_points * sizeof(double), __FILE__, __LINE__);
         goto error;
     }
-
-    /* add two to the length to allow indexing just before and after the range */
-    min_lat_id = malloc((num_longitude_cells + 2) * sizeof(long));
-    if (min_lat_id == NULL)
+    row_poly_longitude = malloc(2 * max_num_points * sizeof(double));
+    if (row_poly_longitude == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (num_longitude_cells + 2) * sizeof(long), __FILE__, __LINE__);
+                       2 * max_num_points * sizeof(double), __FILE__, __LINE__);
         goto error;
     }
-    max_lat_id = malloc((num_longitude_cells + 2) * sizeof(long));
-    if (max_lat_id == NULL)
+    /* the temporary polygon is used for calculating the overlap fraction of the row polygon with a cell */
+    temp_poly_latitude = malloc(4 * max_num_points * sizeof(double));
+    if (temp_poly_latitude == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (num_longitude_cells + 2) * sizeof(long), __FILE__, __LINE__);
+                       4 * max_num_points * sizeof(double), __FILE__, __LINE__);
         goto error;
     }
-    min_lon_id = malloc((num_latitude_cells + 2) * sizeof(long));
-    if (min_lon_id == NULL)
+    temp_poly_longitude = malloc(4 * max_num_points * sizeof(double));
+    if (temp_poly_longitude == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (num_latitude_cells + 2) * sizeof(long), __FILE__, __LINE__);
+                       4 * max_num_points * sizeof(double), __FILE__, __LINE__);
         goto error;
     }
-    max_lon_id = malloc((num_latitude_cells + 2) * sizeof(long));
-    if (max_lon_id == NULL)
+    /* range of crossed longitude cells for each polygon edge within a latitude row */
+    range = malloc(2 * max_num_points * sizeof(long));
+    if (range == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (num_latitude_cells + 2) * sizeof(long), __FILE__, __LINE__);
+                       2 * max_num_points * sizeof(long), __FILE__, __LINE__);
         goto error;
     }
 
-    for (i = 0; i < num_elements; i++)
+    cell_lookup_init(&latitude_lookup, num_latitude_edges, latitude_edges);
+    cell_lookup_init(&longitude_lookup, num_longitude_edges, longitude_edges);
+
+    for (i = first_sample; i < first_sample + num_samples; i++)
     {
         double lat_min, lat_max, lon_min, lon_max;
         long num_vertices = max_num_vertices;
@@ -779,10 +1071,6 @@ static int find_matching_cells_and_weights_for_bounds(harp_variable *latitude_bo
         /* We loop twice to handle wrap-around situations. The second time we use longitudes + 360 */
         for (loop = 0; loop < 2; loop++)
         {
-            long lat_id = -1, lon_id = -1;
-            long next_lat_id, next_lon_id;
-            long cumsum_offset = cumsum_index;
-
             if (loop == 1)
             {
                 lon_min += 360;
@@ -798,252 +1086,27 @@ static int find_matching_cells_and_weights_for_bounds(harp_variable *latitude_bo
                 continue;
             }
 
-            for (j = 0; j < num_longitude_cells + 2; j++)
-            {
-                min_lat_id[j] = num_latitude_cells;
-                max_lat_id[j] = -1;
-            }
-            for (j = 0; j < num_latitude_cells + 2; j++)
-            {
-                min_lon_id[j] = num_longitude_cells;
-                max_lon_id[j] = -1;
-            }
-
-            /* iterate over all line segments and determine which grid cells are crossed */
-            /* we initially add each crossing cell with weight 1 */
-            harp_interpolate_find_index(num_latitude_edges, latitude_edges, poly_latitude[0], &lat_id);
-            if (lat_id == num_latitude_edges)
-            {
-                lat_id = num_latitude_cells;
-            }
-            harp_interpolate_find_index(num_longitude_edges, longitude_edges, poly_longitude[0], &lon_id);
-            if (lon_id == num_longitude_edges)
-            {
-                lon_id = num_longitude_cells;
-            }
-            next_lat_id = lat_id;
-            next_lon_id = lon_id;
-            /* add cell of starting point (if it falls within the grid) */
-            if (lon_id >= 0 && lon_id < num_longitude_cells && lat_id >= 0 && lat_id < num_latitude_cells)
-            {
-                if (lon_id < min_lon_id[lat_id + 1] || lon_id > max_lon_id[lat_id + 1] ||
-                    lat_id < min_lat_id[lon_id + 1] || lat_id > max_lat_id[lon_id + 1])
-                {
-                    num_latlon_index[i]++;
-                    if (add_cell_index(lat_id * num_longitude_cells + lon_id, &cumsum_index, latlon_cell_index,
-                                       latlon_weight) != 0)
-                    {
-                        goto error;
-                    }
-                }
-            }
-            if (lat_id < min_lat_id[lon_id + 1])
-            {
-                min_lat_id[lon_id + 1] = lat_id;
-            }
-            if (lat_id > max_lat_id[lon_id + 1])
-            {
-                max_lat_id[lon_id + 1] = lat_id;
-            }
-            if (lon_id < min_lon_id[lat_id + 1])
-            {
-                min_lon_id[lat_id + 1] = lon_id;
-            }
-            if (lon_id > max_lon_id[lat_id + 1])
+            if (add_cells_for_polygon(num_vertices, poly_latitude, poly_longitude, lat_min, lat_max, &latitude_lookup,
+                                      &longitude_lookup, row_poly_latitude, row_poly_longitude, temp_poly_latitude,
+                                      temp_poly_longitude, range, &num_latlon_index[i], &cumsum_index,
+                                      latlon_cell_index, latlon_weight) != 0)
             {
-                max_lon_id[lat_id + 1] = lon_id;
+                goto error;
             }
-            for (j = 0; j < num_vertices - 1; j++)
-            {
-                double latitude = poly_latitude[j];
-                double longitude = poly_longitude[j];
-                double next_latitude = poly_latitude[j + 1];
-                double next_longitude = poly_longitude[j + 1];
+        }
+    }
 
-                /* determine grid location of end of line segment */
-                harp_interpolate_find_index(num_latitude_edges, latitude_edges, poly_latitude[j + 1], &next_lat_id);
-                if (next_lat_id == num_latitude_edges)
-                {
-                    next_lat_id = num_latitude_cells;
-                }
-                harp_interpolate_find_index(num_longitude_edges, longitude_edges, poly_longitude[j + 1], &next_lon_id);
-                if (next_lon_id == num_longitude_edges)
-                {
-                    next_lon_id = num_longitude_cells;
-                }
-                while (lat_id != next_lat_id || lon_id != next_lon_id)
-                {
-                    /* determine intermediate cells that the line segment crosses */
-                    if (next_lat_id > lat_id)
-                    {
-                        double slope = (next_longitude - longitude) / (next_latitude - latitude);
+    free(poly_latitude);
+    free(poly_longitude);
+    free(row_poly_latitude);
+    free(row_poly_longitude);
+    free(temp_poly_latitude);
+    free(temp_poly_longitude);
+    free(range);
 
-                        if (next_lon_id > lon_id &&
-                            longitude + (latitude_edges[lat_id + 1] - latitude) * slope > longitude_edges[lon_id + 1])
-                        {
-                            /* move right */
-                            latitude += (longitude_edges[lon_id + 1] - longitude) / slope;
-                            longitude = longitude_edges[lon_id + 1];
-                            lon_id++;
-                        }
-                        else if (next_lon_id < lon_id &&
-                                 longitude + (latitude_edges[lat_id + 1] - latitude) * slope < longitude_edges[lon_id])
-                        {
-                            /* move left */
-                            latitude += (longitude_edges[lon_id] - longitude) / slope;
-                            longitude = longitude_edges[lon_id];
-                            lon_id--;
-                        }
-                        else
-                        {
-                            /* move up */
-                            longitude += (latitude_edges[lat_id + 1] - latitude) * slope;
-                            latitude = latitude_edges[lat_id + 1];
-                            lat_id++;
-                        }
-                    }
-                    else if (next_lat_id < lat_id)
-                    {
-                        double slope = (next_longitude - longitude) / (next_latitude - latitude);
+    *num_latlon_cells = cumsum_index;
 
-                        if (next_lon_id > lon_id &&
-                            longitude + (latitude_edges[lat_id] - latitude) * slope > longitude_edges[lon_id + 1])
-                        {
-                            /* move right */
-                            latitude += (longitude_edges[lon_id + 1] - longitude) / slope;
-                            longitude = longitude_edges[lon_id + 1];
-                            lon_id++;
-                        }
-                        else if (next_lon_id < lon_id &&
-                                 longitude + (latitude_edges[lat_id] - latitude) * slope < longitude_edges[lon_id])
-                        {
-                            /* move left */
-                            latitude += (longitude_edges[lon_id] - longitude) / slope;
-                            longitude = longitude_edges[lon_id];
-                            lon_id--;
-                        }
-                        else
-                        {
-                            /* move down */
-                            longitude += (latitude_edges[lat_id] - latitude) * slope;
-                            latitude = latitude_edges[lat_id];
-                            lat_id--;
-                        }
-                    }
-                    else
-                    {
-                        double slope = (next_latitude - latitude) / (next_longitude - longitude);
-
-                        if (next_lon_id > lon_id)
-                        {
-                            /* move right */
-                            latitude += (longitude_edges[lon_id + 1] - longitude) * slope;
-                            longitude = longitude_edges[lon_id + 1];
-                            lon_id++;
-                        }
-                        else
-                        {
-                            /* move left */
-                            latitude += (longitude_edges[lon_id] - longitude) * slope;
-                            longitude = longitude_edges[lon_id];
-                            lon_id--;
-                        }
-                    }
-                    /* add next cell (if it falls within the grid) */
-                    if (lon_id >= 0 && lon_id < num_longitude_cells && lat_id >= 0 && lat_id < num_latitude_cells)
-                    {
-                        if (lon_id < min_lon_id[lat_id + 1] || lon_id > max_lon_id[lat_id + 1] ||
-                            lat_id < min_lat_id[lon_id + 1] || lat_id > max_lat_id[lon_id + 1])
-                        {
-                            num_latlon_index[i]++;
-                            if (add_cell_index(lat_id * num_longitude_cells + lon_id, &cumsum_index, latlon_cell_index,
-                                               latlon_weight) != 0)
-                            {
-                                goto error;
-                            }
-                        }
-                    }
-                    if (lat_id < min_lat_id[lon_id + 1])
-                    {
-                        min_lat_id[lon_id + 1] = lat_id;
-                    }
-                    if (lat_id > max_lat_id[lon_id + 1])
-                    {
-                        max_lat_id[lon_id + 1] = lat_id;
-                    }
-                    if (lon_id < min_lon_id[lat_id + 1])
-                    {
-                        min_lon_id[lat_id + 1] = lon_id;
-                    }
-                    if (lon_id > max_lon_id[lat_id + 1])
-                    {
-                        max_lon_id[lat_id + 1] = lon_id;
-                    }
-                }
-            }
-
-            /* calculate actual weight (based on overlap fraction) for each cell we have added up to now */
-            for (j = cumsum_offset; j < cumsum_index; j++)
-            {
-                lat_id = (*latlon_cell_index)[j] / num_longitude_cells;
-                lon_id = (*latlon_cell_index)[j] - lat_id * num_longitude_cells;
-                (*latlon_weight)[j] = find_weight_for_polygon_and_cell(num_vertices, poly_latitude, poly_longitude,
-                                                                       temp_poly_latitude, temp_poly_longitude,
-                                                                       &latitude_edges[lat_id],
-                                                                       &longitude_edges[lon_id]);
-            }
-
-            /* add all grid cells that lie fully within the polygon */
-            for (j = 0; j < num_latitude_cells; j++)
-            {
-                if (min_lon_id[j + 1] < max_lon_id[j + 1])
-                {
-                    for (k = min_lon_id[j + 1] + 1; k < max_lon_id[j + 1]; k++)
-                    {
-                        long cell_index = j * num_longitude_cells + k;
-
-                        if (j > min_lat_id[k + 1] && j < max_lat_id[k + 1])
-                        {
-                            long l;
-
-                            /* check if this cell wasn't already added due to a partial overlap */
-                            for (l = cumsum_offset; l < cumsum_index; l++)
-                            {
-                                if (cell_index == (*latlon_cell_index)[l])
-                                {
-                                    break;
-                                }
-                            }
-                            if (l == cumsum_index)
-                            {
-                                /* add cell with full weight */
-                                num_latlon_index[i]++;
-                                if (add_cell_index(cell_index, &cumsum_index, latlon_cell_index, latlon_weight) != 0)
-                                {
-                                    goto error;
-                                }
-                                (*latlon_weight)[cumsum_index - 1] =
-                                    find_weight_for_polygon_and_cell(num_vertices, poly_latitude, poly_longitude,
-                                                                     temp_poly_latitude, temp_poly_longitude,
-                                                                     &latitude_edges[j], &longitude_edges[k]);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    free(poly_latitude);
-    free(poly_longitude);
-    free(temp_poly_latitude);
-    free(temp_poly_longitude);
-    free(min_lat_id);
-    free(max_lat_id);
-    free(min_lon_id);
-    free(max_lon_id);
-
-    return 0;
+    return 0;
 
   error:
     if (poly_latitude != NULL)
@@ -1054,6 +1117,14 @@ static int find_matching_cells_and_weights_for_bounds(harp_variable *latitude_bo
     {
         free(poly_longitude);
     }
+    if (row_poly_latitude != NULL)
+    {
+        free(row_poly_latitude);
+    }
+    if (row_poly_longitude != NULL)
+    {
+        free(row_poly_longitude);
+    }
     if (temp_poly_latitude != NULL)
     {
         free(temp_poly_latitude);
@@ -1062,240 +1133,420 @@ static int find_matching_cells_and_weights_for_bounds(harp_variable *latitude_bo
     {
         free(temp_poly_longitude);
     }
-    if (min_lat_id != NULL)
-    {
-        free(min_lat_id);
-    }
-    if (max_lat_id != NULL)
+    if (range != NULL)
     {
-        free(max_lat_id);
+        free(range);
     }
-    if (min_lon_id != NULL)
+    if (*latlon_cell_index != NULL)
     {
-        free(min_lon_id);
+        free(*latlon_cell_index);
+        *latlon_cell_index = NULL;
     }
-    if (max_lon_id != NULL)
+    if (*latlon_weight != NULL)
     {
-        free(max_lon_id);
+        free(*latlon_weight);
+        *latlon_weight = NULL;
     }
 
     return -1;
 }
 
-static int find_matching_cells_for_points(harp_variable *latitude, harp_variable *longitude, long num_latitude_edges,
-                                          double *latitude_edges, long num_longitude_edges, double *longitude_edges,
-                                          long *num_latlon_index, long **latlon_cell_index)
+/* the samples are split into slices that are matched in parallel; the results are concatenated in sample order */
+static int find_matching_cells_and_weights_for_bounds(harp_variable *latitude_bounds, harp_variable *longitude_bounds,
+                                                      long num_latitude_edges, double *latitude_edges,
+                                                      long num_longitude_edges, double *longitude_edges,
+                                                      long *num_latlon_index, long **latlon_cell_index,
+                                                      double **latlon_weight)
 {
-    long latitude_index = -1;
-    long longitude_index = -1;
-    long cumsum_index = 0;
+    long *slice_num_cells = NULL;
+    long **slice_cell_index = NULL;
+    double **slice_weight = NULL;
     long num_elements;
-    long i;
+    long num_cells;
+    int num_slices;
+    int failed = 0;
+    int i;
 
-    num_elements = latitude->dimension[0];
-    for (i = 0; i < num_elements; i++)
+    num_elements = latitude_bounds->dimension[0];
+
+    if (longitude_bounds->dimension[latitude_bounds->num_dimensions - 1] !=
+        latitude_bounds->dimension[latitude_bounds->num_dimensions - 1])
+    {
+        harp_set_error(HARP_ERROR_INVALID_VARIABLE, "latitude_bounds and longitude_bounds variables should have the "
+                       "same length for the inpendent dimension");
+        return -1;
+    }
+
+    num_slices = harp_get_num_threads();
+    if (num_slices > num_elements)
+    {
+        num_slices = (int)num_elements;
+    }
+    if (num_slices <= 1)
+    {
+        return find_matching_cells_and_weights_for_sample_range(latitude_bounds, longitude_bounds,
+                                                                num_latitude_edges, latitude_edges,
+                                                                num_longitude_edges, longitude_edges, 0,
+                                                                num_elements, num_latlon_index, &num_cells,
+                                                                latlon_cell_index, latlon_weight);
+    }
+
+    slice_num_cells = calloc(num_slices, sizeof(long));
+    slice_cell_index = calloc(num_slices, sizeof(long *));
+    slice_weight = calloc(num_slices, sizeof(double *));
+    if (slice_num_cells == NULL || slice_cell_index == NULL || slice_weight == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_slices * sizeof(double *), __FILE__, __LINE__);
+        failed = 1;
+    }
+    else
     {
-        double wrapped_longitude;
+#pragma omp parallel for reduction(|:failed) schedule(static) num_threads(num_slices)
+        for (i = 0; i < num_slices; i++)
+        {
+            long offset = num_elements * i / num_slices;
+            long length = num_elements * (i + 1) / num_slices - offset;
+
+            if (find_matching_cells_and_weights_for_sample_range(latitude_bounds, longitude_bounds,
+                                                                 num_latitude_edges, latitude_edges,
+                                                                 num_longitude_edges, longitude_edges, offset, length,
+                                                                 num_latlon_index, &slice_num_cells[i],
+                                                                 &slice_cell_index[i], &slice_weight[i]) != 0)
+            {
+                failed |= 1;
+            }
+        }
+    }
 
-        harp_interpolate_find_index(num_latitude_edges, latitude_edges, latitude->data.double_data[i], &latitude_index);
-        if (latitude_index < 0 || latitude_index >= num_latitude_edges - 1)
+    if (!failed)
+    {
+        num_cells = 0;
+        for (i = 0; i < num_slices; i++)
         {
-            num_latlon_index[i] = 0;
-            continue;
+            num_cells += slice_num_cells[i];
         }
-        wrapped_longitude = harp_wrap(longitude->data.double_data[i], longitude_edges[0], longitude_edges[0] + 360);
-        harp_interpolate_find_index(num_longitude_edges, longitude_edges, wrapped_longitude, &longitude_index);
-        if (longitude_index < 0 || longitude_index >= num_longitude_edges - 1)
+        if (num_cells > 0)
         {
-            num_latlon_index[i] = 0;
-            continue;
+            *latlon_cell_index = malloc(num_cells * sizeof(long));
+            if (*latlon_cell_index == NULL)
+            {
+                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               num_cells * sizeof(long), __FILE__, __LINE__);
+                failed = 1;
+            }
+            else
+            {
+                *latlon_weight = malloc(num_cells * sizeof(double));
+                if (*latlon_weight == NULL)
+                {
+                    harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                                   num_cells * sizeof(double), __FILE__, __LINE__);
+                    free(*latlon_cell_index);
+                    *latlon_cell_index = NULL;
+                    failed = 1;
+                }
+            }
         }
-        num_latlon_index[i] = 1;
-        if (cumsum_index % LATLON_BLOCK_SIZE == 0)
+        if (!failed)
         {
-            long *new_latlon_cell_index;
+            num_cells = 0;
+            for (i = 0; i < num_slices; i++)
+            {
+                if (slice_num_cells[i] > 0)
+                {
+                    memcpy(&(*latlon_cell_index)[num_cells], slice_cell_index[i], slice_num_cells[i] * sizeof(long));
+                    memcpy(&(*latlon_weight)[num_cells], slice_weight[i], slice_num_cells[i] * sizeof(double));
+                    num_cells += slice_num_cells[i];
+                }
+            }
+        }
+    }
 
-            new_latlon_cell_index = realloc(*latlon_cell_index, (cumsum_index + LATLON_BLOCK_SIZE) * sizeof(long));
-            if (new_latlon_cell_index == NULL)
+    if (slice_cell_index != NULL)
+    {
+        for (i = 0; i < num_slices; i++)
+        {
+            if (slice_cell_index[i] != NULL)
             {
-                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                               (cumsum_index + LATLON_BLOCK_SIZE) * sizeof(long), __FILE__, __LINE__);
-                return -1;
+                free(slice_cell_index[i]);
+            }
+        }
+        free(slice_cell_index);
+    }
+    if (slice_weight != NULL)
+    {
+        for (i = 0; i < num_slices; i++)
+        {
+            if (slice_weight[i] != NULL)
+            {
+                free(slice_weight[i]);
             }
-            *latlon_cell_index = new_latlon_cell_index;
         }
-        (*latlon_cell_index)[cumsum_index] = latitude_index * (num_longitude_edges - 1) + longitude_index;
-        cumsum_index++;
+        free(slice_weight);
+    }
+    if (slice_num_cells != NULL)
+    {
+        free(slice_num_cells);
     }
 
-    return 0;
+    return failed ? -1 : 0;
 }
 
-/** \addtogroup harp_product
- * @{
- */
-
-
-/** Bin the product's variables into a spatial grid.
- * This will bin all variables with a time dimension into a three dimensional time x latitude x longitude grid.
- * Each time sample will first be allocated to a time bin defined by time_bin_index (similar to \a harp_product_bin).
- * Then within that time bin the sample will be allocated to the appropriate cell(s) in the latitude/longitude grid as
- * defined by the latitude_edges and longitude_edges variables.
- *
- * The lat/lon grid will be a fixed time-independent grid and will have 'num_latitude_edges-1' latitudes and
- * 'num_longitude_edges-1' longitudes.
- * The latitude_edges and longitude_edges arrays provide the boundaries of the grid cells in degrees and need to be
- * provided in a strict ascending order. The latitude edge values need to be between -90 and 90 and for the longitude
- * edge values the constraint is that the difference between the last and first edge should be <= 360.
- *
- * If the product has latitude_bounds {time,independent} and longitude_bounds {time,independent} variables then an area
- * binning is performed. This means that each sample will be allocated to each lat/lon grid cell based on the amount of
- * overlap. This overlap calculation will treat lines between points as straight lines within the carthesian plane
- * (i.e. using a Plate Carree projection, and not using great circle arcs between points on a sphere).
- *
- * If the product doesn't have lat/lon bounds per sample, it should have latitude {time} and longitude {time} variables.
- * The binning onto the lat/lon grid will then be a point binning. This means that each sample is allocated to only one
- * grid cell based on its lat/lon coordinate. To achieve a unique assignment, for each cell the lower edge will be
- * considered inclusive and the upper edge exclusive (except for the last cell (when there is no wrap-around)).
- *
- * The resulting value for each time/lat/lon cell will be the average of all values for that cell.
- * This will be a weighted average in case an area binning is performed and a straight average for point binning.
- * Variables with multiple dimensions will have all elements in its sub dimensions averaged on an element by element
- * basis (i.e. sub dimensions will be retained).
- *
- * Variables that have a time dimension but no unit (or using a string data type) will be removed.
- * Any existing count or weight variables will also be removed.
- *
- * For uncertainty variables the first order propagation rules are used (assuming full correlation).
- *
- * All variables that are binned are converted to a double data type. Cells that have no samples will end up with a NaN
- * value.
- *
- * A 'count' variable will be added to the product that will contain the number of samples per time bin.
- * In addition, a 'weight' variable will be added that will contain the sum of weights for the contribution to each
- * cell. If a variable contained NaN values then a variable specific weight variable will be created with only the sum
- * of weights for the non-NaN entries.
- *
- * For angle variables a variable-specific weight variable will be created that contains the magnitude of the sum of the
- * unit vectors that was used to calculate the angle average.
- *
- * Axis variables for the time dimension such as datetime, datetime_length, datetime_start, and datetime_stop will only
- * be binned in the time dimension (and will not gain a latitude or longitude dimension).
- *
- * \param product Product to regrid.
- * \param num_time_bins Number of target bins in the time dimension.
- * \param num_time_elements Length of bin_index array (should equal the length of the time dimension)
- * \param time_bin_index Array of target time bin index numbers (0 .. num_bins-1) for each sample in the time dimension.
- * \param num_latitude_edges Number of edges for the latitude grid (number of latitude rows = num_latitude_edges - 1)
- * \param latitude_edges latitude grid edge vales
- * \param num_longitude_edges Number of edges for the longitude grid
- *        (number of longitude columns = num_longitude_edges - 1)
- * \param longitude_edges longitude grid edge vales
- *
- * \return
- *   \arg \c 0, Success.
- *   \arg \c -1, Error occurred (check #harp_errno).
- */
-LIBHARP_API int harp_product_bin_spatial(harp_product *product, long num_time_bins, long num_time_elements,
-                                         long *time_bin_index, long num_latitude_edges, double *latitude_edges,
-                                         long num_longitude_edges, double *longitude_edges)
+static int find_matching_cells_for_points(harp_variable *latitude, harp_variable *longitude, long num_latitude_edges,
+                                          double *latitude_edges, long num_longitude_edges, double *longitude_edges,
+                                          long *num_latlon_index, long **latlon_cell_index)
 {
-    long spatial_block_length = (num_latitude_edges - 1) * (num_longitude_edges - 1);
-    harp_data_type data_type = harp_type_double;
-    harp_dimension_type dimension_type[HARP_MAX_NUM_DIMS];
-    long dimension[HARP_MAX_NUM_DIMS];
-    harp_variable *latitude = NULL;
-    harp_variable *longitude = NULL;
-    binning_type *bintype = NULL;
-    double nan_value = harp_nan();
-    long *num_latlon_index = NULL;      /* number of matching latlon cells for each sample [num_time_elements] */
-    long *latlon_cell_index = NULL;     /* flat latlon cell index for each matching cell for each sample [sum(num_latlon_index)] */
-    double *latlon_weight = NULL;       /* weight for each matching cell for each sample [sum(num_latlon_index)] */
-    long *time_index = NULL;    /* index of first contributing sample for each bin */
-    long weight_size;
-    int32_t *bin_count = NULL;  /* number of contributing samples for each time bin [num_time_bins] */
-    float *weight = NULL;       /* sum of weights per latlon cell and time [num_time_bins, num_latitude_edges-1, num_longitude_edges-1] */
-    long cumsum_index;  /* index into latlon_cell_index and latlon_weight */
-    int area_binning = 0;
-    long i, j, k, l;
+    cell_lookup latitude_lookup;
+    cell_lookup longitude_lookup;
+    long cumsum_index = 0;
+    long num_elements;
+    int num_slices;
+    long i;
+    int j;
 
-    if (product->dimension[harp_dimension_latitude] > 0 || product->dimension[harp_dimension_longitude] > 0)
+    num_elements = latitude->dimension[0];
+    if (num_elements == 0)
     {
-        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "spatial binning cannot be performed on products that already "
-                       "have a latitude and/or longitude dimension");
-        return -1;
+        return 0;
     }
 
-    if (num_time_elements != product->dimension[harp_dimension_time])
+    /* each point matches at most one cell */
+    *latlon_cell_index = malloc(num_elements * sizeof(long));
+    if (*latlon_cell_index == NULL)
     {
-        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_time_elements (%ld) does not match time dimension length "
-                       "(%ld) (%s:%u)", num_time_elements, product->dimension[harp_dimension_time], __FILE__, __LINE__);
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_elements * sizeof(long), __FILE__, __LINE__);
         return -1;
     }
 
-    for (i = 0; i < num_time_elements; i++)
-    {
-        if (time_bin_index[i] < 0 || time_bin_index[i] >= num_time_bins)
-        {
-            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "time_bin_index[%ld] (%ld) should be in the range [0..%ld) "
-                           "(%s:%u)", i, time_bin_index[i], num_time_bins, __FILE__, __LINE__);
-            return -1;
-        }
-    }
+    cell_lookup_init(&latitude_lookup, num_latitude_edges, latitude_edges);
+    cell_lookup_init(&longitude_lookup, num_longitude_edges, longitude_edges);
 
-    if (num_latitude_edges < 2)
+    /* find the cell of each sample in parallel (storing it at the index of the sample) */
+    num_slices = harp_get_num_threads();
+    if (num_slices > num_elements)
     {
-        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "need at least 2 latitude edges to perform spatial binning");
-        return -1;
+        num_slices = (int)num_elements;
     }
-    if (num_longitude_edges < 2)
+    if (num_slices < 1)
     {
-        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "need at least 2 longitude edges to perform spatial binning");
-        return -1;
+        num_slices = 1;
     }
-    for (i = 0; i < num_latitude_edges; i++)
+#pragma omp parallel for schedule(static) num_threads(num_slices)
+    for (j = 0; j < num_slices; j++)
     {
-        if (latitude_edges[i] < -90.0 || latitude_edges[i] > 90.0)
+        cell_lookup slice_latitude_lookup = latitude_lookup;
+        cell_lookup slice_longitude_lookup = longitude_lookup;
+        long offset = num_elements * j / num_slices;
+        long length = num_elements * (j + 1) / num_slices - offset;
+        long i;
+
+        for (i = offset; i < offset + length; i++)
         {
-            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "latitude edge value (%lf) needs to be in the range [-90,90] "
-                           "for spatial binning", latitude_edges[i]);
-            return -1;
+            double wrapped_longitude;
+            long latitude_index;
+            long longitude_index;
+
+            latitude_index = cell_lookup_find(&slice_latitude_lookup, latitude->data.double_data[i]);
+            if (latitude_index < 0)
+            {
+                num_latlon_index[i] = 0;
+                continue;
+            }
+            wrapped_longitude = harp_wrap(longitude->data.double_data[i], longitude_edges[0],
+                                          longitude_edges[0] + 360);
+            longitude_index = cell_lookup_find(&slice_longitude_lookup, wrapped_longitude);
+            if (longitude_index < 0)
+            {
+                num_latlon_index[i] = 0;
+                continue;
+            }
+            num_latlon_index[i] = 1;
+            (*latlon_cell_index)[i] = latitude_index * (num_longitude_edges - 1) + longitude_index;
         }
     }
-    for (i = 1; i < num_latitude_edges; i++)
+
+    /* remove the entries of samples without a matching cell */
+    for (i = 0; i < num_elements; i++)
     {
-        if (latitude_edges[i] <= latitude_edges[i - 1])
+        if (num_latlon_index[i] > 0)
         {
-            harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
-                           "latitude edge values need to be in strict ascending order for spatial binning");
-            return -1;
+            (*latlon_cell_index)[cumsum_index] = (*latlon_cell_index)[i];
+            cumsum_index++;
         }
     }
-    for (i = 1; i < num_longitude_edges; i++)
+
+    return 0;
+}
+
+/* sum up all samples into the [num_time_bins, num_latitude_cells, num_longitude_cells, num_sub_elements] target grid.
+ * if time_bin_index is NULL then all samples are put in a single time bin.
+ * if variable is NULL only the global weight per cell is accumulated.
+ * the target grid is split into bands of latitude rows that are processed in parallel; each band visits the samples in
+ * the original order, such that the result does not depend on the number of threads.
+ * returns whether a NaN value was encountered (which requires storing a weight variable).
+ */
+static int accumulate_samples(long num_time_elements, const long *time_bin_index, long num_latitude_cells,
+                              long num_longitude_cells, const long *num_latlon_index, const long *latlon_cell_index,
+                              const double *latlon_weight, int area_binning, binning_type bintype,
+                              const harp_variable *variable, long num_sub_elements, harp_variable *new_variable,
+                              float *weight)
+{
+    long spatial_block_length = num_latitude_cells * num_longitude_cells;
+    int store_weight_variable = 0;
+    int num_bands;
+    int b;
+
+    num_bands = harp_get_num_threads();
+    if (num_bands > num_latitude_cells)
     {
-        if (longitude_edges[i] <= longitude_edges[i - 1])
-        {
-            harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
-                           "longitude edge values need to be in strict ascending order for spatial binning");
-            return -1;
-        }
+        num_bands = (int)num_latitude_cells;
     }
-    if (longitude_edges[num_longitude_edges - 1] - longitude_edges[0] > 360)
+    if (num_bands < 1)
+    {
+        num_bands = 1;
+    }
+
+#pragma omp parallel for reduction(|:store_weight_variable) schedule(static) num_threads(num_bands)
+    for (b = 0; b < num_bands; b++)
+    {
+        long first_cell = (num_latitude_cells * b / num_bands) * num_longitude_cells;
+        long end_cell = (num_latitude_cells * (b + 1) / num_bands) * num_longitude_cells;
+        long cumsum_index = 0;  /* index into latlon_cell_index and latlon_weight */
+        long i, j, l;
+
+        for (i = 0; i < num_time_elements; i++)
+        {
+            long index_offset = time_bin_index == NULL ? 0 : time_bin_index[i] * spatial_block_length;
+
+            for (l = 0; l < num_latlon_index[i]; l++, cumsum_index++)
+            {
+                long target_index = index_offset + latlon_cell_index[cumsum_index];
+                double multiplication_factor = 1;
+                double sample_weight = 1;
+
+                if (latlon_cell_index[cumsum_index] < first_cell || latlon_cell_index[cumsum_index] >= end_cell)
+                {
+                    continue;
+                }
+                if (area_binning)
+                {
+                    sample_weight = latlon_weight[cumsum_index];
+                    multiplication_factor = sample_weight;
+                    if (bintype == binning_uncertainty)
+                    {
+                        multiplication_factor *= sample_weight;
+                    }
+                }
+                if (variable == NULL)
+                {
+                    weight[target_index] += sample_weight;
+                }
+                else if (bintype == binning_angle)
+                {
+                    /* for angle variables we use one weight element per vector pair */
+                    for (j = 0; j < num_sub_elements; j += 2)
+                    {
+                        if (!harp_isnan(variable->data.double_data[i * num_sub_elements + j]))
+                        {
+                            weight[(target_index * num_sub_elements + j) / 2] += sample_weight;
+                            new_variable->data.double_data[target_index * num_sub_elements + j] +=
+                                multiplication_factor * variable->data.double_data[i * num_sub_elements + j];
+                            new_variable->data.double_data[target_index * num_sub_elements + j + 1] +=
+                                multiplication_factor * variable->data.double_data[i * num_sub_elements + j + 1];
+                        }
+                    }
+                }
+                else
+                {
+                    for (j = 0; j < num_sub_elements; j++)
+                    {
+                        if (!harp_isnan(variable->data.double_data[i * num_sub_elements + j]))
+                        {
+                            weight[target_index * num_sub_elements + j] += sample_weight;
+                            new_variable->data.double_data[target_index * num_sub_elements + j] +=
+                                multiplication_factor * variable->data.double_data[i * num_sub_elements + j];
+                        }
+                        else
+                        {
+                            store_weight_variable = 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return store_weight_variable;
+}
+
+/* verify that the grid edges can be used for spatial binning */
+static int check_grid_edges(long num_latitude_edges, const double *latitude_edges, long num_longitude_edges,
+                            const double *longitude_edges)
+{
+    long i;
+
+    if (num_latitude_edges < 2)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "need at least 2 latitude edges to perform spatial binning");
+        return -1;
+    }
+    if (num_longitude_edges < 2)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "need at least 2 longitude edges to perform spatial binning");
+        return -1;
+    }
+    for (i = 0; i < num_latitude_edges; i++)
+    {
+        if (latitude_edges[i] < -90.0 || latitude_edges[i] > 90.0)
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "latitude edge value (%lf) needs to be in the range [-90,90] "
+                           "for spatial binning", latitude_edges[i]);
+            return -1;
+        }
+    }
+    for (i = 1; i < num_latitude_edges; i++)
+    {
+        if (latitude_edges[i] <= latitude_edges[i - 1])
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
+                           "latitude edge values need to be in strict ascending order for spatial binning");
+            return -1;
+        }
+    }
+    for (i = 1; i < num_longitude_edges; i++)
+    {
+        if (longitude_edges[i] <= longitude_edges[i - 1])
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
+                           "longitude edge values need to be in strict ascending order for spatial binning");
+            return -1;
+        }
+    }
+    if (longitude_edges[num_longitude_edges - 1] - longitude_edges[0] > 360)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "longitude edge range (%lf .. %lf) cannot exceed 360 degrees",
                        latitude_edges[0], longitude_edges[num_longitude_edges - 1]);
         return -1;
     }
 
+    return 0;
+}
 
-    num_latlon_index = malloc(num_time_elements * sizeof(long));
-    if (num_latlon_index == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       num_time_elements * sizeof(long), __FILE__, __LINE__);
-        goto error;
-    }
+/* determine the matching grid cells (and weights) for all samples of a product.
+ * an area binning is performed if the product has latitude_bounds and longitude_bounds, otherwise a point binning.
+ */
+static int find_matching_cells_for_product(harp_product *product, long num_latitude_edges, double *latitude_edges,
+                                           long num_longitude_edges, double *longitude_edges, long *num_latlon_index,
+                                           long **latlon_cell_index, double **latlon_weight, int *area_binning)
+{
+    harp_data_type data_type = harp_type_double;
+    harp_dimension_type dimension_type[2];
+    harp_variable *latitude = NULL;
+    harp_variable *longitude = NULL;
 
+    *area_binning = 0;
     dimension_type[0] = harp_dimension_time;
     dimension_type[1] = harp_dimension_independent;
     if (harp_product_get_derived_variable(product, "latitude_bounds", &data_type, "degree_north", 2, dimension_type,
@@ -1304,463 +1555,1228 @@ LIBHARP_API int harp_product_bin_spatial(harp_product *product, long num_time_bi
         if (harp_product_get_derived_variable(product, "longitude_bounds", &data_type, "degree_east", 2, dimension_type,
                                               &longitude) == 0)
         {
-            area_binning = 1;
+            *area_binning = 1;
             /* determine matching cells and weighting factors */
             if (find_matching_cells_and_weights_for_bounds(latitude, longitude, num_latitude_edges, latitude_edges,
                                                            num_longitude_edges, longitude_edges, num_latlon_index,
-                                                           &latlon_cell_index, &latlon_weight) != 0)
+                                                           latlon_cell_index, latlon_weight) != 0)
             {
                 harp_variable_delete(latitude);
                 harp_variable_delete(longitude);
-                goto error;
+                return -1;
             }
             harp_variable_delete(longitude);
         }
         harp_variable_delete(latitude);
     }
-    if (!area_binning)
+    if (!*area_binning)
     {
         if (harp_product_get_derived_variable(product, "latitude", &data_type, "degree_north", 1, dimension_type,
                                               &latitude) != 0)
         {
-            goto error;
+            return -1;
         }
         if (harp_product_get_derived_variable(product, "longitude", &data_type, "degree_east", 1, dimension_type,
                                               &longitude) != 0)
         {
-            goto error;
+            harp_variable_delete(latitude);
+            return -1;
         }
         if (find_matching_cells_for_points(latitude, longitude, num_latitude_edges, latitude_edges, num_longitude_edges,
-                                           longitude_edges, num_latlon_index, &latlon_cell_index) != 0)
+                                           longitude_edges, num_latlon_index, latlon_cell_index) != 0)
         {
             harp_variable_delete(latitude);
             harp_variable_delete(longitude);
-            goto error;
+            return -1;
         }
         harp_variable_delete(latitude);
         harp_variable_delete(longitude);
     }
 
-    /* make 'bintype' big enough to also store any count/weight variables that we may want to add (i.e. 2 + factor 2) */
-    bintype = malloc((2 * product->num_variables + 2) * sizeof(binning_type));
-    if (bintype == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (2 * product->num_variables + 2) * sizeof(binning_type), __FILE__, __LINE__);
-        goto error;
-    }
-    weight_size = num_time_bins * spatial_block_length;
-    for (k = 0; k < product->num_variables; k++)
-    {
-        bintype[k] = get_binning_type(product->variable[k]);
+    return 0;
+}
 
-        /* determine the maximum number of elements (as size for the 'weight' array) */
-        if (bintype[k] != binning_remove && bintype[k] != binning_skip)
-        {
-            long total_num_elements = product->variable[k]->num_elements;
+/* convert a variable to double and bring its values in the form in which they are summed up */
+static int preprocess_variable(harp_variable *variable, binning_type bintype)
+{
+    long i;
 
-            /* is the resulting [time,latitude,longitude,...] larger than the input [time,...] ? */
-            if (num_time_bins * spatial_block_length > num_time_elements)
-            {
-                /* use largest size (before vs. after binning) */
-                total_num_elements = num_time_bins * spatial_block_length * (total_num_elements / num_time_elements);
-            }
-            if (total_num_elements > weight_size)
-            {
-                weight_size = total_num_elements;
-            }
-        }
-    }
-    time_index = malloc(num_time_bins * sizeof(long));
-    if (time_index == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       num_time_bins * sizeof(long), __FILE__, __LINE__);
-        goto error;
-    }
-    bin_count = malloc(num_time_bins * sizeof(int32_t));
-    if (bin_count == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       num_time_bins * sizeof(int32_t), __FILE__, __LINE__);
-        goto error;
-    }
-    weight = malloc(weight_size * sizeof(float));
-    if (weight == NULL)
+    /* convert variables to double */
+    if (harp_variable_convert_data_type(variable, harp_type_double) != 0)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       weight_size * sizeof(float), __FILE__, __LINE__);
-        goto error;
+        return -1;
     }
 
-    /* for each time bin, store the index of the first sample that contributes to the bin */
-    for (i = 0; i < num_time_bins; i++)
-    {
-        time_index[i] = 0;      /* initialize with 0 so harp_variable_rearrange_dimension will get valid indices */
-        bin_count[i] = 0;
-    }
-    for (i = 0; i < num_time_elements; i++)
+    if (bintype == binning_angle)
     {
-        /* only include samples that contribute to at least one grid cell */
-        if (num_latlon_index[i] > 0)
+        /* convert all angles to 2D vectors [cos(x),sin(x)] */
+        if (harp_convert_unit(variable->unit, "rad", variable->num_elements, variable->data.double_data) != 0)
         {
-            if (bin_count[time_bin_index[i]] == 0)
-            {
-                time_index[time_bin_index[i]] = i;
-            }
-            bin_count[time_bin_index[i]]++;
+            return -1;
+        }
+        if (harp_variable_add_dimension(variable, variable->num_dimensions, harp_dimension_independent, 2) != 0)
+        {
+            return -1;
+        }
+        for (i = 0; i < variable->num_elements; i += 2)
+        {
+            variable->data.double_data[i] = cos(variable->data.double_data[i]);
+            variable->data.double_data[i + 1] = sin(variable->data.double_data[i + 1]);
         }
     }
 
-    /* pre-process all variables */
-    for (k = 0; k < product->num_variables; k++)
+    if (bintype == binning_uncertainty)
     {
-        harp_variable *variable;
-
-        if (bintype[k] == binning_skip || bintype[k] == binning_remove)
+        /* square the uncertainties */
+        for (i = 0; i < variable->num_elements; i++)
         {
-            continue;
+            variable->data.double_data[i] *= variable->data.double_data[i];
         }
+    }
 
-        variable = product->variable[k];
+    return 0;
+}
 
-        /* convert variables to double */
-        if (harp_variable_convert_data_type(variable, harp_type_double) != 0)
-        {
-            goto error;
-        }
+/* turn the summed up values of a variable into averages using the sum of weights per element.
+ * for angle variables the weight is replaced by the magnitude of the sum of the unit vectors and
+ * store_weight_variable is set.
+ */
+static int finalise_variable(harp_variable *variable, binning_type bintype, float *weight, int *store_weight_variable)
+{
+    double nan_value = harp_nan();
+    long i;
 
-        if (bintype[k] == binning_angle)
+    if (bintype == binning_angle)
+    {
+        /* convert angle variables back from 2D vectors to angles */
+#pragma omp parallel for schedule(static) num_threads(harp_get_num_threads())
+        for (i = 0; i < variable->num_elements; i += 2)
         {
-            /* convert all angles to 2D vectors [cos(x),sin(x)] */
-            if (harp_convert_unit(variable->unit, "rad", variable->num_elements, variable->data.double_data) != 0)
+            if (weight[i / 2] == 0)
             {
-                goto error;
+                variable->data.double_data[i] = nan_value;
             }
-            if (harp_variable_add_dimension(variable, variable->num_dimensions, harp_dimension_independent, 2) != 0)
+            else
             {
-                goto error;
+                double x = variable->data.double_data[i];
+                double y = variable->data.double_data[i + 1];
+
+                weight[i / 2] = sqrt(x * x + y * y);
+                variable->data.double_data[i] = atan2(y, x);
             }
-            for (i = 0; i < variable->num_elements; i += 2)
+        }
+        if (harp_variable_remove_dimension(variable, variable->num_dimensions - 1, 0) != 0)
+        {
+            return -1;
+        }
+        /* convert all angles back to the original unit */
+        if (harp_convert_unit("rad", variable->unit, variable->num_elements, variable->data.double_data) != 0)
+        {
+            return -1;
+        }
+        *store_weight_variable = 1;
+    }
+    else
+    {
+        /* take square root of the sum before dividing by the sum of the weights */
+        if (bintype == binning_uncertainty)
+        {
+#pragma omp parallel for schedule(static) num_threads(harp_get_num_threads())
+            for (i = 0; i < variable->num_elements; i++)
             {
-                variable->data.double_data[i] = cos(variable->data.double_data[i]);
-                variable->data.double_data[i + 1] = sin(variable->data.double_data[i + 1]);
+                variable->data.double_data[i] = sqrt(variable->data.double_data[i]);
             }
         }
 
-        if (bintype[k] == binning_uncertainty)
+#pragma omp parallel for schedule(static) num_threads(harp_get_num_threads())
+        for (i = 0; i < variable->num_elements; i++)
         {
-            /* square the uncertainties */
-            for (i = 0; i < variable->num_elements; i++)
+            if (weight[i] == 0)
+            {
+                variable->data.double_data[i] = nan_value;
+            }
+            else if (bintype == binning_average || bintype == binning_uncertainty)
             {
-                variable->data.double_data[i] *= variable->data.double_data[i];
+                /* divide by the sum of the weights */
+                variable->data.double_data[i] /= weight[i];
             }
         }
     }
 
-    /* resample data */
-    product->dimension[harp_dimension_time] = num_time_bins;
-    product->dimension[harp_dimension_latitude] = num_latitude_edges - 1;
-    product->dimension[harp_dimension_longitude] = num_longitude_edges - 1;
+    return 0;
+}
 
-    /* create global count variable */
-    dimension_type[0] = harp_dimension_time;
-    dimension[0] = num_time_bins;
-    if (add_count_variable(product, bintype, binning_skip, NULL, 1, dimension_type, dimension, bin_count) != 0)
-    {
-        goto error;
-    }
+/* add latitude_bounds and longitude_bounds variables for the grid */
+static int add_grid_bounds_variables(harp_product *product, long num_latitude_edges, const double *latitude_edges,
+                                     long num_longitude_edges, const double *longitude_edges)
+{
+    harp_dimension_type dimension_type[2];
+    harp_variable *latitude = NULL;
+    harp_variable *longitude = NULL;
+    long dimension[2];
+    long i;
 
-    /* create global weight variable */
-    memset(weight, 0, num_time_bins * spatial_block_length * sizeof(float));
-    cumsum_index = 0;
-    for (i = 0; i < num_time_elements; i++)
+    dimension_type[0] = harp_dimension_latitude;
+    dimension[0] = num_latitude_edges - 1;
+    dimension_type[1] = harp_dimension_independent;
+    dimension[1] = 2;
+    if (harp_variable_new("latitude_bounds", harp_type_double, 2, dimension_type, dimension, &latitude) != 0)
     {
-        long index_offset = time_bin_index[i] * spatial_block_length;
-
-        for (l = 0; l < num_latlon_index[i]; l++)
-        {
-            weight[index_offset + latlon_cell_index[cumsum_index]] += area_binning ? latlon_weight[cumsum_index] : 1;
-            cumsum_index++;
-        }
+        return -1;
     }
-    dimension_type[0] = harp_dimension_time;
-    dimension[0] = num_time_bins;
-    dimension_type[1] = harp_dimension_latitude;
-    dimension[1] = num_latitude_edges - 1;
-    dimension_type[2] = harp_dimension_longitude;
-    dimension[2] = num_longitude_edges - 1;
-    if (add_weight_variable(product, bintype, binning_skip, NULL, 3, dimension_type, dimension, weight) != 0)
+    for (i = 0; i < dimension[0]; i++)
     {
-        goto error;
+        latitude->data.double_data[2 * i] = latitude_edges[i];
+        latitude->data.double_data[2 * i + 1] = latitude_edges[i + 1];
     }
-
-    /* sum up all samples into spatial bins (replacing variables) and create weight variables where needed */
-    for (k = 0; k < product->num_variables; k++)
+    if (harp_product_add_variable(product, latitude) != 0)
+    {
+        harp_variable_delete(latitude);
+        return -1;
+    }
+    if (harp_variable_set_unit(latitude, HARP_UNIT_LATITUDE) != 0)
+    {
+        return -1;
+    }
+
+    dimension_type[0] = harp_dimension_longitude;
+    dimension[0] = num_longitude_edges - 1;
+    if (harp_variable_new("longitude_bounds", harp_type_double, 2, dimension_type, dimension, &longitude) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < dimension[0]; i++)
+    {
+        longitude->data.double_data[2 * i] = longitude_edges[i];
+        longitude->data.double_data[2 * i + 1] = longitude_edges[i + 1];
+    }
+    if (harp_product_add_variable(product, longitude) != 0)
+    {
+        harp_variable_delete(longitude);
+        return -1;
+    }
+    if (harp_variable_set_unit(longitude, HARP_UNIT_LONGITUDE) != 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/** \addtogroup harp_product
+ * @{
+ */
+
+
+/** Bin the product's variables into a spatial grid.
+ * This will bin all variables with a time dimension into a three dimensional time x latitude x longitude grid.
+ * Each time sample will first be allocated to a time bin defined by time_bin_index (similar to \a harp_product_bin).
+ * Then within that time bin the sample will be allocated to the appropriate cell(s) in the latitude/longitude grid as
+ * defined by the latitude_edges and longitude_edges variables.
+ *
+ * The lat/lon grid will be a fixed time-independent grid and will have 'num_latitude_edges-1' latitudes and
+ * 'num_longitude_edges-1' longitudes.
+ * The latitude_edges and longitude_edges arrays provide the boundaries of the grid cells in degrees and need to be
+ * provided in a strict ascending order. The latitude edge values need to be between -90 and 90 and for the longitude
+ * edge values the constraint is that the difference between the last and first edge should be <= 360.
+ *
+ * If the product has latitude_bounds {time,independent} and longitude_bounds {time,independent} variables then an area
+ * binning is performed. This means that each sample will be allocated to each lat/lon grid cell based on the amount of
+ * overlap. This overlap calculation will treat lines between points as straight lines within the carthesian plane
+ * (i.e. using a Plate Carree projection, and not using great circle arcs between points on a sphere).
+ *
+ * If the product doesn't have lat/lon bounds per sample, it should have latitude {time} and longitude {time} variables.
+ * The binning onto the lat/lon grid will then be a point binning. This means that each sample is allocated to only one
+ * grid cell based on its lat/lon coordinate. To achieve a unique assignment, for each cell the lower edge will be
+ * considered inclusive and the upper edge exclusive (except for the last cell (when there is no wrap-around)).
+ *
+ * The resulting value for each time/lat/lon cell will be the average of all values for that cell.
+ * This will be a weighted average in case an area binning is performed and a straight average for point binning.
+ * Variables with multiple dimensions will have all elements in its sub dimensions averaged on an element by element
+ * basis (i.e. sub dimensions will be retained).
+ *
+ * Variables that have a time dimension but no unit (or using a string data type) will be removed.
+ * Any existing count or weight variables will also be removed.
+ *
+ * For uncertainty variables the first order propagation rules are used (assuming full correlation).
+ *
+ * All variables that are binned are converted to a double data type. Cells that have no samples will end up with a NaN
+ * value.
+ *
+ * A 'count' variable will be added to the product that will contain the number of samples per time bin.
+ * In addition, a 'weight' variable will be added that will contain the sum of weights for the contribution to each
+ * cell. If a variable contained NaN values then a variable specific weight variable will be created with only the sum
+ * of weights for the non-NaN entries.
+ *
+ * For angle variables a variable-specific weight variable will be created that contains the magnitude of the sum of the
+ * unit vectors that was used to calculate the angle average.
+ *
+ * Axis variables for the time dimension such as datetime, datetime_length, datetime_start, and datetime_stop will only
+ * be binned in the time dimension (and will not gain a latitude or longitude dimension).
+ *
+ * \param product Product to regrid.
+ * \param num_time_bins Number of target bins in the time dimension.
+ * \param num_time_elements Length of bin_index array (should equal the length of the time dimension)
+ * \param time_bin_index Array of target time bin index numbers (0 .. num_bins-1) for each sample in the time dimension.
+ * \param num_latitude_edges Number of edges for the latitude grid (number of latitude rows = num_latitude_edges - 1)
+ * \param latitude_edges latitude grid edge vales
+ * \param num_longitude_edges Number of edges for the longitude grid
+ *        (number of longitude columns = num_longitude_edges - 1)
+ * \param longitude_edges longitude grid edge vales
+ *
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_product_bin_spatial(harp_product *product, long num_time_bins, long num_time_elements,
+                                         long *time_bin_index, long num_latitude_edges, double *latitude_edges,
+                                         long num_longitude_edges, double *longitude_edges)
+{
+    long spatial_block_length = (num_latitude_edges - 1) * (num_longitude_edges - 1);
+    harp_dimension_type dimension_type[HARP_MAX_NUM_DIMS];
+    long dimension[HARP_MAX_NUM_DIMS];
+    binning_type *bintype = NULL;
+    double nan_value = harp_nan();
+    long *num_latlon_index = NULL;      /* number of matching latlon cells for each sample [num_time_elements] */
+    long *latlon_cell_index = NULL;     /* flat latlon cell index for each matching cell for each sample [sum(num_latlon_index)] */
+    double *latlon_weight = NULL;       /* weight for each matching cell for each sample [sum(num_latlon_index)] */
+    long *time_index = NULL;    /* index of first contributing sample for each bin */
+    long weight_size;
+    int32_t *bin_count = NULL;  /* number of contributing samples for each time bin [num_time_bins] */
+    float *weight = NULL;       /* sum of weights per latlon cell and time [num_time_bins, num_latitude_edges-1, num_longitude_edges-1] */
+    int area_binning = 0;
+    long i, k;
+
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
+    if (product->dimension[harp_dimension_latitude] > 0 || product->dimension[harp_dimension_longitude] > 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "spatial binning cannot be performed on products that already "
+                       "have a latitude and/or longitude dimension");
+        return -1;
+    }
+
+    if (num_time_elements != product->dimension[harp_dimension_time])
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_time_elements (%ld) does not match time dimension length "
+                       "(%ld) (%s:%u)", num_time_elements, product->dimension[harp_dimension_time], __FILE__, __LINE__);
+        return -1;
+    }
+
+    for (i = 0; i < num_time_elements; i++)
+    {
+        if (time_bin_index[i] < 0 || time_bin_index[i] >= num_time_bins)
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "time_bin_index[%ld] (%ld) should be in the range [0..%ld) "
+                           "(%s:%u)", i, time_bin_index[i], num_time_bins, __FILE__, __LINE__);
+            return -1;
+        }
+    }
+
+    if (check_grid_edges(num_latitude_edges, latitude_edges, num_longitude_edges, longitude_edges) != 0)
+    {
+        return -1;
+    }
+
+    num_latlon_index = malloc(num_time_elements * sizeof(long));
+    if (num_latlon_index == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_time_elements * sizeof(long), __FILE__, __LINE__);
+        goto error;
+    }
+
+    if (find_matching_cells_for_product(product, num_latitude_edges, latitude_edges, num_longitude_edges,
+                                        longitude_edges, num_latlon_index, &latlon_cell_index, &latlon_weight,
+                                        &area_binning) != 0)
+    {
+        goto error;
+    }
+
+    /* make 'bintype' big enough to also store any count/weight variables that we may want to add (i.e. 2 + factor 2) */
+    bintype = malloc((2 * product->num_variables + 2) * sizeof(binning_type));
+    if (bintype == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (2 * product->num_variables + 2) * sizeof(binning_type), __FILE__, __LINE__);
+        goto error;
+    }
+    weight_size = num_time_bins * spatial_block_length;
+    for (k = 0; k < product->num_variables; k++)
+    {
+        bintype[k] = get_binning_type(product->variable[k]);
+
+        /* determine the maximum number of elements (as size for the 'weight' array) */
+        if (bintype[k] != binning_remove && bintype[k] != binning_skip)
+        {
+            long total_num_elements = product->variable[k]->num_elements;
+
+            /* is the resulting [time,latitude,longitude,...] larger than the input [time,...] ? */
+            if (num_time_bins * spatial_block_length > num_time_elements)
+            {
+                /* use largest size (before vs. after binning) */
+                total_num_elements = num_time_bins * spatial_block_length * (total_num_elements / num_time_elements);
+            }
+            if (total_num_elements > weight_size)
+            {
+                weight_size = total_num_elements;
+            }
+        }
+    }
+    time_index = malloc(num_time_bins * sizeof(long));
+    if (time_index == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_time_bins * sizeof(long), __FILE__, __LINE__);
+        goto error;
+    }
+    bin_count = malloc(num_time_bins * sizeof(int32_t));
+    if (bin_count == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_time_bins * sizeof(int32_t), __FILE__, __LINE__);
+        goto error;
+    }
+    weight = malloc(weight_size * sizeof(float));
+    if (weight == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       weight_size * sizeof(float), __FILE__, __LINE__);
+        goto error;
+    }
+
+    /* for each time bin, store the index of the first sample that contributes to the bin */
+    for (i = 0; i < num_time_bins; i++)
+    {
+        time_index[i] = 0;      /* initialize with 0 so harp_variable_rearrange_dimension will get valid indices */
+        bin_count[i] = 0;
+    }
+    for (i = 0; i < num_time_elements; i++)
+    {
+        /* only include samples that contribute to at least one grid cell */
+        if (num_latlon_index[i] > 0)
+        {
+            if (bin_count[time_bin_index[i]] == 0)
+            {
+                time_index[time_bin_index[i]] = i;
+            }
+            bin_count[time_bin_index[i]]++;
+        }
+    }
+
+    /* pre-process all variables */
+    for (k = 0; k < product->num_variables; k++)
     {
         harp_variable *variable;
-        long num_sub_elements;
 
-        if (bintype[k] == binning_skip || bintype[k] == binning_remove)
+        if (bintype[k] == binning_skip || bintype[k] == binning_remove)
+        {
+            continue;
+        }
+
+        variable = product->variable[k];
+
+        if (preprocess_variable(variable, bintype[k]) != 0)
+        {
+            goto error;
+        }
+    }
+
+    /* resample data */
+    product->dimension[harp_dimension_time] = num_time_bins;
+    product->dimension[harp_dimension_latitude] = num_latitude_edges - 1;
+    product->dimension[harp_dimension_longitude] = num_longitude_edges - 1;
+
+    /* create global count variable */
+    dimension_type[0] = harp_dimension_time;
+    dimension[0] = num_time_bins;
+    if (add_count_variable(product, bintype, binning_skip, NULL, 1, dimension_type, dimension, bin_count) != 0)
+    {
+        goto error;
+    }
+
+    /* create global weight variable */
+    memset(weight, 0, num_time_bins * spatial_block_length * sizeof(float));
+    accumulate_samples(num_time_elements, time_bin_index, num_latitude_edges - 1, num_longitude_edges - 1,
+                       num_latlon_index, latlon_cell_index, latlon_weight, area_binning, binning_skip, NULL, 1, NULL,
+                       weight);
+    dimension_type[0] = harp_dimension_time;
+    dimension[0] = num_time_bins;
+    dimension_type[1] = harp_dimension_latitude;
+    dimension[1] = num_latitude_edges - 1;
+    dimension_type[2] = harp_dimension_longitude;
+    dimension[2] = num_longitude_edges - 1;
+    if (add_weight_variable(product, bintype, binning_skip, NULL, 3, dimension_type, dimension, weight) != 0)
+    {
+        goto error;
+    }
+
+    /* sum up all samples into spatial bins (replacing variables) and create weight variables where needed */
+    for (k = 0; k < product->num_variables; k++)
+    {
+        harp_variable *variable;
+        long num_sub_elements;
+
+        if (bintype[k] == binning_skip || bintype[k] == binning_remove)
+        {
+            continue;
+        }
+
+        variable = product->variable[k];
+        assert(variable->dimension[0] == num_time_elements);
+        num_sub_elements = variable->num_elements / num_time_elements;
+
+        if (bintype[k] == binning_time_max || bintype[k] == binning_time_min || bintype[k] == binning_time_average)
+        {
+            /* datetime variables are only binned temporally, not spatially */
+            if (bintype[k] == binning_time_min)
+            {
+                /* take minimum of all values per bin */
+                for (i = 0; i < num_time_elements; i++)
+                {
+                    if (num_latlon_index[i] > 0)
+                    {
+                        long target_index = time_index[time_bin_index[i]];
+
+                        if (variable->data.double_data[i] < variable->data.double_data[target_index])
+                        {
+                            variable->data.double_data[target_index] = variable->data.double_data[i];
+                        }
+                    }
+                }
+            }
+            else if (bintype[k] == binning_time_max)
+            {
+                /* take maximum of all values per bin */
+                for (i = 0; i < num_time_elements; i++)
+                {
+                    if (num_latlon_index[i] > 0)
+                    {
+                        long target_index = time_index[time_bin_index[i]];
+
+                        if (variable->data.double_data[i] > variable->data.double_data[target_index])
+                        {
+                            variable->data.double_data[target_index] = variable->data.double_data[i];
+                        }
+                    }
+                }
+            }
+            else
+            {
+                /* sum up all values of a bin into the location of the first sample */
+                /* we don't perform NaN filtering for datetime values (these should not be NaN) */
+                for (i = 0; i < num_time_elements; i++)
+                {
+                    if (num_latlon_index[i] > 0)
+                    {
+                        long target_index = time_index[time_bin_index[i]];
+
+                        if (target_index != i)
+                        {
+                            variable->data.double_data[target_index] += variable->data.double_data[i];
+                        }
+                    }
+                }
+            }
+            /* resample the time dimension to the target bins */
+            /* this uses the first sample for empty bins, which we set to NaN as a next step */
+            if (harp_variable_rearrange_dimension(variable, 0, num_time_bins, time_index) != 0)
+            {
+                goto error;
+            }
+            /* set all empty bins to NaN and divide by sample count for the average */
+            for (i = 0; i < variable->num_elements; i++)
+            {
+                if (bin_count[i] == 0)
+                {
+                    variable->data.double_data[i] = nan_value;
+                }
+                else if (bintype[k] == binning_time_average)
+                {
+                    variable->data.double_data[i] /= bin_count[i];
+                }
+            }
+        }
+        else
+        {
+            harp_variable *new_variable = NULL;
+            int store_weight_variable = 0;
+
+            assert(bintype[k] == binning_average || bintype[k] == binning_angle || bintype[k] == binning_uncertainty);
+
+            /* we need to create a variable that includes the lat/lon dimensions and uses the binned time dimension */
+            if (variable->num_dimensions + 2 >= HARP_MAX_NUM_DIMS)
+            {
+                harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "too many dimensions (%d) for variables %s to perform "
+                               "spatial binning", variable->num_dimensions, variable->name);
+                goto error;
+            }
+            dimension_type[0] = harp_dimension_time;
+            dimension[0] = num_time_bins;
+            dimension_type[1] = harp_dimension_latitude;
+            dimension[1] = num_latitude_edges - 1;
+            dimension_type[2] = harp_dimension_longitude;
+            dimension[2] = num_longitude_edges - 1;
+            for (i = 1; i < variable->num_dimensions; i++)
+            {
+                dimension_type[i + 2] = variable->dimension_type[i];
+                dimension[i + 2] = variable->dimension[i];
+            }
+            if (harp_variable_new(variable->name, variable->data_type, variable->num_dimensions + 2, dimension_type,
+                                  dimension, &new_variable) != 0)
+            {
+                goto error;
+            }
+            if (harp_variable_copy_attributes(variable, new_variable) != 0)
+            {
+                harp_variable_delete(new_variable);
+                goto error;
+            }
+
+            /* sum up all values per cell */
+            memset(weight, 0, weight_size * sizeof(float));
+            store_weight_variable = accumulate_samples(num_time_elements, time_bin_index, num_latitude_edges - 1,
+                                                       num_longitude_edges - 1, num_latlon_index, latlon_cell_index,
+                                                       latlon_weight, area_binning, bintype[k], variable,
+                                                       num_sub_elements, new_variable, weight);
+
+            /* replace variable in product with new variable */
+            product->variable[k] = new_variable;
+            harp_variable_delete(variable);
+            variable = new_variable;
+
+            if (finalise_variable(variable, bintype[k], weight, &store_weight_variable) != 0)
+            {
+                goto error;
+            }
+
+            if (store_weight_variable)
+            {
+                if (add_weight_variable(product, bintype, binning_skip, variable->name, variable->num_dimensions,
+                                        variable->dimension_type, variable->dimension, weight) != 0)
+                {
+                    goto error;
+                }
+            }
+        }
+    }
+
+    /* remove all variables that need to be removed (in reverse order!) */
+    for (k = product->num_variables - 1; k >= 0; k--)
+    {
+        if (bintype[k] == binning_remove)
+        {
+            if (harp_product_remove_variable(product, product->variable[k]) != 0)
+            {
+                goto error;
+            }
+        }
+    }
+
+    free(bintype);
+    free(weight);
+    free(time_index);
+    free(bin_count);
+    free(num_latlon_index);
+    if (latlon_cell_index != NULL)
+    {
+        free(latlon_cell_index);
+    }
+    if (latlon_weight != NULL)
+    {
+        free(latlon_weight);
+    }
+
+    /* add latitude_bounds and longitude_bounds variables */
+    return add_grid_bounds_variables(product, num_latitude_edges, latitude_edges, num_longitude_edges, longitude_edges);
+
+  error:
+    if (bintype != NULL)
+    {
+        free(bintype);
+    }
+    if (time_index != NULL)
+    {
+        free(time_index);
+    }
+    if (bin_count != NULL)
+    {
+        free(bin_count);
+    }
+    if (weight != NULL)
+    {
+        free(weight);
+    }
+    if (num_latlon_index != NULL)
+    {
+        free(num_latlon_index);
+    }
+    if (latlon_cell_index != NULL)
+    {
+        free(latlon_cell_index);
+    }
+    if (latlon_weight != NULL)
+    {
+        free(latlon_weight);
+    }
+    return -1;
+}
+
+/**
+ * @}
+ */
+
+/** Perform a spatial binning such that all samples end up in a single time bin.
+ *
+ * \param product Product to regrid.
+ * \param num_latitude_edges Number of edges for the latitude grid (number of latitude rows = num_latitude_edges - 1)
+ * \param latitude_edges latitude grid edge vales
+ * \param num_longitude_edges Number of edges for the longitude grid
+ *        (number of longitude columns = num_longitude_edges - 1)
+ * \param longitude_edges longitude grid edge vales
+ *
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+int harp_product_bin_spatial_full(harp_product *product, long num_latitude_edges, double *latitude_edges,
+                                  long num_longitude_edges, double *longitude_edges)
+{
+    long *bin_index;
+    long num_elements;
+    long i;
+
+    num_elements = product->dimension[harp_dimension_time];
+    if (num_elements == 0)
+    {
+        /* nothing to do */
+        return 0;
+    }
+
+    bin_index = malloc(num_elements * sizeof(long));
+    if (bin_index == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_elements * sizeof(long), __FILE__, __LINE__);
+        return -1;
+    }
+    for (i = 0; i < num_elements; i++)
+    {
+        bin_index[i] = 0;
+    }
+
+    if (harp_product_bin_spatial(product, 1, num_elements, bin_index, num_latitude_edges, latitude_edges,
+                                 num_longitude_edges, longitude_edges) != 0)
+    {
+        free(bin_index);
+        return -1;
+    }
+
+    free(bin_index);
+    return 0;
+}
+
+typedef struct spatial_grid_variable_struct
+{
+    binning_type bintype;
+    harp_variable *sum; /* [time=1] for time binning, [time=1,lat,lon,...] with summed values otherwise */
+    float *weight;      /* sum of weights per element of sum (per vector pair for angles) */
+    long count; /* number of contributing samples (time binning only) */
+    int store_weight_variable;
+} spatial_grid_variable;
+
+struct harp_spatial_grid_struct
+{
+    long num_latitude_edges;
+    double *latitude_edges;
+    long num_longitude_edges;
+    double *longitude_edges;
+    long num_products;  /* number of (non-empty) products that were added */
+    int32_t count;      /* number of samples that contributed to at least one grid cell */
+    float *weight;      /* sum of weights per grid cell [num_latitude_edges-1, num_longitude_edges-1] */
+    int num_variables;
+    spatial_grid_variable **variable;
+};
+
+static void spatial_grid_variable_delete(spatial_grid_variable *grid_variable)
+{
+    if (grid_variable != NULL)
+    {
+        if (grid_variable->sum != NULL)
+        {
+            harp_variable_delete(grid_variable->sum);
+        }
+        if (grid_variable->weight != NULL)
+        {
+            free(grid_variable->weight);
+        }
+        free(grid_variable);
+    }
+}
+
+/* create the accumulation state for a (pre-processed) variable */
+static int spatial_grid_variable_new(const harp_spatial_grid *grid, const harp_variable *variable,
+                                     binning_type bintype, spatial_grid_variable **new_grid_variable)
+{
+    harp_dimension_type dimension_type[HARP_MAX_NUM_DIMS];
+    long dimension[HARP_MAX_NUM_DIMS];
+    spatial_grid_variable *grid_variable;
+    int num_dimensions;
+    long i;
+
+    grid_variable = malloc(sizeof(spatial_grid_variable));
+    if (grid_variable == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(spatial_grid_variable), __FILE__, __LINE__);
+        return -1;
+    }
+    grid_variable->bintype = bintype;
+    grid_variable->sum = NULL;
+    grid_variable->weight = NULL;
+    grid_variable->count = 0;
+    grid_variable->store_weight_variable = 0;
+
+    dimension_type[0] = harp_dimension_time;
+    dimension[0] = 1;
+    num_dimensions = 1;
+    if (bintype != binning_time_min && bintype != binning_time_max && bintype != binning_time_average)
+    {
+        if (variable->num_dimensions + 2 >= HARP_MAX_NUM_DIMS)
         {
-            continue;
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "too many dimensions (%d) for variables %s to perform "
+                           "spatial binning", variable->num_dimensions, variable->name);
+            spatial_grid_variable_delete(grid_variable);
+            return -1;
+        }
+        dimension_type[1] = harp_dimension_latitude;
+        dimension[1] = grid->num_latitude_edges - 1;
+        dimension_type[2] = harp_dimension_longitude;
+        dimension[2] = grid->num_longitude_edges - 1;
+        for (i = 1; i < variable->num_dimensions; i++)
+        {
+            dimension_type[i + 2] = variable->dimension_type[i];
+            dimension[i + 2] = variable->dimension[i];
+        }
+        num_dimensions = variable->num_dimensions + 2;
+    }
+    if (harp_variable_new(variable->name, harp_type_double, num_dimensions, dimension_type, dimension,
+                          &grid_variable->sum) != 0)
+    {
+        spatial_grid_variable_delete(grid_variable);
+        return -1;
+    }
+    if (harp_variable_copy_attributes(variable, grid_variable->sum) != 0)
+    {
+        spatial_grid_variable_delete(grid_variable);
+        return -1;
+    }
+    if (num_dimensions > 1)
+    {
+        long num_weights = grid_variable->sum->num_elements;
+
+        if (bintype == binning_angle)
+        {
+            num_weights /= 2;
+        }
+        grid_variable->weight = calloc(num_weights, sizeof(float));
+        if (grid_variable->weight == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_weights * sizeof(float), __FILE__, __LINE__);
+            spatial_grid_variable_delete(grid_variable);
+            return -1;
         }
+    }
 
-        variable = product->variable[k];
-        assert(variable->dimension[0] == num_time_elements);
-        num_sub_elements = variable->num_elements / num_time_elements;
+    *new_grid_variable = grid_variable;
 
-        if (bintype[k] == binning_time_max || bintype[k] == binning_time_min || bintype[k] == binning_time_average)
+    return 0;
+}
+
+/* check that a (time dependent) variable can be added to the grid and bring it in the form in which it gets
+ * accumulated; the variable will be modified in place. 'grid_variable' is set to the matching variable of the grid, or
+ * to NULL if the grid does not have the variable yet.
+ */
+static int spatial_grid_prepare_variable(const harp_spatial_grid *grid, harp_variable *variable, binning_type bintype,
+                                         spatial_grid_variable **grid_variable)
+{
+    long i;
+    int k;
+
+    *grid_variable = NULL;
+    for (k = 0; k < grid->num_variables; k++)
+    {
+        if (strcmp(grid->variable[k]->sum->name, variable->name) == 0)
         {
-            /* datetime variables are only binned temporally, not spatially */
-            if (bintype[k] == binning_time_min)
-            {
-                /* take minimum of all values per bin */
-                for (i = 0; i < num_time_elements; i++)
-                {
-                    if (num_latlon_index[i] > 0)
-                    {
-                        long target_index = time_index[time_bin_index[i]];
+            *grid_variable = grid->variable[k];
+            break;
+        }
+    }
+    if (*grid_variable == NULL)
+    {
+        return preprocess_variable(variable, bintype);
+    }
 
-                        if (variable->data.double_data[i] < variable->data.double_data[target_index])
-                        {
-                            variable->data.double_data[target_index] = variable->data.double_data[i];
-                        }
-                    }
-                }
-            }
-            else if (bintype[k] == binning_time_max)
-            {
-                /* take maximum of all values per bin */
-                for (i = 0; i < num_time_elements; i++)
-                {
-                    if (num_latlon_index[i] > 0)
-                    {
-                        long target_index = time_index[time_bin_index[i]];
+    if ((*grid_variable)->bintype != bintype)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable '%s' is not binned in the same way as in a previous "
+                       "product", variable->name);
+        return -1;
+    }
+    if ((*grid_variable)->sum->unit != NULL && variable->unit != NULL && bintype != binning_angle &&
+        strcmp((*grid_variable)->sum->unit, variable->unit) != 0)
+    {
+        if (harp_variable_convert_unit(variable, (*grid_variable)->sum->unit) != 0)
+        {
+            return -1;
+        }
+    }
+    if (preprocess_variable(variable, bintype) != 0)
+    {
+        return -1;
+    }
+    if (bintype != binning_time_min && bintype != binning_time_max && bintype != binning_time_average)
+    {
+        int consistent = (*grid_variable)->sum->num_dimensions == variable->num_dimensions + 2;
 
-                        if (variable->data.double_data[i] > variable->data.double_data[target_index])
-                        {
-                            variable->data.double_data[target_index] = variable->data.double_data[i];
-                        }
-                    }
-                }
-            }
-            else
-            {
-                /* sum up all values of a bin into the location of the first sample */
-                /* we don't perform NaN filtering for datetime values (these should not be NaN) */
-                for (i = 0; i < num_time_elements; i++)
-                {
-                    if (num_latlon_index[i] > 0)
-                    {
-                        long target_index = time_index[time_bin_index[i]];
+        for (i = 1; consistent && i < variable->num_dimensions; i++)
+        {
+            consistent = (*grid_variable)->sum->dimension_type[i + 2] == variable->dimension_type[i] &&
+                (*grid_variable)->sum->dimension[i + 2] == variable->dimension[i];
+        }
+        if (!consistent)
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "dimensions of variable '%s' do not match those of a "
+                           "previous product", variable->name);
+            return -1;
+        }
+    }
 
-                        if (target_index != i)
-                        {
-                            variable->data.double_data[target_index] += variable->data.double_data[i];
-                        }
-                    }
-                }
-            }
-            /* resample the time dimension to the target bins */
-            /* this uses the first sample for empty bins, which we set to NaN as a next step */
-            if (harp_variable_rearrange_dimension(variable, 0, num_time_bins, time_index) != 0)
-            {
-                goto error;
-            }
-            /* set all empty bins to NaN and divide by sample count for the average */
-            for (i = 0; i < variable->num_elements; i++)
+    return 0;
+}
+
+/* add the samples of a variable that was prepared with spatial_grid_prepare_variable() to the grid */
+static void spatial_grid_add_samples(const harp_spatial_grid *grid, spatial_grid_variable *grid_variable,
+                                     const harp_variable *variable, long *num_latlon_index, long *latlon_cell_index,
+                                     double *latlon_weight, int area_binning)
+{
+    binning_type bintype = grid_variable->bintype;
+    long num_time_elements;
+    long i;
+
+    num_time_elements = variable->dimension[0];
+    if (bintype == binning_time_min || bintype == binning_time_max || bintype == binning_time_average)
+    {
+        double *value = grid_variable->sum->data.double_data;
+
+        for (i = 0; i < num_time_elements; i++)
+        {
+            if (num_latlon_index[i] > 0)
             {
-                if (bin_count[i] == 0)
+                if (grid_variable->count == 0 ||
+                    (bintype == binning_time_min && variable->data.double_data[i] < *value) ||
+                    (bintype == binning_time_max && variable->data.double_data[i] > *value))
                 {
-                    variable->data.double_data[i] = nan_value;
+                    *value = variable->data.double_data[i];
                 }
-                else if (bintype[k] == binning_time_average)
+                else if (bintype == binning_time_average)
                 {
-                    variable->data.double_data[i] /= bin_count[i];
+                    *value += variable->data.double_data[i];
                 }
+                grid_variable->count++;
             }
         }
-        else
-        {
-            harp_variable *new_variable = NULL;
-            int store_weight_variable = 0;
+    }
+    else
+    {
+        grid_variable->store_weight_variable |=
+            accumulate_samples(num_time_elements, NULL, grid->num_latitude_edges - 1, grid->num_longitude_edges - 1,
+                               num_latlon_index, latlon_cell_index, latlon_weight, area_binning, bintype,
+                               variable, variable->num_elements / num_time_elements,
+                               grid_variable->sum, grid_variable->weight);
+    }
+}
 
-            assert(bintype[k] == binning_average || bintype[k] == binning_angle || bintype[k] == binning_uncertainty);
+/** Create a new accumulator for spatially binning the samples of multiple products.
+ * \ingroup harp_product
+ * Products can be added one by one to the accumulator (using harp_spatial_grid_add_product()). Only the sums of the
+ * values and weights per grid cell are kept, so memory use does not grow with the number of products. The result is
+ * retrieved using harp_spatial_grid_get_product() and is the same as when all products would have been merged using
+ * harp_product_append() and then binned using harp_product_bin_spatial() with all samples in a single time bin.
+ *
+ * See harp_product_bin_spatial() for the constraints on the grid edges.
+ * The accumulator needs to be deleted with harp_spatial_grid_delete().
+ * \param num_latitude_edges Number of edges for the latitude grid (number of latitude rows = num_latitude_edges - 1)
+ * \param latitude_edges Latitude grid edge values
+ * \param num_longitude_edges Number of edges for the longitude grid
+ *        (number of longitude columns = num_longitude_edges - 1)
+ * \param longitude_edges Longitude grid edge values
+ * \param new_grid Pointer to the C variable where the new accumulator will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_spatial_grid_new(long num_latitude_edges, const double *latitude_edges, long num_longitude_edges,
+                                      const double *longitude_edges, harp_spatial_grid **new_grid)
+{
+    harp_spatial_grid *grid;
+    long num_cells;
 
-            /* we need to create a variable that includes the lat/lon dimensions and uses the binned time dimension */
-            if (variable->num_dimensions + 2 >= HARP_MAX_NUM_DIMS)
-            {
-                harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "too many dimensions (%d) for variables %s to perform "
-                               "spatial binning", variable->num_dimensions, variable->name);
-                goto error;
-            }
-            dimension_type[0] = harp_dimension_time;
-            dimension[0] = num_time_bins;
-            dimension_type[1] = harp_dimension_latitude;
-            dimension[1] = num_latitude_edges - 1;
-            dimension_type[2] = harp_dimension_longitude;
-            dimension[2] = num_longitude_edges - 1;
-            for (i = 1; i < variable->num_dimensions; i++)
-            {
-                dimension_type[i + 2] = variable->dimension_type[i];
-                dimension[i + 2] = variable->dimension[i];
-            }
-            if (harp_variable_new(variable->name, variable->data_type, variable->num_dimensions + 2, dimension_type,
-                                  dimension, &new_variable) != 0)
-            {
-                goto error;
-            }
-            if (harp_variable_copy_attributes(variable, new_variable) != 0)
-            {
-                harp_variable_delete(new_variable);
-                goto error;
-            }
+    if (check_grid_edges(num_latitude_edges, latitude_edges, num_longitude_edges, longitude_edges) != 0)
+    {
+        return -1;
+    }
+    num_cells = (num_latitude_edges - 1) * (num_longitude_edges - 1);
 
-            /* sum up all values per cell */
-            memset(weight, 0, weight_size * sizeof(float));
-            cumsum_index = 0;
-            for (i = 0; i < num_time_elements; i++)
-            {
-                long index_offset = time_bin_index[i] * spatial_block_length;
+    grid = malloc(sizeof(harp_spatial_grid));
+    if (grid == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(harp_spatial_grid), __FILE__, __LINE__);
+        return -1;
+    }
+    grid->num_latitude_edges = num_latitude_edges;
+    grid->latitude_edges = NULL;
+    grid->num_longitude_edges = num_longitude_edges;
+    grid->longitude_edges = NULL;
+    grid->num_products = 0;
+    grid->count = 0;
+    grid->weight = NULL;
+    grid->num_variables = 0;
+    grid->variable = NULL;
 
-                for (l = 0; l < num_latlon_index[i]; l++)
-                {
-                    long target_index = index_offset + latlon_cell_index[cumsum_index];
-                    double multiplication_factor = 1;
-                    double sample_weight = 1;
+    grid->latitude_edges = malloc(num_latitude_edges * sizeof(double));
+    if (grid->latitude_edges == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_latitude_edges * sizeof(double), __FILE__, __LINE__);
+        harp_spatial_grid_delete(grid);
+        return -1;
+    }
+    memcpy(grid->latitude_edges, latitude_edges, num_latitude_edges * sizeof(double));
+    grid->longitude_edges = malloc(num_longitude_edges * sizeof(double));
+    if (grid->longitude_edges == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_longitude_edges * sizeof(double), __FILE__, __LINE__);
+        harp_spatial_grid_delete(grid);
+        return -1;
+    }
+    memcpy(grid->longitude_edges, longitude_edges, num_longitude_edges * sizeof(double));
+    grid->weight = calloc(num_cells, sizeof(float));
+    if (grid->weight == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_cells * sizeof(float), __FILE__, __LINE__);
+        harp_spatial_grid_delete(grid);
+        return -1;
+    }
 
-                    if (area_binning)
-                    {
-                        sample_weight = latlon_weight[cumsum_index];
-                        multiplication_factor = sample_weight;
-                        if (bintype[k] == binning_uncertainty)
-                        {
-                            multiplication_factor *= sample_weight;
-                        }
-                    }
-                    if (bintype[k] == binning_angle)
-                    {
-                        /* for angle variables we use one weight element per vector pair */
-                        for (j = 0; j < num_sub_elements; j += 2)
-                        {
-                            if (!harp_isnan(variable->data.double_data[i * num_sub_elements + j]))
-                            {
-                                weight[(target_index * num_sub_elements + j) / 2] += sample_weight;
-                                new_variable->data.double_data[target_index * num_sub_elements + j] +=
-                                    multiplication_factor * variable->data.double_data[i * num_sub_elements + j];
-                                new_variable->data.double_data[target_index * num_sub_elements + j + 1] +=
-                                    multiplication_factor * variable->data.double_data[i * num_sub_elements + j + 1];
-                            }
-                        }
-                    }
-                    else
-                    {
-                        for (j = 0; j < num_sub_elements; j++)
-                        {
-                            if (!harp_isnan(variable->data.double_data[i * num_sub_elements + j]))
-                            {
-                                weight[target_index * num_sub_elements + j] += sample_weight;
-                                new_variable->data.double_data[target_index * num_sub_elements + j] +=
-                                    multiplication_factor * variable->data.double_data[i * num_sub_elements + j];
-                            }
-                            else
-                            {
-                                store_weight_variable = 1;
-                            }
-                        }
-                    }
-                    cumsum_index++;
-                }
-            }
+    *new_grid = grid;
 
-            /* replace variable in product with new variable */
-            product->variable[k] = new_variable;
-            harp_variable_delete(variable);
-            variable = new_variable;
+    return 0;
+}
+
+/** Add the samples of a product to a spatial binning accumulator.
+ * \ingroup harp_product
+ * Variables are binned in the same way as for harp_product_bin_spatial(). Time independent variables are treated as
+ * if they were time dependent (as is the case after harp_product_append()). As for harp_product_append(), all products
+ * need to have the same set of variables. Variables are matched by name with those of the first product and need to
+ * have the same (non-time) dimensions. Values are converted to the unit that was used for the first product.
+ * All variables are checked before any samples are added, so the accumulator is left unchanged if an error occurs.
+ * The product itself is not modified (apart from loading any data that was not loaded yet) and remains owned by the
+ * caller. Empty products are ignored.
+ * \param grid Spatial binning accumulator.
+ * \param product Product whose samples should be added.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_spatial_grid_add_product(harp_spatial_grid *grid, harp_product *product)
+{
+    spatial_grid_variable **grid_variable = NULL;
+    spatial_grid_variable **new_grid_variable = NULL;
+    harp_variable **variable = NULL;
+    binning_type *bintype = NULL;
+    long *num_latlon_index = NULL;
+    long *latlon_cell_index = NULL;
+    double *latlon_weight = NULL;
+    long num_time_elements;
+    int num_variables = 0;
+    int area_binning = 0;
+    long i;
+    int j;
+    int k;
+
+    if (harp_product_is_empty(product))
+    {
+        return 0;
+    }
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+    if (product->dimension[harp_dimension_latitude] > 0 || product->dimension[harp_dimension_longitude] > 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "spatial binning cannot be performed on products that already "
+                       "have a latitude and/or longitude dimension");
+        return -1;
+    }
+    num_time_elements = product->dimension[harp_dimension_time];
+    if (num_time_elements == 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "spatial binning requires a product with a time dimension");
+        return -1;
+    }
+
+    num_latlon_index = malloc(num_time_elements * sizeof(long));
+    if (num_latlon_index == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_time_elements * sizeof(long), __FILE__, __LINE__);
+        return -1;
+    }
+    if (find_matching_cells_for_product(product, grid->num_latitude_edges, grid->latitude_edges,
+                                        grid->num_longitude_edges, grid->longitude_edges, num_latlon_index,
+                                        &latlon_cell_index, &latlon_weight, &area_binning) != 0)
+    {
+        goto error;
+    }
+
+    variable = malloc(product->num_variables * sizeof(harp_variable *));
+    if (variable == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       product->num_variables * sizeof(harp_variable *), __FILE__, __LINE__);
+        goto error;
+    }
+    bintype = malloc(product->num_variables * sizeof(binning_type));
+    if (bintype == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       product->num_variables * sizeof(binning_type), __FILE__, __LINE__);
+        goto error;
+    }
+    grid_variable = malloc(product->num_variables * sizeof(spatial_grid_variable *));
+    if (grid_variable == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       product->num_variables * sizeof(spatial_grid_variable *), __FILE__, __LINE__);
+        goto error;
+    }
 
-            /* post-process variable */
-            if (bintype[k] == binning_angle)
+    /* first check and prepare all variables, so the grid remains unchanged if a variable can not be added */
+    for (k = 0; k < product->num_variables; k++)
+    {
+        bintype[num_variables] = get_binning_type(product->variable[k]);
+        if (bintype[num_variables] == binning_remove)
+        {
+            continue;
+        }
+        /* work on a copy, so the product itself remains unchanged */
+        if (harp_variable_copy(product->variable[k], &variable[num_variables]) != 0)
+        {
+            goto error;
+        }
+        num_variables++;
+        if (bintype[num_variables - 1] == binning_skip)
+        {
+            /* make time independent variables time dependent (as is done by harp_product_append()) */
+            if (harp_variable_add_dimension(variable[num_variables - 1], 0, harp_dimension_time, num_time_elements)
+                != 0)
             {
-                /* convert angle variables back from 2D vectors to angles */
-                for (i = 0; i < variable->num_elements; i += 2)
-                {
-                    if (weight[i / 2] == 0)
-                    {
-                        variable->data.double_data[i] = nan_value;
-                    }
-                    else
-                    {
-                        double x = variable->data.double_data[i];
-                        double y = variable->data.double_data[i + 1];
-
-                        weight[i / 2] = sqrt(x * x + y * y);
-                        variable->data.double_data[i] = atan2(y, x);
-                    }
-                }
-                if (harp_variable_remove_dimension(variable, variable->num_dimensions - 1, 0) != 0)
-                {
-                    goto error;
-                }
-                /* convert all angles back to the original unit */
-                if (harp_convert_unit("rad", variable->unit, variable->num_elements, variable->data.double_data) != 0)
-                {
-                    goto error;
-                }
-                store_weight_variable = 1;
+                goto error;
             }
-            else
+            bintype[num_variables - 1] = get_binning_type(variable[num_variables - 1]);
+            if (bintype[num_variables - 1] == binning_remove)
             {
-                /* take square root of the sum before dividing by the sum of the weights */
-                if (bintype[k] == binning_uncertainty)
-                {
-                    for (i = 0; i < variable->num_elements; i++)
-                    {
-                        variable->data.double_data[i] = sqrt(variable->data.double_data[i]);
-                    }
-                }
-
-                for (i = 0; i < variable->num_elements; i++)
-                {
-                    if (weight[i] == 0)
-                    {
-                        variable->data.double_data[i] = nan_value;
-                    }
-                    else if (bintype[k] == binning_average || bintype[k] == binning_uncertainty)
-                    {
-                        /* divide by the sum of the weights */
-                        variable->data.double_data[i] /= weight[i];
-                    }
-                }
+                num_variables--;
+                harp_variable_delete(variable[num_variables]);
+                continue;
             }
-
-            if (store_weight_variable)
+        }
+        if (spatial_grid_prepare_variable(grid, variable[num_variables - 1], bintype[num_variables - 1],
+                                          &grid_variable[num_variables - 1]) != 0)
+        {
+            harp_add_error_message(" (variable '%s')", variable[num_variables - 1]->name);
+            goto error;
+        }
+        if (grid->num_products > 0 && grid_variable[num_variables - 1] == NULL)
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "products don't both have variable '%s'",
+                           variable[num_variables - 1]->name);
+            goto error;
+        }
+    }
+    if (grid->num_products > 0)
+    {
+        for (j = 0; j < grid->num_variables; j++)
+        {
+            for (k = 0; k < num_variables; k++)
             {
-                if (add_weight_variable(product, bintype, binning_skip, variable->name, variable->num_dimensions,
-                                        variable->dimension_type, variable->dimension, weight) != 0)
+                if (grid_variable[k] == grid->variable[j])
                 {
-                    goto error;
+                    break;
                 }
             }
+            if (k == num_variables)
+            {
+                harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "products don't both have variable '%s'",
+                               grid->variable[j]->sum->name);
+                goto error;
+            }
         }
     }
-
-    /* remove all variables that need to be removed (in reverse order!) */
-    for (k = product->num_variables - 1; k >= 0; k--)
+    else if (num_variables > 0)
     {
-        if (bintype[k] == binning_remove)
+        /* the first product determines the variables of the grid */
+        new_grid_variable = calloc(num_variables, sizeof(spatial_grid_variable *));
+        if (new_grid_variable == NULL)
         {
-            if (harp_product_remove_variable(product, product->variable[k]) != 0)
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_variables * sizeof(spatial_grid_variable *), __FILE__, __LINE__);
+            goto error;
+        }
+        for (k = 0; k < num_variables; k++)
+        {
+            if (spatial_grid_variable_new(grid, variable[k], bintype[k], &new_grid_variable[k]) != 0)
             {
                 goto error;
             }
+            grid_variable[k] = new_grid_variable[k];
+        }
+        grid->variable = new_grid_variable;
+        grid->num_variables = num_variables;
+        new_grid_variable = NULL;
+    }
+
+    for (k = 0; k < num_variables; k++)
+    {
+        spatial_grid_add_samples(grid, grid_variable[k], variable[k], num_latlon_index, latlon_cell_index,
+                                 latlon_weight, area_binning);
+        harp_variable_delete(variable[k]);
+    }
+    num_variables = 0;
+
+    accumulate_samples(num_time_elements, NULL, grid->num_latitude_edges - 1, grid->num_longitude_edges - 1,
+                       num_latlon_index, latlon_cell_index, latlon_weight, area_binning, binning_skip, NULL, 1, NULL,
+                       grid->weight);
+    for (i = 0; i < num_time_elements; i++)
+    {
+        if (num_latlon_index[i] > 0)
+        {
+            grid->count++;
         }
     }
+    grid->num_products++;
 
+    free(grid_variable);
     free(bintype);
-    free(weight);
-    free(time_index);
-    free(bin_count);
+    free(variable);
     free(num_latlon_index);
     if (latlon_cell_index != NULL)
     {
@@ -1771,135 +2787,240 @@ LIBHARP_API int harp_product_bin_spatial(harp_product *product, long num_time_bi
         free(latlon_weight);
     }
 
-    /* add latitude_bounds and longitude_bounds variables */
-    dimension_type[0] = harp_dimension_latitude;
-    dimension[0] = num_latitude_edges - 1;
-    dimension_type[1] = harp_dimension_independent;
-    dimension[1] = 2;
-    if (harp_variable_new("latitude_bounds", harp_type_double, 2, dimension_type, dimension, &latitude) != 0)
+    return 0;
+
+  error:
+    if (new_grid_variable != NULL)
     {
-        return -1;
+        for (k = 0; k < num_variables; k++)
+        {
+            if (new_grid_variable[k] != NULL)
+            {
+                spatial_grid_variable_delete(new_grid_variable[k]);
+            }
+        }
+        free(new_grid_variable);
     }
-    for (i = 0; i < dimension[0]; i++)
+    if (variable != NULL)
     {
-        latitude->data.double_data[2 * i] = latitude_edges[i];
-        latitude->data.double_data[2 * i + 1] = latitude_edges[i + 1];
+        for (k = 0; k < num_variables; k++)
+        {
+            harp_variable_delete(variable[k]);
+        }
+        free(variable);
     }
-    if (harp_product_add_variable(product, latitude) != 0)
+    if (grid_variable != NULL)
     {
-        harp_variable_delete(latitude);
-        return -1;
+        free(grid_variable);
     }
-    if (harp_variable_set_unit(latitude, HARP_UNIT_LATITUDE) != 0)
+    if (bintype != NULL)
     {
-        return -1;
+        free(bintype);
     }
-
-    dimension_type[0] = harp_dimension_longitude;
-    dimension[0] = num_longitude_edges - 1;
-    if (harp_variable_new("longitude_bounds", harp_type_double, 2, dimension_type, dimension, &longitude) != 0)
+    free(num_latlon_index);
+    if (latlon_cell_index != NULL)
     {
-        return -1;
+        free(latlon_cell_index);
     }
-    for (i = 0; i < dimension[0]; i++)
+    if (latlon_weight != NULL)
     {
-        longitude->data.double_data[2 * i] = longitude_edges[i];
-        longitude->data.double_data[2 * i + 1] = longitude_edges[i + 1];
+        free(latlon_weight);
     }
-    if (harp_product_add_variable(product, longitude) != 0)
+    return -1;
+}
+
+/** Retrieve the spatially binned product from an accumulator.
+ * \ingroup harp_product
+ * The resulting product has a time dimension of length 1 and the latitude and longitude dimensions of the grid, and
+ * contains 'count', 'weight', 'latitude_bounds', and 'longitude_bounds' variables as described for
+ * harp_product_bin_spatial(). The accumulator itself is not modified, so more products can be added afterwards.
+ * \param grid Spatial binning accumulator.
+ * \param product Pointer to the C variable where the new product will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_spatial_grid_get_product(harp_spatial_grid *grid, harp_product **product)
+{
+    harp_dimension_type dimension_type[3];
+    harp_variable **weight_variable;
+    harp_product *new_product;
+    harp_variable *variable;
+    long dimension[3];
+    int k;
+
+    weight_variable = calloc(grid->num_variables + 1, sizeof(harp_variable *));
+    if (weight_variable == NULL)
     {
-        harp_variable_delete(longitude);
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (grid->num_variables + 1) * sizeof(harp_variable *), __FILE__, __LINE__);
         return -1;
     }
-    if (harp_variable_set_unit(longitude, HARP_UNIT_LONGITUDE) != 0)
+    if (harp_product_new(&new_product) != 0)
     {
+        free(weight_variable);
         return -1;
     }
 
-    return 0;
+    for (k = 0; k < grid->num_variables; k++)
+    {
+        spatial_grid_variable *grid_variable = grid->variable[k];
 
-  error:
-    if (bintype != NULL)
+        if (harp_variable_copy(grid_variable->sum, &variable) != 0)
+        {
+            goto error;
+        }
+        if (harp_product_add_variable(new_product, variable) != 0)
+        {
+            harp_variable_delete(variable);
+            goto error;
+        }
+        if (grid_variable->bintype == binning_time_min || grid_variable->bintype == binning_time_max ||
+            grid_variable->bintype == binning_time_average)
+        {
+            if (grid_variable->count == 0)
+            {
+                variable->data.double_data[0] = harp_nan();
+            }
+            else if (grid_variable->bintype == binning_time_average)
+            {
+                variable->data.double_data[0] /= grid_variable->count;
+            }
+        }
+        else
+        {
+            char weight_variable_name[MAX_NAME_LENGTH];
+            int store_weight_variable = grid_variable->store_weight_variable;
+            long num_weights = variable->num_elements;
+            float *weight;
+
+            if (grid_variable->bintype == binning_angle)
+            {
+                num_weights /= 2;
+            }
+            /* the weights get modified for angle variables, so finalise using a copy */
+            weight = malloc(num_weights * sizeof(float));
+            if (weight == NULL)
+            {
+                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               num_weights * sizeof(float), __FILE__, __LINE__);
+                goto error;
+            }
+            memcpy(weight, grid_variable->weight, num_weights * sizeof(float));
+            if (finalise_variable(variable, grid_variable->bintype, weight, &store_weight_variable) != 0)
+            {
+                free(weight);
+                goto error;
+            }
+            if (store_weight_variable)
+            {
+                snprintf(weight_variable_name, MAX_NAME_LENGTH, "%s_weight", variable->name);
+                if (harp_variable_new(weight_variable_name, harp_type_float, variable->num_dimensions,
+                                      variable->dimension_type, variable->dimension, &weight_variable[k]) != 0)
+                {
+                    free(weight);
+                    goto error;
+                }
+                memcpy(weight_variable[k]->data.float_data, weight, num_weights * sizeof(float));
+            }
+            free(weight);
+        }
+    }
+
+    /* count and weight variables */
+    dimension_type[0] = harp_dimension_time;
+    dimension[0] = 1;
+    if (harp_variable_new("count", harp_type_int32, 1, dimension_type, dimension, &variable) != 0)
     {
-        free(bintype);
+        goto error;
     }
-    if (time_index != NULL)
+    variable->data.int32_data[0] = grid->count;
+    if (harp_product_add_variable(new_product, variable) != 0)
     {
-        free(time_index);
+        harp_variable_delete(variable);
+        goto error;
     }
-    if (bin_count != NULL)
+    dimension_type[1] = harp_dimension_latitude;
+    dimension[1] = grid->num_latitude_edges - 1;
+    dimension_type[2] = harp_dimension_longitude;
+    dimension[2] = grid->num_longitude_edges - 1;
+    if (harp_variable_new("weight", harp_type_float, 3, dimension_type, dimension, &variable) != 0)
     {
-        free(bin_count);
+        goto error;
     }
-    if (weight != NULL)
+    memcpy(variable->data.float_data, grid->weight, variable->num_elements * sizeof(float));
+    if (harp_product_add_variable(new_product, variable) != 0)
     {
-        free(weight);
+        harp_variable_delete(variable);
+        goto error;
     }
-    if (num_latlon_index != NULL)
+    for (k = 0; k < grid->num_variables; k++)
     {
-        free(num_latlon_index);
+        if (weight_variable[k] != NULL)
+        {
+            if (harp_product_add_variable(new_product, weight_variable[k]) != 0)
+            {
+                goto error;
+            }
+            weight_variable[k] = NULL;
+        }
     }
-    if (latlon_cell_index != NULL)
+
+    if (add_grid_bounds_variables(new_product, grid->num_latitude_edges, grid->latitude_edges,
+                                  grid->num_longitude_edges, grid->longitude_edges) != 0)
     {
-        free(latlon_cell_index);
+        goto error;
     }
-    if (latlon_weight != NULL)
+
+    free(weight_variable);
+    *product = new_product;
+
+    return 0;
+
+  error:
+    for (k = 0; k < grid->num_variables; k++)
     {
-        free(latlon_weight);
+        if (weight_variable[k] != NULL)
+        {
+            harp_variable_delete(weight_variable[k]);
+        }
     }
+    free(weight_variable);
+    harp_product_delete(new_product);
     return -1;
 }
 
-/**
- * @}
- */
-
-/** Perform a spatial binning such that all samples end up in a single time bin.
- *
- * \param product Product to regrid.
- * \param num_latitude_edges Number of edges for the latitude grid (number of latitude rows = num_latitude_edges - 1)
- * \param latitude_edges latitude grid edge vales
- * \param num_longitude_edges Number of edges for the longitude grid
- *        (number of longitude columns = num_longitude_edges - 1)
- * \param longitude_edges longitude grid edge vales
- *
- * \return
- *   \arg \c 0, Success.
- *   \arg \c -1, Error occurred (check #harp_errno).
+/** Delete a spatial binning accumulator.
+ * \ingroup harp_product
+ * \param grid Spatial binning accumulator.
  */
-int harp_product_bin_spatial_full(harp_product *product, long num_latitude_edges, double *latitude_edges,
-                                  long num_longitude_edges, double *longitude_edges)
+LIBHARP_API void harp_spatial_grid_delete(harp_spatial_grid *grid)
 {
-    long *bin_index;
-    long num_elements;
-    long i;
+    int k;
 
-    num_elements = product->dimension[harp_dimension_time];
-    if (num_elements == 0)
+    if (grid == NULL)
     {
-        /* nothing to do */
-        return 0;
+        return;
     }
-
-    bin_index = malloc(num_elements * sizeof(long));
-    if (bin_index == NULL)
+    if (grid->latitude_edges != NULL)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       num_elements * sizeof(long), __FILE__, __LINE__);
-        return -1;
+        free(grid->latitude_edges);
     }
-    for (i = 0; i < num_elements; i++)
+    if (grid->longitude_edges != NULL)
     {
-        bin_index[i] = 0;
+        free(grid->longitude_edges);
     }
-
-    if (harp_product_bin_spatial(product, 1, num_elements, bin_index, num_latitude_edges, latitude_edges,
-                                 num_longitude_edges, longitude_edges) != 0)
+    if (grid->weight != NULL)
     {
-        free(bin_index);
-        return -1;
+        free(grid->weight);
     }
-
-    free(bin_index);
-    return 0;
+    if (grid->variable != NULL)
+    {
+        for (k = 0; k < grid->num_variables; k++)
+        {
+            spatial_grid_variable_delete(grid->variable[k]);
+        }
+        free(grid->variable);
+    }
+    free(grid);
 }
@@ -579,6 +579,11 @@ LIBHARP_API int harp_product_bin(harp_product *product, long num_bins, long num_
     long i, j, k;
     int result;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (num_elements != product->dimension[harp_dimension_time])
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_elements (%ld) does not match time dimension length (%ld) "
@@ -1350,10 +1355,9 @@ int harp_product_bin_with_collocated_dataset(harp_product *product, harp_colloca
     {
         for (j = 0; j < num_bins; j++)
         {
-            if (filtered_collocation_result->pair[index[j]]->product_index_b ==
-                filtered_collocation_result->pair[i]->product_index_b &&
-                filtered_collocation_result->pair[index[j]]->sample_index_b ==
-                filtered_collocation_result->pair[i]->sample_index_b)
+            if (filtered_collocation_result->product_index_b[index[j]] ==
+                filtered_collocation_result->product_index_b[i] &&
+                filtered_collocation_result->sample_index_b[index[j]] == filtered_collocation_result->sample_index_b[i])
             {
                 break;
             }
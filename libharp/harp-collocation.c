@@ -49,71 +49,177 @@
  * Collocation results can be written to and read from a csv file.
  */
 
-static void collocation_pair_swap_datasets(harp_collocation_pair *pair)
+static int resize_long_array(long **array, long num_elements)
 {
-    long index_a = pair->product_index_a;
-    long sample_a = pair->sample_index_a;
+    long *new_array;
 
-    pair->product_index_a = pair->product_index_b;
-    pair->sample_index_a = pair->sample_index_b;
-    pair->product_index_b = index_a;
-    pair->sample_index_b = sample_a;
+    new_array = realloc(*array, num_elements * sizeof(long));
+    if (new_array == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_elements * sizeof(long), __FILE__, __LINE__);
+        return -1;
+    }
+    *array = new_array;
+
+    return 0;
 }
 
-static void collocation_pair_delete(harp_collocation_pair *pair)
+/* Make sure the pair arrays have room for at least num_pairs pairs.
+ * The arrays are always allocated for a multiple of COLLOCATION_RESULT_BLOCK_SIZE pairs that is larger than num_pairs,
+ * such that harp_collocation_result_add_pair() only needs to grow them when num_pairs is a multiple of the block size.
+ */
+static int collocation_result_reserve(harp_collocation_result *collocation_result, long num_pairs)
 {
-    if (pair != NULL)
+    long num_allocated_pairs = (num_pairs / COLLOCATION_RESULT_BLOCK_SIZE + 1) * COLLOCATION_RESULT_BLOCK_SIZE;
+
+    if (resize_long_array(&collocation_result->collocation_index, num_allocated_pairs) != 0)
+    {
+        return -1;
+    }
+    if (resize_long_array(&collocation_result->product_index_a, num_allocated_pairs) != 0)
+    {
+        return -1;
+    }
+    if (resize_long_array(&collocation_result->sample_index_a, num_allocated_pairs) != 0)
+    {
+        return -1;
+    }
+    if (resize_long_array(&collocation_result->product_index_b, num_allocated_pairs) != 0)
     {
-        if (pair->difference != NULL)
+        return -1;
+    }
+    if (resize_long_array(&collocation_result->sample_index_b, num_allocated_pairs) != 0)
+    {
+        return -1;
+    }
+    if (collocation_result->num_differences > 0)
+    {
+        double *difference;
+
+        difference = realloc(collocation_result->difference,
+                             num_allocated_pairs * collocation_result->num_differences * sizeof(double));
+        if (difference == NULL)
         {
-            free(pair->difference);
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_allocated_pairs * collocation_result->num_differences * sizeof(double), __FILE__,
+                           __LINE__);
+            return -1;
         }
+        collocation_result->difference = difference;
+    }
+
+    return 0;
+}
 
-        free(pair);
+static void collocation_result_free_pairs(harp_collocation_result *collocation_result)
+{
+    if (collocation_result->collocation_index != NULL)
+    {
+        free(collocation_result->collocation_index);
+    }
+    if (collocation_result->product_index_a != NULL)
+    {
+        free(collocation_result->product_index_a);
+    }
+    if (collocation_result->sample_index_a != NULL)
+    {
+        free(collocation_result->sample_index_a);
+    }
+    if (collocation_result->product_index_b != NULL)
+    {
+        free(collocation_result->product_index_b);
+    }
+    if (collocation_result->sample_index_b != NULL)
+    {
+        free(collocation_result->sample_index_b);
+    }
+    if (collocation_result->difference != NULL)
+    {
+        free(collocation_result->difference);
     }
 }
 
-static int collocation_pair_new(long collocation_index, long product_index_a, long sample_index_a, long product_index_b,
-                                long sample_index_b, int num_differences, const double *difference,
-                                harp_collocation_pair **new_pair)
+/* Copy the pair at index 'source' to index 'target' */
+static void collocation_result_copy_pair(harp_collocation_result *collocation_result, long target, long source)
 {
-    harp_collocation_pair *pair;
-    int i;
+    int num_differences = collocation_result->num_differences;
 
-    pair = (harp_collocation_pair *)malloc(sizeof(harp_collocation_pair));
-    if (pair == NULL)
+    collocation_result->collocation_index[target] = collocation_result->collocation_index[source];
+    collocation_result->product_index_a[target] = collocation_result->product_index_a[source];
+    collocation_result->sample_index_a[target] = collocation_result->sample_index_a[source];
+    collocation_result->product_index_b[target] = collocation_result->product_index_b[source];
+    collocation_result->sample_index_b[target] = collocation_result->sample_index_b[source];
+    if (num_differences > 0)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       sizeof(harp_collocation_pair), __FILE__, __LINE__);
-        return -1;
+        memcpy(&collocation_result->difference[target * num_differences],
+               &collocation_result->difference[source * num_differences], num_differences * sizeof(double));
     }
+}
 
-    pair->collocation_index = collocation_index;
+static void gather_long_array(long *array, long num_elements, const long *index, long *buffer)
+{
+    long i;
 
-    pair->product_index_a = product_index_a;
-    pair->sample_index_a = sample_index_a;
+    for (i = 0; i < num_elements; i++)
+    {
+        buffer[i] = array[index[i]];
+    }
+    memcpy(array, buffer, num_elements * sizeof(long));
+}
 
-    pair->product_index_b = product_index_b;
-    pair->sample_index_b = sample_index_b;
+/* Rearrange the pairs such that the i-th pair becomes the pair that was at index[i] (for 0 <= i < num_pairs).
+ * The collocation result will be reduced to num_pairs pairs (which should be <= the current number of pairs).
+ */
+static int collocation_result_gather_pairs(harp_collocation_result *collocation_result, long num_pairs,
+                                           const long *index)
+{
+    int num_differences = collocation_result->num_differences;
+    long *buffer;
+    long i;
 
-    pair->num_differences = num_differences;
-    pair->difference = NULL;
+    if (num_pairs == 0)
+    {
+        collocation_result->num_pairs = 0;
+        return 0;
+    }
 
-    pair->difference = malloc(num_differences * sizeof(double));
-    if (pair->difference == NULL)
+    buffer = malloc(num_pairs * sizeof(long));
+    if (buffer == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       sizeof(harp_collocation_pair), __FILE__, __LINE__);
-        collocation_pair_delete(pair);
+                       num_pairs * sizeof(long), __FILE__, __LINE__);
         return -1;
     }
+    gather_long_array(collocation_result->collocation_index, num_pairs, index, buffer);
+    gather_long_array(collocation_result->product_index_a, num_pairs, index, buffer);
+    gather_long_array(collocation_result->sample_index_a, num_pairs, index, buffer);
+    gather_long_array(collocation_result->product_index_b, num_pairs, index, buffer);
+    gather_long_array(collocation_result->sample_index_b, num_pairs, index, buffer);
+    free(buffer);
 
-    for (i = 0; i < num_differences; i++)
+    if (num_differences > 0)
     {
-        pair->difference[i] = difference[i];
+        double *difference;
+
+        difference = malloc(num_pairs * num_differences * sizeof(double));
+        if (difference == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_pairs * num_differences * sizeof(double), __FILE__, __LINE__);
+            return -1;
+        }
+        for (i = 0; i < num_pairs; i++)
+        {
+            memcpy(&difference[i * num_differences], &collocation_result->difference[index[i] * num_differences],
+                   num_differences * sizeof(double));
+        }
+        memcpy(collocation_result->difference, difference, num_pairs * num_differences * sizeof(double));
+        free(difference);
     }
 
-    *new_pair = pair;
+    collocation_result->num_pairs = num_pairs;
+
     return 0;
 }
 
@@ -151,7 +257,12 @@ LIBHARP_API int harp_collocation_result_new(harp_collocation_result **new_colloc
     collocation_result->difference_variable_name = NULL;
     collocation_result->difference_unit = NULL;
     collocation_result->num_pairs = 0;
-    collocation_result->pair = NULL;
+    collocation_result->collocation_index = NULL;
+    collocation_result->product_index_a = NULL;
+    collocation_result->sample_index_a = NULL;
+    collocation_result->product_index_b = NULL;
+    collocation_result->sample_index_b = NULL;
+    collocation_result->difference = NULL;
 
     if (harp_dataset_new(&collocation_result->dataset_a) != 0)
     {
@@ -190,6 +301,7 @@ LIBHARP_API int harp_collocation_result_new(harp_collocation_result **new_colloc
         {
             collocation_result->difference_unit[i] = NULL;
         }
+        collocation_result->num_differences = num_differences;
         if (difference_variable_name != NULL)
         {
             for (i = 0; i < num_differences; i++)
@@ -269,16 +381,7 @@ LIBHARP_API void harp_collocation_result_delete(harp_collocation_result *colloca
         free(collocation_result->difference_unit);
     }
 
-    if (collocation_result->pair)
-    {
-        long i;
-
-        for (i = 0; i < collocation_result->num_pairs; i++)
-        {
-            collocation_pair_delete(collocation_result->pair[i]);
-        }
-        free(collocation_result->pair);
-    }
+    collocation_result_free_pairs(collocation_result);
 
     free(collocation_result);
 }
@@ -293,6 +396,19 @@ int harp_collocation_result_add_difference(harp_collocation_result *collocation_
     char **new_string_array;
     int index;
 
+    if (collocation_result->num_pairs > 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "cannot add difference to collocation result with pairs (%s:%u)",
+                       __FILE__, __LINE__);
+        return -1;
+    }
+    if (collocation_result->difference != NULL)
+    {
+        /* the difference array will be reallocated for the new number of differences when pairs get added */
+        free(collocation_result->difference);
+        collocation_result->difference = NULL;
+    }
+
     new_string_array = realloc(collocation_result->difference_variable_name,
                                (collocation_result->num_differences + 1) * sizeof(char *));
     if (new_string_array == NULL)
@@ -336,41 +452,85 @@ int harp_collocation_result_add_difference(harp_collocation_result *collocation_
     return 0;
 }
 
-static harp_dataset *sort_dataset_a = NULL;
-static harp_dataset *sort_dataset_b = NULL;
+static const harp_dataset *sort_dataset = NULL;
+static const harp_collocation_result *sort_collocation_result = NULL;
+static const long *sort_rank_a = NULL;
+static const long *sort_rank_b = NULL;
 
-static int compare_by_a(const void *a, const void *b)
+static int compare_by_source_product(const void *a, const void *b)
 {
-    harp_collocation_pair *pair_a = *(harp_collocation_pair **)a;
-    harp_collocation_pair *pair_b = *(harp_collocation_pair **)b;
+    return strcmp(sort_dataset->source_product[*(long *)a], sort_dataset->source_product[*(long *)b]);
+}
+
+/* Determine for each product in the dataset its position when the products are sorted by source product name.
+ * This allows pairs to be sorted on product by comparing integers instead of strings.
+ */
+static int get_source_product_rank(const harp_dataset *dataset, long **new_rank)
+{
+    long *product_index;
+    long *rank;
+    long i;
 
-    if (pair_a->product_index_a != pair_b->product_index_a)
+    rank = malloc((dataset->num_products + 1) * sizeof(long));
+    if (rank == NULL)
     {
-        return strcmp(sort_dataset_a->source_product[pair_a->product_index_a],
-                      sort_dataset_a->source_product[pair_b->product_index_a]);
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (dataset->num_products + 1) * sizeof(long), __FILE__, __LINE__);
+        return -1;
     }
-    if (pair_a->sample_index_a < pair_b->sample_index_a)
+    product_index = malloc((dataset->num_products + 1) * sizeof(long));
+    if (product_index == NULL)
     {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (dataset->num_products + 1) * sizeof(long), __FILE__, __LINE__);
+        free(rank);
         return -1;
     }
-    if (pair_a->sample_index_a > pair_b->sample_index_a)
+    for (i = 0; i < dataset->num_products; i++)
     {
-        return 1;
+        product_index[i] = i;
     }
+    sort_dataset = dataset;
+    qsort(product_index, dataset->num_products, sizeof(long), compare_by_source_product);
+    sort_dataset = NULL;
+    for (i = 0; i < dataset->num_products; i++)
+    {
+        rank[product_index[i]] = i;
+    }
+    free(product_index);
 
-    /* If a is equal, then further sort by b to get a fixed ordering. */
-    if (pair_a->product_index_b != pair_b->product_index_b)
+    *new_rank = rank;
+
+    return 0;
+}
+
+static int compare_by_a(const void *a, const void *b)
+{
+    const harp_collocation_result *collocation_result = sort_collocation_result;
+    long index_a = *(long *)a;
+    long index_b = *(long *)b;
+    long rank_a = sort_rank_a[collocation_result->product_index_a[index_a]];
+    long rank_b = sort_rank_a[collocation_result->product_index_a[index_b]];
+
+    if (rank_a != rank_b)
     {
-        return strcmp(sort_dataset_b->source_product[pair_a->product_index_b],
-                      sort_dataset_b->source_product[pair_b->product_index_b]);
+        return rank_a < rank_b ? -1 : 1;
     }
-    if (pair_a->sample_index_b < pair_b->sample_index_b)
+    if (collocation_result->sample_index_a[index_a] != collocation_result->sample_index_a[index_b])
     {
-        return -1;
+        return collocation_result->sample_index_a[index_a] < collocation_result->sample_index_a[index_b] ? -1 : 1;
     }
-    if (pair_a->sample_index_b > pair_b->sample_index_b)
+
+    /* If a is equal, then further sort by b to get a fixed ordering. */
+    rank_a = sort_rank_b[collocation_result->product_index_b[index_a]];
+    rank_b = sort_rank_b[collocation_result->product_index_b[index_b]];
+    if (rank_a != rank_b)
     {
-        return 1;
+        return rank_a < rank_b ? -1 : 1;
+    }
+    if (collocation_result->sample_index_b[index_a] != collocation_result->sample_index_b[index_b])
+    {
+        return collocation_result->sample_index_b[index_a] < collocation_result->sample_index_b[index_b] ? -1 : 1;
     }
 
     return 0;
@@ -378,34 +538,47 @@ static int compare_by_a(const void *a, const void *b)
 
 static int compare_by_b(const void *a, const void *b)
 {
-    harp_collocation_pair *pair_a = *(harp_collocation_pair **)a;
-    harp_collocation_pair *pair_b = *(harp_collocation_pair **)b;
+    const harp_collocation_result *collocation_result = sort_collocation_result;
+    long index_a = *(long *)a;
+    long index_b = *(long *)b;
+    long rank_a = sort_rank_b[collocation_result->product_index_b[index_a]];
+    long rank_b = sort_rank_b[collocation_result->product_index_b[index_b]];
 
-    if (pair_a->product_index_b != pair_b->product_index_b)
+    if (rank_a != rank_b)
     {
-        return strcmp(sort_dataset_b->source_product[pair_a->product_index_b],
-                      sort_dataset_b->source_product[pair_b->product_index_b]);
+        return rank_a < rank_b ? -1 : 1;
     }
-    if (pair_a->sample_index_b < pair_b->sample_index_b)
+    if (collocation_result->sample_index_b[index_a] != collocation_result->sample_index_b[index_b])
     {
-        return -1;
-    }
-    if (pair_a->sample_index_b > pair_b->sample_index_b)
-    {
-        return 1;
+        return collocation_result->sample_index_b[index_a] < collocation_result->sample_index_b[index_b] ? -1 : 1;
     }
 
     /* If b is equal, then further sort by a to get a fixed ordering. */
-    if (pair_a->product_index_a != pair_b->product_index_a)
+    rank_a = sort_rank_a[collocation_result->product_index_a[index_a]];
+    rank_b = sort_rank_a[collocation_result->product_index_a[index_b]];
+    if (rank_a != rank_b)
     {
-        return strcmp(sort_dataset_a->source_product[pair_a->product_index_a],
-                      sort_dataset_a->source_product[pair_b->product_index_a]);
+        return rank_a < rank_b ? -1 : 1;
     }
-    if (pair_a->sample_index_a < pair_b->sample_index_a)
+    if (collocation_result->sample_index_a[index_a] != collocation_result->sample_index_a[index_b])
+    {
+        return collocation_result->sample_index_a[index_a] < collocation_result->sample_index_a[index_b] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static int compare_by_collocation_index(const void *a, const void *b)
+{
+    const long *collocation_index = sort_collocation_result->collocation_index;
+    long index_a = *(long *)a;
+    long index_b = *(long *)b;
+
+    if (collocation_index[index_a] < collocation_index[index_b])
     {
         return -1;
     }
-    if (pair_a->sample_index_a > pair_b->sample_index_a)
+    if (collocation_index[index_a] > collocation_index[index_b])
     {
         return 1;
     }
@@ -413,20 +586,69 @@ static int compare_by_b(const void *a, const void *b)
     return 0;
 }
 
-static int compare_by_collocation_index(const void *a, const void *b)
+/* Sort the pairs by first sorting a permutation index using 'compare' and then rearranging all pair arrays */
+static int sort_pairs(harp_collocation_result *collocation_result, int (*compare)(const void *, const void *))
 {
-    harp_collocation_pair *pair_a = *(harp_collocation_pair **)a;
-    harp_collocation_pair *pair_b = *(harp_collocation_pair **)b;
+    long *rank_a = NULL;
+    long *rank_b = NULL;
+    long *index;
+    long i;
+
+    if (collocation_result->num_pairs < 2)
+    {
+        return 0;
+    }
+
+    if (compare != compare_by_collocation_index)
+    {
+        if (get_source_product_rank(collocation_result->dataset_a, &rank_a) != 0)
+        {
+            return -1;
+        }
+        if (get_source_product_rank(collocation_result->dataset_b, &rank_b) != 0)
+        {
+            free(rank_a);
+            return -1;
+        }
+    }
 
-    if (pair_a->collocation_index < pair_b->collocation_index)
+    index = malloc(collocation_result->num_pairs * sizeof(long));
+    if (index == NULL)
     {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       collocation_result->num_pairs * sizeof(long), __FILE__, __LINE__);
+        if (rank_a != NULL)
+        {
+            free(rank_a);
+            free(rank_b);
+        }
         return -1;
     }
-    if (pair_a->collocation_index > pair_b->collocation_index)
+    for (i = 0; i < collocation_result->num_pairs; i++)
     {
-        return 1;
+        index[i] = i;
     }
 
+    sort_collocation_result = collocation_result;
+    sort_rank_a = rank_a;
+    sort_rank_b = rank_b;
+    qsort(index, collocation_result->num_pairs, sizeof(long), compare);
+    sort_collocation_result = NULL;
+    sort_rank_a = NULL;
+    sort_rank_b = NULL;
+    if (rank_a != NULL)
+    {
+        free(rank_a);
+        free(rank_b);
+    }
+
+    if (collocation_result_gather_pairs(collocation_result, collocation_result->num_pairs, index) != 0)
+    {
+        free(index);
+        return -1;
+    }
+    free(index);
+
     return 0;
 }
 
@@ -443,12 +665,7 @@ static int compare_by_collocation_index(const void *a, const void *b)
  */
 LIBHARP_API int harp_collocation_result_sort_by_a(harp_collocation_result *collocation_result)
 {
-    sort_dataset_a = collocation_result->dataset_a;
-    sort_dataset_b = collocation_result->dataset_b;
-    qsort(collocation_result->pair, collocation_result->num_pairs, sizeof(harp_collocation_pair *), compare_by_a);
-    sort_dataset_a = NULL;
-    sort_dataset_b = NULL;
-    return 0;
+    return sort_pairs(collocation_result, compare_by_a);
 }
 
 /** Sort the collocation result pairs by dataset B
@@ -460,12 +677,7 @@ LIBHARP_API int harp_collocation_result_sort_by_a(harp_collocation_result *collo
  */
 LIBHARP_API int harp_collocation_result_sort_by_b(harp_collocation_result *collocation_result)
 {
-    sort_dataset_a = collocation_result->dataset_a;
-    sort_dataset_b = collocation_result->dataset_b;
-    qsort(collocation_result->pair, collocation_result->num_pairs, sizeof(harp_collocation_pair *), compare_by_b);
-    sort_dataset_a = NULL;
-    sort_dataset_b = NULL;
-    return 0;
+    return sort_pairs(collocation_result, compare_by_b);
 }
 
 /** Sort the collocation result pairs by collocation index
@@ -476,9 +688,7 @@ LIBHARP_API int harp_collocation_result_sort_by_b(harp_collocation_result *collo
  */
 LIBHARP_API int harp_collocation_result_sort_by_collocation_index(harp_collocation_result *collocation_result)
 {
-    qsort(collocation_result->pair, collocation_result->num_pairs, sizeof(harp_collocation_pair *),
-          compare_by_collocation_index);
-    return 0;
+    return sort_pairs(collocation_result, compare_by_collocation_index);
 }
 
 /** Filter collocation result set for a specific product from dataset A
@@ -499,18 +709,19 @@ LIBHARP_API int harp_collocation_result_filter_for_source_product_a(harp_colloca
     {
         return -1;
     }
-    for (i = collocation_result->num_pairs - 1; i >= 0; i--)
+    j = 0;
+    for (i = 0; i < collocation_result->num_pairs; i++)
     {
-        if (collocation_result->pair[i]->product_index_a != product_index)
+        if (collocation_result->product_index_a[i] == product_index)
         {
-            collocation_pair_delete(collocation_result->pair[i]);
-            for (j = i + 1; j < collocation_result->num_pairs; j++)
+            if (j != i)
             {
-                collocation_result->pair[j - 1] = collocation_result->pair[j];
+                collocation_result_copy_pair(collocation_result, j, i);
             }
-            collocation_result->num_pairs--;
+            j++;
         }
     }
+    collocation_result->num_pairs = j;
     return 0;
 }
 
@@ -532,18 +743,19 @@ LIBHARP_API int harp_collocation_result_filter_for_source_product_b(harp_colloca
     {
         return -1;
     }
-    for (i = collocation_result->num_pairs - 1; i >= 0; i--)
+    j = 0;
+    for (i = 0; i < collocation_result->num_pairs; i++)
     {
-        if (collocation_result->pair[i]->product_index_b != product_index)
+        if (collocation_result->product_index_b[i] == product_index)
         {
-            collocation_pair_delete(collocation_result->pair[i]);
-            for (j = i + 1; j < collocation_result->num_pairs; j++)
+            if (j != i)
             {
-                collocation_result->pair[j - 1] = collocation_result->pair[j];
+                collocation_result_copy_pair(collocation_result, j, i);
             }
-            collocation_result->num_pairs--;
+            j++;
         }
     }
+    collocation_result->num_pairs = j;
     return 0;
 }
 
@@ -567,14 +779,14 @@ static int find_collocation_pair_for_collocation_index(harp_collocation_result *
         long pivot_index = lower_index + ((upper_index - lower_index) / 2);
 
         /* If the pivot equals the key, terminate early. */
-        if (collocation_result->pair[pivot_index]->collocation_index == collocation_index)
+        if (collocation_result->collocation_index[pivot_index] == collocation_index)
         {
             *index = pivot_index;
             return 0;
         }
 
         /* If the pivot is smaller than the key, search the upper sub array, otherwise search the lower sub array. */
-        if (collocation_result->pair[pivot_index]->collocation_index < collocation_index)
+        if (collocation_result->collocation_index[pivot_index] < collocation_index)
         {
             lower_index = pivot_index + 1;
         }
@@ -606,8 +818,8 @@ static int find_collocation_pair_for_collocation_index(harp_collocation_result *
 LIBHARP_API int harp_collocation_result_filter_for_collocation_indices(harp_collocation_result *collocation_result,
                                                                        long num_indices, int32_t *collocation_index)
 {
-    harp_collocation_pair **pair = NULL;
-    long num_pairs = 0;
+    uint8_t *is_used = NULL;
+    long *index = NULL;
     long i;
 
     if (harp_collocation_result_sort_by_collocation_index(collocation_result) != 0)
@@ -615,49 +827,57 @@ LIBHARP_API int harp_collocation_result_filter_for_collocation_indices(harp_coll
         return -1;
     }
 
-    /* create a temporary array to store all pairs */
-    pair = malloc(collocation_result->num_pairs * sizeof(harp_collocation_pair *));
-    if (!pair)
+    if (num_indices == 0)
+    {
+        collocation_result->num_pairs = 0;
+        return 0;
+    }
+
+    index = malloc(num_indices * sizeof(long));
+    if (index == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       collocation_result->num_pairs * sizeof(harp_collocation_pair *), __FILE__, __LINE__);
+                       num_indices * sizeof(long), __FILE__, __LINE__);
+        return -1;
+    }
+    is_used = calloc(collocation_result->num_pairs + 1, sizeof(uint8_t));
+    if (is_used == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       collocation_result->num_pairs * sizeof(uint8_t), __FILE__, __LINE__);
+        free(index);
         return -1;
     }
 
     for (i = 0; i < num_indices; i++)
     {
-        long index;
-        long j;
-
-        if (find_collocation_pair_for_collocation_index(collocation_result, collocation_index[i], &index) != 0)
+        if (find_collocation_pair_for_collocation_index(collocation_result, collocation_index[i], &index[i]) != 0)
         {
             goto error;
         }
-        pair[num_pairs] = collocation_result->pair[index];
-        num_pairs++;
-        for (j = index + 1; j < collocation_result->num_pairs; j++)
+        /* each pair can only be selected once */
+        if (is_used[index[i]])
         {
-            collocation_result->pair[j - 1] = collocation_result->pair[j];
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "cannot find collocation index %d in collocation results",
+                           collocation_index[i]);
+            goto error;
         }
-        collocation_result->num_pairs--;
+        is_used[index[i]] = 1;
     }
 
-    for (i = 0; i < collocation_result->num_pairs; i++)
+    if (collocation_result_gather_pairs(collocation_result, num_indices, index) != 0)
     {
-        collocation_pair_delete(collocation_result->pair[i]);
+        goto error;
     }
-    free(collocation_result->pair);
-    collocation_result->pair = pair;
-    collocation_result->num_pairs = num_pairs;
+
+    free(is_used);
+    free(index);
 
     return 0;
 
   error:
-    for (i = 0; i < num_pairs; i++)
-    {
-        collocation_pair_delete(pair[i]);
-    }
-    free(pair);
+    free(is_used);
+    free(index);
 
     return -1;
 }
@@ -682,8 +902,8 @@ LIBHARP_API int harp_collocation_result_add_pair(harp_collocation_result *colloc
                                                  const char *source_product_b, long index_b, int num_differences,
                                                  const double *difference)
 {
-    harp_collocation_pair *pair;
     long product_index_a, product_index_b;
+    long index;
 
     if (num_differences != collocation_result->num_differences)
     {
@@ -713,31 +933,24 @@ LIBHARP_API int harp_collocation_result_add_pair(harp_collocation_result *colloc
     {
         return -1;
     }
-    if (collocation_pair_new(collocation_index, product_index_a, index_a, product_index_b, index_b, num_differences,
-                             difference, &pair) != 0)
-    {
-        return -1;
-    }
-
     if (collocation_result->num_pairs % COLLOCATION_RESULT_BLOCK_SIZE == 0)
     {
-        harp_collocation_pair **new_pair = NULL;
-
-        new_pair = realloc(collocation_result->pair, (collocation_result->num_pairs + COLLOCATION_RESULT_BLOCK_SIZE) *
-                           sizeof(harp_collocation_pair *));
-        if (new_pair == NULL)
+        if (collocation_result_reserve(collocation_result, collocation_result->num_pairs) != 0)
         {
-            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                           (long)(collocation_result->num_pairs + COLLOCATION_RESULT_BLOCK_SIZE) *
-                           sizeof(harp_collocation_pair *), __FILE__, __LINE__);
-            collocation_pair_delete(pair);
             return -1;
         }
-
-        collocation_result->pair = new_pair;
     }
 
-    collocation_result->pair[collocation_result->num_pairs] = pair;
+    index = collocation_result->num_pairs;
+    collocation_result->collocation_index[index] = collocation_index;
+    collocation_result->product_index_a[index] = product_index_a;
+    collocation_result->sample_index_a[index] = index_a;
+    collocation_result->product_index_b[index] = product_index_b;
+    collocation_result->sample_index_b[index] = index_b;
+    if (num_differences > 0)
+    {
+        memcpy(&collocation_result->difference[index * num_differences], difference, num_differences * sizeof(double));
+    }
     collocation_result->num_pairs++;
     return 0;
 }
@@ -760,16 +973,47 @@ LIBHARP_API int harp_collocation_result_remove_pair_at_index(harp_collocation_re
         return -1;
     }
 
-    collocation_pair_delete(collocation_result->pair[index]);
     for (i = index + 1; i < collocation_result->num_pairs; i++)
     {
-        collocation_result->pair[i - 1] = collocation_result->pair[i];
+        collocation_result_copy_pair(collocation_result, i - 1, i);
     }
     collocation_result->num_pairs--;
 
     return 0;
 }
 
+/** Retrieve a single entry of a collocation result set.
+ * The difference array of the pair points into the difference array of the collocation result set, so it is only
+ * valid until the result set is modified or deleted (it should not be freed by the caller).
+ * \param collocation_result Result set from which to retrieve the entry
+ * \param index Zero-based index in the collocation result set of the entry
+ * \param pair Pointer to the C variable where the collocation pair will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_collocation_result_get_pair(const harp_collocation_result *collocation_result, long index,
+                                                 harp_collocation_pair *pair)
+{
+    if (index < 0 || index >= collocation_result->num_pairs)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "index (%ld) is not in the range of collocation results [0,%ld)",
+                       index, collocation_result->num_pairs);
+        return -1;
+    }
+
+    pair->collocation_index = collocation_result->collocation_index[index];
+    pair->product_index_a = collocation_result->product_index_a[index];
+    pair->sample_index_a = collocation_result->sample_index_a[index];
+    pair->product_index_b = collocation_result->product_index_b[index];
+    pair->sample_index_b = collocation_result->sample_index_b[index];
+    pair->num_differences = collocation_result->num_differences;
+    pair->difference = collocation_result->num_differences > 0 ?
+        &collocation_result->difference[index * collocation_result->num_differences] : NULL;
+
+    return 0;
+}
+
 /**
  * @}
  */
@@ -1095,24 +1339,21 @@ static void write_header(FILE *file, const harp_collocation_result *collocation_
 
 static void write_pair(FILE *file, const harp_collocation_result *collocation_result, long index)
 {
-    harp_collocation_pair *pair;
     int i;
 
-    assert(collocation_result->pair != NULL);
     assert(index >= 0 && index < collocation_result->num_pairs);
-    assert(collocation_result->pair[index] != NULL);
-
-    pair = collocation_result->pair[index];
 
     /* Write filenames and measurement indices */
-    fprintf(file, "%ld,%s,%ld,%s,%ld", pair->collocation_index,
-            collocation_result->dataset_a->source_product[pair->product_index_a], pair->sample_index_a,
-            collocation_result->dataset_b->source_product[pair->product_index_b], pair->sample_index_b);
+    fprintf(file, "%ld,%s,%ld,%s,%ld", collocation_result->collocation_index[index],
+            collocation_result->dataset_a->source_product[collocation_result->product_index_a[index]],
+            collocation_result->sample_index_a[index],
+            collocation_result->dataset_b->source_product[collocation_result->product_index_b[index]],
+            collocation_result->sample_index_b[index]);
 
     /* Write differences */
-    for (i = 0; i < pair->num_differences; i++)
+    for (i = 0; i < collocation_result->num_differences; i++)
     {
-        fprintf(file, ",%.8g", pair->difference[i]);
+        fprintf(file, ",%.8g", collocation_result->difference[index * collocation_result->num_differences + i]);
     }
     fprintf(file, "\n");
 }
@@ -1169,6 +1410,79 @@ LIBHARP_API int harp_collocation_result_write(const char *collocation_result_fil
     return 0;
 }
 
+/** Append collocation pairs to a csv file
+ * The first \a num_pairs pairs of the collocation result are appended to the given csv file. If the file does not
+ * exist yet or is empty, the header is written first. This allows a collocation result to be written out
+ * incrementally (removing pairs from memory once they have been written).
+ * The file is closed after the pairs have been written, so all appended pairs are flushed to disk on return.
+ * \param collocation_result_filename Full file path to the csv file.
+ * \param collocation_result Collocation result set from which the pairs will be written.
+ * \param num_pairs Number of pairs (starting from the first pair) that should be written.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_collocation_result_append(const char *collocation_result_filename,
+                                               harp_collocation_result *collocation_result, long num_pairs)
+{
+    FILE *file;
+    long i;
+
+    if (collocation_result_filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "collocation_result_filename is NULL");
+        return -1;
+    }
+    if (collocation_result == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "collocation_result is NULL");
+        return -1;
+    }
+    if (num_pairs < 0 || num_pairs > collocation_result->num_pairs)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_pairs (%ld) is not in the range of collocation results "
+                       "[0,%ld]", num_pairs, collocation_result->num_pairs);
+        return -1;
+    }
+
+    /* Open the collocation result file */
+    file = fopen(collocation_result_filename, "a");
+    if (file == NULL)
+    {
+        harp_set_error(HARP_ERROR_FILE_OPEN, "error opening collocation result file '%s'", collocation_result_filename);
+        return -1;
+    }
+
+    /* Write the header if the file is still empty */
+    if (fseek(file, 0, SEEK_END) != 0)
+    {
+        harp_set_error(HARP_ERROR_FILE_WRITE, "error positioning in collocation result file '%s'",
+                       collocation_result_filename);
+        fclose(file);
+        return -1;
+    }
+    if (ftell(file) == 0)
+    {
+        write_header(file, collocation_result);
+    }
+
+    /* Write the matching pairs */
+    for (i = 0; i < num_pairs; i++)
+    {
+        write_pair(file, collocation_result, i);
+    }
+
+    /* Close the collocation result file */
+    if (fclose(file) != 0)
+    {
+        harp_set_error(HARP_ERROR_FILE_CLOSE, "error closing collocation result file '%s'",
+                       collocation_result_filename);
+        return -1;
+    }
+
+    return 0;
+}
+
 /** Swap the columns of this collocation result inplace.
  *
  * This swaps datasets A and B (such that A becomes B and B becomes A).
@@ -1176,13 +1490,15 @@ LIBHARP_API int harp_collocation_result_write(const char *collocation_result_fil
  */
 LIBHARP_API void harp_collocation_result_swap_datasets(harp_collocation_result *collocation_result)
 {
-    long i;
     harp_dataset *data_a;
+    long *index;
 
-    for (i = 0; i < collocation_result->num_pairs; i++)
-    {
-        collocation_pair_swap_datasets(collocation_result->pair[i]);
-    }
+    index = collocation_result->product_index_a;
+    collocation_result->product_index_a = collocation_result->product_index_b;
+    collocation_result->product_index_b = index;
+    index = collocation_result->sample_index_a;
+    collocation_result->sample_index_a = collocation_result->sample_index_b;
+    collocation_result->sample_index_b = index;
 
     data_a = collocation_result->dataset_a;
 
@@ -1199,7 +1515,7 @@ int harp_collocation_result_shallow_copy(const harp_collocation_result *collocat
                                          harp_collocation_result **new_result)
 {
     harp_collocation_result *result = NULL;
-    long i;
+    long num_pairs = collocation_result->num_pairs;
 
     /* allocate memory for the result struct */
     result = (harp_collocation_result *)malloc(sizeof(harp_collocation_result));
@@ -1214,34 +1530,33 @@ int harp_collocation_result_shallow_copy(const harp_collocation_result *collocat
     result->num_differences = collocation_result->num_differences;
     result->difference_variable_name = collocation_result->difference_variable_name;
     result->difference_unit = collocation_result->difference_unit;
-    result->num_pairs = collocation_result->num_pairs;
-    result->pair = NULL;
+    result->num_pairs = 0;
+    result->collocation_index = NULL;
+    result->product_index_a = NULL;
+    result->sample_index_a = NULL;
+    result->product_index_b = NULL;
+    result->sample_index_b = NULL;
+    result->difference = NULL;
 
-    result->pair = malloc(collocation_result->num_pairs * sizeof(harp_collocation_pair *));
-    if (result->pair == NULL)
+    if (collocation_result_reserve(result, num_pairs) != 0)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       collocation_result->num_pairs * sizeof(harp_collocation_pair *), __FILE__, __LINE__);
         harp_collocation_result_shallow_delete(result);
         return -1;
     }
-    for (i = 0; i < collocation_result->num_pairs; i++)
-    {
-        result->pair[i] = NULL;
-    }
-
-    for (i = 0; i < collocation_result->num_pairs; i++)
+    if (num_pairs > 0)
     {
-        harp_collocation_pair *pair = collocation_result->pair[i];
-
-        if (collocation_pair_new(pair->collocation_index, pair->product_index_a, pair->sample_index_a,
-                                 pair->product_index_b, pair->sample_index_b, pair->num_differences, pair->difference,
-                                 &result->pair[i]) != 0)
+        memcpy(result->collocation_index, collocation_result->collocation_index, num_pairs * sizeof(long));
+        memcpy(result->product_index_a, collocation_result->product_index_a, num_pairs * sizeof(long));
+        memcpy(result->sample_index_a, collocation_result->sample_index_a, num_pairs * sizeof(long));
+        memcpy(result->product_index_b, collocation_result->product_index_b, num_pairs * sizeof(long));
+        memcpy(result->sample_index_b, collocation_result->sample_index_b, num_pairs * sizeof(long));
+        if (result->num_differences > 0)
         {
-            harp_collocation_result_shallow_delete(result);
-            return -1;
+            memcpy(result->difference, collocation_result->difference,
+                   num_pairs * result->num_differences * sizeof(double));
         }
     }
+    result->num_pairs = num_pairs;
 
     *new_result = result;
 
@@ -1252,18 +1567,7 @@ void harp_collocation_result_shallow_delete(harp_collocation_result *collocation
 {
     if (collocation_result != NULL)
     {
-        if (collocation_result->pair != NULL)
-        {
-            long i;
-
-            for (i = 0; i < collocation_result->num_pairs; i++)
-            {
-                collocation_pair_delete(collocation_result->pair[i]);
-            }
-
-            free(collocation_result->pair);
-        }
-
+        collocation_result_free_pairs(collocation_result);
         free(collocation_result);
     }
 }
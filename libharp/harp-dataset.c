@@ -30,6 +30,8 @@
  */
 
 #include "harp-internal.h"
+#include "harp-area-mask.h"
+#include "harp-geometry.h"
 #include "harp-program.h"
 #include "harp-csv.h"
 #include "hashtable.h"
@@ -40,6 +42,7 @@
 #include <sys/stat.h>
 #include <assert.h>
 #include <errno.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -49,8 +52,21 @@
 
 #ifdef WIN32
 #include "windows.h"
+#include <process.h>
+#define getpid _getpid
+#else
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
 #endif
 
+/* Name of the file in which the metadata of the products in a directory is cached (see
+ * harp_set_option_metadata_cache()). Since the name starts with a '.' it is never considered to be a product itself.
+ */
+#define METADATA_CACHE_FILENAME ".harp_metadata_cache.csv"
+#define METADATA_CACHE_HEADER "name,size,mtime,format,datetime_start,datetime_stop,time,latitude,longitude,vertical," \
+    "spectral,source_product,latitude_min,latitude_max,longitude_min,longitude_max"
+
 /** \defgroup harp_dataset HARP harp_dataset
  * The HARP harp_dataset module contains everything regarding HARP datasets.
  *
@@ -90,6 +106,30 @@ static int is_directory(const char *directoryname)
     return 0;
 }
 
+/* parse a floating point csv element that may be empty (in which case the value is set to NaN) */
+static int parse_optional_double(char **line, double *value)
+{
+    char *string = NULL;
+
+    if (harp_csv_parse_string(line, &string) != 0)
+    {
+        return -1;
+    }
+    if (string[0] == '\0')
+    {
+        *value = harp_nan();
+        return 0;
+    }
+    if (sscanf(string, "%lf", value) != 1)
+    {
+        harp_set_error(HARP_ERROR_INVALID_FORMAT, "could not parse floating point value from csv element '%s'",
+                       string);
+        return -1;
+    }
+
+    return 0;
+}
+
 static int parse_metadata_from_csv_line(char *line, harp_product_metadata *metadata)
 {
     char *string = NULL;
@@ -188,6 +228,18 @@ static int parse_metadata_from_csv_line(char *line, harp_product_metadata *metad
         return -1;
     }
 
+    /* bounding box (optional, since older dataset csv files do not have these columns) */
+    if (*line != '\0')
+    {
+        if (parse_optional_double(&line, &metadata->latitude_min) != 0 ||
+            parse_optional_double(&line, &metadata->latitude_max) != 0 ||
+            parse_optional_double(&line, &metadata->longitude_min) != 0 ||
+            parse_optional_double(&line, &metadata->longitude_max) != 0)
+        {
+            return -1;
+        }
+    }
+
     return 0;
 }
 
@@ -302,7 +354,142 @@ static int add_path_file(harp_dataset *dataset, const char *filename, const char
     return 0;
 }
 
-static int add_directory(harp_dataset *dataset, const char *pathname, const char *options)
+/* An entry of a directory that is added to a dataset, or an entry of the metadata cache of that directory */
+typedef struct directory_entry_struct
+{
+    char *name;
+    char *path;
+    int is_product;     /* 0 for subdirectories and .pth files, which are added using harp_dataset_import() */
+    long size;
+    long mtime;
+    harp_product_metadata *metadata;
+} directory_entry;
+
+typedef struct directory_entry_list_struct
+{
+    long num_entries;
+    directory_entry *entry;
+    hashtable *name_to_index;
+} directory_entry_list;
+
+static void directory_entry_list_delete(directory_entry_list *list)
+{
+    long i;
+
+    if (list->entry != NULL)
+    {
+        for (i = 0; i < list->num_entries; i++)
+        {
+            if (list->entry[i].name != NULL)
+            {
+                free(list->entry[i].name);
+            }
+            if (list->entry[i].path != NULL)
+            {
+                free(list->entry[i].path);
+            }
+            if (list->entry[i].metadata != NULL)
+            {
+                harp_product_metadata_delete(list->entry[i].metadata);
+            }
+        }
+        free(list->entry);
+    }
+    if (list->name_to_index != NULL)
+    {
+        hashtable_delete(list->name_to_index);
+    }
+    free(list);
+}
+
+static int directory_entry_list_new(directory_entry_list **new_list)
+{
+    directory_entry_list *list;
+
+    list = (directory_entry_list *)malloc(sizeof(directory_entry_list));
+    if (list == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(directory_entry_list), __FILE__, __LINE__);
+        return -1;
+    }
+    list->num_entries = 0;
+    list->entry = NULL;
+    list->name_to_index = hashtable_new(1);
+    if (list->name_to_index == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not create hashtable) (%s:%u)", __FILE__,
+                       __LINE__);
+        free(list);
+        return -1;
+    }
+
+    *new_list = list;
+
+    return 0;
+}
+
+/* Add an entry with the given name; the full path of the entry is only set if pathname is not NULL */
+static int directory_entry_list_add(directory_entry_list *list, const char *pathname, const char *name)
+{
+    directory_entry *entry;
+
+    if (list->num_entries % BLOCK_SIZE == 0)
+    {
+        directory_entry *new_entry;
+
+        new_entry = realloc(list->entry, (list->num_entries + BLOCK_SIZE) * sizeof(directory_entry));
+        if (new_entry == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (list->num_entries + BLOCK_SIZE) * sizeof(directory_entry), __FILE__, __LINE__);
+            return -1;
+        }
+        list->entry = new_entry;
+    }
+
+    entry = &list->entry[list->num_entries];
+    entry->name = NULL;
+    entry->path = NULL;
+    entry->is_product = 0;
+    entry->size = 0;
+    entry->mtime = 0;
+    entry->metadata = NULL;
+    list->num_entries++;
+
+    entry->name = strdup(name);
+    if (entry->name == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        return -1;
+    }
+    if (pathname != NULL)
+    {
+        entry->path = malloc(strlen(pathname) + 1 + strlen(name) + 1);
+        if (entry->path == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)strlen(pathname) + 1 + strlen(name) + 1, __FILE__, __LINE__);
+            return -1;
+        }
+#ifdef WIN32
+        sprintf(entry->path, "%s\\%s", pathname, name);
+#else
+        sprintf(entry->path, "%s/%s", pathname, name);
+#endif
+    }
+
+    /* names are unique within a directory; a name that is already present will not be found via the hashtable */
+    hashtable_add_name(list->name_to_index, entry->name);
+
+    return 0;
+}
+
+/* Collect the entries of a directory (in the order in which the system provides them).
+ * Entries whose name start with a '.' are skipped, since harp_dataset_import() ignores them anyway.
+ */
+static int read_directory(const char *pathname, directory_entry_list *list)
 {
 #ifdef WIN32
     WIN32_FIND_DATA FileData;
@@ -335,26 +522,13 @@ static int add_directory(harp_dataset *dataset, const char *pathname, const char
     fFinished = FALSE;
     while (!fFinished)
     {
-        if (!(FileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        if (!(FileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && FileData.cFileName[0] != '.')
         {
-            char *filepath;
-
-            filepath = malloc(strlen(pathname) + 1 + strlen(FileData.cFileName) + 1);
-            if (filepath == NULL)
+            if (directory_entry_list_add(list, pathname, FileData.cFileName) != 0)
             {
-                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                               (long)strlen(pathname) + 1 + strlen(FileData.cFileName) + 1, __FILE__, __LINE__);
                 FindClose(hSearch);
                 return -1;
             }
-            sprintf(filepath, "%s\\%s", pathname, FileData.cFileName);
-            if (harp_dataset_import(dataset, filepath, options) != 0)
-            {
-                free(filepath);
-                FindClose(hSearch);
-                return -1;
-            }
-            free(filepath);
         }
 
         if (!FindNextFile(hSearch, &FileData))
@@ -385,39 +559,448 @@ static int add_directory(harp_dataset *dataset, const char *pathname, const char
         return -1;
     }
 
-    /* Walk through files in directory and add filenames to dataset */
+    /* Walk through files in directory and add filenames to the list */
     while ((dp = readdir(dirp)) != NULL)
     {
-        char *filepath = NULL;
-
-        /* Skip '.' and '..' */
-        if (strcmp(dp->d_name, ".") == 0 || strcmp(dp->d_name, "..") == 0)
+        /* Skip '.', '..', and hidden files */
+        if (dp->d_name[0] == '.')
         {
             continue;
         }
 
-        /* Add path before filename */
-        filepath = malloc(strlen(pathname) + 1 + strlen(dp->d_name) + 1);
-        if (filepath == NULL)
+        if (directory_entry_list_add(list, pathname, dp->d_name) != 0)
         {
-            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                           (long)strlen(pathname) + 1 + strlen(dp->d_name) + 1, __FILE__, __LINE__);
             closedir(dirp);
             return -1;
         }
-        sprintf(filepath, "%s/%s", pathname, dp->d_name);
+    }
+
+    closedir(dirp);
+#endif
+
+    return 0;
+}
+
+static char *get_metadata_cache_filename(const char *pathname)
+{
+    char *filename;
+
+    filename = malloc(strlen(pathname) + 1 + strlen(METADATA_CACHE_FILENAME) + 1);
+    if (filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)strlen(pathname) + 1 + strlen(METADATA_CACHE_FILENAME) + 1, __FILE__, __LINE__);
+        return NULL;
+    }
+#ifdef WIN32
+    sprintf(filename, "%s\\%s", pathname, METADATA_CACHE_FILENAME);
+#else
+    sprintf(filename, "%s/%s", pathname, METADATA_CACHE_FILENAME);
+#endif
+
+    return filename;
+}
+
+static int parse_metadata_cache_line(char *line, directory_entry_list *cache)
+{
+    harp_product_metadata *metadata;
+    directory_entry *entry;
+    char *string = NULL;
+    int i;
+
+    if (harp_csv_parse_string(&line, &string) != 0)
+    {
+        return -1;
+    }
+    if (directory_entry_list_add(cache, NULL, string) != 0)
+    {
+        return -1;
+    }
+    entry = &cache->entry[cache->num_entries - 1];
+    if (harp_csv_parse_long(&line, &entry->size) != 0 || harp_csv_parse_long(&line, &entry->mtime) != 0)
+    {
+        return -1;
+    }
+
+    if (harp_product_metadata_new(&entry->metadata) != 0)
+    {
+        return -1;
+    }
+    metadata = entry->metadata;
+    if (harp_csv_parse_string(&line, &string) != 0)
+    {
+        return -1;
+    }
+    metadata->format = strdup(string);
+    if (metadata->format == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        return -1;
+    }
+    if (harp_csv_parse_double(&line, &metadata->datetime_start) != 0 ||
+        harp_csv_parse_double(&line, &metadata->datetime_stop) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < HARP_NUM_DIM_TYPES; i++)
+    {
+        if (harp_csv_parse_long(&line, &metadata->dimension[i]) != 0)
+        {
+            return -1;
+        }
+    }
+    if (harp_csv_parse_string(&line, &string) != 0)
+    {
+        return -1;
+    }
+    metadata->source_product = strdup(string);
+    if (metadata->source_product == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        return -1;
+    }
+    if (harp_csv_parse_double(&line, &metadata->latitude_min) != 0 ||
+        harp_csv_parse_double(&line, &metadata->latitude_max) != 0 ||
+        harp_csv_parse_double(&line, &metadata->longitude_min) != 0 ||
+        harp_csv_parse_double(&line, &metadata->longitude_max) != 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Read a line without the trailing newline; returns 0 on success and -1 at the end of the file or for an incomplete
+ * (or too long) line.
+ */
+static int read_metadata_cache_line(FILE *stream, char *line)
+{
+    long length;
 
-        if (harp_dataset_import(dataset, filepath, options) != 0)
+    if (fgets(line, HARP_CSV_LINE_LENGTH + 1, stream) == NULL)
+    {
+        return -1;
+    }
+    length = (long)strlen(line);
+    if (length == 0 || line[length - 1] != '\n')
+    {
+        return -1;
+    }
+    line[length - 1] = '\0';
+
+    return 0;
+}
+
+/* Read the metadata cache of a directory.
+ * The cache is only used if it was created with the same ingestion options. A cache that is missing, outdated, or
+ * that cannot be parsed results in an empty list (with *is_valid set to 0), since the cache is only an optimization.
+ */
+static int read_metadata_cache(const char *pathname, const char *options, directory_entry_list **new_cache,
+                               int *is_valid)
+{
+    char line[HARP_CSV_LINE_LENGTH + 1];
+    directory_entry_list *cache = NULL;
+    char *filename;
+    FILE *stream;
+    int valid = 0;
+
+    if (directory_entry_list_new(&cache) != 0)
+    {
+        return -1;
+    }
+
+    filename = get_metadata_cache_filename(pathname);
+    if (filename == NULL)
+    {
+        directory_entry_list_delete(cache);
+        return -1;
+    }
+    stream = fopen(filename, "r");
+    free(filename);
+
+    /* the first line contains the HARP version that wrote the cache, the second line the ingestion options, and the
+     * third line the column names; the cache is ignored if any of these differ (the metadata that ingestion modules
+     * provide can change between HARP versions) */
+    if (stream != NULL && read_metadata_cache_line(stream, line) == 0 && strncmp(line, "harp=", 5) == 0 &&
+        strcmp(&line[5], libharp_version) == 0 && read_metadata_cache_line(stream, line) == 0 &&
+        strncmp(line, "options=", 8) == 0 && strcmp(&line[8], options == NULL ? "" : options) == 0 &&
+        read_metadata_cache_line(stream, line) == 0 && strcmp(line, METADATA_CACHE_HEADER) == 0)
+    {
+        valid = 1;
+        while (valid && read_metadata_cache_line(stream, line) == 0)
+        {
+            if (parse_metadata_cache_line(line, cache) != 0)
+            {
+                if (harp_errno == HARP_ERROR_OUT_OF_MEMORY)
+                {
+                    fclose(stream);
+                    directory_entry_list_delete(cache);
+                    return -1;
+                }
+                valid = 0;
+            }
+        }
+        if (!feof(stream))
+        {
+            valid = 0;
+        }
+    }
+    if (stream != NULL)
+    {
+        fclose(stream);
+    }
+
+    if (!valid)
+    {
+        directory_entry_list_delete(cache);
+        if (directory_entry_list_new(&cache) != 0)
         {
-            free(filepath);
-            closedir(dirp);
             return -1;
         }
-        free(filepath);
     }
 
-    closedir(dirp);
-#endif
+    *new_cache = cache;
+    *is_valid = valid;
+
+    return 0;
+}
+
+static void print_metadata_cache_string(FILE *stream, const char *string)
+{
+    if (strchr(string, ',') != NULL)
+    {
+        fprintf(stream, "\"%s\",", string);
+    }
+    else
+    {
+        fprintf(stream, "%s,", string);
+    }
+}
+
+/* Failures to write a metadata cache are only reported once per process. Otherwise every import of a read-only
+ * directory would give the same warning again.
+ */
+static void report_metadata_cache_failure(const char *pathname, const char *reason)
+{
+    static int reported = 0;
+
+    if (!reported)
+    {
+        reported = 1;
+        harp_report_warning("could not write metadata cache for %s (%s); further failures to write a metadata cache "
+                            "will not be reported", pathname, reason);
+    }
+}
+
+/* Store the metadata of all products of a directory in its metadata cache.
+ * The cache is first written under a process specific name and then renamed, so concurrent imports of the same
+ * directory never see a partially written cache. Failures are reported as a warning.
+ */
+static void write_metadata_cache(const char *pathname, const char *options, const directory_entry_list *list)
+{
+    char *tmp_filename;
+    char *filename;
+    FILE *stream;
+    long i;
+    int j;
+
+    filename = get_metadata_cache_filename(pathname);
+    if (filename == NULL)
+    {
+        report_metadata_cache_failure(pathname, harp_errno_to_string(harp_errno));
+        return;
+    }
+    tmp_filename = malloc(strlen(filename) + 32);
+    if (tmp_filename == NULL)
+    {
+        report_metadata_cache_failure(pathname, "out of memory");
+        free(filename);
+        return;
+    }
+    sprintf(tmp_filename, "%s.%ld.tmp", filename, (long)getpid());
+
+    stream = fopen(tmp_filename, "w");
+    if (stream == NULL)
+    {
+        report_metadata_cache_failure(pathname, "could not create file");
+        free(tmp_filename);
+        free(filename);
+        return;
+    }
+    fprintf(stream, "harp=%s\n", libharp_version);
+    fprintf(stream, "options=%s\n", options == NULL ? "" : options);
+    fprintf(stream, "%s\n", METADATA_CACHE_HEADER);
+    for (i = 0; i < list->num_entries; i++)
+    {
+        const harp_product_metadata *metadata = list->entry[i].metadata;
+
+        if (metadata == NULL || strchr(list->entry[i].name, '"') != NULL)
+        {
+            continue;
+        }
+        print_metadata_cache_string(stream, list->entry[i].name);
+        fprintf(stream, "%ld,%ld,", list->entry[i].size, list->entry[i].mtime);
+        print_metadata_cache_string(stream, metadata->format == NULL ? "" : metadata->format);
+        fprintf(stream, "%.17g,%.17g,", metadata->datetime_start, metadata->datetime_stop);
+        for (j = 0; j < HARP_NUM_DIM_TYPES; j++)
+        {
+            fprintf(stream, "%ld,", metadata->dimension[j]);
+        }
+        print_metadata_cache_string(stream, metadata->source_product);
+        fprintf(stream, "%.17g,%.17g,%.17g,%.17g\n", metadata->latitude_min, metadata->latitude_max,
+                metadata->longitude_min, metadata->longitude_max);
+    }
+    if (fclose(stream) != 0)
+    {
+        report_metadata_cache_failure(pathname, "could not write file");
+        remove(tmp_filename);
+    }
+    else if (rename(tmp_filename, filename) != 0)
+    {
+        report_metadata_cache_failure(pathname, "could not rename file");
+        remove(tmp_filename);
+    }
+
+    free(tmp_filename);
+    free(filename);
+}
+
+/* Retrieve the metadata for a directory entry, either from the metadata cache or from the file itself.
+ * Returns 1 if the metadata was taken from the cache, 0 if not, and -1 on error.
+ */
+static int import_directory_entry(directory_entry *entry, directory_entry_list *cache, const char *options)
+{
+    struct stat statbuf;
+    long length;
+
+    if (stat(entry->path, &statbuf) != 0)
+    {
+        harp_set_error(HARP_ERROR_FILE_OPEN, "could not open '%s' (%s)", entry->path, strerror(errno));
+        return -1;
+    }
+    length = (long)strlen(entry->name);
+    if ((statbuf.st_mode & S_IFDIR) || (length > 4 && strcmp(&entry->name[length - 4], ".pth") == 0))
+    {
+        /* will be added using harp_dataset_import() */
+        return 0;
+    }
+    entry->is_product = 1;
+    entry->size = (long)statbuf.st_size;
+    entry->mtime = (long)statbuf.st_mtime;
+
+    if (cache != NULL)
+    {
+        long index;
+
+        index = hashtable_get_index_from_name(cache->name_to_index, entry->name);
+        if (index >= 0 && cache->entry[index].size == entry->size && cache->entry[index].mtime == entry->mtime)
+        {
+            entry->metadata = cache->entry[index].metadata;
+            cache->entry[index].metadata = NULL;
+            entry->metadata->filename = strdup(entry->path);
+            if (entry->metadata->filename == NULL)
+            {
+                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)",
+                               __FILE__, __LINE__);
+                return -1;
+            }
+            return 1;
+        }
+    }
+
+    return harp_import_product_metadata(entry->path, options, &entry->metadata);
+}
+
+/* Add the contents of a directory to a dataset.
+ * The metadata of all products is retrieved first, after which the products are added to the dataset in directory
+ * order. With the metadata cache option enabled, the metadata of files that did not change since the previous import
+ * (same name, size, and modification time) is taken from the cache instead of from the file.
+ * Retrieving the metadata is not done in parallel, since the file readers (CODA, netCDF, HDF4/HDF5) are not
+ * thread-safe.
+ */
+static int add_directory(harp_dataset *dataset, const char *pathname, const char *options)
+{
+    directory_entry_list *list = NULL;
+    directory_entry_list *cache = NULL;
+    int cache_is_valid = 0;
+    long num_cache_hits = 0;
+    long i;
+
+    if (directory_entry_list_new(&list) != 0)
+    {
+        return -1;
+    }
+    if (read_directory(pathname, list) != 0)
+    {
+        directory_entry_list_delete(list);
+        return -1;
+    }
+    if (harp_get_option_metadata_cache())
+    {
+        if (read_metadata_cache(pathname, options, &cache, &cache_is_valid) != 0)
+        {
+            directory_entry_list_delete(list);
+            return -1;
+        }
+    }
+
+    for (i = 0; i < list->num_entries; i++)
+    {
+        int result;
+
+        result = import_directory_entry(&list->entry[i], cache, options);
+        if (result < 0)
+        {
+            if (cache != NULL)
+            {
+                directory_entry_list_delete(cache);
+            }
+            directory_entry_list_delete(list);
+            return -1;
+        }
+        num_cache_hits += result;
+    }
+
+    if (cache != NULL)
+    {
+        long num_products = 0;
+
+        /* only rewrite the cache if products were added, changed, or removed */
+        for (i = 0; i < list->num_entries; i++)
+        {
+            num_products += list->entry[i].is_product;
+        }
+        if (!cache_is_valid || num_cache_hits != cache->num_entries || num_cache_hits != num_products)
+        {
+            write_metadata_cache(pathname, options, list);
+        }
+        directory_entry_list_delete(cache);
+    }
+
+    for (i = 0; i < list->num_entries; i++)
+    {
+        directory_entry *entry = &list->entry[i];
+
+        if (entry->is_product)
+        {
+            if (harp_dataset_add_product(dataset, entry->metadata->source_product, entry->metadata) != 0)
+            {
+                directory_entry_list_delete(list);
+                return -1;
+            }
+            /* ownership of the metadata was transferred to the dataset */
+            entry->metadata = NULL;
+        }
+        else if (harp_dataset_import(dataset, entry->path, options) != 0)
+        {
+            directory_entry_list_delete(list);
+            return -1;
+        }
+    }
+
+    directory_entry_list_delete(list);
 
     return 0;
 }
@@ -518,7 +1101,8 @@ LIBHARP_API void harp_dataset_print(harp_dataset *dataset, int (*print)(const ch
 {
     long i;
 
-    print("filename,datetime_start,datetime_stop,time,latitude,longitude,vertical,spectral,source_product\n");
+    print("filename,datetime_start,datetime_stop,time,latitude,longitude,vertical,spectral,source_product,"
+          "latitude_min,latitude_max,longitude_min,longitude_max\n");
     for (i = 0; i < dataset->num_products; i++)
     {
         if (dataset->metadata[i] != NULL)
@@ -527,7 +1111,7 @@ LIBHARP_API void harp_dataset_print(harp_dataset *dataset, int (*print)(const ch
         }
         else
         {
-            print(",,,,,,,,%s\n", dataset->source_product[i]);
+            print(",,,,,,,,%s,,,,\n", dataset->source_product[i]);
         }
     }
 }
@@ -697,17 +1281,24 @@ LIBHARP_API int harp_dataset_add_product(harp_dataset *dataset, const char *sour
             }
         }
 
-        /* add newly appended item into the list of sorted indices */
+        /* add newly appended item into the list of sorted indices (using a binary search for its position) */
         index = 0;
-        while (index < dataset->num_products &&
-               strcmp(source_product, dataset->source_product[dataset->sorted_index[index]]) > 0)
-        {
-            index++;
-        }
-        for (i = dataset->num_products; i > index; i--)
+        i = dataset->num_products;
+        while (index < i)
         {
-            dataset->sorted_index[i] = dataset->sorted_index[i - 1];
+            long middle = (index + i) / 2;
+
+            if (strcmp(source_product, dataset->source_product[dataset->sorted_index[middle]]) > 0)
+            {
+                index = middle + 1;
+            }
+            else
+            {
+                i = middle;
+            }
         }
+        memmove(&dataset->sorted_index[index + 1], &dataset->sorted_index[index],
+                (dataset->num_products - index) * sizeof(long));
         dataset->sorted_index[index] = dataset->num_products;
 
         dataset->num_products++;
@@ -831,18 +1422,27 @@ int harp_dataset_filter(harp_dataset *dataset, uint8_t *mask)
     return 0;
 }
 
+static int has_bounding_box(const harp_product_metadata *metadata)
+{
+    return metadata != NULL && !harp_isnan(metadata->latitude_min) && !harp_isnan(metadata->latitude_max) &&
+        !harp_isnan(metadata->longitude_min) && !harp_isnan(metadata->longitude_max);
+}
+
 static int prefilter_comparison(harp_dataset *dataset, uint8_t *mask, harp_operation_comparison_filter *operation)
 {
+    int is_latitude;
     long i;
 
+    is_latitude = strcmp(operation->variable_name, "latitude") == 0;
     if (strcmp(operation->variable_name, "datetime") != 0 && strcmp(operation->variable_name, "datetime_start") != 0 &&
-        strcmp(operation->variable_name, "datetime_stop") != 0)
+        strcmp(operation->variable_name, "datetime_stop") != 0 && !is_latitude)
     {
         /* not a variable we can pre-filter on */
         return 0;
     }
 
-    if (harp_operation_set_value_unit((harp_operation *)operation, "days since 2000-01-01") != 0)
+    if (harp_operation_set_value_unit((harp_operation *)operation,
+                                      is_latitude ? "degree_north" : "days since 2000-01-01") != 0)
     {
         return -1;
     }
@@ -850,45 +1450,64 @@ static int prefilter_comparison(harp_dataset *dataset, uint8_t *mask, harp_opera
     {
         if (mask[i] && dataset->metadata[i] != NULL)
         {
-            double datetime_start = harp_unit_converter_convert_double(operation->unit_converter,
-                                                                       dataset->metadata[i]->datetime_start);
-            double datetime_stop = harp_unit_converter_convert_double(operation->unit_converter,
-                                                                      dataset->metadata[i]->datetime_stop);
+            double minimum;
+            double maximum;
+
+            /* the range of values in the product is the datetime range or the latitude range of the bounding box */
+            if (is_latitude)
+            {
+                if (!has_bounding_box(dataset->metadata[i]))
+                {
+                    continue;
+                }
+                minimum = dataset->metadata[i]->latitude_min;
+                maximum = dataset->metadata[i]->latitude_max;
+            }
+            else
+            {
+                minimum = dataset->metadata[i]->datetime_start;
+                maximum = dataset->metadata[i]->datetime_stop;
+            }
+            if (operation->unit_converter != NULL)
+            {
+                minimum = harp_unit_converter_convert_double(operation->unit_converter, minimum);
+                maximum = harp_unit_converter_convert_double(operation->unit_converter, maximum);
+            }
 
             switch (operation->operator_type)
             {
                 case operator_eq:
-                    if (datetime_stop < operation->value || datetime_start > operation->value)
+                    if (maximum < operation->value || minimum > operation->value)
                     {
                         mask[i] = 0;
                     }
                     break;
                 case operator_ne:
-                    if (datetime_start == operation->value && datetime_stop == operation->value)
+                    if (minimum == operation->value && maximum == operation->value)
                     {
                         mask[i] = 0;
                     }
                     break;
                 case operator_lt:
-                    if (datetime_start >= operation->value)
+                    if (minimum >= operation->value)
                     {
                         mask[i] = 0;
                     }
                     break;
                 case operator_le:
-                    if (datetime_start > operation->value)
+                    if (minimum > operation->value)
                     {
                         mask[i] = 0;
                     }
                     break;
                 case operator_gt:
-                    if (datetime_stop <= operation->value)
+                    if (maximum <= operation->value)
                     {
                         mask[i] = 0;
                     }
                     break;
                 case operator_ge:
-                    if (datetime_stop < operation->value)
+                    if (maximum < operation->value)
                     {
                         mask[i] = 0;
                     }
@@ -900,6 +1519,165 @@ static int prefilter_comparison(harp_dataset *dataset, uint8_t *mask, harp_opera
     return 0;
 }
 
+/* mask out all products whose bounding box does not overlap with the given box */
+static void prefilter_bounding_box(harp_dataset *dataset, uint8_t *mask, double latitude_min, double latitude_max,
+                                   double longitude_min, double longitude_max)
+{
+    long i;
+
+    for (i = 0; i < dataset->num_products; i++)
+    {
+        if (mask[i] && has_bounding_box(dataset->metadata[i]))
+        {
+            if (dataset->metadata[i]->latitude_min > latitude_max ||
+                dataset->metadata[i]->latitude_max < latitude_min ||
+                !harp_geographic_longitude_ranges_overlap(dataset->metadata[i]->longitude_min,
+                                                          dataset->metadata[i]->longitude_max, longitude_min,
+                                                          longitude_max))
+            {
+                mask[i] = 0;
+            }
+        }
+    }
+}
+
+static int prefilter_longitude_range(harp_dataset *dataset, uint8_t *mask,
+                                     harp_operation_longitude_range_filter *operation)
+{
+    if (operation->max - operation->min >= 360.0)
+    {
+        /* all longitudes are included */
+        return 0;
+    }
+    prefilter_bounding_box(dataset, mask, -90.0, 90.0, operation->min, operation->max);
+
+    return 0;
+}
+
+static int prefilter_point_distance(harp_dataset *dataset, uint8_t *mask,
+                                    harp_operation_point_distance_filter *operation)
+{
+    double latitude = operation->point.lat * CONST_RAD2DEG;
+    double longitude = operation->point.lon * CONST_RAD2DEG;
+    double radius = operation->distance / CONST_EARTH_RADIUS_WGS84_SPHERE;      /* angular radius in [rad] */
+    double delta_longitude;
+
+    if (radius >= M_PI)
+    {
+        /* the filter includes the whole globe */
+        return 0;
+    }
+
+    /* determine the bounding box of the spherical cap around the point */
+    if (latitude + radius * CONST_RAD2DEG >= 90.0 || latitude - radius * CONST_RAD2DEG <= -90.0)
+    {
+        /* the cap contains a pole */
+        prefilter_bounding_box(dataset, mask, latitude - radius * CONST_RAD2DEG, latitude + radius * CONST_RAD2DEG,
+                               -180.0, 180.0);
+        return 0;
+    }
+    delta_longitude = asin(sin(radius) / cos(latitude * CONST_DEG2RAD)) * CONST_RAD2DEG;
+    prefilter_bounding_box(dataset, mask, latitude - radius * CONST_RAD2DEG, latitude + radius * CONST_RAD2DEG,
+                           longitude - delta_longitude, longitude + delta_longitude);
+
+    return 0;
+}
+
+/* mask out all products whose bounding box does not overlap with the bounding box of any of the polygons */
+static int prefilter_area_mask(harp_dataset *dataset, uint8_t *mask, const harp_area_mask *area_mask)
+{
+    uint8_t *overlaps;
+    double *latitude = NULL;
+    double *longitude = NULL;
+    long i, j;
+
+    overlaps = calloc(dataset->num_products, 1);
+    if (overlaps == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %ld bytes) (%s:%u)",
+                       dataset->num_products, __FILE__, __LINE__);
+        return -1;
+    }
+
+    for (i = 0; i < area_mask->num_polygons; i++)
+    {
+        const harp_spherical_polygon *polygon = area_mask->polygon[i];
+        harp_geographic_extent extent;
+        double latitude_min, latitude_max;
+        double longitude_min, longitude_max;
+        double *new_latitude;
+        double *new_longitude;
+
+        new_latitude = realloc(latitude, polygon->numberofpoints * sizeof(double));
+        if (new_latitude == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           polygon->numberofpoints * sizeof(double), __FILE__, __LINE__);
+            break;
+        }
+        latitude = new_latitude;
+        new_longitude = realloc(longitude, polygon->numberofpoints * sizeof(double));
+        if (new_longitude == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           polygon->numberofpoints * sizeof(double), __FILE__, __LINE__);
+            break;
+        }
+        longitude = new_longitude;
+
+        for (j = 0; j < polygon->numberofpoints; j++)
+        {
+            latitude[j] = polygon->point[j].lat * CONST_RAD2DEG;
+            longitude[j] = polygon->point[j].lon * CONST_RAD2DEG;
+        }
+        harp_geographic_extent_init(&extent);
+        harp_geographic_extent_add_polygon(&extent, polygon->numberofpoints, latitude, longitude);
+        if (harp_geographic_extent_get_range(&extent, &latitude_min, &latitude_max, &longitude_min, &longitude_max)
+            != 0)
+        {
+            /* an empty polygon does not overlap with any product */
+            continue;
+        }
+
+        for (j = 0; j < dataset->num_products; j++)
+        {
+            if (!has_bounding_box(dataset->metadata[j]) ||
+                (dataset->metadata[j]->latitude_min <= latitude_max &&
+                 dataset->metadata[j]->latitude_max >= latitude_min &&
+                 harp_geographic_longitude_ranges_overlap(dataset->metadata[j]->longitude_min,
+                                                          dataset->metadata[j]->longitude_max, longitude_min,
+                                                          longitude_max)))
+            {
+                overlaps[j] = 1;
+            }
+        }
+    }
+    if (latitude != NULL)
+    {
+        free(latitude);
+    }
+    if (longitude != NULL)
+    {
+        free(longitude);
+    }
+    if (i < area_mask->num_polygons)
+    {
+        free(overlaps);
+        return -1;
+    }
+
+    for (i = 0; i < dataset->num_products; i++)
+    {
+        if (!overlaps[i])
+        {
+            mask[i] = 0;
+        }
+    }
+    free(overlaps);
+
+    return 0;
+}
+
 static int match_collocation_line(char *line, harp_operation_collocation_filter *operation, harp_dataset *dataset,
                                   uint8_t *available)
 {
@@ -1052,16 +1830,37 @@ static int prefilter_collocation(harp_dataset *dataset, uint8_t *mask, harp_oper
     return 0;
 }
 
+static const harp_area_mask *get_area_mask(const harp_operation *operation)
+{
+    switch (operation->type)
+    {
+        case operation_area_covers_area_filter:
+            return ((const harp_operation_area_covers_area_filter *)operation)->area_mask;
+        case operation_area_inside_area_filter:
+            return ((const harp_operation_area_inside_area_filter *)operation)->area_mask;
+        case operation_area_intersects_area_filter:
+            return ((const harp_operation_area_intersects_area_filter *)operation)->area_mask;
+        case operation_point_in_area_filter:
+            return ((const harp_operation_point_in_area_filter *)operation)->area_mask;
+        default:
+            assert(0);
+            exit(1);
+    }
+}
+
 /** \addtogroup harp_dataset
  * @{
  */
 
 /** Filter products in dataset based on operations.
  * Remove any entries from the dataset that can already be discarded based on filters at the start of the operations
- * string. This includes comparisons against datetime/datetime_start/datetime_stop and collocate_left/collocate_right
- * operations.
+ * string. This includes comparisons against datetime/datetime_start/datetime_stop/latitude, longitude_range,
+ * point_distance, area_covers_area, area_covers_point, area_inside_area, area_intersects_area, point_in_area, and
+ * collocate_left/collocate_right operations.
  * The filters will be matched against the metadata in the dataset. The datatime_start and datetime_stop attributes
- * will be used for the datetime filters and the source_product attribute for the collocation filters.
+ * will be used for the datetime filters, the bounding box (latitude_min/latitude_max/longitude_min/longitude_max) for
+ * the spatial filters, and the source_product attribute for the collocation filters. Products for which the bounding
+ * box is unknown are not removed by the spatial filters.
  * \param dataset Dataset that should be filtered.
  * \param operations Operations to execute; should be specified as a semi-colon separated string of operations.
  * \return
@@ -1119,6 +1918,45 @@ LIBHARP_API int harp_dataset_prefilter(harp_dataset *dataset, const char *operat
                     return -1;
                 }
                 break;
+            case operation_longitude_range_filter:
+                if (prefilter_longitude_range(dataset, mask, (harp_operation_longitude_range_filter *)operation) != 0)
+                {
+                    harp_program_delete(program);
+                    free(mask);
+                    return -1;
+                }
+                break;
+            case operation_point_distance_filter:
+                if (prefilter_point_distance(dataset, mask, (harp_operation_point_distance_filter *)operation) != 0)
+                {
+                    harp_program_delete(program);
+                    free(mask);
+                    return -1;
+                }
+                break;
+            case operation_area_covers_area_filter:
+            case operation_area_inside_area_filter:
+            case operation_area_intersects_area_filter:
+            case operation_point_in_area_filter:
+                /* all these filters can only match samples that overlap with one of the polygons of the area mask */
+                if (prefilter_area_mask(dataset, mask, get_area_mask(operation)) != 0)
+                {
+                    harp_program_delete(program);
+                    free(mask);
+                    return -1;
+                }
+                break;
+            case operation_area_covers_point_filter:
+                {
+                    harp_operation_area_covers_point_filter *point_operation;
+                    double latitude, longitude;
+
+                    point_operation = (harp_operation_area_covers_point_filter *)operation;
+                    latitude = point_operation->point.lat * CONST_RAD2DEG;
+                    longitude = point_operation->point.lon * CONST_RAD2DEG;
+                    prefilter_bounding_box(dataset, mask, latitude, latitude, longitude, longitude);
+                }
+                break;
             case operation_set:
                 /* we can skip over set() calls (which might exist to set collocation_datetime) */
                 break;
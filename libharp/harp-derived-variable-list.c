@@ -1968,6 +1968,10 @@ static int add_aux_afgl86_conversion(const char *variable_name, const char *unit
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "datetime", harp_type_double, HARP_UNIT_DATETIME, 1,
                                             dimension_type, 0) != 0)
     {
@@ -2008,6 +2012,10 @@ static int add_aux_usstd76_conversion(const char *variable_name, const char *uni
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "altitude", harp_type_double, HARP_UNIT_LENGTH, 2,
                                             dimension_type, 0) != 0)
     {
@@ -2255,6 +2263,10 @@ static int add_species_uncertainty_conversions(const char *variable_name, const
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_uncertainty_sys, harp_type_double, unit, num_dimensions,
                                             dimension_type, 0) != 0)
     {
@@ -2307,6 +2319,10 @@ static int add_species_uncertainty_conversions(const char *variable_name, const
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_covariance, harp_type_double, unit_squared,
                                                 num_dimensions + 1, covar_dimension_type, 0) != 0)
         {
@@ -2352,6 +2368,10 @@ static int add_dfs_from_avk_conversion(const char *variable_name, int num_dimens
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_dfs, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                             num_dimensions + 1, vertical_dimension_type, 0) != 0)
     {
@@ -2365,6 +2385,10 @@ static int add_dfs_from_avk_conversion(const char *variable_name, int num_dimens
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_avk, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                             num_dimensions + 2, vertical_dimension_type, 0) != 0)
     {
@@ -2511,6 +2535,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_density, harp_type_double,
                                                 HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -2528,6 +2556,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_density, harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -2546,6 +2578,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2559,6 +2595,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_mmr, harp_type_double, HARP_UNIT_MASS_MIXING_RATIO,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -2577,6 +2617,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2605,6 +2649,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_nd_apriori, harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2733,6 +2781,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -2750,6 +2802,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_nd, harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -2768,6 +2824,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_density, harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2781,6 +2841,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_vmr, harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2799,6 +2863,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2819,6 +2887,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -2838,6 +2910,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) !=
             0)
@@ -2859,6 +2935,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_vmr, harp_type_double, HARP_UNIT_VOLUME_MIXING_RATIO,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -2899,6 +2979,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_nd_apriori, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -2916,6 +3000,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_nd_apriori, harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -2934,6 +3022,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_density_apriori, harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2948,6 +3040,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_vmr_apriori, harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -2989,6 +3085,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_nd_avk, harp_type_double,
                                                 HARP_UNIT_DIMENSIONLESS, num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -3003,6 +3103,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_nd_avk, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                                 num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -3036,6 +3140,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_nd_avk, harp_type_double,
                                                 HARP_UNIT_DIMENSIONLESS, num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -3075,6 +3183,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_nd_avk, harp_type_double,
                                                 HARP_UNIT_DIMENSIONLESS, num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -3123,6 +3235,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -3150,6 +3266,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -3220,6 +3340,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -3247,6 +3371,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -3323,6 +3451,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_density, harp_type_double,
                                                 HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3341,6 +3473,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_vmr, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3361,6 +3497,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_column_mmr_dry, harp_type_double,
                                                     HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0)
                 != 0)
@@ -3412,6 +3552,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_density, harp_type_double,
                                                 HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3430,6 +3574,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3443,6 +3591,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_mmr, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3493,6 +3645,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_strato_column_mmr_dry, harp_type_double,
                                                     HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0)
                 != 0)
@@ -3544,6 +3700,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_strato_column_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3557,6 +3717,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_strato_column_mmr, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3608,6 +3772,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_tropo_column_mmr_dry, harp_type_double,
                                                     HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) !=
                 0)
@@ -3659,6 +3827,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_tropo_column_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3672,6 +3844,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_tropo_column_mmr, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3721,6 +3897,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) !=
             0)
@@ -3741,6 +3921,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_mmr, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3761,6 +3945,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_column_vmr_dry, harp_type_double,
                                                     HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0)
                 != 0)
@@ -3785,6 +3973,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr, harp_type_double, HARP_UNIT_VOLUME_MIXING_RATIO,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -3828,6 +4020,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) !=
             0)
@@ -3848,6 +4044,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_mmr_dry, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3861,6 +4061,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_vmr, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3911,6 +4115,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_strato_column_vmr_dry, harp_type_double,
                                                     HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0)
                 != 0)
@@ -3962,6 +4170,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_strato_column_mmr_dry, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -3975,6 +4187,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_strato_column_vmr, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4026,6 +4242,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_tropo_column_vmr_dry, harp_type_double,
                                                     HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0)
                 != 0)
@@ -4077,6 +4297,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_tropo_column_mmr_dry, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4090,6 +4314,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_tropo_column_vmr, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4136,6 +4364,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_nd, harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4149,6 +4381,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_density, harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -4183,6 +4419,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_density, harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4200,6 +4440,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_vmr, harp_type_double, HARP_UNIT_VOLUME_MIXING_RATIO,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4220,6 +4464,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_mmr_dry, harp_type_double, HARP_UNIT_MASS_MIXING_RATIO,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4249,6 +4497,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_vmr_apriori, harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -4296,6 +4548,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_density, harp_type_double, HARP_UNIT_MASS_DENSITY,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4314,6 +4570,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4327,6 +4587,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_mmr, harp_type_double, HARP_UNIT_MASS_MIXING_RATIO,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4358,6 +4622,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr_dry_apriori, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4398,6 +4666,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_density, harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4410,6 +4682,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_vmr, harp_type_double, HARP_UNIT_VOLUME_MIXING_RATIO,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4429,6 +4705,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4448,6 +4728,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_nd, harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -4476,6 +4760,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_vmr_apriori, harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -4496,6 +4784,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr_dry_apriori, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4515,6 +4807,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_nd_apriori, harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -4546,6 +4842,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr_avk, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                                 num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -4566,6 +4866,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_vmr_dry_avk, harp_type_double,
                                                     HARP_UNIT_DIMENSIONLESS, num_dimensions + 1, dimension_type, 0) !=
                 0)
@@ -4587,6 +4891,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_nd_avk, harp_type_double,
                                                 HARP_UNIT_DIMENSIONLESS, num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -4632,6 +4940,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_vmr, harp_type_double, HARP_UNIT_VOLUME_MIXING_RATIO,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4652,6 +4964,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4686,6 +5002,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_nd, harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4703,6 +5023,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_mmr, harp_type_double, HARP_UNIT_MASS_MIXING_RATIO,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4721,6 +5045,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_pp, harp_type_double, HARP_UNIT_PRESSURE, num_dimensions,
                                             dimension_type, 0) != 0)
     {
@@ -4741,6 +5069,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr_dry, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4762,6 +5094,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_column_vmr, harp_type_double,
                                                 HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -4786,6 +5122,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_nd_apriori, harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -4804,7 +5144,11 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
     {
         return -1;
     }
-    if (harp_variable_conversion_add_source(conversion, name_mmr_apriori, harp_type_double, HARP_UNIT_MASS_MIXING_RATIO,
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
+    if (harp_variable_conversion_add_source(conversion, name_mmr_apriori, harp_type_double, HARP_UNIT_MASS_MIXING_RATIO,
                                             num_dimensions, dimension_type, 0) != 0)
     {
         return -1;
@@ -4834,6 +5178,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_nd_avk, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                                 num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -4882,6 +5230,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_nd, harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4900,6 +5252,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_mmr_dry, harp_type_double, HARP_UNIT_MASS_MIXING_RATIO,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4913,6 +5269,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_pp, harp_type_double, HARP_UNIT_PRESSURE,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4931,6 +5291,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_vmr, harp_type_double, HARP_UNIT_VOLUME_MIXING_RATIO,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4962,6 +5326,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_nd_apriori, harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -4980,6 +5348,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_mmr_dry_apriori, harp_type_double,
                                                 HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
         {
@@ -5007,6 +5379,10 @@ static int add_species_conversions_for_grid(harp_chemical_species species, int n
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, name_nd_avk, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                                 num_dimensions + 1, dimension_type, 0) != 0)
         {
@@ -5083,6 +5459,10 @@ static int add_particulate_matter_conversions_for_grid(const char *pm, int num_d
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, name_column_density, harp_type_double,
                                                 HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -5100,6 +5480,10 @@ static int add_particulate_matter_conversions_for_grid(const char *pm, int num_d
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_density, harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5173,6 +5557,10 @@ static int add_particulate_matter_conversions_for_grid(const char *pm, int num_d
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, name_column_density, harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5227,6 +5615,10 @@ static int add_aerosol_conversions_for_grid(int num_dimensions, harp_dimension_t
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source(conversion, name_aod, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                                     num_dimensions, dimension_type, 0) != 0)
             {
@@ -5273,6 +5665,10 @@ static int add_aerosol_conversions_for_grid(int num_dimensions, harp_dimension_t
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             dimension_type[num_dimensions] = harp_dimension_vertical;
             if (harp_variable_conversion_add_source(conversion, name_aod, harp_type_double, HARP_UNIT_DIMENSIONLESS,
                                                     num_dimensions + 1, dimension_type, 0) != 0)
@@ -5290,6 +5686,10 @@ static int add_aerosol_conversions_for_grid(int num_dimensions, harp_dimension_t
             {
                 return -1;
             }
+            if (harp_variable_conversion_set_time_separable(conversion) != 0)
+            {
+                return -1;
+            }
             if (harp_variable_conversion_add_source
                 (conversion, name_ext, harp_type_double, HARP_UNIT_AEROSOL_EXTINCTION, num_dimensions, dimension_type,
                  0) != 0)
@@ -5419,6 +5819,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "geopotential_height", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -5439,6 +5843,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "pressure", harp_type_double, HARP_UNIT_PRESSURE,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -5478,6 +5886,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "altitude_bounds", harp_type_double, HARP_UNIT_LENGTH,
                                             num_dimensions + 1, dimension_type, 2) != 0)
     {
@@ -5502,6 +5914,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source
             (conversion, "altitude", harp_type_double, HARP_UNIT_LENGTH, num_dimensions, dimension_type, 0) != 0)
         {
@@ -5518,6 +5934,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "wavelength", harp_type_double, HARP_UNIT_WAVELENGTH,
                                             1, &dimension_type[num_dimensions], 0) != 0)
     {
@@ -5551,6 +5971,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "dry_air_column_density", harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5568,6 +5992,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "column_density", harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5588,6 +6016,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         dimension_type[num_dimensions + 1] = harp_dimension_independent;
         if (harp_variable_conversion_add_source(conversion, "surface_pressure", harp_type_double, HARP_UNIT_PRESSURE,
@@ -5618,6 +6050,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "column_density", harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5647,6 +6083,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "cloud_base_height", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -5685,6 +6125,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, "column_number_density", harp_type_double,
                                                 HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions + 1, dimension_type, 0)
@@ -5701,6 +6145,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "number_density", harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5719,6 +6167,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "column_density", harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5736,6 +6188,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "dry_air_column_number_density", harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5753,6 +6209,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "column_number_density", harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5770,6 +6230,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "column_number_density", harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5813,6 +6277,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "number_density", harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5831,6 +6299,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "column_density", harp_type_double,
                                             HARP_UNIT_COLUMN_MASS_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -5849,6 +6321,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "dry_air_density", harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5866,6 +6342,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "density", harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5883,6 +6363,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "density", harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5915,6 +6399,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "geopotential_height", harp_type_double, HARP_UNIT_LENGTH,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5936,6 +6424,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "geopotential", harp_type_double, HARP_UNIT_GEOPOTENTIAL,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -5950,6 +6442,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "altitude", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -5970,6 +6466,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "pressure", harp_type_double, HARP_UNIT_PRESSURE,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6007,6 +6507,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "latitude", harp_type_double, HARP_UNIT_LATITUDE,
                                                 num_dimensions - 1, dimension_type, 0) != 0)
         {
@@ -6026,6 +6530,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "latitude", harp_type_double, HARP_UNIT_LATITUDE,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6042,6 +6550,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "H2O_mass_mixing_ratio", harp_type_double,
                                             HARP_UNIT_DIMENSIONLESS, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6055,6 +6567,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "H2O_mass_mixing_ratio_dry_air", harp_type_double,
                                             HARP_UNIT_DIMENSIONLESS, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6068,6 +6584,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "dry_air_mass_mixing_ratio", harp_type_double,
                                             HARP_UNIT_DIMENSIONLESS, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6089,6 +6609,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "density", harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6106,6 +6630,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "H2O_mass_mixing_ratio", harp_type_double,
                                             HARP_UNIT_MASS_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6118,6 +6646,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "H2O_volume_mixing_ratio", harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6145,6 +6677,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "density", harp_type_double, HARP_UNIT_MASS_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6162,6 +6698,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "pressure", harp_type_double, HARP_UNIT_PRESSURE,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6180,6 +6720,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "column_number_density", harp_type_double,
                                             HARP_UNIT_COLUMN_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6198,6 +6742,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "dry_air_number_density", harp_type_double,
                                             HARP_UNIT_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6215,6 +6763,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "number_density", harp_type_double,
                                             HARP_UNIT_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6232,6 +6784,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "number_density", harp_type_double,
                                             HARP_UNIT_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6258,6 +6814,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "number_density", harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6277,6 +6837,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "altitude", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6314,6 +6878,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "geopotential_height", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6348,6 +6916,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "pressure_bounds", harp_type_double, HARP_UNIT_PRESSURE,
                                             num_dimensions + 1, dimension_type, 2) != 0)
     {
@@ -6372,6 +6944,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "pressure", harp_type_double, HARP_UNIT_PRESSURE,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6436,6 +7012,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_geopotential_height", harp_type_double,
                                                 HARP_UNIT_LENGTH, num_dimensions, dimension_type, 0) != 0)
         {
@@ -6465,6 +7045,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_number_density", harp_type_double,
                                                 HARP_UNIT_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
         {
@@ -6495,6 +7079,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_geopotential_height", harp_type_double,
                                                 HARP_UNIT_LENGTH, num_dimensions, dimension_type, 0) != 0)
         {
@@ -6520,6 +7108,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_geopotential", harp_type_double,
                                                 HARP_UNIT_GEOPOTENTIAL, num_dimensions, dimension_type, 0) != 0)
         {
@@ -6533,6 +7125,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_altitude", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6556,6 +7152,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "latitude", harp_type_double, HARP_UNIT_LATITUDE,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6594,6 +7194,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_pressure", harp_type_double, HARP_UNIT_PRESSURE,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6630,6 +7234,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_number_density", harp_type_double,
                                                 HARP_UNIT_NUMBER_DENSITY, num_dimensions, dimension_type, 0) != 0)
         {
@@ -6663,6 +7271,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "number_density", harp_type_double, HARP_UNIT_NUMBER_DENSITY,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6680,6 +7292,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "virtual_temperature", harp_type_double, HARP_UNIT_TEMPERATURE,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6701,6 +7317,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, "altitude", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions + 1, dimension_type, 0) != 0)
@@ -6729,6 +7349,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         dimension_type[num_dimensions] = harp_dimension_vertical;
         if (harp_variable_conversion_add_source(conversion, "altitude", harp_type_double, HARP_UNIT_LENGTH,
                                                 num_dimensions + 1, dimension_type, 0) != 0)
@@ -6808,6 +7432,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "temperature", harp_type_double, HARP_UNIT_TEMPERATURE,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6828,6 +7456,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "H2O_volume_mixing_ratio", harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6841,6 +7473,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "H2O_volume_mixing_ratio_dry_air", harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6854,6 +7490,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "dry_air_volume_mixing_ratio", harp_type_double,
                                             HARP_UNIT_VOLUME_MIXING_RATIO, num_dimensions, dimension_type, 0) != 0)
     {
@@ -6868,6 +7508,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "zonal_wind_velocity", harp_type_double, HARP_UNIT_SPEED,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6885,6 +7529,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_zonal_wind_velocity", harp_type_double,
                                                 HARP_UNIT_SPEED, num_dimensions, dimension_type, 0) != 0)
         {
@@ -6905,6 +7553,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "zonal_wind_velocity", harp_type_double, HARP_UNIT_SPEED,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6922,6 +7574,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_zonal_wind_velocity", harp_type_double,
                                                 HARP_UNIT_SPEED, num_dimensions, dimension_type, 0) != 0)
         {
@@ -6942,6 +7598,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "wind_speed", harp_type_double, HARP_UNIT_SPEED,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6960,6 +7620,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_wind_speed", harp_type_double, HARP_UNIT_SPEED,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -6980,6 +7644,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "wind_speed", harp_type_double, HARP_UNIT_SPEED,
                                             num_dimensions, dimension_type, 0) != 0)
     {
@@ -6998,6 +7666,10 @@ static int add_conversions_for_grid(int num_dimensions, harp_dimension_type dime
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "surface_wind_speed", harp_type_double, HARP_UNIT_SPEED,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7112,6 +7784,10 @@ static int add_radiance_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "radiance", harp_type_double, HARP_UNIT_RADIANCE, i,
                                                 dimension_type, 0) != 0)
         {
@@ -7134,6 +7810,10 @@ static int add_radiance_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "wavelength_radiance", harp_type_double,
                                                 HARP_UNIT_WAVELENGTH_RADIANCE, i, dimension_type, 0) != 0)
         {
@@ -7196,6 +7876,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_azimuth_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7223,6 +7907,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_zenith_angle", harp_type_double, HARP_UNIT_ANGLE, i,
                                                 dimension_type, 0) != 0)
         {
@@ -7255,6 +7943,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "viewing_azimuth_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7277,6 +7969,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_zenith_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7299,6 +7995,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_elevation_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7310,6 +8010,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "viewing_zenith_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7330,6 +8034,10 @@ static int add_angle_conversions(void)
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "latitude", harp_type_double, HARP_UNIT_LATITUDE, 1,
                                             dimension_type, 0) != 0)
     {
@@ -7358,6 +8066,10 @@ static int add_angle_conversions(void)
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "datetime", harp_type_double, HARP_UNIT_DATETIME, 1,
                                             dimension_type, 0) != 0)
     {
@@ -7371,6 +8083,10 @@ static int add_angle_conversions(void)
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "datetime", harp_type_double, HARP_UNIT_DATETIME, 1,
                                             dimension_type, 0) != 0)
     {
@@ -7396,6 +8112,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "solar_zenith_angle", harp_type_double, HARP_UNIT_ANGLE, i,
                                                 dimension_type, 0) != 0)
         {
@@ -7417,6 +8137,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "solar_elevation_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7429,6 +8153,10 @@ static int add_angle_conversions(void)
     {
         return -1;
     }
+    if (harp_variable_conversion_set_time_separable(conversion) != 0)
+    {
+        return -1;
+    }
     if (harp_variable_conversion_add_source(conversion, "latitude", harp_type_double, HARP_UNIT_LATITUDE, 1,
                                             dimension_type, 0) != 0)
     {
@@ -7460,6 +8188,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_azimuth_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7482,6 +8214,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "viewing_zenith_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7504,6 +8240,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_zenith_angle", harp_type_double, HARP_UNIT_ANGLE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7515,6 +8255,10 @@ static int add_angle_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "viewing_elevation_angle", harp_type_double,
                                                 HARP_UNIT_ANGLE, i, dimension_type, 0) != 0)
         {
@@ -7557,6 +8301,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime_start", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7585,6 +8333,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime_start", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7613,6 +8365,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime_start", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7641,6 +8397,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime_bounds", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions + 1, dimension_type, 2) != 0)
         {
@@ -7653,6 +8413,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7670,6 +8434,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime_stop", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7698,6 +8466,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime_bounds", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions + 1, dimension_type, 2) != 0)
         {
@@ -7710,6 +8482,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7727,6 +8503,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime_start", harp_type_double, HARP_UNIT_DATETIME,
                                                 num_dimensions, dimension_type, 0) != 0)
         {
@@ -7816,6 +8596,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_latitude", harp_type_double, HARP_UNIT_LATITUDE, i,
                                                 dimension_type, 0) != 0)
         {
@@ -7832,6 +8616,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "latitude", harp_type_double, HARP_UNIT_LATITUDE, i + 1,
                                                 &dimension_type[1 - i], 0) != 0)
         {
@@ -7947,6 +8735,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_longitude", harp_type_double, HARP_UNIT_LONGITUDE,
                                                 i, dimension_type, 0) != 0)
         {
@@ -7963,6 +8755,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "longitude", harp_type_double, HARP_UNIT_LONGITUDE, i + 1,
                                                 &dimension_type[1 - i], 0) != 0)
         {
@@ -8071,6 +8867,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "sensor_altitude", harp_type_double, HARP_UNIT_LENGTH, i,
                                                 dimension_type, 0) != 0)
         {
@@ -8162,6 +8962,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "wavelength", harp_type_double, HARP_UNIT_WAVELENGTH, i,
                                                 dimension_type, 0) != 0)
         {
@@ -8174,6 +8978,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "wavenumber", harp_type_double, HARP_UNIT_WAVENUMBER, i,
                                                 dimension_type, 0) != 0)
         {
@@ -8200,6 +9008,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "frequency", harp_type_double, HARP_UNIT_FREQUENCY, i,
                                                 dimension_type, 0) != 0)
         {
@@ -8212,6 +9024,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "wavenumber", harp_type_double, HARP_UNIT_WAVENUMBER, i,
                                                 dimension_type, 0) != 0)
         {
@@ -8238,6 +9054,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "frequency", harp_type_double, HARP_UNIT_FREQUENCY, i,
                                                 dimension_type, 0) != 0)
         {
@@ -8250,6 +9070,10 @@ static int add_axis_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "wavelength", harp_type_double, HARP_UNIT_WAVELENGTH, i,
                                                 dimension_type, 0) != 0)
         {
@@ -8278,6 +9102,10 @@ static int add_misc_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "latitude_bounds", harp_type_double, HARP_UNIT_LATITUDE,
                                                 i + 1, &dimension_type[1 - i], -1) != 0)
         {
@@ -8367,6 +9195,10 @@ static int add_misc_conversions(void)
         {
             return -1;
         }
+        if (harp_variable_conversion_set_time_separable(conversion) != 0)
+        {
+            return -1;
+        }
         if (harp_variable_conversion_add_source(conversion, "datetime", harp_type_double, HARP_UNIT_DATETIME, i,
                                                 dimension_type, 0) != 0)
         {
@@ -38,6 +38,21 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* minimum number of elements per slice when a time separable conversion is performed in parallel */
+#define MIN_NUM_ELEMENTS_PER_SLICE 4096
+
+/* maximum number of released scratch buffers that are kept for reuse during a derivation */
+#define MAX_NUM_SCRATCH_BUFFERS 8
+
+/* buffers for the converted copies of source variables; buffers are reused for other source variables with the same
+ * number of elements once the conversion that needed them is done */
+typedef struct scratch_pool_struct
+{
+    int num_buffers;
+    long num_elements[MAX_NUM_SCRATCH_BUFFERS];
+    double *buffer[MAX_NUM_SCRATCH_BUFFERS];
+} scratch_pool;
+
 typedef struct conversion_info_struct
 {
     const harp_product *product;
@@ -51,10 +66,63 @@ typedef struct conversion_info_struct
     int depth;
     int max_depth;
     harp_variable *variable;
+    scratch_pool *pool; /* pool that is shared by all levels of a derivation (points to own_pool of the top level) */
+    scratch_pool own_pool;
 } conversion_info;
 
 static int find_and_execute_conversion(conversion_info *info);
 
+static double *scratch_pool_get(scratch_pool *pool, long num_elements)
+{
+    double *buffer;
+    int i;
+
+    for (i = 0; i < pool->num_buffers; i++)
+    {
+        if (pool->num_elements[i] == num_elements)
+        {
+            buffer = pool->buffer[i];
+            pool->num_buffers--;
+            pool->buffer[i] = pool->buffer[pool->num_buffers];
+            pool->num_elements[i] = pool->num_elements[pool->num_buffers];
+            return buffer;
+        }
+    }
+
+    buffer = malloc((size_t)(num_elements > 0 ? num_elements : 1) * sizeof(double));
+    if (buffer == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (size_t)num_elements * sizeof(double), __FILE__, __LINE__);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+static void scratch_pool_put(scratch_pool *pool, double *buffer, long num_elements)
+{
+    if (pool->num_buffers == MAX_NUM_SCRATCH_BUFFERS)
+    {
+        free(buffer);
+        return;
+    }
+    pool->buffer[pool->num_buffers] = buffer;
+    pool->num_elements[pool->num_buffers] = num_elements;
+    pool->num_buffers++;
+}
+
+static void scratch_pool_done(scratch_pool *pool)
+{
+    int i;
+
+    for (i = 0; i < pool->num_buffers; i++)
+    {
+        free(pool->buffer[i]);
+    }
+    pool->num_buffers = 0;
+}
+
 static void set_variable_not_found_error(conversion_info *info)
 {
     int i;
@@ -179,6 +247,8 @@ static int conversion_info_init(conversion_info *info, const harp_product *produ
     info->depth = 0;
     info->max_depth = 10;
     info->variable = NULL;
+    info->pool = &info->own_pool;
+    info->own_pool.num_buffers = 0;
 
     info->skip = malloc(harp_derived_variable_conversions->num_variables);
     if (info->skip == NULL)
@@ -246,6 +316,7 @@ static void conversion_info_done(conversion_info *info)
     {
         harp_variable_delete(info->variable);
     }
+    scratch_pool_done(&info->own_pool);
 }
 
 static int create_variable(conversion_info *info)
@@ -296,6 +367,87 @@ static int create_variable(conversion_info *info)
     return 0;
 }
 
+/* Create a double precision copy of the existing (numeric) variable info->variable in the given unit (if unit is not
+ * NULL). The data type and unit conversion are performed in a single pass, and the data is stored in a buffer from the
+ * scratch pool.
+ */
+static int get_converted_source_variable(conversion_info *info, const char *unit)
+{
+    const harp_variable *variable = info->variable;
+    harp_unit_converter *unit_converter = NULL;
+    harp_variable *converted_variable;
+    double *data;
+
+    info->variable = NULL;
+
+    if (unit != NULL && !harp_variable_has_unit(variable, unit))
+    {
+        if (harp_unit_converter_new(variable->unit, unit, &unit_converter) != 0)
+        {
+            harp_add_error_message(" (in unit conversion of variable '%s')", variable->name);
+            return -1;
+        }
+    }
+
+    data = scratch_pool_get(info->pool, variable->num_elements);
+    if (data == NULL)
+    {
+        harp_unit_converter_delete(unit_converter);
+        return -1;
+    }
+    harp_unit_converter_convert_array_to_double(unit_converter, variable->data_type, variable->num_elements,
+                                                variable->data.ptr, data);
+
+    if (harp_variable_new_with_data(variable->name, harp_type_double, variable->num_dimensions,
+                                    variable->dimension_type, variable->dimension, data, &converted_variable) != 0)
+    {
+        scratch_pool_put(info->pool, data, variable->num_elements);
+        harp_unit_converter_delete(unit_converter);
+        return -1;
+    }
+    harp_unit_converter_convert_array_to_double(unit_converter, variable->data_type, 1, &variable->valid_min,
+                                                &converted_variable->valid_min.double_data);
+    harp_unit_converter_convert_array_to_double(unit_converter, variable->data_type, 1, &variable->valid_max,
+                                                &converted_variable->valid_max.double_data);
+    harp_unit_converter_delete(unit_converter);
+
+    if (unit != NULL || variable->unit != NULL)
+    {
+        converted_variable->unit = strdup(unit != NULL ? unit : variable->unit);
+        if (converted_variable->unit == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                           __LINE__);
+            converted_variable->data.ptr = NULL;
+            harp_variable_delete(converted_variable);
+            scratch_pool_put(info->pool, data, variable->num_elements);
+            return -1;
+        }
+    }
+
+    info->variable = converted_variable;
+
+    return 0;
+}
+
+/* Delete a source variable that was returned by get_source_variable() with *is_temp set to 'is_temp' */
+static void release_source_variable(conversion_info *info, harp_variable *variable, int is_temp)
+{
+    if (is_temp == 2)
+    {
+        /* data is owned by the scratch pool */
+        scratch_pool_put(info->pool, variable->data.double_data, variable->num_elements);
+        variable->data.ptr = NULL;
+    }
+    if (is_temp)
+    {
+        harp_variable_delete(variable);
+    }
+}
+
+/* *is_temp is set to 0 if the returned variable is a variable from the product, to 1 if it is a temporary variable,
+ * and to 2 if it is a temporary variable that uses a buffer from the scratch pool.
+ */
 static int get_source_variable(conversion_info *info, harp_data_type data_type, const char *unit, int *is_temp)
 {
     *is_temp = 0;
@@ -305,6 +457,24 @@ static int get_source_variable(conversion_info *info, harp_data_type data_type,
         if (harp_variable_has_dimension_types(info->variable, info->num_dimensions, info->dimension_type))
         {
             /* variable already exists */
+            if (harp_variable_load(info->variable) != 0)
+            {
+                info->variable = NULL;
+                return -1;
+            }
+            if (data_type == harp_type_double && info->variable->data_type != harp_type_string &&
+                info->variable->num_enum_values == 0 &&
+                (info->variable->data_type != data_type || (unit != NULL && !harp_variable_has_unit(info->variable,
+                                                                                                     unit))))
+            {
+                /* perform data type and unit conversion in one go */
+                if (get_converted_source_variable(info, unit) != 0)
+                {
+                    return -1;
+                }
+                *is_temp = 2;
+                return 0;
+            }
             if (unit != NULL && !harp_variable_has_unit(info->variable, unit))
             {
                 /* create a copy if we need to perform unit conversion */
@@ -359,6 +529,97 @@ static int get_source_variable(conversion_info *info, harp_data_type data_type,
     return 0;
 }
 
+/* Initialize 'slice' as a view on the time samples [offset, offset + length) of 'variable' (which should have time as
+ * its first dimension). The slice shares its data (and all other properties) with 'variable'.
+ */
+static void get_time_slice(const harp_variable *variable, long offset, long length, harp_variable *slice)
+{
+    long block_size = variable->num_elements / variable->dimension[0];
+
+    *slice = *variable;
+    slice->dimension[0] = length;
+    slice->num_elements = length * block_size;
+    slice->data.ptr = (char *)variable->data.ptr + offset * block_size * harp_get_size_for_type(variable->data_type);
+}
+
+/* Set the data of the target variable using the conversion function.
+ * For time separable conversions the time dimension is split up in a number of consecutive slices and the conversion
+ * function is called for each slice in parallel. Since each time sample is calculated exactly as it would be when
+ * converting the variable in one go, the result does not depend on the number of threads.
+ */
+static int set_variable_data(const harp_variable_conversion *conversion, harp_variable *variable,
+                             harp_variable **source_variable)
+{
+    long num_time;
+    int num_slices;
+    int failed = 0;
+    int i;
+
+    if (!conversion->time_separable || variable->num_dimensions == 0 ||
+        variable->dimension_type[0] != harp_dimension_time)
+    {
+        return conversion->set_variable_data(variable, (const harp_variable **)source_variable);
+    }
+    num_time = variable->dimension[0];
+
+    for (i = 0; i < conversion->num_source_variables; i++)
+    {
+        if (source_variable[i]->num_dimensions > 0 && source_variable[i]->dimension_type[0] == harp_dimension_time &&
+            source_variable[i]->dimension[0] != num_time)
+        {
+            return conversion->set_variable_data(variable, (const harp_variable **)source_variable);
+        }
+    }
+
+    /* make sure each slice is large enough to be worth the threading overhead */
+    num_slices = harp_get_num_threads();
+    if (num_slices > variable->num_elements / MIN_NUM_ELEMENTS_PER_SLICE)
+    {
+        num_slices = (int)(variable->num_elements / MIN_NUM_ELEMENTS_PER_SLICE);
+    }
+    if (num_slices > num_time)
+    {
+        num_slices = (int)num_time;
+    }
+    if (num_slices < 2)
+    {
+        return conversion->set_variable_data(variable, (const harp_variable **)source_variable);
+    }
+
+#pragma omp parallel for reduction(|:failed) schedule(static) num_threads(num_slices)
+    for (i = 0; i < num_slices; i++)
+    {
+        harp_variable slice;
+        harp_variable source_slice[MAX_NUM_SOURCE_VARIABLES];
+        const harp_variable *slice_source_variable[MAX_NUM_SOURCE_VARIABLES];
+        long offset = num_time * i / num_slices;
+        long length = num_time * (i + 1) / num_slices - offset;
+        int j;
+
+        get_time_slice(variable, offset, length, &slice);
+        for (j = 0; j < conversion->num_source_variables; j++)
+        {
+            if (source_variable[j]->num_dimensions > 0 &&
+                source_variable[j]->dimension_type[0] == harp_dimension_time)
+            {
+                get_time_slice(source_variable[j], offset, length, &source_slice[j]);
+                slice_source_variable[j] = &source_slice[j];
+            }
+            else
+            {
+                slice_source_variable[j] = source_variable[j];
+            }
+        }
+
+        if (conversion->set_variable_data(&slice, slice_source_variable) != 0)
+        {
+            failed |= 1;
+        }
+    }
+
+    return failed ? -1 : 0;
+}
+
 static int perform_conversion(conversion_info *info)
 {
     harp_variable *source_variable[MAX_NUM_SOURCE_VARIABLES];
@@ -379,16 +640,19 @@ static int perform_conversion(conversion_info *info)
         }
         memcpy(source_info.skip, info->skip, harp_derived_variable_conversions->num_variables);
         source_info.depth = info->depth + 1;
+        source_info.pool = info->pool;
 
         if (get_source_variable(&source_info, source_definition->data_type, source_definition->unit, &is_temp[i]) != 0)
         {
             for (j = 0; j < i; j++)
             {
-                if (is_temp[j])
-                {
-                    harp_variable_delete(source_variable[j]);
-                }
+                release_source_variable(info, source_variable[j], is_temp[j]);
+            }
+            if (!is_temp[i])
+            {
+                source_info.variable = NULL;
             }
+            conversion_info_done(&source_info);
             return -1;
         }
         source_variable[i] = source_info.variable;
@@ -399,7 +663,7 @@ static int perform_conversion(conversion_info *info)
     result = create_variable(info);
     if (result == 0)
     {
-        result = info->conversion->set_variable_data(info->variable, (const harp_variable **)source_variable);
+        result = set_variable_data(info->conversion, info->variable, source_variable);
         /* TODO: set description of variable based on the applied conversion
          * e.g. <target_var_name> from (<source_var_name> from ...), (<source_var_2_name> from ...)
          */
@@ -407,10 +671,7 @@ static int perform_conversion(conversion_info *info)
 
     for (j = 0; j < info->conversion->num_source_variables; j++)
     {
-        if (is_temp[j])
-        {
-            harp_variable_delete(source_variable[j]);
-        }
+        release_source_variable(info, source_variable[j], is_temp[j]);
     }
 
     return result;
@@ -970,6 +1231,7 @@ int harp_variable_conversion_species_new(const char *variable_name, harp_data_ty
     conversion->source_description = NULL;
     conversion->set_variable_data = set_variable_data;
     conversion->enabled = NULL;
+    conversion->time_separable = 0;
     conversion->specific_species = specific_species;
 
     conversion->dimsvar_name = get_dimsvar_name(variable_name, num_dimensions, dimension_type);
@@ -1092,6 +1354,13 @@ int harp_variable_conversion_set_source_description(harp_variable_conversion *co
     return 0;
 }
 
+int harp_variable_conversion_set_time_separable(harp_variable_conversion *conversion)
+{
+    conversion->time_separable = 1;
+
+    return 0;
+}
+
 /** Print the full listing of available variable conversions.
  * \ingroup harp_documentation
  * If product is NULL then all possible conversions will be printed. If a product is provided then only conversions
@@ -180,6 +180,11 @@ LIBHARP_API int harp_errno = HARP_SUCCESS;
 
 /** @} */
 
+/* The error state is shared by all threads. Operations that run in parallel may therefore set an error from more than
+ * one thread at the same time. All updates of the error state are serialized using a single named critical section
+ * such that the final error state always corresponds to one complete error.
+ */
+
 static void add_error_message_vargs(const char *message, va_list ap)
 {
     size_t current_length;
@@ -189,13 +194,16 @@ static void add_error_message_vargs(const char *message, va_list ap)
         return;
     }
 
-    current_length = strlen(harp_error_message_buffer);
-    if (current_length >= MAX_ERROR_INFO_LENGTH)
+#pragma omp critical (harp_error_state)
     {
-        return;
+        current_length = strlen(harp_error_message_buffer);
+        if (current_length < MAX_ERROR_INFO_LENGTH)
+        {
+            vsnprintf(&harp_error_message_buffer[current_length], MAX_ERROR_INFO_LENGTH - current_length, message,
+                      ap);
+            harp_error_message_buffer[MAX_ERROR_INFO_LENGTH] = '\0';
+        }
     }
-    vsnprintf(&harp_error_message_buffer[current_length], MAX_ERROR_INFO_LENGTH - current_length, message, ap);
-    harp_error_message_buffer[MAX_ERROR_INFO_LENGTH] = '\0';
 }
 
 static int add_error_message(const char *message, ...)
@@ -254,10 +262,12 @@ LIBHARP_API void harp_set_error(int err, const char *message, ...)
 {
     va_list ap;
 
-    harp_errno = err;
-
     va_start(ap, message);
-    set_error_message_vargs(message, ap);
+#pragma omp critical (harp_error_state)
+    {
+        harp_errno = err;
+        set_error_message_vargs(message, ap);
+    }
     va_end(ap);
 
 #ifdef HAVE_HDF4
@@ -207,20 +207,22 @@ static int collocation_mask_from_result(const harp_collocation_result *collocati
     /* if product_index is -1, no match will be found */
     for (i = 0; i < collocation_result->num_pairs && product_index >= 0; i++)
     {
-        const harp_collocation_pair *pair;
-        double datetime_diff;
+        double datetime_diff = harp_nan();
 
-        pair = collocation_result->pair[i];
-        datetime_diff = datetime_diff_index >= 0 ? pair->difference[datetime_diff_index] : harp_nan();
+        if (datetime_diff_index >= 0)
+        {
+            datetime_diff = collocation_result->difference[i * collocation_result->num_differences +
+                                                           datetime_diff_index];
+        }
         if (filter_type == harp_collocation_left)
         {
-            if (pair->product_index_a != product_index)
+            if (collocation_result->product_index_a[i] != product_index)
             {
                 continue;
             }
 
-            if (collocation_mask_add_index_pair(mask, pair->collocation_index, pair->sample_index_a, -datetime_diff) !=
-                0)
+            if (collocation_mask_add_index_pair(mask, collocation_result->collocation_index[i],
+                                                collocation_result->sample_index_a[i], -datetime_diff) != 0)
             {
                 harp_collocation_mask_delete(mask);
                 return -1;
@@ -228,13 +230,13 @@ static int collocation_mask_from_result(const harp_collocation_result *collocati
         }
         else
         {
-            if (pair->product_index_b != product_index)
+            if (collocation_result->product_index_b[i] != product_index)
             {
                 continue;
             }
 
-            if (collocation_mask_add_index_pair(mask, pair->collocation_index, pair->sample_index_b, datetime_diff) !=
-                0)
+            if (collocation_mask_add_index_pair(mask, collocation_result->collocation_index[i],
+                                                collocation_result->sample_index_b[i], datetime_diff) != 0)
             {
                 harp_collocation_mask_delete(mask);
                 return -1;
@@ -610,7 +612,7 @@ static int get_collocated_product(harp_collocation_result *collocation_result, c
     harp_collocation_mask *mask;
     harp_product_metadata *product_metadata;
     harp_product *collocated_product;
-    harp_collocation_pair *pair;
+    long product_index;
 
     if (harp_collocation_result_filter_for_source_product_b(collocation_result, source_product_b) != 0)
     {
@@ -622,12 +624,12 @@ static int get_collocated_product(harp_collocation_result *collocation_result, c
         return 0;
     }
     /* use product b reference from first pair to find and import product */
-    pair = collocation_result->pair[0];
-    product_metadata = collocation_result->dataset_b->metadata[pair->product_index_b];
+    product_index = collocation_result->product_index_b[0];
+    product_metadata = collocation_result->dataset_b->metadata[product_index];
     if (product_metadata == NULL)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "missing product metadata for product %s",
-                       collocation_result->dataset_b->source_product[pair->product_index_b]);
+                       collocation_result->dataset_b->source_product[product_index]);
         return -1;
     }
 
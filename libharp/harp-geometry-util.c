@@ -441,3 +441,327 @@ void harp_get_grid_corner_coordinates(long num_x, long num_y, const double *long
         }
     }
 }
+
+static int get_longitude_bin(double longitude)
+{
+    double offset;
+    int bin;
+
+    offset = fmod(longitude + 180.0, 360.0);
+    if (offset < 0)
+    {
+        offset += 360.0;
+    }
+    bin = (int)offset;
+    if (bin >= 360)
+    {
+        bin = 0;
+    }
+
+    return bin;
+}
+
+/* normalize a longitude difference to the range [-180,180] */
+static double normalize_longitude_difference(double delta)
+{
+    delta = fmod(delta, 360.0);
+    if (delta > 180.0)
+    {
+        delta -= 360.0;
+    }
+    else if (delta < -180.0)
+    {
+        delta += 360.0;
+    }
+
+    return delta;
+}
+
+/* Add the great circle arc between p and q (the shortest path between the points) to the extent.
+ * Besides the end points we include the highest/lowest point of the great circle if it lies on the arc.
+ */
+static void add_great_circle_arc(harp_geographic_extent *extent, double latitude_p, double longitude_p,
+                                 double latitude_q, double longitude_q)
+{
+    double px, py, pz;
+    double qx, qy, qz;
+    double nx, ny, nz;
+    double hx, hy, hz;
+    double norm;
+
+    harp_geographic_extent_add_latitude(extent, latitude_p);
+    harp_geographic_extent_add_latitude(extent, latitude_q);
+    harp_geographic_extent_add_longitude_range(extent, longitude_p, longitude_q);
+
+    px = cos(latitude_p * CONST_DEG2RAD) * cos(longitude_p * CONST_DEG2RAD);
+    py = cos(latitude_p * CONST_DEG2RAD) * sin(longitude_p * CONST_DEG2RAD);
+    pz = sin(latitude_p * CONST_DEG2RAD);
+    qx = cos(latitude_q * CONST_DEG2RAD) * cos(longitude_q * CONST_DEG2RAD);
+    qy = cos(latitude_q * CONST_DEG2RAD) * sin(longitude_q * CONST_DEG2RAD);
+    qz = sin(latitude_q * CONST_DEG2RAD);
+
+    /* normal of the plane of the great circle */
+    nx = py * qz - pz * qy;
+    ny = pz * qx - px * qz;
+    nz = px * qy - py * qx;
+    norm = sqrt(nx * nx + ny * ny + nz * nz);
+    if (HARP_GEOMETRY_FPzero(norm))
+    {
+        /* coinciding or antipodal points */
+        return;
+    }
+    nx /= norm;
+    ny /= norm;
+    nz /= norm;
+
+    /* highest point of the great circle: h = z - (z.n)n */
+    hx = -nz * nx;
+    hy = -nz * ny;
+    hz = 1 - nz * nz;
+    norm = sqrt(hx * hx + hy * hy + hz * hz);
+    if (HARP_GEOMETRY_FPzero(norm))
+    {
+        /* the great circle is the equator */
+        return;
+    }
+    hx /= norm;
+    hy /= norm;
+    hz /= norm;
+
+    /* h lies on the arc if (p x h).n >= 0 and (h x q).n >= 0 (and similar for the lowest point -h) */
+    if ((py * hz - pz * hy) * nx + (pz * hx - px * hz) * ny + (px * hy - py * hx) * nz >= 0 &&
+        (hy * qz - hz * qy) * nx + (hz * qx - hx * qz) * ny + (hx * qy - hy * qx) * nz >= 0)
+    {
+        harp_geographic_extent_add_latitude(extent, asin(hz) * CONST_RAD2DEG);
+    }
+    if ((py * hz - pz * hy) * nx + (pz * hx - px * hz) * ny + (px * hy - py * hx) * nz <= 0 &&
+        (hy * qz - hz * qy) * nx + (hz * qx - hx * qz) * ny + (hx * qy - hy * qx) * nz <= 0)
+    {
+        harp_geographic_extent_add_latitude(extent, -asin(hz) * CONST_RAD2DEG);
+    }
+}
+
+/** Initialize an empty geographic extent.
+ */
+void harp_geographic_extent_init(harp_geographic_extent *extent)
+{
+    int i;
+
+    extent->latitude_min = harp_plusinf();
+    extent->latitude_max = harp_mininf();
+    for (i = 0; i < 360; i++)
+    {
+        extent->longitude_bin[i] = 0;
+    }
+}
+
+/** Extend the geographic extent with a latitude value [deg] (NaN values are ignored).
+ */
+void harp_geographic_extent_add_latitude(harp_geographic_extent *extent, double latitude)
+{
+    if (harp_isnan(latitude))
+    {
+        return;
+    }
+    if (latitude < extent->latitude_min)
+    {
+        extent->latitude_min = latitude;
+    }
+    if (latitude > extent->latitude_max)
+    {
+        extent->latitude_max = latitude;
+    }
+}
+
+/** Extend the geographic extent with a longitude value [deg] (NaN values are ignored).
+ */
+void harp_geographic_extent_add_longitude(harp_geographic_extent *extent, double longitude)
+{
+    if (harp_isnan(longitude))
+    {
+        return;
+    }
+    extent->longitude_bin[get_longitude_bin(longitude)] = 1;
+}
+
+/** Extend the geographic extent with all longitudes [deg] on the shortest path between two longitudes.
+ * NaN values are ignored.
+ */
+void harp_geographic_extent_add_longitude_range(harp_geographic_extent *extent, double longitude_from,
+                                                double longitude_to)
+{
+    double delta;
+    int bin;
+    int last_bin;
+
+    if (harp_isnan(longitude_from) || harp_isnan(longitude_to))
+    {
+        return;
+    }
+    delta = normalize_longitude_difference(longitude_to - longitude_from);
+    if (delta < 0)
+    {
+        longitude_from += delta;
+        delta = -delta;
+    }
+    bin = get_longitude_bin(longitude_from);
+    last_bin = get_longitude_bin(longitude_from + delta);
+    extent->longitude_bin[bin] = 1;
+    while (bin != last_bin)
+    {
+        bin = (bin + 1) % 360;
+        extent->longitude_bin[bin] = 1;
+    }
+}
+
+/** Extend the geographic extent with a polygon [deg] whose edges are great circle arcs.
+ * Vertices for which the latitude or longitude is NaN are ignored.
+ * Polygons that enclose a pole extend the extent to that pole and to all longitudes.
+ */
+void harp_geographic_extent_add_polygon(harp_geographic_extent *extent, long num_vertices, const double *latitude,
+                                        const double *longitude)
+{
+    double latitude_sum = 0;
+    double winding = 0;
+    long first = -1;
+    long prev = -1;
+    long i;
+
+    for (i = 0; i < num_vertices; i++)
+    {
+        if (harp_isnan(latitude[i]) || harp_isnan(longitude[i]))
+        {
+            continue;
+        }
+        if (prev == -1)
+        {
+            first = i;
+        }
+        else
+        {
+            add_great_circle_arc(extent, latitude[prev], longitude[prev], latitude[i], longitude[i]);
+            winding += normalize_longitude_difference(longitude[i] - longitude[prev]);
+        }
+        latitude_sum += latitude[i];
+        prev = i;
+    }
+    if (first == -1)
+    {
+        return;
+    }
+    add_great_circle_arc(extent, latitude[prev], longitude[prev], latitude[first], longitude[first]);
+    winding += normalize_longitude_difference(longitude[first] - longitude[prev]);
+
+    if (fabs(winding) > 180.0)
+    {
+        /* the polygon encloses a pole */
+        harp_geographic_extent_add_latitude(extent, latitude_sum >= 0 ? 90.0 : -90.0);
+        for (i = 0; i < 360; i++)
+        {
+            extent->longitude_bin[i] = 1;
+        }
+    }
+}
+
+/** Get the bounding box of a geographic extent.
+ * The longitude range will be in [-180,180] with longitude_min > longitude_max if the range crosses the dateline.
+ * If the extent contains no longitude or no latitude information then the full longitude or latitude range is
+ * returned.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c 1, The extent is empty (no range is returned).
+ */
+int harp_geographic_extent_get_range(const harp_geographic_extent *extent, double *latitude_min,
+                                     double *latitude_max, double *longitude_min, double *longitude_max)
+{
+    int gap_start = 0;
+    int gap_length = 0;
+    int num_bins = 0;
+    int i;
+
+    for (i = 0; i < 360; i++)
+    {
+        num_bins += extent->longitude_bin[i];
+    }
+    if (num_bins == 0 && extent->latitude_min > extent->latitude_max)
+    {
+        return 1;
+    }
+
+    if (extent->latitude_min > extent->latitude_max)
+    {
+        *latitude_min = -90.0;
+        *latitude_max = 90.0;
+    }
+    else
+    {
+        *latitude_min = extent->latitude_min;
+        *latitude_max = extent->latitude_max;
+    }
+
+    if (num_bins == 0 || num_bins == 360)
+    {
+        *longitude_min = -180.0;
+        *longitude_max = 180.0;
+        return 0;
+    }
+
+    /* the longitude range is the complement of the largest gap of empty bins */
+    for (i = 0; i < 360; i++)
+    {
+        if (extent->longitude_bin[i] && !extent->longitude_bin[(i + 1) % 360])
+        {
+            int length = 1;
+
+            while (!extent->longitude_bin[(i + 1 + length) % 360])
+            {
+                length++;
+            }
+            if (length > gap_length)
+            {
+                gap_start = (i + 1) % 360;
+                gap_length = length;
+            }
+        }
+    }
+    *longitude_min = (gap_start + gap_length) % 360 - 180.0;
+    *longitude_max = (gap_start + 359) % 360 + 1 - 180.0;
+
+    return 0;
+}
+
+/** Check whether two longitude ranges [deg] overlap.
+ * A range with longitude_min > longitude_max is considered to cross the dateline.
+ */
+int harp_geographic_longitude_ranges_overlap(double longitude_min_a, double longitude_max_a, double longitude_min_b,
+                                             double longitude_max_b)
+{
+    double width_a = longitude_max_a - longitude_min_a;
+    double width_b = longitude_max_b - longitude_min_b;
+    double offset;
+
+    if (width_a < 0)
+    {
+        width_a += 360.0;
+    }
+    if (width_b < 0)
+    {
+        width_b += 360.0;
+    }
+    offset = fmod(longitude_min_b - longitude_min_a, 360.0);
+    if (offset < 0)
+    {
+        offset += 360.0;
+    }
+    if (offset <= width_a)
+    {
+        return 1;
+    }
+    offset = fmod(longitude_min_a - longitude_min_b, 360.0);
+    if (offset < 0)
+    {
+        offset += 360.0;
+    }
+
+    return offset <= width_b;
+}
@@ -155,6 +155,16 @@ typedef struct harp_euler_transformation_struct
     double psi; /* third rotation angle */
 } harp_euler_transformation;
 
+/* Coarse geographic extent of a set of points and polygons (in [deg]).
+ * The longitude coverage is tracked using bins of 1 degree.
+ */
+typedef struct harp_geographic_extent_struct
+{
+    double latitude_min;
+    double latitude_max;
+    uint8_t longitude_bin[360];
+} harp_geographic_extent;
+
 /* 3D vector functions */
 int harp_vector3d_equal(const harp_vector3d *vectora, const harp_vector3d *vectorb);
 double harp_vector3d_dotproduct(const harp_vector3d *vectora, const harp_vector3d *vectorb);
@@ -239,6 +249,18 @@ int harp_geographic_center_from_bounds(long num_vertices, const double *latitude
                                        const double *longitude_bounds, double *center_latitude,
                                        double *center_longitude);
 
+void harp_geographic_extent_init(harp_geographic_extent *extent);
+void harp_geographic_extent_add_latitude(harp_geographic_extent *extent, double latitude);
+void harp_geographic_extent_add_longitude(harp_geographic_extent *extent, double longitude);
+void harp_geographic_extent_add_longitude_range(harp_geographic_extent *extent, double longitude_from,
+                                                double longitude_to);
+void harp_geographic_extent_add_polygon(harp_geographic_extent *extent, long num_vertices, const double *latitude,
+                                        const double *longitude);
+int harp_geographic_extent_get_range(const harp_geographic_extent *extent, double *latitude_min,
+                                     double *latitude_max, double *longitude_min, double *longitude_max);
+int harp_geographic_longitude_ranges_overlap(double longitude_min_a, double longitude_max_a, double longitude_min_b,
+                                             double longitude_max_b);
+
 void harp_get_grid_corner_coordinates(long num_x, long num_y, const double *longitude, const double *latitude,
                                       double *longitude_edge, double *latitude_edge);
 
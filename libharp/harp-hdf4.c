@@ -53,6 +53,12 @@ typedef enum hdf4_dimension_type_enum
     hdf4_dimension_scalar
 } hdf4_dimension_type;
 
+struct harp_hdf4_stream_struct
+{
+    int32 sd_id;
+    long num_time_elements; /* number of records written so far */
+};
+
 static const char *get_dimension_type_name(hdf4_dimension_type dimension_type)
 {
     switch (dimension_type)
@@ -832,6 +838,40 @@ static int update_dimensions_with_variable(long dimension[], int32 sds_id)
     return 0;
 }
 
+/* read the bounding box of the product (it remains unknown if any of the attributes is absent) */
+static int read_bounding_box_attributes(int32 sd_id, harp_product_metadata *metadata)
+{
+    const char *name[4] = { "geospatial_lat_min", "geospatial_lat_max", "geospatial_lon_min", "geospatial_lon_max" };
+    harp_data_type data_type;
+    harp_scalar value[4];
+    int32 hdf4_index;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        hdf4_index = SDfindattr(sd_id, name[i]);
+        if (hdf4_index < 0)
+        {
+            return 0;
+        }
+        if (read_numeric_attribute(sd_id, hdf4_index, &data_type, &value[i]) != 0)
+        {
+            return -1;
+        }
+        if (data_type != harp_type_double)
+        {
+            harp_set_error(HARP_ERROR_IMPORT, "attribute '%s' has invalid type", name[i]);
+            return -1;
+        }
+    }
+    metadata->latitude_min = value[0].double_data;
+    metadata->latitude_max = value[1].double_data;
+    metadata->longitude_min = value[2].double_data;
+    metadata->longitude_max = value[3].double_data;
+
+    return 0;
+}
+
 int harp_import_metadata_hdf4(const char *filename, harp_product_metadata *metadata)
 {
     harp_scalar value;
@@ -908,6 +948,12 @@ int harp_import_metadata_hdf4(const char *filename, harp_product_metadata *metad
         metadata->datetime_stop = harp_plusinf();
     }
 
+    if (read_bounding_box_attributes(sd_id, metadata) != 0)
+    {
+        SDend(sd_id);
+        return -1;
+    }
+
     /* dimension */
     if (SDfileinfo(sd_id, &num_sds, &hdf4_num_attributes) != 0)
     {
@@ -1086,10 +1132,11 @@ static int write_dimensions(int32 sds_id, int num_dimensions, const hdf4_dimensi
     return 0;
 }
 
-static int write_variable(harp_variable *variable, int32 sd_id)
+static int write_variable(harp_variable *variable, int32 sd_id, int extendible)
 {
     hdf4_dimension_type dimension_type[MAX_HDF4_VAR_DIMS];
     int32 dimension[MAX_HDF4_VAR_DIMS];
+    int32 create_dimension[MAX_HDF4_VAR_DIMS];
     int32 start[MAX_HDF4_VAR_DIMS] = { 0 };
     int32 sds_id;
     int32 num_dimensions;
@@ -1110,6 +1157,8 @@ static int write_variable(harp_variable *variable, int32 sd_id)
         }
         num_dimensions = variable->num_dimensions;
     }
+    /* only the time dimension can be extended */
+    extendible = extendible && variable->num_dimensions > 0 && variable->dimension_type[0] == harp_dimension_time;
 
     /* Write data. */
     if (variable->data_type == harp_type_string)
@@ -1130,7 +1179,13 @@ static int write_variable(harp_variable *variable, int32 sd_id)
         dimension[num_dimensions] = length;
         num_dimensions++;
 
-        sds_id = SDcreate(sd_id, variable->name, DFNT_CHAR, num_dimensions, dimension);
+        memcpy(create_dimension, dimension, num_dimensions * sizeof(int32));
+        if (extendible)
+        {
+            /* use an unlimited time dimension so records can be appended later on */
+            create_dimension[0] = SD_UNLIMITED;
+        }
+        sds_id = SDcreate(sd_id, variable->name, DFNT_CHAR, num_dimensions, create_dimension);
         if (sds_id == -1)
         {
             harp_set_error(HARP_ERROR_HDF4, NULL);
@@ -1150,7 +1205,14 @@ static int write_variable(harp_variable *variable, int32 sd_id)
     }
     else
     {
-        sds_id = SDcreate(sd_id, variable->name, get_hdf4_type(variable->data_type), num_dimensions, dimension);
+        memcpy(create_dimension, dimension, num_dimensions * sizeof(int32));
+        if (extendible)
+        {
+            /* use an unlimited time dimension so records can be appended later on */
+            create_dimension[0] = SD_UNLIMITED;
+        }
+        sds_id = SDcreate(sd_id, variable->name, get_hdf4_type(variable->data_type), num_dimensions,
+                          create_dimension);
         if (sds_id == -1)
         {
             harp_set_error(HARP_ERROR_HDF4, NULL);
@@ -1246,7 +1308,37 @@ static int write_variable(harp_variable *variable, int32 sd_id)
     return 0;
 }
 
-static int write_product(const harp_product *product, int32 sd_id)
+/* write the bounding box of the product (if it has latitude/longitude information) */
+static int write_bounding_box_attributes(int32 sd_id, const harp_product *product)
+{
+    const char *name[4] = { "geospatial_lat_min", "geospatial_lat_max", "geospatial_lon_min", "geospatial_lon_max" };
+    harp_scalar value[4];
+    int result;
+    int i;
+
+    result = harp_product_get_spatial_extent(product, &value[0].double_data, &value[1].double_data,
+                                             &value[2].double_data, &value[3].double_data);
+    if (result < 0)
+    {
+        return -1;
+    }
+    if (result == 1)
+    {
+        /* no latitude/longitude information */
+        return 0;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        if (write_numeric_attribute(sd_id, name[i], harp_type_double, value[i]) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int write_product(const harp_product *product, int32 sd_id, int streaming)
 {
     harp_scalar datetime_start;
     harp_scalar datetime_stop;
@@ -1258,8 +1350,9 @@ static int write_product(const harp_product *product, int32 sd_id)
         return -1;
     }
 
-    /* Write attributes. */
-    if (harp_product_get_datetime_range(product, &datetime_start.double_data, &datetime_stop.double_data) == 0)
+    /* Write attributes (for a streamed product the datetime range is only known when the stream is closed). */
+    if (!streaming &&
+        harp_product_get_datetime_range(product, &datetime_start.double_data, &datetime_stop.double_data) == 0)
     {
         if (write_numeric_attribute(sd_id, "datetime_start", harp_type_double, datetime_start) != 0)
         {
@@ -1271,6 +1364,10 @@ static int write_product(const harp_product *product, int32 sd_id)
             return -1;
         }
     }
+    if (!streaming && write_bounding_box_attributes(sd_id, product) != 0)
+    {
+        return -1;
+    }
 
     if (product->source_product != NULL && strcmp(product->source_product, "") != 0)
     {
@@ -1291,7 +1388,7 @@ static int write_product(const harp_product *product, int32 sd_id)
     /* Write variables. */
     for (i = 0; i < product->num_variables; i++)
     {
-        if (write_variable(product->variable[i], sd_id) != 0)
+        if (write_variable(product->variable[i], sd_id, streaming) != 0)
         {
             return -1;
         }
@@ -1324,7 +1421,7 @@ int harp_export_hdf4(const char *filename, const harp_product *product)
         return -1;
     }
 
-    if (write_product(product, sd_id) != 0)
+    if (write_product(product, sd_id, 0) != 0)
     {
         harp_add_error_message(" (%s)", filename);
         SDend(sd_id);
@@ -1341,6 +1438,187 @@ int harp_export_hdf4(const char *filename, const harp_product *product)
     return 0;
 }
 
+/* Create an HDF4 file for 'product' with an unlimited time dimension, such that the records of other (compatible)
+ * products can be appended to it with harp_export_hdf4_stream_append().
+ * All variables of 'product' should be time dependent.
+ */
+int harp_export_hdf4_stream_open(const char *filename, const harp_product *product, harp_hdf4_stream **new_stream)
+{
+    harp_hdf4_stream *stream;
+    int32 sd_id;
+
+    if (filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "filename is NULL");
+        return -1;
+    }
+
+    if (product == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product is NULL");
+        return -1;
+    }
+
+    stream = malloc(sizeof(harp_hdf4_stream));
+    if (stream == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(harp_hdf4_stream), __FILE__, __LINE__);
+        return -1;
+    }
+
+    sd_id = SDstart(filename, DFACC_CREATE);
+    if (sd_id == -1)
+    {
+        harp_set_error(HARP_ERROR_HDF4, NULL);
+        harp_add_error_message(" (%s)", filename);
+        free(stream);
+        return -1;
+    }
+
+    if (write_product(product, sd_id, 1) != 0)
+    {
+        harp_add_error_message(" (%s)", filename);
+        SDend(sd_id);
+        free(stream);
+        return -1;
+    }
+
+    stream->sd_id = sd_id;
+    stream->num_time_elements = product->dimension[harp_dimension_time];
+
+    *new_stream = stream;
+
+    return 0;
+}
+
+/* Append the records of 'product' to the file.
+ * The product should have been verified to be compatible with the product that was used to open the stream.
+ */
+int harp_export_hdf4_stream_append(harp_hdf4_stream *stream, const harp_product *product)
+{
+    int i;
+
+    for (i = 0; i < product->num_variables; i++)
+    {
+        harp_variable *variable = product->variable[i];
+        char name[MAX_HDF4_NAME_LENGTH + 1];
+        int32 dimension[MAX_HDF4_VAR_DIMS];
+        int32 start[MAX_HDF4_VAR_DIMS];
+        int32 num_dimensions;
+        int32 data_type;
+        int32 num_attributes;
+        int32 sds_index;
+        int32 sds_id;
+        int32 result;
+        int j;
+
+        assert(variable->num_dimensions > 0 && variable->dimension_type[0] == harp_dimension_time);
+
+        sds_index = SDnametoindex(stream->sd_id, variable->name);
+        if (sds_index == -1)
+        {
+            harp_set_error(HARP_ERROR_HDF4, NULL);
+            return -1;
+        }
+        sds_id = SDselect(stream->sd_id, sds_index);
+        if (sds_id == -1)
+        {
+            harp_set_error(HARP_ERROR_HDF4, NULL);
+            return -1;
+        }
+        if (SDgetinfo(sds_id, name, &num_dimensions, dimension, &data_type, &num_attributes) != 0)
+        {
+            harp_set_error(HARP_ERROR_HDF4, NULL);
+            SDendaccess(sds_id);
+            return -1;
+        }
+
+        start[0] = stream->num_time_elements;
+        dimension[0] = variable->dimension[0];
+        for (j = 1; j < variable->num_dimensions; j++)
+        {
+            start[j] = 0;
+            dimension[j] = variable->dimension[j];
+        }
+
+        if (variable->data_type == harp_type_string)
+        {
+            /* the length of the string dimension was fixed when the variable was created */
+            long length = dimension[variable->num_dimensions];
+            char *buffer;
+
+            if (harp_get_max_string_length(variable->num_elements, variable->data.string_data) > length)
+            {
+                harp_set_error(HARP_ERROR_EXPORT, "string length of variable '%s' exceeds the string length of the "
+                               "exported variable (%ld)", variable->name, length);
+                SDendaccess(sds_id);
+                return -1;
+            }
+            if (harp_get_char_array_from_string_array(variable->num_elements, variable->data.string_data, length,
+                                                      NULL, &buffer) != 0)
+            {
+                SDendaccess(sds_id);
+                return -1;
+            }
+            start[variable->num_dimensions] = 0;
+            result = SDwritedata(sds_id, start, NULL, dimension, buffer);
+            free(buffer);
+        }
+        else
+        {
+            result = SDwritedata(sds_id, start, NULL, dimension, variable->data.ptr);
+        }
+        if (result != 0)
+        {
+            harp_set_error(HARP_ERROR_HDF4, NULL);
+            SDendaccess(sds_id);
+            return -1;
+        }
+
+        SDendaccess(sds_id);
+    }
+    stream->num_time_elements += product->dimension[harp_dimension_time];
+
+    return 0;
+}
+
+/* Finalize and close the file.
+ * If 'datetime_range' is not NULL it should contain the datetime_start and datetime_stop values of the full product.
+ * The stream is always closed (and freed), also if an error occurs.
+ */
+int harp_export_hdf4_stream_close(harp_hdf4_stream *stream, const double *datetime_range)
+{
+    int32 sd_id;
+
+    sd_id = stream->sd_id;
+    free(stream);
+
+    if (datetime_range != NULL)
+    {
+        harp_scalar datetime_start;
+        harp_scalar datetime_stop;
+
+        datetime_start.double_data = datetime_range[0];
+        datetime_stop.double_data = datetime_range[1];
+
+        if (write_numeric_attribute(sd_id, "datetime_start", harp_type_double, datetime_start) != 0 ||
+            write_numeric_attribute(sd_id, "datetime_stop", harp_type_double, datetime_stop) != 0)
+        {
+            SDend(sd_id);
+            return -1;
+        }
+    }
+
+    if (SDend(sd_id) != 0)
+    {
+        harp_set_error(HARP_ERROR_HDF4, NULL);
+        return -1;
+    }
+
+    return 0;
+}
+
 void harp_hdf4_add_error_message(void)
 {
     int error = HEvalue(1);
@@ -38,6 +38,15 @@
 #include "hdf5.h"
 #include "hdf5_hl.h"
 
+/* With zlib available and HDF5 >= 1.10.3 we compress chunks ourselves (in parallel) and write them directly to file */
+#if defined(HAVE_ZLIB) && H5_VERSION_GE(1, 10, 3)
+#define HARP_HDF5_DIRECT_CHUNK_WRITE
+#include <zlib.h>
+#endif
+
+/* Maximum number of chunks that are compressed in parallel before being written to file */
+#define HARP_HDF5_CHUNK_BATCH_SIZE 256
+
 /* String value used in netCDF-4 files as the NAME attribute for dimension scales without coordinate variables. This
  * #define statement was copied verbatim from netcdf.h and should be kept in sync with future updates of the netCDF-4
  * library.
@@ -66,6 +75,12 @@ typedef struct hdf5_dimensions_struct
     hid_t *dataset_id;
 } hdf5_dimensions;
 
+struct harp_hdf5_stream_struct
+{
+    hid_t file_id;
+    long num_time_elements; /* length of the time dimension written so far */
+};
+
 /* A unique identifier for HDF5 objects based on the corresponding members of the H5O_info_t struct (defined in
  * H5Opublic.h). See also H5Oget_info().
  */
@@ -371,55 +386,462 @@ static int get_link_iteration_index_type(hid_t group_id, H5_index_t * index_type
     return 0;
 }
 
-static int set_compression(hid_t plist_id, harp_variable *variable)
+static int set_chunking(hid_t plist_id, harp_variable *variable, long element_size, int extendible)
+{
+    long max_length = 4294967295;
+    long chunk_size = harp_get_option_hdf5_chunk_size();
+    long num_elements;
+    hsize_t dimension[HARP_MAX_NUM_DIMS];
+    int i;
+
+    for (i = 0; i < variable->num_dimensions; i++)
+    {
+        dimension[i] = variable->dimension[i];
+    }
+    if (chunk_size > 0 && variable->dimension_type[0] == harp_dimension_time)
+    {
+        long slice_size = element_size;
+        long num_time_elements;
+
+        /* chunk along the time dimension such that each chunk is (close to) chunk_size bytes */
+        for (i = 1; i < variable->num_dimensions; i++)
+        {
+            slice_size *= variable->dimension[i];
+        }
+        num_time_elements = slice_size > 0 ? chunk_size / slice_size : variable->dimension[0];
+        if (!extendible && num_time_elements > variable->dimension[0])
+        {
+            num_time_elements = variable->dimension[0];
+        }
+        if (num_time_elements < 1)
+        {
+            num_time_elements = 1;
+        }
+        dimension[0] = num_time_elements;
+    }
+
+    /* we want to use the largest block possible while staying within the 2^32-1 elements per chunk limit */
+    num_elements = 1;
+    for (i = 0; i < variable->num_dimensions; i++)
+    {
+        num_elements *= (long)dimension[i];
+    }
+    if (num_elements > max_length)
+    {
+        int i = 0;
+
+        while (i < variable->num_dimensions - 1)
+        {
+            num_elements /= (long)dimension[i];
+            if (num_elements <= max_length)
+            {
+                dimension[i] = max_length / num_elements;
+                num_elements *= (long)dimension[i];
+                break;
+            }
+            dimension[i] = 1;
+            i++;
+        }
+        if (num_elements > max_length)
+        {
+            dimension[i] = max_length;
+        }
+    }
+    if (H5Pset_chunk(plist_id, variable->num_dimensions, dimension) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Set chunking and compression for a variable.
+ * Extendible datasets need a chunked layout, so for those chunking is always enabled.
+ * The element_size is the size in bytes of a single element as stored in the file.
+ */
+static int set_compression(hid_t plist_id, harp_variable *variable, long element_size, int extendible)
 {
     int level = harp_get_option_hdf5_compression();
 
+    if ((level > 0 || extendible) && variable->num_dimensions > 0)
+    {
+        /* set chunk configuration (we need chunking to enable compression) */
+        if (set_chunking(plist_id, variable, element_size, extendible) != 0)
+        {
+            return -1;
+        }
+    }
     if (level > 0 && variable->num_dimensions > 0)
     {
-        long max_length = 4294967295;
-        hsize_t dimension[HARP_MAX_NUM_DIMS];
-        int i;
+        if (harp_get_option_hdf5_shuffle())
+        {
+            /* the shuffle filter needs to come before the deflate filter in the pipeline */
+            if (H5Pset_shuffle(plist_id) < 0)
+            {
+                harp_set_error(HARP_ERROR_HDF5, NULL);
+                return -1;
+            }
+        }
+        if (H5Pset_deflate(plist_id, level) < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            return -1;
+        }
+    }
+    return 0;
+}
 
-        /* set chunk configuration (we need chunking to enable compression) */
-        /* we want to use the largest block possible while staying within the 2^32-1 elements per chunk limit */
-        for (i = 0; i < variable->num_dimensions; i++)
+#ifdef HARP_HDF5_DIRECT_CHUNK_WRITE
+/* Create the filtered (i.e. shuffled and deflated) data for a single chunk. The part of an edge chunk that falls
+ * outside the dataset is set to the fill value (HDF5 always stores complete chunks).
+ * This produces exactly the same chunk data as HDF5 would create using its own shuffle and deflate filters.
+ */
+static int get_filtered_chunk(int num_dimensions, const hsize_t *dimension, const hsize_t *chunk_dimension,
+                              const hsize_t *offset, long element_size, const char *data, const char *fill_value,
+                              int level, int shuffle, void **filtered_chunk, size_t *filtered_chunk_size)
+{
+    hsize_t index[HARP_MAX_NUM_DIMS];
+    size_t num_chunk_elements = 1;
+    size_t chunk_size;
+    size_t row_size;
+    uLongf compressed_size;
+    char *chunk;
+    char *compressed_chunk;
+    int is_edge_chunk = 0;
+    int i;
+
+    for (i = 0; i < num_dimensions; i++)
+    {
+        num_chunk_elements *= (size_t)chunk_dimension[i];
+        if (offset[i] + chunk_dimension[i] > dimension[i])
         {
-            dimension[i] = variable->dimension[i];
+            is_edge_chunk = 1;
         }
-        if (variable->num_elements > max_length)
+        index[i] = 0;
+    }
+    chunk_size = num_chunk_elements * element_size;
+
+    chunk = calloc(chunk_size == 0 ? 1 : chunk_size, 1);
+    if (chunk == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (unsigned long)chunk_size, __FILE__, __LINE__);
+        return -1;
+    }
+    if (is_edge_chunk && fill_value != NULL)
+    {
+        size_t j;
+
+        for (j = 0; j < num_chunk_elements; j++)
         {
-            long num_elements = variable->num_elements;
-            int i = 0;
+            memcpy(&chunk[j * element_size], fill_value, element_size);
+        }
+    }
 
-            while (i < variable->num_dimensions - 1)
+    /* copy the data row by row (a row being the part of the chunk along the last dimension) */
+    row_size = (size_t)chunk_dimension[num_dimensions - 1];
+    if (offset[num_dimensions - 1] + row_size > dimension[num_dimensions - 1])
+    {
+        row_size = (size_t)(dimension[num_dimensions - 1] - offset[num_dimensions - 1]);
+    }
+    row_size *= element_size;
+    for (;;)
+    {
+        size_t source_offset = 0;
+        size_t target_offset = 0;
+        int in_range = 1;
+
+        for (i = 0; i < num_dimensions; i++)
+        {
+            if (offset[i] + index[i] >= dimension[i])
             {
-                num_elements /= (long)dimension[i];
-                if (num_elements <= max_length)
-                {
-                    dimension[i] = max_length / num_elements;
-                    num_elements *= (long)dimension[i];
-                    break;
-                }
-                dimension[i] = 1;
-                i++;
+                in_range = 0;
+                break;
             }
-            if (num_elements > max_length)
+            source_offset = source_offset * (size_t)dimension[i] + (size_t)(offset[i] + index[i]);
+            target_offset = target_offset * (size_t)chunk_dimension[i] + (size_t)index[i];
+        }
+        if (in_range)
+        {
+            memcpy(&chunk[target_offset * element_size], &data[source_offset * element_size], row_size);
+        }
+
+        /* go to the next row */
+        i = num_dimensions - 2;
+        while (i >= 0)
+        {
+            index[i]++;
+            if (index[i] < chunk_dimension[i])
             {
-                dimension[i] = max_length;
+                break;
             }
+            index[i] = 0;
+            i--;
         }
-        if (H5Pset_chunk(plist_id, variable->num_dimensions, dimension) < 0)
+        if (i < 0)
         {
-            harp_set_error(HARP_ERROR_HDF5, NULL);
+            break;
+        }
+    }
+
+    if (shuffle && element_size > 1 && num_chunk_elements > 1)
+    {
+        char *shuffled_chunk;
+        size_t j;
+
+        shuffled_chunk = malloc(chunk_size);
+        if (shuffled_chunk == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (unsigned long)chunk_size, __FILE__, __LINE__);
+            free(chunk);
             return -1;
         }
-        if (H5Pset_deflate(plist_id, level) < 0)
+        for (j = 0; j < num_chunk_elements; j++)
+        {
+            long k;
+
+            for (k = 0; k < element_size; k++)
+            {
+                shuffled_chunk[k * num_chunk_elements + j] = chunk[j * element_size + k];
+            }
+        }
+        free(chunk);
+        chunk = shuffled_chunk;
+    }
+
+    compressed_size = compressBound((uLong)chunk_size);
+    compressed_chunk = malloc(compressed_size);
+    if (compressed_chunk == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (unsigned long)compressed_size, __FILE__, __LINE__);
+        free(chunk);
+        return -1;
+    }
+    if (compress2((Bytef *)compressed_chunk, &compressed_size, (const Bytef *)chunk, (uLong)chunk_size, level) != Z_OK)
+    {
+        harp_set_error(HARP_ERROR_EXPORT, "could not compress chunk data");
+        free(compressed_chunk);
+        free(chunk);
+        return -1;
+    }
+    free(chunk);
+
+    *filtered_chunk = compressed_chunk;
+    *filtered_chunk_size = (size_t)compressed_size;
+
+    return 0;
+}
+
+/* Write the data of a compressed dataset by compressing the chunks in parallel and writing them using direct chunk
+ * writes. Returns 1 if the dataset does not qualify for this (e.g. if it consists of a single chunk), in which case
+ * nothing is written.
+ */
+static int write_chunked_data(hid_t dataset_id, long element_size, const void *data)
+{
+    hsize_t dimension[HARP_MAX_NUM_DIMS];
+    hsize_t chunk_dimension[HARP_MAX_NUM_DIMS];
+    hsize_t num_chunks_per_dimension[HARP_MAX_NUM_DIMS];
+    void *filtered_chunk[HARP_HDF5_CHUNK_BATCH_SIZE];
+    size_t filtered_chunk_size[HARP_HDF5_CHUNK_BATCH_SIZE];
+    int level = harp_get_option_hdf5_compression();
+    int shuffle = harp_get_option_hdf5_shuffle();
+    H5D_fill_value_t fill_value_status;
+    char *fill_value = NULL;
+    long num_chunks = 1;
+    long batch_offset;
+    hid_t space_id;
+    hid_t dcpl_id;
+    int num_dimensions;
+    int i;
+
+    if (level == 0)
+    {
+        return 1;
+    }
+
+    space_id = H5Dget_space(dataset_id);
+    if (space_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+    num_dimensions = H5Sget_simple_extent_dims(space_id, dimension, NULL);
+    H5Sclose(space_id);
+    if (num_dimensions < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+    if (num_dimensions == 0 || num_dimensions > HARP_MAX_NUM_DIMS)
+    {
+        return 1;
+    }
+
+    dcpl_id = H5Dget_create_plist(dataset_id);
+    if (dcpl_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+    if (H5Pget_layout(dcpl_id) != H5D_CHUNKED || H5Pget_chunk(dcpl_id, num_dimensions, chunk_dimension) != num_dimensions)
+    {
+        H5Pclose(dcpl_id);
+        return 1;
+    }
+    for (i = 0; i < num_dimensions; i++)
+    {
+        if (dimension[i] == 0)
+        {
+            /* nothing to write */
+            H5Pclose(dcpl_id);
+            return 0;
+        }
+        num_chunks_per_dimension[i] = (dimension[i] + chunk_dimension[i] - 1) / chunk_dimension[i];
+        num_chunks *= (long)num_chunks_per_dimension[i];
+    }
+    if (num_chunks == 1)
+    {
+        /* nothing to parallelise; let the HDF5 library compress the single chunk without an extra copy */
+        H5Pclose(dcpl_id);
+        return 1;
+    }
+    if (H5Pfill_value_defined(dcpl_id, &fill_value_status) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        H5Pclose(dcpl_id);
+        return -1;
+    }
+    if (fill_value_status == H5D_FILL_VALUE_USER_DEFINED)
+    {
+        hid_t data_type_id;
+
+        /* edge chunks need to be padded with the fill value */
+        fill_value = malloc(element_size);
+        if (fill_value == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (unsigned long)element_size, __FILE__, __LINE__);
+            H5Pclose(dcpl_id);
+            return -1;
+        }
+        data_type_id = H5Dget_type(dataset_id);
+        if (data_type_id < 0 || H5Pget_fill_value(dcpl_id, data_type_id, fill_value) < 0)
         {
             harp_set_error(HARP_ERROR_HDF5, NULL);
+            if (data_type_id >= 0)
+            {
+                H5Tclose(data_type_id);
+            }
+            free(fill_value);
+            H5Pclose(dcpl_id);
+            return -1;
+        }
+        H5Tclose(data_type_id);
+    }
+    H5Pclose(dcpl_id);
+
+    for (batch_offset = 0; batch_offset < num_chunks; batch_offset += HARP_HDF5_CHUNK_BATCH_SIZE)
+    {
+        int batch_size = HARP_HDF5_CHUNK_BATCH_SIZE;
+        int failed = 0;
+        int j;
+
+        if (batch_offset + batch_size > num_chunks)
+        {
+            batch_size = (int)(num_chunks - batch_offset);
+        }
+        for (j = 0; j < batch_size; j++)
+        {
+            filtered_chunk[j] = NULL;
+        }
+
+        /* compressing a chunk does not involve the HDF5 library, so this can be done in parallel */
+#pragma omp parallel for reduction(|:failed) schedule(dynamic) num_threads(harp_get_num_threads())
+        for (j = 0; j < batch_size; j++)
+        {
+            hsize_t offset[HARP_MAX_NUM_DIMS];
+            long chunk_index = batch_offset + j;
+            int k;
+
+            for (k = num_dimensions - 1; k >= 0; k--)
+            {
+                offset[k] = (chunk_index % num_chunks_per_dimension[k]) * chunk_dimension[k];
+                chunk_index /= (long)num_chunks_per_dimension[k];
+            }
+            if (get_filtered_chunk(num_dimensions, dimension, chunk_dimension, offset, element_size, data, fill_value,
+                                   level, shuffle, &filtered_chunk[j], &filtered_chunk_size[j]) != 0)
+            {
+                failed |= 1;
+            }
+        }
+
+        for (j = 0; j < batch_size && !failed; j++)
+        {
+            hsize_t offset[HARP_MAX_NUM_DIMS];
+            long chunk_index = batch_offset + j;
+            int k;
+
+            for (k = num_dimensions - 1; k >= 0; k--)
+            {
+                offset[k] = (chunk_index % num_chunks_per_dimension[k]) * chunk_dimension[k];
+                chunk_index /= (long)num_chunks_per_dimension[k];
+            }
+            if (H5Dwrite_chunk(dataset_id, H5P_DEFAULT, 0, offset, filtered_chunk_size[j], filtered_chunk[j]) < 0)
+            {
+                harp_set_error(HARP_ERROR_HDF5, NULL);
+                failed = 1;
+            }
+        }
+
+        for (j = 0; j < batch_size; j++)
+        {
+            if (filtered_chunk[j] != NULL)
+            {
+                free(filtered_chunk[j]);
+            }
+        }
+        if (failed)
+        {
+            if (fill_value != NULL)
+            {
+                free(fill_value);
+            }
             return -1;
         }
     }
+
+    if (fill_value != NULL)
+    {
+        free(fill_value);
+    }
+
+    return 0;
+}
+#endif
+
+/* Write the full data of a dataset */
+static int write_data(hid_t dataset_id, hid_t mem_type_id, long element_size, const void *data)
+{
+#ifdef HARP_HDF5_DIRECT_CHUNK_WRITE
+    int result;
+
+    result = write_chunked_data(dataset_id, element_size, data);
+    if (result != 1)
+    {
+        return result;
+    }
+#else
+    (void)element_size;
+#endif
+    if (H5Dwrite(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+
     return 0;
 }
 
@@ -781,45 +1203,9 @@ static int read_variable_dimensions(const char *variable_name, hid_t dataset_id,
     return 0;
 }
 
-static int read_variable(hid_t dataset_id, const char *name, const hdf5_dimension_ids *dimension_ids,
-                         harp_product *product)
+static int read_variable_data(hid_t dataset_id, harp_variable *variable)
 {
-    const char *variable_name;
-    harp_variable *variable;
-    harp_dimension_type dimension_type[HARP_MAX_NUM_DIMS];
-    long dimension[HARP_MAX_NUM_DIMS];
-    harp_data_type data_type;
-    int num_dimensions;
-    herr_t result;
-
-    if (read_variable_data_type(dataset_id, &data_type) != 0)
-    {
-        return -1;
-    }
-
-    if (read_variable_dimensions(name, dataset_id, dimension_ids, &num_dimensions, dimension_type, dimension) != 0)
-    {
-        return -1;
-    }
-
-    variable_name = name;
-    if (strncmp(name, "_nc4_non_coord_", 15) == 0)
-    {
-        variable_name = &name[15];
-    }
-    if (harp_variable_new(variable_name, data_type, num_dimensions, dimension_type, dimension, &variable) != 0)
-    {
-        return -1;
-    }
-
-    if (harp_product_add_variable(product, variable) != 0)
-    {
-        harp_variable_delete(variable);
-        return -1;
-    }
-
-    /* Read variable data. */
-    if (variable->data_type == harp_type_string)
+    if (variable->data_type == harp_type_string)
     {
         char *buffer;
         hid_t type_id;
@@ -914,6 +1300,64 @@ static int read_variable(hid_t dataset_id, const char *name, const hdf5_dimensio
         }
     }
 
+    return 0;
+}
+
+static int read_variable(const char *filename, int lazy, hid_t dataset_id, const char *name,
+                         const hdf5_dimension_ids *dimension_ids, harp_product *product)
+{
+    const char *variable_name;
+    harp_variable *variable;
+    harp_dimension_type dimension_type[HARP_MAX_NUM_DIMS];
+    long dimension[HARP_MAX_NUM_DIMS];
+    harp_data_type data_type;
+    int num_dimensions;
+    herr_t result;
+
+    if (read_variable_data_type(dataset_id, &data_type) != 0)
+    {
+        return -1;
+    }
+
+    if (read_variable_dimensions(name, dataset_id, dimension_ids, &num_dimensions, dimension_type, dimension) != 0)
+    {
+        return -1;
+    }
+
+    variable_name = name;
+    if (strncmp(name, "_nc4_non_coord_", 15) == 0)
+    {
+        variable_name = &name[15];
+    }
+    if (lazy)
+    {
+        /* the data is only read when it is first needed (see harp_import_variable_data_hdf5()) */
+        if (harp_variable_new_from_source(variable_name, data_type, num_dimensions, dimension_type, dimension,
+                                          harp_variable_source_hdf5, filename, name, &variable) != 0)
+        {
+            return -1;
+        }
+    }
+    else if (harp_variable_new(variable_name, data_type, num_dimensions, dimension_type, dimension, &variable) != 0)
+    {
+        return -1;
+    }
+
+    if (harp_product_add_variable(product, variable) != 0)
+    {
+        harp_variable_delete(variable);
+        return -1;
+    }
+
+    if (!lazy)
+    {
+        if (read_variable_data(dataset_id, variable) != 0)
+        {
+            harp_add_error_message(" (dataset '%s')", name);
+            return -1;
+        }
+    }
+
     /* Read variable attributes. */
     result = H5Aexists(dataset_id, "description");
     if (result > 0)
@@ -1141,6 +1585,8 @@ static int find_dimensions(hid_t group_id, hdf5_dimension_ids *dimension_ids)
  */
 typedef struct hdf5_read_variable_func_args_struct
 {
+    const char *filename;
+    int lazy;
     hdf5_dimension_ids *dimension_ids;
     harp_product *product;
 } hdf5_read_variable_func_args;
@@ -1203,7 +1649,7 @@ static herr_t hdf5_read_variable_func(hid_t group_id, const char *name, const H5
         }
     }
 
-    if (read_variable(dataset_id, name, args->dimension_ids, args->product) != 0)
+    if (read_variable(args->filename, args->lazy, dataset_id, name, args->dimension_ids, args->product) != 0)
     {
         H5Dclose(dataset_id);
         return 1;
@@ -1214,7 +1660,8 @@ static herr_t hdf5_read_variable_func(hid_t group_id, const char *name, const H5
     return 0;
 }
 
-static int read_variables(hid_t group_id, hdf5_dimension_ids *dimension_ids, harp_product *product)
+static int read_variables(const char *filename, int lazy, hid_t group_id, hdf5_dimension_ids *dimension_ids,
+                          harp_product *product)
 {
     hdf5_read_variable_func_args args;
     H5_index_t index_type;
@@ -1224,6 +1671,8 @@ static int read_variables(hid_t group_id, hdf5_dimension_ids *dimension_ids, har
         return -1;
     }
 
+    args.filename = filename;
+    args.lazy = lazy;
     args.dimension_ids = dimension_ids;
     args.product = product;
 
@@ -1265,7 +1714,7 @@ static int read_attributes(hid_t group_id, harp_product *product)
     return 0;
 }
 
-static int read_product(hid_t file_id, harp_product *product)
+static int read_product(const char *filename, int lazy, hid_t file_id, harp_product *product)
 {
     hdf5_dimension_ids dimension_ids = { {0}, {{0, 0}}, {0} };
     hid_t root_id;
@@ -1285,7 +1734,7 @@ static int read_product(hid_t file_id, harp_product *product)
     }
 
     /* Read variables. */
-    if (read_variables(root_id, &dimension_ids, product) != 0)
+    if (read_variables(filename, lazy, root_id, &dimension_ids, product) != 0)
     {
         H5Gclose(root_id);
         return -1;
@@ -1335,7 +1784,10 @@ static int verify_product(hid_t file_id)
     return -1;
 }
 
-int harp_import_hdf5(const char *filename, harp_product **product)
+/* Import a HARP product from an HDF5 file.
+ * If 'lazy' is set, the data of the variables is not read, but only when it is first needed (see harp_variable_load()).
+ */
+int harp_import_hdf5(const char *filename, int lazy, harp_product **product)
 {
     harp_product *new_product;
     hid_t file_id;
@@ -1360,7 +1812,7 @@ int harp_import_hdf5(const char *filename, harp_product **product)
         return -1;
     }
 
-    if (read_product(file_id, new_product) != 0)
+    if (read_product(filename, lazy, file_id, new_product) != 0)
     {
         harp_add_error_message(" (%s)", filename);
         harp_product_delete(new_product);
@@ -1375,6 +1827,90 @@ int harp_import_hdf5(const char *filename, harp_product **product)
     return 0;
 }
 
+/* Read the data of variables that were imported from 'filename' by harp_import_hdf5().
+ * 'dataset_name' contains the name of the dataset in the file for each variable. The data of each variable should
+ * already have been allocated.
+ */
+int harp_import_variable_data_hdf5(const char *filename, int num_variables, const char **dataset_name,
+                                   harp_variable **variable)
+{
+    hid_t file_id;
+    int i;
+
+    file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        harp_add_error_message(" (%s)", filename);
+        return -1;
+    }
+
+    for (i = 0; i < num_variables; i++)
+    {
+        hid_t dataset_id;
+
+        dataset_id = H5Dopen(file_id, dataset_name[i]);
+        if (dataset_id < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            harp_add_error_message(" (dataset '%s' in %s)", dataset_name[i], filename);
+            H5Fclose(file_id);
+            return -1;
+        }
+        if (read_variable_data(dataset_id, variable[i]) != 0)
+        {
+            harp_add_error_message(" (dataset '%s' in %s)", dataset_name[i], filename);
+            H5Dclose(dataset_id);
+            H5Fclose(file_id);
+            return -1;
+        }
+        H5Dclose(dataset_id);
+    }
+
+    H5Fclose(file_id);
+
+    return 0;
+}
+
+/* read the bounding box of the product (it remains unknown if any of the attributes is absent) */
+static int read_bounding_box_attributes(hid_t root_id, harp_product_metadata *metadata)
+{
+    const char *name[4] = { "geospatial_lat_min", "geospatial_lat_max", "geospatial_lon_min", "geospatial_lon_max" };
+    harp_data_type data_type;
+    harp_scalar value[4];
+    htri_t result;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        result = H5Aexists(root_id, name[i]);
+        if (result < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            return -1;
+        }
+        if (result == 0)
+        {
+            return 0;
+        }
+        if (read_numeric_attribute(root_id, name[i], &data_type, &value[i]) != 0)
+        {
+            return -1;
+        }
+        if (data_type != harp_type_double)
+        {
+            harp_set_error(HARP_ERROR_IMPORT, "attribute '%s' has invalid type", name[i]);
+            return -1;
+        }
+    }
+    metadata->latitude_min = value[0].double_data;
+    metadata->latitude_max = value[1].double_data;
+    metadata->longitude_min = value[2].double_data;
+    metadata->longitude_max = value[3].double_data;
+
+    return 0;
+}
+
 int harp_import_metadata_hdf5(const char *filename, harp_product_metadata *metadata)
 {
     hdf5_dimension_ids dimension_ids = { {0}, {{0, 0}}, {0} };
@@ -1475,6 +2011,13 @@ int harp_import_metadata_hdf5(const char *filename, harp_product_metadata *metad
         metadata->datetime_stop = harp_plusinf();
     }
 
+    if (read_bounding_box_attributes(root_id, metadata) != 0)
+    {
+        H5Gclose(root_id);
+        H5Fclose(file_id);
+        return -1;
+    }
+
     /* dimension */
     /* Find dimension scales. */
     if (find_dimensions(root_id, &dimension_ids) != 0)
@@ -1688,9 +2231,10 @@ static int write_numeric_attribute(hid_t obj_id, const char *name, harp_data_typ
     return 0;
 }
 
-static int write_variable(hid_t group_id, const char *name, harp_variable *variable)
+static int write_variable(hid_t group_id, const char *name, harp_variable *variable, int extendible)
 {
     hsize_t dimension[HARP_MAX_NUM_DIMS];
+    hsize_t max_dimension[HARP_MAX_NUM_DIMS];
     hid_t space_id;
     hid_t dcpl_id;
     hid_t dataset_id;
@@ -1699,6 +2243,13 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
     for (i = 0; i < variable->num_dimensions; i++)
     {
         dimension[i] = (hsize_t)variable->dimension[i];
+        max_dimension[i] = dimension[i];
+    }
+    /* only the time dimension can be extended */
+    extendible = extendible && variable->num_dimensions > 0 && variable->dimension_type[0] == harp_dimension_time;
+    if (extendible)
+    {
+        max_dimension[0] = H5S_UNLIMITED;
     }
 
     if (variable->data_type == harp_type_string)
@@ -1737,7 +2288,7 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
             return -1;
         }
 
-        space_id = H5Screate_simple(variable->num_dimensions, dimension, NULL);
+        space_id = H5Screate_simple(variable->num_dimensions, dimension, max_dimension);
         if (space_id < 0)
         {
             harp_set_error(HARP_ERROR_HDF5, NULL);
@@ -1767,7 +2318,7 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
             return -1;
         }
 
-        if (set_compression(dcpl_id, variable) != 0)
+        if (set_compression(dcpl_id, variable, length, extendible) != 0)
         {
             H5Pclose(dcpl_id);
             H5Sclose(space_id);
@@ -1790,9 +2341,8 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
         H5Pclose(dcpl_id);
         H5Sclose(space_id);
 
-        if (H5Dwrite(dataset_id, data_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer) < 0)
+        if (write_data(dataset_id, data_type_id, length, buffer) != 0)
         {
-            harp_set_error(HARP_ERROR_HDF5, NULL);
             H5Dclose(dataset_id);
             H5Tclose(data_type_id);
             free(buffer);
@@ -1804,7 +2354,7 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
     }
     else
     {
-        space_id = H5Screate_simple(variable->num_dimensions, dimension, NULL);
+        space_id = H5Screate_simple(variable->num_dimensions, dimension, max_dimension);
         if (space_id < 0)
         {
             harp_set_error(HARP_ERROR_HDF5, NULL);
@@ -1828,7 +2378,7 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
             return -1;
         }
 
-        if (set_compression(dcpl_id, variable) != 0)
+        if (set_compression(dcpl_id, variable, harp_get_size_for_type(variable->data_type), extendible) != 0)
         {
             harp_set_error(HARP_ERROR_HDF5, NULL);
             H5Pclose(dcpl_id);
@@ -1862,10 +2412,9 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
         H5Pclose(dcpl_id);
         H5Sclose(space_id);
 
-        if (H5Dwrite(dataset_id, get_hdf5_type(variable->data_type), H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                     variable->data.ptr) < 0)
+        if (write_data(dataset_id, get_hdf5_type(variable->data_type), harp_get_size_for_type(variable->data_type),
+                       variable->data.ptr) != 0)
         {
-            harp_set_error(HARP_ERROR_HDF5, NULL);
             H5Dclose(dataset_id);
             return -1;
         }
@@ -1943,16 +2492,19 @@ static int write_variable(hid_t group_id, const char *name, harp_variable *varia
     return 0;
 }
 
-static int write_dimension(hid_t group_id, harp_dimension_type dimension_type, long length, hid_t *dimensions_id)
+static int write_dimension(hid_t group_id, harp_dimension_type dimension_type, long length, int extendible,
+                           hid_t *dimensions_id)
 {
     hid_t space_id;
     hid_t dcpl_id;
     hid_t dataset_id;
     hsize_t dimension[1];
+    hsize_t max_dimension[1];
 
     dimension[0] = length;
+    max_dimension[0] = extendible ? H5S_UNLIMITED : dimension[0];
 
-    space_id = H5Screate_simple(1, dimension, NULL);
+    space_id = H5Screate_simple(1, dimension, max_dimension);
     if (space_id < 0)
     {
         harp_set_error(HARP_ERROR_HDF5, NULL);
@@ -1976,6 +2528,18 @@ static int write_dimension(hid_t group_id, harp_dimension_type dimension_type, l
         return -1;
     }
 
+    if (extendible)
+    {
+        /* extendible datasets need a chunked layout */
+        if (H5Pset_chunk(dcpl_id, 1, dimension) < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            H5Pclose(dcpl_id);
+            H5Sclose(space_id);
+            return -1;
+        }
+    }
+
     if (dimension_type == harp_dimension_independent)
     {
         char dataset_name[64];
@@ -2019,7 +2583,8 @@ static int write_dimension(hid_t group_id, harp_dimension_type dimension_type, l
     return 0;
 }
 
-static int write_dimensions(hid_t group_id, const harp_product *product, hdf5_dimensions *dimensions)
+static int write_dimensions(hid_t group_id, const harp_product *product, hdf5_dimensions *dimensions,
+                            int extendible_time)
 {
     harp_scalar netcdf4_dimension_id;
     int i;
@@ -2058,7 +2623,8 @@ static int write_dimensions(hid_t group_id, const harp_product *product, hdf5_di
         }
 
         /* Write a dimension scale without a coordinate variable attached to it. */
-        if (write_dimension(group_id, dimension_type, product->dimension[i], &dataset_id) != 0)
+        if (write_dimension(group_id, dimension_type, product->dimension[i],
+                            extendible_time && dimension_type == harp_dimension_time, &dataset_id) != 0)
         {
             H5Dclose(dataset_id);
             return -1;
@@ -2100,7 +2666,7 @@ static int write_dimensions(hid_t group_id, const harp_product *product, hdf5_di
             }
 
             /* Write a dimension scale without a coordinate variable attached to it. */
-            if (write_dimension(group_id, harp_dimension_independent, variable->dimension[j], &dataset_id) != 0)
+            if (write_dimension(group_id, harp_dimension_independent, variable->dimension[j], 0, &dataset_id) != 0)
             {
                 H5Dclose(dataset_id);
                 return -1;
@@ -2272,12 +2838,44 @@ static int write_nc3_strict_attribute(hid_t group_id)
     return write_numeric_attribute(group_id, NC3_STRICT_ATT_NAME, harp_type_int32, nc3_strict);
 }
 
-static int write_attributes(hid_t group_id, const harp_product *product)
+/* write the bounding box of the product (if it has latitude/longitude information) */
+static int write_bounding_box_attributes(hid_t group_id, const harp_product *product)
+{
+    const char *name[4] = { "geospatial_lat_min", "geospatial_lat_max", "geospatial_lon_min", "geospatial_lon_max" };
+    harp_scalar value[4];
+    int result;
+    int i;
+
+    result = harp_product_get_spatial_extent(product, &value[0].double_data, &value[1].double_data,
+                                             &value[2].double_data, &value[3].double_data);
+    if (result < 0)
+    {
+        return -1;
+    }
+    if (result == 1)
+    {
+        /* no latitude/longitude information */
+        return 0;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        if (write_numeric_attribute(group_id, name[i], harp_type_double, value[i]) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int write_attributes(hid_t group_id, const harp_product *product, int streaming)
 {
     harp_scalar datetime_start;
     harp_scalar datetime_stop;
 
-    if (harp_product_get_datetime_range(product, &datetime_start.double_data, &datetime_stop.double_data) == 0)
+    /* for a streamed product the datetime range is only known when the stream is closed */
+    if (!streaming &&
+        harp_product_get_datetime_range(product, &datetime_start.double_data, &datetime_stop.double_data) == 0)
     {
         if (write_numeric_attribute(group_id, "datetime_start", harp_type_double, datetime_start) != 0)
         {
@@ -2289,6 +2887,10 @@ static int write_attributes(hid_t group_id, const harp_product *product)
             return -1;
         }
     }
+    if (!streaming && write_bounding_box_attributes(group_id, product) != 0)
+    {
+        return -1;
+    }
 
     if (product->source_product != NULL && strcmp(product->source_product, "") != 0)
     {
@@ -2309,7 +2911,7 @@ static int write_attributes(hid_t group_id, const harp_product *product)
     return 0;
 }
 
-static int write_product(hid_t file_id, const harp_product *product)
+static int write_product(hid_t file_id, const harp_product *product, int streaming)
 {
     hid_t root_id;
     hdf5_dimensions dimensions;
@@ -2337,7 +2939,7 @@ static int write_product(hid_t file_id, const harp_product *product)
     }
 
     /* Write product attributes. */
-    if (write_attributes(root_id, product) != 0)
+    if (write_attributes(root_id, product, streaming) != 0)
     {
         H5Gclose(root_id);
         return -1;
@@ -2346,7 +2948,7 @@ static int write_product(hid_t file_id, const harp_product *product)
     /* Write dimensions and variables. */
     dimensions_init(&dimensions);
 
-    if (write_dimensions(root_id, product, &dimensions) != 0)
+    if (write_dimensions(root_id, product, &dimensions, streaming) != 0)
     {
         dimensions_done(&dimensions);
         H5Gclose(root_id);
@@ -2362,7 +2964,7 @@ static int write_product(hid_t file_id, const harp_product *product)
         {
             return -1;
         }
-        if (write_variable(root_id, name, product->variable[i]) != 0)
+        if (write_variable(root_id, name, product->variable[i], streaming) != 0)
         {
             free(name);
             dimensions_done(&dimensions);
@@ -2444,7 +3046,7 @@ int harp_export_hdf5(const char *filename, const harp_product *product)
 
     H5Pclose(fcpl_id);
 
-    if (write_product(file_id, product) != 0)
+    if (write_product(file_id, product, 0) != 0)
     {
         harp_add_error_message(" (%s)", filename);
         H5Fclose(file_id);
@@ -2461,6 +3063,345 @@ int harp_export_hdf5(const char *filename, const harp_product *product)
     return 0;
 }
 
+/* Extend a dataset along its first (time) dimension and write the data of 'variable' at 'time_offset' */
+static int write_variable_records(hid_t group_id, const char *name, const harp_variable *variable, long time_offset)
+{
+    hsize_t dimension[HARP_MAX_NUM_DIMS];
+    hsize_t start[HARP_MAX_NUM_DIMS];
+    hid_t dataset_id;
+    hid_t file_space_id;
+    hid_t memory_space_id;
+    hid_t data_type_id;
+    char *buffer = NULL;
+    const void *data;
+    int i;
+
+    assert(variable->num_dimensions > 0 && variable->dimension_type[0] == harp_dimension_time);
+
+    dataset_id = H5Dopen(group_id, name);
+    if (dataset_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+
+    dimension[0] = time_offset + variable->dimension[0];
+    start[0] = time_offset;
+    for (i = 1; i < variable->num_dimensions; i++)
+    {
+        dimension[i] = variable->dimension[i];
+        start[i] = 0;
+    }
+    if (H5Dset_extent(dataset_id, dimension) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        H5Dclose(dataset_id);
+        return -1;
+    }
+
+    if (variable->data_type == harp_type_string)
+    {
+        size_t string_length;
+
+        /* the fixed string length was set when the dataset was created */
+        data_type_id = H5Dget_type(dataset_id);
+        if (data_type_id < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            H5Dclose(dataset_id);
+            return -1;
+        }
+        string_length = H5Tget_size(data_type_id);
+        if (harp_get_max_string_length(variable->num_elements, variable->data.string_data) > (long)string_length)
+        {
+            harp_set_error(HARP_ERROR_EXPORT, "string length of variable '%s' exceeds the string length of the "
+                           "exported variable (%ld)", variable->name, (long)string_length);
+            H5Tclose(data_type_id);
+            H5Dclose(dataset_id);
+            return -1;
+        }
+        if (harp_get_char_array_from_string_array(variable->num_elements, variable->data.string_data,
+                                                  (long)string_length, NULL, &buffer) != 0)
+        {
+            H5Tclose(data_type_id);
+            H5Dclose(dataset_id);
+            return -1;
+        }
+        data = buffer;
+    }
+    else
+    {
+        data_type_id = H5Tcopy(get_hdf5_type(variable->data_type));
+        if (data_type_id < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            H5Dclose(dataset_id);
+            return -1;
+        }
+        data = variable->data.ptr;
+    }
+
+    file_space_id = H5Dget_space(dataset_id);
+    if (file_space_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        goto error;
+    }
+    for (i = 0; i < variable->num_dimensions; i++)
+    {
+        dimension[i] = variable->dimension[i];
+    }
+    if (H5Sselect_hyperslab(file_space_id, H5S_SELECT_SET, start, NULL, dimension, NULL) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        H5Sclose(file_space_id);
+        goto error;
+    }
+    memory_space_id = H5Screate_simple(variable->num_dimensions, dimension, NULL);
+    if (memory_space_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        H5Sclose(file_space_id);
+        goto error;
+    }
+    if (H5Dwrite(dataset_id, data_type_id, memory_space_id, file_space_id, H5P_DEFAULT, data) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        H5Sclose(memory_space_id);
+        H5Sclose(file_space_id);
+        goto error;
+    }
+    H5Sclose(memory_space_id);
+    H5Sclose(file_space_id);
+
+    if (buffer != NULL)
+    {
+        free(buffer);
+    }
+    H5Tclose(data_type_id);
+    H5Dclose(dataset_id);
+
+    return 0;
+
+  error:
+    if (buffer != NULL)
+    {
+        free(buffer);
+    }
+    H5Tclose(data_type_id);
+    H5Dclose(dataset_id);
+    return -1;
+}
+
+/* Create an HDF5 file for 'product' with an extendible (chunked) time dimension, such that other (compatible) products
+ * can be appended to it with harp_export_hdf5_stream_append().
+ * All variables of 'product' should be time dependent.
+ */
+int harp_export_hdf5_stream_open(const char *filename, const harp_product *product, harp_hdf5_stream **new_stream)
+{
+    harp_hdf5_stream *stream;
+    hid_t file_id;
+    hid_t fcpl_id;
+
+    if (filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "filename is NULL");
+        return -1;
+    }
+
+    if (product == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product is NULL");
+        return -1;
+    }
+
+    stream = malloc(sizeof(harp_hdf5_stream));
+    if (stream == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(harp_hdf5_stream), __FILE__, __LINE__);
+        return -1;
+    }
+
+    /* Setup file creation property list to enable link and attribute creation
+     * order tracking and indexing.
+     */
+    fcpl_id = H5Pcreate(H5P_FILE_CREATE);
+    if (fcpl_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        free(stream);
+        return -1;
+    }
+
+    if (H5Pset_link_creation_order(fcpl_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        H5Pclose(fcpl_id);
+        free(stream);
+        return -1;
+    }
+
+    if (H5Pset_attr_creation_order(fcpl_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        H5Pclose(fcpl_id);
+        free(stream);
+        return -1;
+    }
+
+    file_id = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl_id, H5P_DEFAULT);
+    if (file_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        harp_add_error_message(" (%s)", filename);
+        H5Pclose(fcpl_id);
+        free(stream);
+        return -1;
+    }
+
+    H5Pclose(fcpl_id);
+
+    if (write_product(file_id, product, 1) != 0)
+    {
+        harp_add_error_message(" (%s)", filename);
+        H5Fclose(file_id);
+        free(stream);
+        return -1;
+    }
+
+    stream->file_id = file_id;
+    stream->num_time_elements = product->dimension[harp_dimension_time];
+
+    *new_stream = stream;
+
+    return 0;
+}
+
+/* Append the data of 'product' along the time dimension.
+ * The product should have been verified to be compatible with the product that was used to open the stream.
+ */
+int harp_export_hdf5_stream_append(harp_hdf5_stream *stream, const harp_product *product)
+{
+    const char *time_name;
+    hsize_t dimension[1];
+    hid_t root_id;
+    hid_t dataset_id;
+    hid_t space_id;
+    int i;
+
+    root_id = H5Gopen(stream->file_id, "/");
+    if (root_id < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+
+    for (i = 0; i < product->num_variables; i++)
+    {
+        char *name;
+
+        name = get_hdf5_variable_name(product, product->variable[i]);
+        if (name == NULL)
+        {
+            H5Gclose(root_id);
+            return -1;
+        }
+        if (write_variable_records(root_id, name, product->variable[i], stream->num_time_elements) != 0)
+        {
+            free(name);
+            H5Gclose(root_id);
+            return -1;
+        }
+        free(name);
+    }
+    stream->num_time_elements += product->dimension[harp_dimension_time];
+
+    /* extend the time dimension scale if it is not also a variable (in which case it was already extended above) */
+    time_name = harp_get_dimension_type_name(harp_dimension_time);
+    dataset_id = H5Dopen(root_id, time_name);
+    if (dataset_id < 0)
+    {
+        harp_set_error(HARP_ERROR_EXPORT, "dataset '%s' does not exist", time_name);
+        H5Gclose(root_id);
+        return -1;
+    }
+    space_id = H5Dget_space(dataset_id);
+    if (space_id < 0 || H5Sget_simple_extent_dims(space_id, dimension, NULL) != 1)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        if (space_id >= 0)
+        {
+            H5Sclose(space_id);
+        }
+        H5Dclose(dataset_id);
+        H5Gclose(root_id);
+        return -1;
+    }
+    H5Sclose(space_id);
+    if (dimension[0] < (hsize_t)stream->num_time_elements)
+    {
+        dimension[0] = stream->num_time_elements;
+        if (H5Dset_extent(dataset_id, dimension) < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            H5Dclose(dataset_id);
+            H5Gclose(root_id);
+            return -1;
+        }
+    }
+    H5Dclose(dataset_id);
+    H5Gclose(root_id);
+
+    return 0;
+}
+
+/* Finalize and close the file.
+ * If 'datetime_range' is not NULL it should contain the datetime_start and datetime_stop values of the full product.
+ * The stream is always closed (and freed), also if an error occurs.
+ */
+int harp_export_hdf5_stream_close(harp_hdf5_stream *stream, const double *datetime_range)
+{
+    hid_t file_id;
+
+    file_id = stream->file_id;
+    free(stream);
+
+    if (datetime_range != NULL)
+    {
+        harp_scalar datetime_start;
+        harp_scalar datetime_stop;
+        hid_t root_id;
+
+        datetime_start.double_data = datetime_range[0];
+        datetime_stop.double_data = datetime_range[1];
+
+        root_id = H5Gopen(file_id, "/");
+        if (root_id < 0)
+        {
+            harp_set_error(HARP_ERROR_HDF5, NULL);
+            H5Fclose(file_id);
+            return -1;
+        }
+        if (write_numeric_attribute(root_id, "datetime_start", harp_type_double, datetime_start) != 0 ||
+            write_numeric_attribute(root_id, "datetime_stop", harp_type_double, datetime_stop) != 0)
+        {
+            H5Gclose(root_id);
+            H5Fclose(file_id);
+            return -1;
+        }
+        H5Gclose(root_id);
+    }
+
+    if (H5Fclose(file_id) < 0)
+    {
+        harp_set_error(HARP_ERROR_HDF5, NULL);
+        return -1;
+    }
+
+    return 0;
+}
+
 static herr_t add_error_message(int n, H5E_error_t *err_desc, void *client_data)
 {
     (void)client_data;
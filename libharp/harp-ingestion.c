@@ -2064,6 +2064,79 @@ int harp_ingest(const char *filename, const char *operations, const char *option
     return status;
 }
 
+/* read the bounding box from the geospatial_lat_min/max and geospatial_lon_min/max global attributes of the product
+ * returns 0 if the bounding box was set, or 1 if any of these attributes is absent or invalid
+ */
+static int read_bounding_box_attributes(coda_product *product, harp_product_metadata *metadata)
+{
+    const char *path[4] = { "/@geospatial_lat_min", "/@geospatial_lat_max", "/@geospatial_lon_min",
+        "/@geospatial_lon_max"
+    };
+    double value[4];
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        coda_type_class type_class;
+        coda_cursor cursor;
+
+        if (coda_cursor_set_product(&cursor, product) != 0 || coda_cursor_goto(&cursor, path[i]) != 0)
+        {
+            return 1;
+        }
+        if (coda_cursor_get_type_class(&cursor, &type_class) != 0)
+        {
+            return 1;
+        }
+        if (type_class == coda_array_class)
+        {
+            long num_elements;
+
+            if (coda_cursor_get_num_elements(&cursor, &num_elements) != 0 || num_elements != 1 ||
+                coda_cursor_goto_first_array_element(&cursor) != 0)
+            {
+                return 1;
+            }
+        }
+        if (coda_cursor_read_double(&cursor, &value[i]) != 0 || harp_isnan(value[i]))
+        {
+            return 1;
+        }
+    }
+
+    if (value[0] < -90 || value[0] > value[1] || value[1] > 90)
+    {
+        return 1;
+    }
+    for (i = 2; i < 4; i++)
+    {
+        if (value[i] < -180 || value[i] > 360)
+        {
+            return 1;
+        }
+    }
+    if (value[3] - value[2] >= 360)
+    {
+        value[2] = -180;
+        value[3] = 180;
+    }
+    for (i = 2; i < 4; i++)
+    {
+        /* longitudes can also be given in the range [0,360] */
+        if (value[i] > 180)
+        {
+            value[i] -= 360;
+        }
+    }
+
+    metadata->latitude_min = value[0];
+    metadata->latitude_max = value[1];
+    metadata->longitude_min = value[2];
+    metadata->longitude_max = value[3];
+
+    return 0;
+}
+
 static int ingest_metadata(const char *filename, const harp_ingestion_options *option_list,
                            harp_product_metadata *metadata)
 {
@@ -2190,6 +2263,52 @@ static int ingest_metadata(const char *filename, const harp_ingestion_options *o
         }
     }
 
+    /* use the bounding box that the product itself provides (if available), since deriving it requires reading the
+     * full latitude/longitude arrays */
+    if (read_bounding_box_attributes(info->cproduct, metadata) != 0)
+    {
+        int result;
+
+        /* read all (available) latitude/longitude variables to determine the bounding box */
+        for (i = 0; i < info->product_definition->num_variable_definitions; i++)
+        {
+            if (info->variable_mask[i])
+            {
+                harp_variable_definition *variable_def;
+                harp_variable *variable;
+
+                variable_def = info->product_definition->variable_definition[i];
+                if (strcmp(variable_def->name, "latitude") != 0 && strcmp(variable_def->name, "longitude") != 0 &&
+                    strcmp(variable_def->name, "latitude_bounds") != 0 &&
+                    strcmp(variable_def->name, "longitude_bounds") != 0)
+                {
+                    continue;
+                }
+
+                if (get_variable(info, variable_def, info->dimension_mask_set, &variable) != 0)
+                {
+                    ingestion_done(info);
+                    return -1;
+                }
+
+                if (harp_product_add_variable(info->product, variable) != 0)
+                {
+                    harp_variable_delete(variable);
+                    ingestion_done(info);
+                    return -1;
+                }
+            }
+        }
+        /* without latitude/longitude information the bounding box remains unknown */
+        result = harp_product_get_spatial_extent(info->product, &metadata->latitude_min, &metadata->latitude_max,
+                                                 &metadata->longitude_min, &metadata->longitude_max);
+        if (result < 0)
+        {
+            ingestion_done(info);
+            return -1;
+        }
+    }
+
     ingestion_done(info);
 
     return 0;
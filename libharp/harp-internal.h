@@ -108,6 +108,9 @@ typedef struct harp_variable_conversion_struct
     char *source_description;
     harp_conversion_function set_variable_data;
     harp_conversion_enabled_function enabled;
+    /* element-wise and profile-wise conversions are time separable: each time sample of the result only depends on
+     * the same time sample of the source variables (or on source variables without a time dimension) */
+    int time_separable;
     /* when a variable can only be derived if the product already has a variable with
      * that chemical species then we mark it as chemical species specific */
     harp_chemical_species specific_species;
@@ -130,6 +133,12 @@ typedef struct harp_derived_variable_list_struct
 
 extern harp_derived_variable_list *harp_derived_variable_conversions;
 
+typedef enum harp_variable_source_format_enum
+{
+    harp_variable_source_netcdf,
+    harp_variable_source_hdf5
+} harp_variable_source_format;
+
 /* Utility functions */
 int harp_path_find_file(const char *searchpath, const char *filename, char **location);
 int harp_path_from_path(const char *initialpath, int is_filepath, const char *appendpath, char **resultpath);
@@ -163,9 +172,18 @@ void harp_hdf5_add_error_message(void);
 void harp_add_coda_cursor_path_to_error_message(const coda_cursor *cursor);
 
 /* Variables */
+int harp_variable_new_from_source(const char *name, harp_data_type data_type, int num_dimensions,
+                                  const harp_dimension_type *dimension_type, const long *dimension,
+                                  harp_variable_source_format format, const char *filename, const char *source_name,
+                                  harp_variable **new_variable);
+int harp_variable_new_with_data(const char *name, harp_data_type data_type, int num_dimensions,
+                                const harp_dimension_type *dimension_type, const long *dimension, void *data,
+                                harp_variable **new_variable);
+int harp_variable_load_from_source(int num_variables, harp_variable **variable);
 int harp_variable_get_flag_values_string(const harp_variable *variable, char **flag_values);
 int harp_variable_get_flag_meanings_string(const harp_variable *variable, char **flag_meanings);
 int harp_variable_set_enumeration_values_using_flag_meanings(harp_variable *variable, const char *flag_meanings);
+int harp_variable_check_append_compatibility(const harp_variable *variable, const harp_variable *other_variable);
 int harp_variable_add_dimension(harp_variable *variable, int dim_index, harp_dimension_type dimension_type,
                                 long length);
 int harp_variable_rearrange_dimension(harp_variable *variable, int dim_index, long num_dim_elements,
@@ -176,6 +194,7 @@ int harp_variable_remove_dimension(harp_variable *variable, int dim_index, long
 int harp_variable_squash_dimension(harp_variable *variable, int dim_index);
 
 /* Products */
+int harp_product_prepare_for_append(harp_product *product, harp_product *other_product);
 int harp_product_rearrange_dimension(harp_product *product, harp_dimension_type dimension_type, long num_dim_elements,
                                      const long *dim_element_ids);
 int harp_product_filter_by_index(harp_product *product, const char *index_variable, long num_elements, int32_t *index);
@@ -183,6 +202,8 @@ int harp_product_filter_dimension(harp_product *product, harp_dimension_type dim
 int harp_product_remove_dimension(harp_product *product, harp_dimension_type dimension_type);
 void harp_product_remove_all_variables(harp_product *product);
 int harp_product_get_datetime_range(const harp_product *product, double *datetime_start, double *datetime_stop);
+int harp_product_get_spatial_extent(const harp_product *product, double *latitude_min, double *latitude_max,
+                                    double *longitude_min, double *longitude_max);
 int harp_product_get_derived_bounds_for_grid(harp_product *product, harp_variable *grid, harp_variable **bounds);
 int harp_product_get_storage_size(const harp_product *product, int with_attributes, int64_t *size);
 int harp_product_bin_full(harp_product *product);
@@ -194,14 +215,24 @@ int harp_product_clamp_dimension(harp_product *product, harp_dimension_type dime
                                  const char *grid_variable_name, const char *unit, double lower_bound,
                                  double upper_bound);
 
+/* Sorting */
+int harp_sort_compare_elements(int num_keys, harp_variable **key_a, long index_a, harp_variable **key_b,
+                               long index_b);
+int harp_sort_is_sorted(int num_keys, harp_variable **key, long num_elements);
+int harp_sort_get_index(int num_keys, harp_variable **key, long num_elements, long *index);
+
 /* Import */
 #ifdef HAVE_HDF4
 int harp_import_hdf4(const char *filename, harp_product **product);
 #endif
 #ifdef HAVE_HDF5
-int harp_import_hdf5(const char *filename, harp_product **product);
+int harp_import_hdf5(const char *filename, int lazy, harp_product **product);
+int harp_import_variable_data_hdf5(const char *filename, int num_variables, const char **dataset_name,
+                                   harp_variable **variable);
 #endif
-int harp_import_netcdf(const char *filename, harp_product **product);
+int harp_import_netcdf(const char *filename, int lazy, harp_product **product);
+int harp_import_variable_data_netcdf(const char *filename, int num_variables, const char **variable_name,
+                                     harp_variable **variable);
 
 #ifdef HAVE_HDF4
 int harp_export_hdf4(const char *filename, const harp_product *product);
@@ -211,6 +242,24 @@ int harp_export_hdf5(const char *filename, const harp_product *product);
 #endif
 int harp_export_netcdf(const char *filename, const harp_product *product);
 
+/* Streamed export */
+#ifdef HAVE_HDF4
+typedef struct harp_hdf4_stream_struct harp_hdf4_stream;
+int harp_export_hdf4_stream_open(const char *filename, const harp_product *product, harp_hdf4_stream **new_stream);
+int harp_export_hdf4_stream_append(harp_hdf4_stream *stream, const harp_product *product);
+int harp_export_hdf4_stream_close(harp_hdf4_stream *stream, const double *datetime_range);
+#endif
+#ifdef HAVE_HDF5
+typedef struct harp_hdf5_stream_struct harp_hdf5_stream;
+int harp_export_hdf5_stream_open(const char *filename, const harp_product *product, harp_hdf5_stream **new_stream);
+int harp_export_hdf5_stream_append(harp_hdf5_stream *stream, const harp_product *product);
+int harp_export_hdf5_stream_close(harp_hdf5_stream *stream, const double *datetime_range);
+#endif
+typedef struct harp_netcdf_stream_struct harp_netcdf_stream;
+int harp_export_netcdf_stream_open(const char *filename, const harp_product *product, harp_netcdf_stream **new_stream);
+int harp_export_netcdf_stream_append(harp_netcdf_stream *stream, const harp_product *product);
+int harp_export_netcdf_stream_close(harp_netcdf_stream *stream, const double *datetime_range);
+
 #ifdef HAVE_HDF4
 int harp_import_metadata_hdf4(const char *filename, harp_product_metadata *metadata);
 #endif
@@ -218,6 +267,7 @@ int harp_import_metadata_hdf4(const char *filename, harp_product_metadata *metad
 int harp_import_metadata_hdf5(const char *filename, harp_product_metadata *metadata);
 #endif
 int harp_import_metadata_netcdf(const char *filename, harp_product_metadata *metadata);
+int harp_get_num_threads(void);
 int harp_parse_file_convention(const char *str, int *major, int *minor);
 
 /* Ingest */
@@ -232,6 +282,8 @@ int harp_unit_converter_new(const char *from_unit, const char *to_unit, harp_uni
 void harp_unit_converter_delete(harp_unit_converter *unit_converter);
 float harp_unit_converter_convert_float(const harp_unit_converter *unit_converter, float value);
 double harp_unit_converter_convert_double(const harp_unit_converter *unit_converter, double value);
+void harp_unit_converter_convert_array_to_double(const harp_unit_converter *unit_converter, harp_data_type data_type,
+                                                 long num_values, const void *value, double *converted_value);
 int harp_unit_compare(const char *unit_a, const char *unit_b);
 int harp_unit_is_valid(const char *str);
 void harp_unit_done(void);
@@ -252,6 +304,7 @@ int harp_variable_conversion_add_source(harp_variable_conversion *conversion, co
 int harp_variable_conversion_set_enabled_function(harp_variable_conversion *conversion,
                                                   harp_conversion_enabled_function enabled);
 int harp_variable_conversion_set_source_description(harp_variable_conversion *conversion, const char *description);
+int harp_variable_conversion_set_time_separable(harp_variable_conversion *conversion);
 void harp_variable_conversion_delete(harp_variable_conversion *conversion);
 
 /* Derived variables */
@@ -338,6 +391,8 @@ double harp_wavenumber_from_wavelength(double wavelength);
 double harp_wrap(double value, double min, double max);
 
 /* Interpolation */
+typedef struct harp_interpolation_weights_struct harp_interpolation_weights;
+
 void harp_interpolate_find_index(long source_length, const double *source_grid, double target_grid_point, long *index);
 int harp_cubic_spline_interpolation(const double *xx, const double *yy, long n, const double xp, double *new_yp);
 int harp_bicubic_spline_interpolation(const double *xx, const double *yy, const double **zz, long m, long n,
@@ -360,6 +415,18 @@ void harp_interpolate_array_logloglinear(long source_length, const double *sourc
 void harp_interval_interpolate_array_linear(long source_length, const double *source_grid_boundaries,
                                             const double *source_array, long target_length,
                                             const double *target_grid_boundaries, double *target_array);
+int harp_interpolation_weights_new_linear(long source_length, const double *source_grid, long target_length,
+                                          const double *target_grid, int out_of_bound_flag,
+                                          harp_interpolation_weights **new_weights);
+int harp_interpolation_weights_new_logloglinear(long source_length, const double *source_grid, long target_length,
+                                                const double *target_grid, int out_of_bound_flag,
+                                                harp_interpolation_weights **new_weights);
+int harp_interpolation_weights_new_interval(long source_length, const double *source_grid_boundaries,
+                                            long target_length, const double *target_grid_boundaries,
+                                            harp_interpolation_weights **new_weights);
+void harp_interpolation_weights_apply(const harp_interpolation_weights *weights, long num_elements,
+                                      const double *source_array, double *target_array);
+void harp_interpolation_weights_delete(harp_interpolation_weights *weights);
 void harp_bounds_from_midpoints_linear(long num_midpoints, const double *midpoints, int extrapolate, double *intervals);
 void harp_bounds_from_midpoints_loglinear(long num_midpoints, const double *midpoints, int extrapolate,
                                           double *intervals);
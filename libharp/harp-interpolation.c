@@ -369,6 +369,51 @@ void harp_interpolate_find_index(long source_length, const double *source_grid,
     }
 }
 
+/* Returns whether target_grid_point lies in the interval [source_grid[index], source_grid[index + 1]) (or, for a
+ * decreasing grid, in (source_grid[index + 1], source_grid[index]]).
+ */
+static int in_interval(const double *source_grid, int ascend, double target_grid_point, long index)
+{
+    if (ascend)
+    {
+        return source_grid[index] <= target_grid_point && target_grid_point < source_grid[index + 1];
+    }
+    return source_grid[index] >= target_grid_point && target_grid_point > source_grid[index + 1];
+}
+
+/* Same as harp_interpolate_find_index(), but optimized for walking along a (monotonic) target grid.
+ * The interval at the initial 'index' and its two neighbouring intervals are checked first, after which the regular
+ * search is used. The result is always identical to that of harp_interpolate_find_index().
+ */
+static void find_index_walk(long source_length, const double *source_grid, int ascend, double target_grid_point,
+                            long *index)
+{
+    long i = *index;
+
+    if (i >= 0 && i < source_length - 1 && target_grid_point != source_grid[source_length - 1])
+    {
+        if (in_interval(source_grid, ascend, target_grid_point, i))
+        {
+            return;
+        }
+        /* the regular search only ends up in the next interval if it starts searching upwards */
+        if (i < source_length - 2 && (ascend ? target_grid_point >= source_grid[i] :
+                                      target_grid_point <= source_grid[i]) &&
+            in_interval(source_grid, ascend, target_grid_point, i + 1))
+        {
+            *index = i + 1;
+            return;
+        }
+        if (i > 0 && in_interval(source_grid, ascend, target_grid_point, i - 1))
+        {
+            *index = i - 1;
+            return;
+        }
+    }
+
+    harp_interpolate_find_index(source_length, source_grid, target_grid_point, index);
+}
+
 int harp_cubic_spline_interpolation(const double *xx, const double *yy, long n, const double xp, double *yp)
 {
     double d0 = 1.0e30; /* First derivative of the interpolating function at points 0. */
@@ -459,6 +504,10 @@ int harp_bicubic_spline_interpolation(const double *xx, const double *yy, const
     return 0;
 }
 
+/* Determine the interpolated value for a target point, with 'pos' the position of the target point in the source grid
+ * as determined by harp_interpolate_find_index(). The same applies to interpolate_loglinear() and
+ * interpolate_logloglinear().
+ */
 static void interpolate_linear(long source_length, const double *source_grid, const double *source_array,
                                double target_grid_point, int out_of_bound_flag, long *pos, double *target_value)
 {
@@ -467,8 +516,6 @@ static void interpolate_linear(long source_length, const double *source_grid, co
     assert(source_length > 1);
     assert(out_of_bound_flag == 0 || out_of_bound_flag == 1 || out_of_bound_flag == 2);
 
-    harp_interpolate_find_index(source_length, source_grid, target_grid_point, pos);
-
     if (*pos == -1)
     {
         /* grid point is before source_grid[0] */
@@ -535,6 +582,7 @@ void harp_interpolate_value_linear(long source_length, const double *source_grid
 {
     long pos = 0;
 
+    harp_interpolate_find_index(source_length, source_grid, target_grid_point, &pos);
     interpolate_linear(source_length, source_grid, source_array, target_grid_point, out_of_bound_flag, &pos,
                        target_value);
 }
@@ -552,12 +600,34 @@ void harp_interpolate_array_linear(long source_length, const double *source_grid
                                    double *target_array)
 {
     long pos = 0;
+    int ascend;
     long i;
 
+    if (target_length == 0)
+    {
+        return;
+    }
+    assert(source_length > 1);
+    ascend = (source_grid[source_length - 1] >= source_grid[0]);
+
     for (i = 0; i < target_length; i++)
     {
-        interpolate_linear(source_length, source_grid, source_array, target_grid[i], out_of_bound_flag, &pos,
-                           &target_array[i]);
+        double target_grid_point = target_grid[i];
+
+        find_index_walk(source_length, source_grid, ascend, target_grid_point, &pos);
+        if (pos == -1 || pos == source_length || target_grid_point == source_grid[pos] ||
+            target_grid_point == source_grid[pos + 1])
+        {
+            /* out of bounds or exact grid point */
+            interpolate_linear(source_length, source_grid, source_array, target_grid_point, out_of_bound_flag, &pos,
+                               &target_array[i]);
+        }
+        else
+        {
+            double v = (target_grid_point - source_grid[pos]) / (source_grid[pos + 1] - source_grid[pos]);
+
+            target_array[i] = (1 - v) * source_array[pos] + v * source_array[pos + 1];
+        }
     }
 }
 
@@ -569,8 +639,6 @@ static void interpolate_loglinear(long source_length, const double *source_grid,
     assert(source_length > 1);
     assert(out_of_bound_flag == 0 || out_of_bound_flag == 1 || out_of_bound_flag == 2);
 
-    harp_interpolate_find_index(source_length, source_grid, target_grid_point, pos);
-
     if (*pos == -1)
     {
         /* grid point is before source_grid[0] */
@@ -638,6 +706,7 @@ void harp_interpolate_value_loglinear(long source_length, const double *source_g
 {
     long pos = 0;
 
+    harp_interpolate_find_index(source_length, source_grid, target_grid_point, &pos);
     interpolate_loglinear(source_length, source_grid, source_array, target_grid_point, out_of_bound_flag, &pos,
                           target_value);
 }
@@ -655,13 +724,44 @@ void harp_interpolate_array_loglinear(long source_length, const double *source_g
                                       long target_length, const double *target_grid, int out_of_bound_flag,
                                       double *target_array)
 {
+    double log_interval = 0;    /* log(source_grid[interval + 1] / source_grid[interval]) */
+    long interval = -1;
     long pos = 0;
+    int ascend;
     long i;
 
+    if (target_length == 0)
+    {
+        return;
+    }
+    assert(source_length > 1);
+    ascend = (source_grid[source_length - 1] >= source_grid[0]);
+
     for (i = 0; i < target_length; i++)
     {
-        interpolate_loglinear(source_length, source_grid, source_array, target_grid[i], out_of_bound_flag, &pos,
-                              &target_array[i]);
+        double target_grid_point = target_grid[i];
+
+        find_index_walk(source_length, source_grid, ascend, target_grid_point, &pos);
+        if (pos == -1 || pos == source_length || target_grid_point == source_grid[pos] ||
+            target_grid_point == source_grid[pos + 1])
+        {
+            /* out of bounds or exact grid point */
+            interpolate_loglinear(source_length, source_grid, source_array, target_grid_point, out_of_bound_flag,
+                                  &pos, &target_array[i]);
+        }
+        else
+        {
+            double v;
+
+            /* consecutive target points mostly fall in the same interval, so only take the log once per interval */
+            if (pos != interval)
+            {
+                log_interval = log(source_grid[pos + 1] / source_grid[pos]);
+                interval = pos;
+            }
+            v = (log(target_grid_point / source_grid[pos])) / log_interval;
+            target_array[i] = (1 - v) * source_array[pos] + v * source_array[pos + 1];
+        }
     }
 }
 
@@ -673,8 +773,6 @@ static void interpolate_logloglinear(long source_length, const double *source_gr
     assert(source_length > 1);
     assert(out_of_bound_flag == 0 || out_of_bound_flag == 1 || out_of_bound_flag == 2);
 
-    harp_interpolate_find_index(source_length, source_grid, target_grid_point, pos);
-
     if (*pos == -1)
     {
         /* grid point is before source_grid[0] */
@@ -743,6 +841,7 @@ void harp_interpolate_value_logloglinear(long source_length, const double *sourc
 {
     long pos = 0;
 
+    harp_interpolate_find_index(source_length, source_grid, target_grid_point, &pos);
     interpolate_logloglinear(source_length, source_grid, source_array, target_grid_point, out_of_bound_flag, &pos,
                              target_value);
 }
@@ -761,13 +860,47 @@ void harp_interpolate_array_logloglinear(long source_length, const double *sourc
                                          long target_length, const double *target_grid, int out_of_bound_flag,
                                          double *target_array)
 {
+    double log_interval = 0;    /* log(source_grid[interval + 1] / source_grid[interval]) */
+    double log_value[2] = { 0, 0 };     /* log(source_array[interval]) and log(source_array[interval + 1]) */
+    long interval = -1;
     long pos = 0;
+    int ascend;
     long i;
 
+    if (target_length == 0)
+    {
+        return;
+    }
+    assert(source_length > 1);
+    ascend = (source_grid[source_length - 1] >= source_grid[0]);
+
     for (i = 0; i < target_length; i++)
     {
-        interpolate_logloglinear(source_length, source_grid, source_array, target_grid[i], out_of_bound_flag, &pos,
-                                 &target_array[i]);
+        double target_grid_point = target_grid[i];
+
+        find_index_walk(source_length, source_grid, ascend, target_grid_point, &pos);
+        if (pos == -1 || pos == source_length || target_grid_point == source_grid[pos] ||
+            target_grid_point == source_grid[pos + 1])
+        {
+            /* out of bounds or exact grid point */
+            interpolate_logloglinear(source_length, source_grid, source_array, target_grid_point, out_of_bound_flag,
+                                     &pos, &target_array[i]);
+        }
+        else
+        {
+            double v;
+
+            /* consecutive target points mostly fall in the same interval, so only take the logs once per interval */
+            if (pos != interval)
+            {
+                log_interval = log(source_grid[pos + 1] / source_grid[pos]);
+                log_value[0] = log(source_array[pos]);
+                log_value[1] = log(source_array[pos + 1]);
+                interval = pos;
+            }
+            v = log(target_grid_point / source_grid[pos]) / log_interval;
+            target_array[i] = exp((1 - v) * log_value[0] + v * log_value[1]);
+        }
     }
 }
 
@@ -839,6 +972,469 @@ void harp_interval_interpolate_array_linear(long source_length, const double *so
     }
 }
 
+typedef enum interpolation_method_enum
+{
+    method_linear,
+    method_logloglinear,
+    method_interval
+} interpolation_method;
+
+typedef enum point_weight_type_enum
+{
+    point_nan,  /* target value is NaN */
+    point_copy, /* target value is source[index] */
+    point_interpolate,  /* target value is an interpolation between source[index] and source[second_index] */
+    point_extrapolate   /* target value is an extrapolation from source[index] away from source[second_index] */
+} point_weight_type;
+
+/* Interpolation weights for a fixed source grid, target grid and interpolation method.
+ * For point interpolation each target element depends on at most two source elements. For interval interpolation the
+ * overlap weights are stored in compressed sparse row format (the weights for target element i are at positions
+ * offset[i] to offset[i + 1]).
+ */
+struct harp_interpolation_weights_struct
+{
+    interpolation_method method;
+    long source_length;
+    long target_length;
+
+    /* point interpolation */
+    uint8_t *type;
+    long *index;
+    long *second_index;
+    double *weight;
+
+    /* interval interpolation */
+    long *offset;
+    long *source_index;
+    double *source_weight;
+};
+
+void harp_interpolation_weights_delete(harp_interpolation_weights *weights)
+{
+    if (weights == NULL)
+    {
+        return;
+    }
+    if (weights->type != NULL)
+    {
+        free(weights->type);
+    }
+    if (weights->index != NULL)
+    {
+        free(weights->index);
+    }
+    if (weights->second_index != NULL)
+    {
+        free(weights->second_index);
+    }
+    if (weights->weight != NULL)
+    {
+        free(weights->weight);
+    }
+    if (weights->offset != NULL)
+    {
+        free(weights->offset);
+    }
+    if (weights->source_index != NULL)
+    {
+        free(weights->source_index);
+    }
+    if (weights->source_weight != NULL)
+    {
+        free(weights->source_weight);
+    }
+    free(weights);
+}
+
+static int interpolation_weights_new(interpolation_method method, long source_length, long target_length,
+                                     harp_interpolation_weights **new_weights)
+{
+    harp_interpolation_weights *weights;
+
+    weights = (harp_interpolation_weights *)malloc(sizeof(harp_interpolation_weights));
+    if (weights == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(harp_interpolation_weights), __FILE__, __LINE__);
+        return -1;
+    }
+    weights->method = method;
+    weights->source_length = source_length;
+    weights->target_length = target_length;
+    weights->type = NULL;
+    weights->index = NULL;
+    weights->second_index = NULL;
+    weights->weight = NULL;
+    weights->offset = NULL;
+    weights->source_index = NULL;
+    weights->source_weight = NULL;
+
+    if (method == method_interval)
+    {
+        weights->offset = (long *)malloc((target_length + 1) * sizeof(long));
+        if (weights->offset == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (target_length + 1) * sizeof(long), __FILE__, __LINE__);
+            harp_interpolation_weights_delete(weights);
+            return -1;
+        }
+    }
+    else if (target_length > 0)
+    {
+        weights->type = (uint8_t *)malloc(target_length * sizeof(uint8_t));
+        if (weights->type == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           target_length * sizeof(uint8_t), __FILE__, __LINE__);
+            harp_interpolation_weights_delete(weights);
+            return -1;
+        }
+        weights->index = (long *)malloc(target_length * sizeof(long));
+        if (weights->index == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           target_length * sizeof(long), __FILE__, __LINE__);
+            harp_interpolation_weights_delete(weights);
+            return -1;
+        }
+        weights->second_index = (long *)malloc(target_length * sizeof(long));
+        if (weights->second_index == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           target_length * sizeof(long), __FILE__, __LINE__);
+            harp_interpolation_weights_delete(weights);
+            return -1;
+        }
+        weights->weight = (double *)malloc(target_length * sizeof(double));
+        if (weights->weight == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           target_length * sizeof(double), __FILE__, __LINE__);
+            harp_interpolation_weights_delete(weights);
+            return -1;
+        }
+    }
+
+    *new_weights = weights;
+
+    return 0;
+}
+
+/* Determine the weight for a single target point (following the same logic as interpolate_linear() and
+ * interpolate_logloglinear()).
+ */
+static void set_point_weight(harp_interpolation_weights *weights, const double *source_grid, double target_grid_point,
+                             int out_of_bound_flag, long i, long *pos)
+{
+    long source_length = weights->source_length;
+    int use_log = (weights->method == method_logloglinear);
+
+    assert(source_length > 1);
+    assert(out_of_bound_flag == 0 || out_of_bound_flag == 1 || out_of_bound_flag == 2);
+
+    find_index_walk(source_length, source_grid, source_grid[source_length - 1] >= source_grid[0], target_grid_point,
+                    pos);
+
+    weights->type[i] = point_copy;
+    weights->index[i] = 0;
+    weights->second_index[i] = 0;
+    weights->weight[i] = 0;
+
+    if (*pos == -1 || *pos == source_length)
+    {
+        long index = (*pos == -1) ? 0 : source_length - 1;
+        long second_index = (*pos == -1) ? 1 : source_length - 2;
+
+        /* grid point is outside the source grid */
+        if (out_of_bound_flag == 1)
+        {
+            weights->index[i] = index;
+        }
+        else if (out_of_bound_flag == 2)
+        {
+            weights->type[i] = point_extrapolate;
+            weights->index[i] = index;
+            weights->second_index[i] = second_index;
+            if (use_log)
+            {
+                weights->weight[i] = log(target_grid_point / source_grid[index]) /
+                    log(source_grid[index] / source_grid[second_index]);
+            }
+            else
+            {
+                weights->weight[i] = (target_grid_point - source_grid[index]) /
+                    (source_grid[index] - source_grid[second_index]);
+            }
+        }
+        else
+        {
+            weights->type[i] = point_nan;
+        }
+    }
+    else if (target_grid_point == source_grid[*pos])
+    {
+        /* don't interpolate, but take exact point */
+        weights->index[i] = *pos;
+    }
+    else if (target_grid_point == source_grid[*pos + 1])
+    {
+        /* don't interpolate, but take exact point */
+        weights->index[i] = *pos + 1;
+    }
+    else
+    {
+        /* grid point is between source_grid[pos] and source_grid[pos + 1] */
+        weights->type[i] = point_interpolate;
+        weights->index[i] = *pos;
+        weights->second_index[i] = *pos + 1;
+        if (use_log)
+        {
+            weights->weight[i] = log(target_grid_point / source_grid[*pos]) /
+                log(source_grid[(*pos) + 1] / source_grid[*pos]);
+        }
+        else
+        {
+            weights->weight[i] = (target_grid_point - source_grid[*pos]) /
+                (source_grid[(*pos) + 1] - source_grid[*pos]);
+        }
+    }
+}
+
+static int interpolation_weights_new_point(interpolation_method method, long source_length,
+                                           const double *source_grid, long target_length, const double *target_grid,
+                                           int out_of_bound_flag, harp_interpolation_weights **new_weights)
+{
+    harp_interpolation_weights *weights;
+    long pos = 0;
+    long i;
+
+    if (interpolation_weights_new(method, source_length, target_length, &weights) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < target_length; i++)
+    {
+        set_point_weight(weights, source_grid, target_grid[i], out_of_bound_flag, i, &pos);
+    }
+
+    *new_weights = weights;
+
+    return 0;
+}
+
+/* Determine the weights for interpolating arrays from source grid to target grid using linear interpolation.
+ * Applying these weights gives the same result as harp_interpolate_array_linear().
+ */
+int harp_interpolation_weights_new_linear(long source_length, const double *source_grid, long target_length,
+                                          const double *target_grid, int out_of_bound_flag,
+                                          harp_interpolation_weights **new_weights)
+{
+    return interpolation_weights_new_point(method_linear, source_length, source_grid, target_length, target_grid,
+                                           out_of_bound_flag, new_weights);
+}
+
+/* Determine the weights for interpolating arrays from source grid to target grid using log/log linear interpolation.
+ * Applying these weights gives the same result as harp_interpolate_array_logloglinear().
+ */
+int harp_interpolation_weights_new_logloglinear(long source_length, const double *source_grid, long target_length,
+                                                const double *target_grid, int out_of_bound_flag,
+                                                harp_interpolation_weights **new_weights)
+{
+    return interpolation_weights_new_point(method_logloglinear, source_length, source_grid, target_length,
+                                           target_grid, out_of_bound_flag, new_weights);
+}
+
+/* Determine the weights for interpolating arrays from source grid to target grid using interval interpolation.
+ * Applying these weights gives the same result as harp_interval_interpolate_array_linear().
+ */
+int harp_interpolation_weights_new_interval(long source_length, const double *source_grid_boundaries,
+                                            long target_length, const double *target_grid_boundaries,
+                                            harp_interpolation_weights **new_weights)
+{
+    harp_interpolation_weights *weights;
+    long num_weights = 0;
+    long pass;
+    long i, j;
+
+    if (interpolation_weights_new(method_interval, source_length, target_length, &weights) != 0)
+    {
+        return -1;
+    }
+
+    /* the first pass counts the number of overlapping intervals and the second pass stores the weights */
+    for (pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1 && num_weights > 0)
+        {
+            weights->source_index = (long *)malloc(num_weights * sizeof(long));
+            if (weights->source_index == NULL)
+            {
+                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               num_weights * sizeof(long), __FILE__, __LINE__);
+                harp_interpolation_weights_delete(weights);
+                return -1;
+            }
+            weights->source_weight = (double *)malloc(num_weights * sizeof(double));
+            if (weights->source_weight == NULL)
+            {
+                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               num_weights * sizeof(double), __FILE__, __LINE__);
+                harp_interpolation_weights_delete(weights);
+                return -1;
+            }
+        }
+        num_weights = 0;
+        for (i = 0; i < target_length; i++)
+        {
+            double xminb, xmaxb;
+
+            weights->offset[i] = num_weights;
+
+            if (target_grid_boundaries[2 * i] < target_grid_boundaries[2 * i + 1])
+            {
+                xminb = target_grid_boundaries[2 * i];
+                xmaxb = target_grid_boundaries[2 * i + 1];
+            }
+            else
+            {
+                xminb = target_grid_boundaries[2 * i + 1];
+                xmaxb = target_grid_boundaries[2 * i];
+            }
+
+            for (j = 0; j < source_length; j++)
+            {
+                double xmina, xmaxa;
+
+                if (source_grid_boundaries[2 * j] < source_grid_boundaries[2 * j + 1])
+                {
+                    xmina = source_grid_boundaries[2 * j];
+                    xmaxa = source_grid_boundaries[2 * j + 1];
+                }
+                else
+                {
+                    xmina = source_grid_boundaries[2 * j + 1];
+                    xmaxa = source_grid_boundaries[2 * j];
+                }
+
+                if (!(xmina >= xmaxb || xminb >= xmaxa))
+                {
+                    if (pass == 1)
+                    {
+                        double xminc, xmaxc;
+
+                        /* calculate intersection interval C of intervals A and B */
+                        xminc = xmina < xminb ? xminb : xmina;
+                        xmaxc = xmaxa > xmaxb ? xmaxb : xmaxa;
+
+                        weights->source_index[num_weights] = j;
+                        weights->source_weight[num_weights] = (xmaxc - xminc) / (xmaxa - xmina);
+                    }
+                    num_weights++;
+                }
+            }
+        }
+        weights->offset[target_length] = num_weights;
+    }
+
+    *new_weights = weights;
+
+    return 0;
+}
+
+/* Apply interpolation weights to a [source_length, num_elements] array, resulting in a [target_length, num_elements]
+ * array. Each of the num_elements columns is interpolated independently. The source and target arrays should not
+ * overlap.
+ */
+void harp_interpolation_weights_apply(const harp_interpolation_weights *weights, long num_elements,
+                                      const double *source_array, double *target_array)
+{
+    long i, l;
+
+    if (weights->method == method_interval)
+    {
+        for (i = 0; i < weights->target_length; i++)
+        {
+            for (l = 0; l < num_elements; l++)
+            {
+                long num_valid_contributions = 0;
+                double sum = 0.0;
+                long k;
+
+                for (k = weights->offset[i]; k < weights->offset[i + 1]; k++)
+                {
+                    double value = source_array[weights->source_index[k] * num_elements + l];
+
+                    if (!harp_isnan(value))
+                    {
+                        sum += weights->source_weight[k] * value;
+                        num_valid_contributions++;
+                    }
+                }
+                target_array[i * num_elements + l] = num_valid_contributions != 0 ? sum : harp_nan();
+            }
+        }
+        return;
+    }
+
+    for (i = 0; i < weights->target_length; i++)
+    {
+        const double *first = &source_array[weights->index[i] * num_elements];
+        const double *second = &source_array[weights->second_index[i] * num_elements];
+        double *target = &target_array[i * num_elements];
+        double v = weights->weight[i];
+
+        switch (weights->type[i])
+        {
+            case point_nan:
+                for (l = 0; l < num_elements; l++)
+                {
+                    target[l] = harp_nan();
+                }
+                break;
+            case point_copy:
+                for (l = 0; l < num_elements; l++)
+                {
+                    target[l] = first[l];
+                }
+                break;
+            case point_interpolate:
+                if (weights->method == method_logloglinear)
+                {
+                    for (l = 0; l < num_elements; l++)
+                    {
+                        target[l] = exp((1 - v) * log(first[l]) + v * log(second[l]));
+                    }
+                }
+                else
+                {
+                    for (l = 0; l < num_elements; l++)
+                    {
+                        target[l] = (1 - v) * first[l] + v * second[l];
+                    }
+                }
+                break;
+            case point_extrapolate:
+                if (weights->method == method_logloglinear)
+                {
+                    for (l = 0; l < num_elements; l++)
+                    {
+                        target[l] = exp((1 + v) * log(first[l]) - v * log(second[l]));
+                    }
+                }
+                else
+                {
+                    for (l = 0; l < num_elements; l++)
+                    {
+                        target[l] = first[l] + v * (first[l] - second[l]);
+                    }
+                }
+                break;
+        }
+    }
+}
+
 /* Determine boundary intervals based on linear inter-/extrapolation of mid points.
  * Any trailing NaN values in the mid point array will be ignored (and corresponding bounds values will be set to NaN).
  * The bounds array will be treated as a [num_midpoints,2] array and should thus be allocated
@@ -56,6 +56,12 @@ typedef struct netcdf_dimensions_struct
     long *length;
 } netcdf_dimensions;
 
+struct harp_netcdf_stream_struct
+{
+    int ncid;
+    long num_time_elements; /* number of records written so far */
+};
+
 static const char *get_dimension_type_name(netcdf_dimension_type dimension_type)
 {
     switch (dimension_type)
@@ -425,7 +431,106 @@ static int read_numeric_attribute(int ncid, int varid, const char *name, harp_da
     return 0;
 }
 
-static int read_variable(harp_product *product, int ncid, int varid, netcdf_dimensions *dimensions)
+static int read_variable_data(int ncid, int varid, harp_variable *variable)
+{
+    int result;
+    long i;
+
+    if (variable->data_type == harp_type_string)
+    {
+        int netcdf_num_dimensions;
+        int netcdf_dim_id[NC_MAX_VAR_DIMS];
+        size_t length;
+        char *buffer;
+
+        result = nc_inq_varndims(ncid, varid, &netcdf_num_dimensions);
+        if (result == NC_NOERR)
+        {
+            result = nc_inq_vardimid(ncid, varid, netcdf_dim_id);
+        }
+        if (result == NC_NOERR)
+        {
+            assert(netcdf_num_dimensions > 0);
+            result = nc_inq_dimlen(ncid, netcdf_dim_id[netcdf_num_dimensions - 1], &length);
+        }
+        if (result != NC_NOERR)
+        {
+            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            return -1;
+        }
+
+        buffer = malloc(variable->num_elements * length * sizeof(char));
+        if (buffer == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           variable->num_elements * length * sizeof(char), __FILE__, __LINE__);
+            return -1;
+        }
+
+        result = nc_get_var_text(ncid, varid, buffer);
+        if (result != NC_NOERR)
+        {
+            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            free(buffer);
+            return -1;
+        }
+
+        for (i = 0; i < variable->num_elements; i++)
+        {
+            char *str;
+
+            str = malloc((length + 1) * sizeof(char));
+            if (str == NULL)
+            {
+                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               (length + 1) * sizeof(char), __FILE__, __LINE__);
+                free(buffer);
+                return -1;
+            }
+
+            memcpy(str, &buffer[i * length], length);
+            str[length] = '\0';
+            variable->data.string_data[i] = str;
+        }
+
+        free(buffer);
+    }
+    else
+    {
+        switch (variable->data_type)
+        {
+            case harp_type_int8:
+                result = nc_get_var_schar(ncid, varid, variable->data.int8_data);
+                break;
+            case harp_type_int16:
+                result = nc_get_var_short(ncid, varid, variable->data.int16_data);
+                break;
+            case harp_type_int32:
+                result = nc_get_var_int(ncid, varid, variable->data.int32_data);
+                break;
+            case harp_type_float:
+                result = nc_get_var_float(ncid, varid, variable->data.float_data);
+                break;
+            case harp_type_double:
+                result = nc_get_var_double(ncid, varid, variable->data.double_data);
+                break;
+            default:
+                assert(0);
+                exit(1);
+        }
+
+        if (result != NC_NOERR)
+        {
+            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int read_variable(const char *filename, int lazy, harp_product *product, int ncid, int varid,
+                         netcdf_dimensions *dimensions)
 {
     harp_variable *variable;
     harp_data_type data_type;
@@ -494,7 +599,16 @@ static int read_variable(harp_product *product, int ncid, int varid, netcdf_dime
         dimension[i] = dimensions->length[netcdf_dim_id[i]];
     }
 
-    if (harp_variable_new(netcdf_name, data_type, num_dimensions, dimension_type, dimension, &variable) != 0)
+    if (lazy)
+    {
+        /* the data is only read when it is first needed (see harp_import_variable_data_netcdf()) */
+        if (harp_variable_new_from_source(netcdf_name, data_type, num_dimensions, dimension_type, dimension,
+                                          harp_variable_source_netcdf, filename, netcdf_name, &variable) != 0)
+        {
+            return -1;
+        }
+    }
+    else if (harp_variable_new(netcdf_name, data_type, num_dimensions, dimension_type, dimension, &variable) != 0)
     {
         return -1;
     }
@@ -505,78 +619,11 @@ static int read_variable(harp_product *product, int ncid, int varid, netcdf_dime
         return -1;
     }
 
-    /* Read data. */
-    if (data_type == harp_type_string)
-    {
-        char *buffer;
-        long length;
-
-        assert(netcdf_num_dimensions > 0);
-        length = dimensions->length[netcdf_dim_id[netcdf_num_dimensions - 1]];
-
-        buffer = malloc(variable->num_elements * length * sizeof(char));
-        if (buffer == NULL)
-        {
-            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                           variable->num_elements * length * sizeof(char), __FILE__, __LINE__);
-            return -1;
-        }
-
-        result = nc_get_var_text(ncid, varid, buffer);
-        if (result != NC_NOERR)
-        {
-            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
-            free(buffer);
-            return -1;
-        }
-
-        for (i = 0; i < variable->num_elements; i++)
-        {
-            char *str;
-
-            str = malloc((length + 1) * sizeof(char));
-            if (str == NULL)
-            {
-                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                               (length + 1) * sizeof(char), __FILE__, __LINE__);
-                free(buffer);
-                return -1;
-            }
-
-            memcpy(str, &buffer[i * length], length);
-            str[length] = '\0';
-            variable->data.string_data[i] = str;
-        }
-
-        free(buffer);
-    }
-    else
+    if (!lazy)
     {
-        switch (data_type)
-        {
-            case harp_type_int8:
-                result = nc_get_var_schar(ncid, varid, variable->data.int8_data);
-                break;
-            case harp_type_int16:
-                result = nc_get_var_short(ncid, varid, variable->data.int16_data);
-                break;
-            case harp_type_int32:
-                result = nc_get_var_int(ncid, varid, variable->data.int32_data);
-                break;
-            case harp_type_float:
-                result = nc_get_var_float(ncid, varid, variable->data.float_data);
-                break;
-            case harp_type_double:
-                result = nc_get_var_double(ncid, varid, variable->data.double_data);
-                break;
-            default:
-                assert(0);
-                exit(1);
-        }
-
-        if (result != NC_NOERR)
+        if (read_variable_data(ncid, varid, variable) != 0)
         {
-            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            harp_add_error_message(" (variable '%s')", netcdf_name);
             return -1;
         }
     }
@@ -714,7 +761,8 @@ static int verify_product(int ncid)
     return -1;
 }
 
-static int read_product(int ncid, harp_product *product, netcdf_dimensions *dimensions)
+static int read_product(const char *filename, int lazy, int ncid, harp_product *product,
+                        netcdf_dimensions *dimensions)
 {
     int num_dimensions;
     int num_variables;
@@ -757,7 +805,7 @@ static int read_product(int ncid, harp_product *product, netcdf_dimensions *dime
 
     for (i = 0; i < num_variables; i++)
     {
-        if (read_variable(product, ncid, i, dimensions) != 0)
+        if (read_variable(filename, lazy, product, ncid, i, dimensions) != 0)
         {
             return -1;
         }
@@ -794,7 +842,10 @@ static int read_product(int ncid, harp_product *product, netcdf_dimensions *dime
     return 0;
 }
 
-int harp_import_netcdf(const char *filename, harp_product **product)
+/* Import a HARP product from a netCDF-3 file.
+ * If 'lazy' is set, the data of the variables is not read, but only when it is first needed (see harp_variable_load()).
+ */
+int harp_import_netcdf(const char *filename, int lazy, harp_product **product)
 {
     harp_product *new_product;
     netcdf_dimensions dimensions;
@@ -828,7 +879,7 @@ int harp_import_netcdf(const char *filename, harp_product **product)
 
     dimensions_init(&dimensions);
 
-    if (read_product(ncid, new_product, &dimensions) != 0)
+    if (read_product(filename, lazy, ncid, new_product, &dimensions) != 0)
     {
         dimensions_done(&dimensions);
         harp_product_delete(new_product);
@@ -850,6 +901,87 @@ int harp_import_netcdf(const char *filename, harp_product **product)
     return 0;
 }
 
+/* Read the data of variables that were imported from 'filename' by harp_import_netcdf().
+ * 'variable_name' contains the name of each variable in the file. The data of each variable should already have been
+ * allocated.
+ */
+int harp_import_variable_data_netcdf(const char *filename, int num_variables, const char **variable_name,
+                                     harp_variable **variable)
+{
+    int ncid;
+    int result;
+    int i;
+
+    result = nc_open(filename, 0, &ncid);
+    if (result != NC_NOERR)
+    {
+        harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+        harp_add_error_message(" (%s)", filename);
+        return -1;
+    }
+
+    for (i = 0; i < num_variables; i++)
+    {
+        int varid;
+
+        result = nc_inq_varid(ncid, variable_name[i], &varid);
+        if (result != NC_NOERR)
+        {
+            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            harp_add_error_message(" (variable '%s' in %s)", variable_name[i], filename);
+            nc_close(ncid);
+            return -1;
+        }
+        if (read_variable_data(ncid, varid, variable[i]) != 0)
+        {
+            harp_add_error_message(" (variable '%s' in %s)", variable_name[i], filename);
+            nc_close(ncid);
+            return -1;
+        }
+    }
+
+    result = nc_close(ncid);
+    if (result != NC_NOERR)
+    {
+        harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* read the bounding box of the product (it remains unknown if any of the attributes is absent) */
+static int read_bounding_box_attributes(int ncid, harp_product_metadata *metadata)
+{
+    const char *name[4] = { "geospatial_lat_min", "geospatial_lat_max", "geospatial_lon_min", "geospatial_lon_max" };
+    harp_data_type data_type;
+    harp_scalar value[4];
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        if (nc_inq_att(ncid, NC_GLOBAL, name[i], NULL, NULL) != NC_NOERR)
+        {
+            return 0;
+        }
+        if (read_numeric_attribute(ncid, NC_GLOBAL, name[i], &data_type, &value[i]) != 0)
+        {
+            return -1;
+        }
+        if (data_type != harp_type_double)
+        {
+            harp_set_error(HARP_ERROR_IMPORT, "attribute '%s' has invalid type", name[i]);
+            return -1;
+        }
+    }
+    metadata->latitude_min = value[0].double_data;
+    metadata->latitude_max = value[1].double_data;
+    metadata->longitude_min = value[2].double_data;
+    metadata->longitude_max = value[3].double_data;
+
+    return 0;
+}
+
 int harp_import_metadata_netcdf(const char *filename, harp_product_metadata *metadata)
 {
     harp_scalar value;
@@ -925,6 +1057,12 @@ int harp_import_metadata_netcdf(const char *filename, harp_product_metadata *met
         metadata->datetime_stop = harp_plusinf();
     }
 
+    if (read_bounding_box_attributes(ncid, metadata) != 0)
+    {
+        nc_close(ncid);
+        return -1;
+    }
+
     /* dimension */
     result = nc_inq(ncid, &num_dimensions, &num_variables, &num_attributes, &unlim_dim);
     if (result != NC_NOERR)
@@ -1017,7 +1155,7 @@ int harp_import_metadata_netcdf(const char *filename, harp_product_metadata *met
     return 0;
 }
 
-static int write_dimensions(int ncid, const netcdf_dimensions *dimensions)
+static int write_dimensions(int ncid, const netcdf_dimensions *dimensions, int unlimited_time)
 {
     int result;
     int i;
@@ -1040,6 +1178,11 @@ static int write_dimensions(int ncid, const netcdf_dimensions *dimensions)
             sprintf(name, "string_%ld", dimensions->length[i]);
             result = nc_def_dim(ncid, name, dimensions->length[i], &dim_id);
         }
+        else if (dimensions->type[i] == netcdf_dimension_time && unlimited_time)
+        {
+            /* use the record dimension so records can be appended later on */
+            result = nc_def_dim(ncid, get_dimension_type_name(dimensions->type[i]), NC_UNLIMITED, &dim_id);
+        }
         else
         {
             result = nc_def_dim(ncid, get_dimension_type_name(dimensions->type[i]), dimensions->length[i], &dim_id);
@@ -1286,7 +1429,118 @@ static int write_variable(int ncid, int varid, const harp_variable *variable)
     return 0;
 }
 
-static int write_product(int ncid, const harp_product *product, netcdf_dimensions *dimensions)
+/* Write the data of a time dependent variable as records [time_offset, time_offset + time length) */
+static int write_variable_records(int ncid, int varid, const harp_variable *variable, long time_offset)
+{
+    size_t start[NC_MAX_VAR_DIMS];
+    size_t count[NC_MAX_VAR_DIMS];
+    int result = NC_NOERR;
+    int i;
+
+    assert(variable->num_dimensions > 0 && variable->dimension_type[0] == harp_dimension_time);
+
+    start[0] = time_offset;
+    count[0] = variable->dimension[0];
+    for (i = 1; i < variable->num_dimensions; i++)
+    {
+        start[i] = 0;
+        count[i] = variable->dimension[i];
+    }
+
+    switch (variable->data_type)
+    {
+        case harp_type_int8:
+            result = nc_put_vara_schar(ncid, varid, start, count, variable->data.ptr);
+            break;
+        case harp_type_int16:
+            result = nc_put_vara_short(ncid, varid, start, count, variable->data.ptr);
+            break;
+        case harp_type_int32:
+            result = nc_put_vara_int(ncid, varid, start, count, variable->data.ptr);
+            break;
+        case harp_type_float:
+            result = nc_put_vara_float(ncid, varid, start, count, variable->data.ptr);
+            break;
+        case harp_type_double:
+            result = nc_put_vara_double(ncid, varid, start, count, variable->data.ptr);
+            break;
+        case harp_type_string:
+            {
+                int dim_id[NC_MAX_VAR_DIMS];
+                size_t string_length;
+                char *buffer;
+
+                /* the length of the string dimension was fixed when the variable was defined */
+                result = nc_inq_vardimid(ncid, varid, dim_id);
+                if (result == NC_NOERR)
+                {
+                    result = nc_inq_dimlen(ncid, dim_id[variable->num_dimensions], &string_length);
+                }
+                if (result != NC_NOERR)
+                {
+                    break;
+                }
+                if (harp_get_max_string_length(variable->num_elements, variable->data.string_data) >
+                    (long)string_length)
+                {
+                    harp_set_error(HARP_ERROR_EXPORT, "string length of variable '%s' exceeds the string length of "
+                                   "the exported variable (%ld)", variable->name, (long)string_length);
+                    return -1;
+                }
+                if (harp_get_char_array_from_string_array(variable->num_elements, variable->data.string_data,
+                                                          (long)string_length, NULL, &buffer) != 0)
+                {
+                    return -1;
+                }
+                start[variable->num_dimensions] = 0;
+                count[variable->num_dimensions] = string_length;
+
+                result = nc_put_vara_text(ncid, varid, start, count, buffer);
+                free(buffer);
+            }
+            break;
+    }
+
+    if (result != NC_NOERR)
+    {
+        harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* write the bounding box of the product (if it has latitude/longitude information) */
+static int write_bounding_box_attributes(int ncid, const harp_product *product)
+{
+    const char *name[4] = { "geospatial_lat_min", "geospatial_lat_max", "geospatial_lon_min", "geospatial_lon_max" };
+    harp_scalar value[4];
+    int result;
+    int i;
+
+    result = harp_product_get_spatial_extent(product, &value[0].double_data, &value[1].double_data,
+                                             &value[2].double_data, &value[3].double_data);
+    if (result < 0)
+    {
+        return -1;
+    }
+    if (result == 1)
+    {
+        /* no latitude/longitude information */
+        return 0;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        if (write_numeric_attribute(ncid, NC_GLOBAL, name[i], harp_type_double, value[i]) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int write_product(int ncid, const harp_product *product, netcdf_dimensions *dimensions, int streaming)
 {
     harp_scalar datetime_start;
     harp_scalar datetime_stop;
@@ -1299,8 +1553,9 @@ static int write_product(int ncid, const harp_product *product, netcdf_dimension
         return -1;
     }
 
-    /* write attributes */
-    if (harp_product_get_datetime_range(product, &datetime_start.double_data, &datetime_stop.double_data) == 0)
+    /* write attributes (for a streamed product the datetime range is only known when the stream is closed) */
+    if (!streaming &&
+        harp_product_get_datetime_range(product, &datetime_start.double_data, &datetime_stop.double_data) == 0)
     {
         if (write_numeric_attribute(ncid, NC_GLOBAL, "datetime_start", harp_type_double, datetime_start) != 0)
         {
@@ -1312,6 +1567,10 @@ static int write_product(int ncid, const harp_product *product, netcdf_dimension
             return -1;
         }
     }
+    if (!streaming && write_bounding_box_attributes(ncid, product) != 0)
+    {
+        return -1;
+    }
 
     if (product->source_product != NULL && strcmp(product->source_product, "") != 0)
     {
@@ -1366,7 +1625,7 @@ static int write_product(int ncid, const harp_product *product, netcdf_dimension
     }
 
     /* write dimensions */
-    if (write_dimensions(ncid, dimensions) != 0)
+    if (write_dimensions(ncid, dimensions, streaming) != 0)
     {
         return -1;
     }
@@ -1383,7 +1642,16 @@ static int write_product(int ncid, const harp_product *product, netcdf_dimension
         assert(varid == i);
     }
 
-    result = nc_enddef(ncid);
+    if (streaming)
+    {
+        /* reserve space in the header for the datetime_start/datetime_stop attributes that are added when the stream
+         * is closed (this prevents having to move all data when these attributes are added) */
+        result = nc__enddef(ncid, 256, 4, 0, 4);
+    }
+    else
+    {
+        result = nc_enddef(ncid);
+    }
     if (result != NC_NOERR)
     {
         harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
@@ -1393,7 +1661,14 @@ static int write_product(int ncid, const harp_product *product, netcdf_dimension
     /* write variable data */
     for (i = 0; i < product->num_variables; i++)
     {
-        if (write_variable(ncid, i, product->variable[i]) != 0)
+        if (streaming)
+        {
+            if (write_variable_records(ncid, i, product->variable[i], 0) != 0)
+            {
+                return -1;
+            }
+        }
+        else if (write_variable(ncid, i, product->variable[i]) != 0)
         {
             return -1;
         }
@@ -1441,7 +1716,7 @@ int harp_export_netcdf(const char *filename, const harp_product *product)
 
     dimensions_init(&dimensions);
 
-    if (write_product(ncid, product, &dimensions) != 0)
+    if (write_product(ncid, product, &dimensions, 0) != 0)
     {
         harp_add_error_message(" (%s)", filename);
         nc_close(ncid);
@@ -1461,3 +1736,160 @@ int harp_export_netcdf(const char *filename, const harp_product *product)
 
     return 0;
 }
+
+/* Create a netCDF-3 file for 'product' with 'time' as record dimension, such that the records of other (compatible)
+ * products can be appended to it with harp_export_netcdf_stream_append().
+ * All variables of 'product' should be time dependent.
+ */
+int harp_export_netcdf_stream_open(const char *filename, const harp_product *product, harp_netcdf_stream **new_stream)
+{
+    harp_netcdf_stream *stream;
+    netcdf_dimensions dimensions;
+    int result;
+    int ncid;
+
+    if (filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "filename is NULL");
+        return -1;
+    }
+
+    if (product == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product is NULL");
+        return -1;
+    }
+
+    stream = malloc(sizeof(harp_netcdf_stream));
+    if (stream == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(harp_netcdf_stream), __FILE__, __LINE__);
+        return -1;
+    }
+
+    /* the final size is not known up front, so always use 64-bit offsets */
+    result = nc_create(filename, NC_64BIT_OFFSET, &ncid);
+    if (result != NC_NOERR)
+    {
+        harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+        harp_add_error_message(" (%s)", filename);
+        free(stream);
+        return -1;
+    }
+
+    /* all records get written explicitly, so there is no need to pre-fill new records */
+    result = nc_set_fill(ncid, NC_NOFILL, NULL);
+    if (result != NC_NOERR)
+    {
+        harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+        harp_add_error_message(" (%s)", filename);
+        nc_close(ncid);
+        free(stream);
+        return -1;
+    }
+
+    dimensions_init(&dimensions);
+
+    if (write_product(ncid, product, &dimensions, 1) != 0)
+    {
+        harp_add_error_message(" (%s)", filename);
+        nc_close(ncid);
+        dimensions_done(&dimensions);
+        free(stream);
+        return -1;
+    }
+
+    dimensions_done(&dimensions);
+
+    stream->ncid = ncid;
+    stream->num_time_elements = product->dimension[harp_dimension_time];
+
+    *new_stream = stream;
+
+    return 0;
+}
+
+/* Append the records of 'product' to the file.
+ * The product should have been verified to be compatible with the product that was used to open the stream.
+ */
+int harp_export_netcdf_stream_append(harp_netcdf_stream *stream, const harp_product *product)
+{
+    int result;
+    int i;
+
+    for (i = 0; i < product->num_variables; i++)
+    {
+        int varid;
+
+        result = nc_inq_varid(stream->ncid, product->variable[i]->name, &varid);
+        if (result != NC_NOERR)
+        {
+            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            return -1;
+        }
+        if (write_variable_records(stream->ncid, varid, product->variable[i], stream->num_time_elements) != 0)
+        {
+            return -1;
+        }
+    }
+    stream->num_time_elements += product->dimension[harp_dimension_time];
+
+    return 0;
+}
+
+/* Finalize and close the file.
+ * If 'datetime_range' is not NULL it should contain the datetime_start and datetime_stop values of the full product.
+ * The stream is always closed (and freed), also if an error occurs.
+ */
+int harp_export_netcdf_stream_close(harp_netcdf_stream *stream, const double *datetime_range)
+{
+    int result;
+    int ncid;
+
+    ncid = stream->ncid;
+    free(stream);
+
+    if (datetime_range != NULL)
+    {
+        harp_scalar datetime_start;
+        harp_scalar datetime_stop;
+
+        datetime_start.double_data = datetime_range[0];
+        datetime_stop.double_data = datetime_range[1];
+
+        result = nc_redef(ncid);
+        if (result != NC_NOERR)
+        {
+            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            nc_close(ncid);
+            return -1;
+        }
+        if (write_numeric_attribute(ncid, NC_GLOBAL, "datetime_start", harp_type_double, datetime_start) != 0)
+        {
+            nc_close(ncid);
+            return -1;
+        }
+        if (write_numeric_attribute(ncid, NC_GLOBAL, "datetime_stop", harp_type_double, datetime_stop) != 0)
+        {
+            nc_close(ncid);
+            return -1;
+        }
+        result = nc_enddef(ncid);
+        if (result != NC_NOERR)
+        {
+            harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+            nc_close(ncid);
+            return -1;
+        }
+    }
+
+    result = nc_close(ncid);
+    if (result != NC_NOERR)
+    {
+        harp_set_error(HARP_ERROR_NETCDF, "%s", nc_strerror(result));
+        return -1;
+    }
+
+    return 0;
+}
@@ -35,6 +35,7 @@
 #include "coda.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -77,7 +78,7 @@ LIBHARP_API void harp_product_metadata_delete(harp_product_metadata *metadata)
 
 /**
  * Create new product metadata.
- * The metadata will be initialized with 0.0 datetime_start/end.
+ * The metadata will be initialized with 0.0 datetime_start/end and an unknown (NaN) bounding box.
  * \param new_metadata Pointer to the C variable where the new HARP product metadata will be stored.
  * \return
  *   \arg \c 0, Success.
@@ -108,6 +109,10 @@ LIBHARP_API int harp_product_metadata_new(harp_product_metadata **new_metadata)
 
     metadata->datetime_start = 0.0;
     metadata->datetime_stop = 0.0;
+    metadata->latitude_min = harp_nan();
+    metadata->latitude_max = harp_nan();
+    metadata->longitude_min = harp_nan();
+    metadata->longitude_max = harp_nan();
 
     *new_metadata = metadata;
 
@@ -126,6 +131,7 @@ LIBHARP_API int harp_product_metadata_new(harp_product_metadata **new_metadata)
  *  - vertical (dimension length)
  *  - spectral (dimension length)
  *  - source_product
+ *  - latitude_min, latitude_max, longitude_min, longitude_max (empty if unknown)
  * \param metadata Pointer to the metadata to print.
  * \param print Pointer to the function that should be used for printing.
  */
@@ -165,11 +171,23 @@ LIBHARP_API void harp_product_metadata_print(harp_product_metadata *metadata, in
     }
     if (strstr(metadata->source_product, ",") != NULL)
     {
-        print("\"%s\"\n", metadata->source_product);
+        print("\"%s\"", metadata->source_product);
     }
     else
     {
-        print("%s\n", metadata->source_product);
+        print("%s", metadata->source_product);
+    }
+    if (harp_isnan(metadata->latitude_min) || harp_isnan(metadata->latitude_max) ||
+        harp_isnan(metadata->longitude_min) || harp_isnan(metadata->longitude_max))
+    {
+        print(",,,,\n");
+    }
+    else
+    {
+        /* round the latitude range outwards, so the printed bounding box still covers the product */
+        print(",%.3f,%.3f,%.3f,%.3f\n", floor(metadata->latitude_min * 1000) / 1000,
+              ceil(metadata->latitude_max * 1000) / 1000, floor(metadata->longitude_min * 1000) / 1000,
+              ceil(metadata->longitude_max * 1000) / 1000);
     }
 }
 
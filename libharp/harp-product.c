@@ -31,6 +31,7 @@
 
 #include "harp-internal.h"
 
+#include "harp-geometry.h"
 #include "hashtable.h"
 
 #include <assert.h>
@@ -125,91 +126,6 @@ static int get_arguments(int argc, char *argv[], char **new_arguments)
 }
 
 #define MAX_NUM_COMPARISON_VARIABLES 8
-static int num_comparison_variables;
-static harp_variable *comparison_variable[MAX_NUM_COMPARISON_VARIABLES];
-
-static int compare_variable_elements(const void *a, const void *b)
-{
-    long index_a = *(long *)a;
-    long index_b = *(long *)b;
-    int i;
-
-    assert(num_comparison_variables <= MAX_NUM_COMPARISON_VARIABLES);
-    for (i = 0; i < num_comparison_variables; i++)
-    {
-        switch (comparison_variable[i]->data_type)
-        {
-            case harp_type_int8:
-                if (comparison_variable[i]->data.int8_data[index_a] < comparison_variable[i]->data.int8_data[index_b])
-                {
-                    return -1;
-                }
-                else if (comparison_variable[i]->data.int8_data[index_a] >
-                         comparison_variable[i]->data.int8_data[index_b])
-                {
-                    return 1;
-                }
-                break;
-            case harp_type_int16:
-                if (comparison_variable[i]->data.int16_data[index_a] < comparison_variable[i]->data.int16_data[index_b])
-                {
-                    return -1;
-                }
-                else if (comparison_variable[i]->data.int16_data[index_a] >
-                         comparison_variable[i]->data.int16_data[index_b])
-                {
-                    return 1;
-                }
-                break;
-            case harp_type_int32:
-                if (comparison_variable[i]->data.int32_data[index_a] < comparison_variable[i]->data.int32_data[index_b])
-                {
-                    return -1;
-                }
-                else if (comparison_variable[i]->data.int32_data[index_a] >
-                         comparison_variable[i]->data.int32_data[index_b])
-                {
-                    return 1;
-                }
-                break;
-            case harp_type_float:
-                if (comparison_variable[i]->data.float_data[index_a] < comparison_variable[i]->data.float_data[index_b])
-                {
-                    return -1;
-                }
-                else if (comparison_variable[i]->data.float_data[index_a] >
-                         comparison_variable[i]->data.float_data[index_b])
-                {
-                    return 1;
-                }
-                break;
-            case harp_type_double:
-                if (comparison_variable[i]->data.double_data[index_a] <
-                    comparison_variable[i]->data.double_data[index_b])
-                {
-                    return -1;
-                }
-                else if (comparison_variable[i]->data.double_data[index_a] >
-                         comparison_variable[i]->data.double_data[index_b])
-                {
-                    return 1;
-                }
-                break;
-            case harp_type_string:
-                {
-                    int result;
-
-                    result = strcmp(comparison_variable[i]->data.string_data[index_a],
-                                    comparison_variable[i]->data.string_data[index_b]);
-                    if (result != 0)
-                    {
-                        return result;
-                    }
-                }
-        }
-    }
-    return 0;
-}
 
 static void sync_product_dimensions_on_variable_add(harp_product *product, const harp_variable *variable)
 {
@@ -320,6 +236,11 @@ int harp_product_make_time_dependent(harp_product *product)
 {
     int i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (product->dimension[harp_dimension_time] == 0)
     {
         product->dimension[harp_dimension_time] = 1;
@@ -345,6 +266,7 @@ int harp_product_make_time_dependent(harp_product *product)
 int harp_product_rearrange_dimension(harp_product *product, harp_dimension_type dimension_type, long num_dim_elements,
                                      const long *dim_element_ids)
 {
+    int failed = 0;
     int i;
 
     if (dimension_type == harp_dimension_independent)
@@ -374,6 +296,14 @@ int harp_product_rearrange_dimension(harp_product *product, harp_dimension_type
         return 0;
     }
 
+    /* load all data up front, so we do not end up reopening the source file for each variable */
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
+    /* variables are independent of each other, so we rearrange them in parallel */
+#pragma omp parallel for reduction(|:failed) schedule(dynamic) num_threads(harp_get_num_threads())
     for (i = 0; i < product->num_variables; i++)
     {
         harp_variable *variable = product->variable[i];
@@ -388,10 +318,15 @@ int harp_product_rearrange_dimension(harp_product *product, harp_dimension_type
 
             if (harp_variable_rearrange_dimension(variable, j, num_dim_elements, dim_element_ids) != 0)
             {
-                return -1;
+                failed |= 1;
+                break;
             }
         }
     }
+    if (failed)
+    {
+        return -1;
+    }
 
     product->dimension[dimension_type] = num_dim_elements;
 
@@ -409,6 +344,10 @@ int harp_product_filter_by_index(harp_product *product, const char *index_variab
     {
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
 
     dim_element_ids = malloc(num_elements * sizeof(long));
     if (dim_element_ids == NULL)
@@ -452,6 +391,11 @@ int harp_product_resize_dimension(harp_product *product, harp_dimension_type dim
 {
     int i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     for (i = 0; i < product->num_variables; i++)
     {
         harp_variable *variable = product->variable[i];
@@ -524,6 +468,11 @@ int harp_product_filter_dimension(harp_product *product, harp_dimension_type dim
         return 0;
     }
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     for (i = 0; i < product->num_variables; i++)
     {
         harp_variable *variable = product->variable[i];
@@ -745,6 +694,163 @@ int harp_product_get_datetime_range(const harp_product *product, double *datetim
     return 0;
 }
 
+static int get_double_variable_in_unit(const harp_product *product, const char *name, const char *unit,
+                                       harp_variable **new_variable)
+{
+    harp_variable *variable;
+
+    if (harp_product_get_variable_by_name(product, name, &variable) != 0)
+    {
+        return -1;
+    }
+    if (harp_variable_copy(variable, &variable) != 0)
+    {
+        return -1;
+    }
+    if (harp_variable_convert_unit(variable, unit) != 0)
+    {
+        harp_variable_delete(variable);
+        return -1;
+    }
+    if (harp_variable_convert_data_type(variable, harp_type_double) != 0)
+    {
+        harp_variable_delete(variable);
+        return -1;
+    }
+
+    *new_variable = variable;
+
+    return 0;
+}
+
+static int add_bounds_to_extent(const harp_product *product, harp_geographic_extent *extent)
+{
+    harp_variable *latitude_bounds;
+    harp_variable *longitude_bounds;
+    int is_paired;
+    long num_vertices;
+    long i;
+    int j;
+
+    if (get_double_variable_in_unit(product, "latitude_bounds", "degree_north", &latitude_bounds) != 0)
+    {
+        return -1;
+    }
+    if (get_double_variable_in_unit(product, "longitude_bounds", "degree_east", &longitude_bounds) != 0)
+    {
+        harp_variable_delete(latitude_bounds);
+        return -1;
+    }
+
+    /* latitude_bounds and longitude_bounds describe polygons if they have the same dimensions */
+    is_paired = latitude_bounds->num_dimensions > 0 &&
+        latitude_bounds->num_dimensions == longitude_bounds->num_dimensions;
+    for (j = 0; is_paired && j < latitude_bounds->num_dimensions; j++)
+    {
+        is_paired = latitude_bounds->dimension_type[j] == longitude_bounds->dimension_type[j] &&
+            latitude_bounds->dimension[j] == longitude_bounds->dimension[j];
+    }
+
+    if (is_paired)
+    {
+        num_vertices = latitude_bounds->dimension[latitude_bounds->num_dimensions - 1];
+        for (i = 0; i < latitude_bounds->num_elements; i += num_vertices)
+        {
+            harp_geographic_extent_add_polygon(extent, num_vertices, &latitude_bounds->data.double_data[i],
+                                               &longitude_bounds->data.double_data[i]);
+        }
+    }
+    else
+    {
+        /* independent latitude and longitude axis bounds (e.g. of a lat/lon grid) */
+        for (i = 0; i < latitude_bounds->num_elements; i++)
+        {
+            harp_geographic_extent_add_latitude(extent, latitude_bounds->data.double_data[i]);
+        }
+        num_vertices = 1;
+        if (longitude_bounds->num_dimensions > 0)
+        {
+            num_vertices = longitude_bounds->dimension[longitude_bounds->num_dimensions - 1];
+        }
+        for (i = 0; i < longitude_bounds->num_elements; i += num_vertices)
+        {
+            harp_geographic_extent_add_longitude(extent, longitude_bounds->data.double_data[i]);
+            for (j = 1; j < num_vertices; j++)
+            {
+                harp_geographic_extent_add_longitude_range(extent, longitude_bounds->data.double_data[i + j - 1],
+                                                           longitude_bounds->data.double_data[i + j]);
+            }
+        }
+    }
+
+    harp_variable_delete(latitude_bounds);
+    harp_variable_delete(longitude_bounds);
+
+    return 0;
+}
+
+/**
+ * Determine the coarse geographic bounding box covered by the product.
+ * The bounding box covers all values of the latitude/longitude variables and all areas described by the
+ * latitude_bounds/longitude_bounds variables (if present). Latitudes and longitudes are returned in degrees.
+ * Longitudes are in the range [-180,180], with longitude_min > longitude_max if the box crosses the dateline.
+ * The longitude range is rounded outwards to whole degrees.
+ *
+ * \param  product       Product to compute the bounding box of.
+ * \param  latitude_min  Pointer to the location where the minimum latitude will be stored.
+ * \param  latitude_max  Pointer to the location where the maximum latitude will be stored.
+ * \param  longitude_min Pointer to the location where the western most longitude will be stored.
+ * \param  longitude_max Pointer to the location where the eastern most longitude will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c 1, The product has no latitude/longitude information (no bounding box is returned).
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+int harp_product_get_spatial_extent(const harp_product *product, double *latitude_min, double *latitude_max,
+                                    double *longitude_min, double *longitude_max)
+{
+    harp_geographic_extent extent;
+    harp_variable *variable;
+    long i;
+
+    harp_geographic_extent_init(&extent);
+
+    if (harp_product_has_variable(product, "latitude_bounds") &&
+        harp_product_has_variable(product, "longitude_bounds"))
+    {
+        if (add_bounds_to_extent(product, &extent) != 0)
+        {
+            return -1;
+        }
+    }
+    if (harp_product_has_variable(product, "latitude"))
+    {
+        if (get_double_variable_in_unit(product, "latitude", "degree_north", &variable) != 0)
+        {
+            return -1;
+        }
+        for (i = 0; i < variable->num_elements; i++)
+        {
+            harp_geographic_extent_add_latitude(&extent, variable->data.double_data[i]);
+        }
+        harp_variable_delete(variable);
+    }
+    if (harp_product_has_variable(product, "longitude"))
+    {
+        if (get_double_variable_in_unit(product, "longitude", "degree_east", &variable) != 0)
+        {
+            return -1;
+        }
+        for (i = 0; i < variable->num_elements; i++)
+        {
+            harp_geographic_extent_add_longitude(&extent, variable->data.double_data[i]);
+        }
+        harp_variable_delete(variable);
+    }
+
+    return harp_geographic_extent_get_range(&extent, latitude_min, latitude_max, longitude_min, longitude_max);
+}
+
 int harp_product_get_storage_size(const harp_product *product, int with_attributes, int64_t *size)
 {
     int64_t total_size = 0;
@@ -851,6 +957,19 @@ LIBHARP_API void harp_product_delete(harp_product *product)
     }
 }
 
+/** Read the data of all variables of a product that have not been loaded yet.
+ * This is the product level equivalent of harp_variable_load(). Variables that are read from the same file are read
+ * together using a single open of the file.
+ * \param product HARP product.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_product_load(harp_product *product)
+{
+    return harp_variable_load_from_source(product->num_variables, product->variable);
+}
+
 /** Create a copy of a product.
  * The function will create a deep-copy of the given product, also creating copyies of all attributes and variables.
  * \param other_product Product that should be copied.
@@ -864,6 +983,12 @@ LIBHARP_API int harp_product_copy(const harp_product *other_product, harp_produc
     harp_product *product;
     int i;
 
+    /* loading the data does not change the content of the product, so we allow this for a const product */
+    if (harp_product_load((harp_product *)other_product) != 0)
+    {
+        return -1;
+    }
+
     if (harp_product_new(&product) != 0)
     {
         return -1;
@@ -985,80 +1110,398 @@ static int add_missing_count_and_weight_variables(harp_product *product, harp_pr
         }
     }
 
-    /* we cannot add specific '*_weight' variables if the product does not have a global 'weight' variable */
-    if (harp_product_has_variable(product, "weight"))
+    /* we cannot add specific '*_weight' variables if the product does not have a global 'weight' variable */
+    if (harp_product_has_variable(product, "weight"))
+    {
+        harp_variable *weight_variable;
+
+        if (harp_product_get_variable_by_name(product, "weight", &weight_variable) != 0)
+        {
+            return -1;
+        }
+        if (weight_variable->num_dimensions > 1 && weight_variable->dimension_type[0] == harp_dimension_time)
+        {
+            for (i = 0; i < other_product->num_variables; i++)
+            {
+                harp_variable *variable = other_product->variable[i];
+                int length = strlen(variable->name);
+
+                if (length > 7 && strcmp(&variable->name[length - 7], "_weight") == 0)
+                {
+                    int same_dimensions = 1;
+
+                    /* Ignore this variable if it does not match the dimensions of the weight variable */
+                    /* (e.g. it is a weight variable linked to an angle variable, which will never be 'missing') */
+                    if (variable->num_dimensions < weight_variable->num_dimensions)
+                    {
+                        same_dimensions = 0;
+                    }
+                    else
+                    {
+                        for (j = 0; j < weight_variable->num_dimensions; j++)
+                        {
+                            if (variable->dimension_type[j] != weight_variable->dimension_type[j])
+                            {
+                                same_dimensions = 0;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (!harp_product_has_variable(product, variable->name) && same_dimensions)
+                    {
+                        harp_variable *new_variable;
+
+                        if (harp_variable_copy(weight_variable, &new_variable) != 0)
+                        {
+                            return -1;
+                        }
+                        if (harp_variable_rename(new_variable, variable->name) != 0)
+                        {
+                            harp_variable_delete(new_variable);
+                            return -1;
+                        }
+                        for (j = weight_variable->num_dimensions; j < variable->num_dimensions; j++)
+                        {
+                            long dim_length;
+
+                            dim_length = variable->dimension_type[j] < 0 ? variable->dimension[j] :
+                                product->dimension[variable->dimension_type[j]];
+                            if (harp_variable_add_dimension(new_variable, j, variable->dimension_type[j], dim_length) !=
+                                0)
+                            {
+                                harp_variable_delete(new_variable);
+                                return -1;
+                            }
+                        }
+                        if (harp_product_add_variable(product, new_variable) != 0)
+                        {
+                            harp_variable_delete(new_variable);
+                            return -1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Make 'product' and 'other_product' compatible for appending.
+ * This removes the 'index' variable from 'other_product', adds missing '*_count' and '*_weight' variables to both
+ * products, verifies that both products have the same set of variables, makes 'other_product' time dependent, and
+ * extends all non-time dimensions of both products to the maximum of either product.
+ * 'product' should already have been made time dependent.
+ */
+int harp_product_prepare_for_append(harp_product *product, harp_product *other_product)
+{
+    harp_variable *variable;
+    harp_dimension_type dimension_type;
+    int i;
+
+    if (harp_product_has_variable(other_product, "index"))
+    {
+        if (harp_product_remove_variable_by_name(other_product, "index") != 0)
+        {
+            return -1;
+        }
+    }
+
+    /* add '*_count' and '*_weight' variables where needed */
+    if (add_missing_count_and_weight_variables(product, other_product) != 0)
+    {
+        return -1;
+    }
+    if (add_missing_count_and_weight_variables(other_product, product) != 0)
+    {
+        return -1;
+    }
+
+    /* now check if both products have the same variables */
+    for (i = 0; i < product->num_variables; i++)
+    {
+        variable = product->variable[i];
+        if (!harp_product_has_variable(other_product, variable->name))
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "products don't both have variable '%s'", variable->name);
+            return -1;
+        }
+    }
+    for (i = 0; i < other_product->num_variables; i++)
+    {
+        variable = other_product->variable[i];
+        if (!harp_product_has_variable(product, variable->name))
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "products don't both have variable '%s'", variable->name);
+            return -1;
+        }
+    }
+
+    if (harp_product_make_time_dependent(other_product) != 0)
+    {
+        return -1;
+    }
+
+    /* align size of all non-time dimensions */
+    for (dimension_type = 0; dimension_type < HARP_NUM_DIM_TYPES; dimension_type++)
+    {
+        if (dimension_type != harp_dimension_time)
+        {
+            if (product->dimension[dimension_type] > other_product->dimension[dimension_type])
+            {
+                if (harp_product_resize_dimension(other_product, dimension_type, product->dimension[dimension_type]) !=
+                    0)
+                {
+                    return -1;
+                }
+            }
+            else if (product->dimension[dimension_type] < other_product->dimension[dimension_type])
+            {
+                if (harp_product_resize_dimension(product, dimension_type, other_product->dimension[dimension_type]) !=
+                    0)
+                {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* A run of consecutive time elements of one of the input products of a sorted append */
+typedef struct append_run_struct
+{
+    int product_index;
+    long start;
+    long length;
+} append_run;
+
+/* Determine whether the current element of product 'a' should come before the current element of product 'b'.
+ * Products with a lower index win ties, which makes the merge stable.
+ */
+static int merge_element_precedes(int num_keys, harp_variable ***key, const long *cursor, int a, int b)
+{
+    int result;
+
+    result = harp_sort_compare_elements(num_keys, key[a], cursor[a], key[b], cursor[b]);
+    return result < 0 || (result == 0 && a < b);
+}
+
+static void merge_heap_sift_down(int num_keys, harp_variable ***key, const long *cursor, int *heap, int heap_size,
+                                 int i)
+{
+    int product_index = heap[i];
+
+    for (;;)
+    {
+        int child = 2 * i + 1;
+
+        if (child >= heap_size)
+        {
+            break;
+        }
+        if (child + 1 < heap_size && merge_element_precedes(num_keys, key, cursor, heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if (!merge_element_precedes(num_keys, key, cursor, heap[child], product_index))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = product_index;
+}
+
+/* Perform a k-way merge of the (sorted) key variables of all products.
+ * The result is a list of runs that, when concatenated, give the time elements of the merged product in sorted order.
+ */
+static int get_merge_runs(int num_products, int num_keys, harp_variable ***key, const long *length, long *num_runs,
+                          append_run **run)
+{
+    append_run *run_list = NULL;
+    long num_allocated_runs = 0;
+    long run_count = 0;
+    long *cursor;
+    int *heap;
+    int heap_size = 0;
+    int i;
+
+    cursor = malloc(num_products * sizeof(long));
+    if (cursor == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_products * sizeof(long), __FILE__, __LINE__);
+        return -1;
+    }
+    heap = malloc(num_products * sizeof(int));
+    if (heap == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_products * sizeof(int), __FILE__, __LINE__);
+        free(cursor);
+        return -1;
+    }
+
+    for (i = 0; i < num_products; i++)
+    {
+        cursor[i] = 0;
+        if (length[i] > 0)
+        {
+            heap[heap_size] = i;
+            heap_size++;
+        }
+    }
+    for (i = heap_size / 2 - 1; i >= 0; i--)
+    {
+        merge_heap_sift_down(num_keys, key, cursor, heap, heap_size, i);
+    }
+
+    while (heap_size > 0)
+    {
+        int product_index = heap[0];
+
+        if (run_count > 0 && run_list[run_count - 1].product_index == product_index)
+        {
+            /* consecutive elements of a product always end up in the same run */
+            run_list[run_count - 1].length++;
+        }
+        else
+        {
+            if (run_count == num_allocated_runs)
+            {
+                append_run *new_run_list;
+
+                num_allocated_runs = num_allocated_runs == 0 ? 16 : 2 * num_allocated_runs;
+                new_run_list = realloc(run_list, num_allocated_runs * sizeof(append_run));
+                if (new_run_list == NULL)
+                {
+                    harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                                   num_allocated_runs * sizeof(append_run), __FILE__, __LINE__);
+                    if (run_list != NULL)
+                    {
+                        free(run_list);
+                    }
+                    free(heap);
+                    free(cursor);
+                    return -1;
+                }
+                run_list = new_run_list;
+            }
+            run_list[run_count].product_index = product_index;
+            run_list[run_count].start = cursor[product_index];
+            run_list[run_count].length = 1;
+            run_count++;
+        }
+
+        cursor[product_index]++;
+        if (cursor[product_index] == length[product_index])
+        {
+            heap_size--;
+            heap[0] = heap[heap_size];
+        }
+        if (heap_size > 0)
+        {
+            merge_heap_sift_down(num_keys, key, cursor, heap, heap_size, 0);
+        }
+    }
+
+    free(heap);
+    free(cursor);
+
+    *num_runs = run_count;
+    *run = run_list;
+
+    return 0;
+}
+
+/* Replace the data of 'source[0]' by the concatenation of the given runs of the variables in 'source'.
+ * All variables in 'source' should already have been verified to be compatible for appending.
+ */
+static int merge_variable_runs(harp_variable **source, long num_runs, const append_run *run, long new_time_length)
+{
+    harp_variable *variable = source[0];
+    long element_size;
+    long block_size;
+    long new_num_elements;
+    long offset;
+    long i;
+    void *data;
+
+    element_size = harp_get_size_for_type(variable->data_type);
+    block_size = variable->num_elements / variable->dimension[0];
+    new_num_elements = new_time_length * block_size;
+
+    data = malloc((size_t)new_num_elements * element_size);
+    if (data == NULL)
     {
-        harp_variable *weight_variable;
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (size_t)new_num_elements * element_size, __FILE__, __LINE__);
+        return -1;
+    }
 
-        if (harp_product_get_variable_by_name(product, "weight", &weight_variable) != 0)
-        {
-            return -1;
-        }
-        if (weight_variable->num_dimensions > 1 && weight_variable->dimension_type[0] == harp_dimension_time)
+    if (variable->data_type == harp_type_string)
+    {
+        char **string_data = (char **)data;
+
+        memset(string_data, 0, (size_t)new_num_elements * element_size);
+        offset = 0;
+        for (i = 0; i < num_runs; i++)
         {
-            for (i = 0; i < other_product->num_variables; i++)
-            {
-                harp_variable *variable = other_product->variable[i];
-                int length = strlen(variable->name);
+            char **source_data = &source[run[i].product_index]->data.string_data[run[i].start * block_size];
+            long j;
 
-                if (length > 7 && strcmp(&variable->name[length - 7], "_weight") == 0)
+            for (j = 0; j < run[i].length * block_size; j++)
+            {
+                if (source_data[j] != NULL)
                 {
-                    int same_dimensions = 1;
-
-                    /* Ignore this variable if it does not match the dimensions of the weight variable */
-                    /* (e.g. it is a weight variable linked to an angle variable, which will never be 'missing') */
-                    if (variable->num_dimensions < weight_variable->num_dimensions)
-                    {
-                        same_dimensions = 0;
-                    }
-                    else
-                    {
-                        for (j = 0; j < weight_variable->num_dimensions; j++)
-                        {
-                            if (variable->dimension_type[j] != weight_variable->dimension_type[j])
-                            {
-                                same_dimensions = 0;
-                                break;
-                            }
-                        }
-                    }
-
-                    if (!harp_product_has_variable(product, variable->name) && same_dimensions)
+                    string_data[offset] = strdup(source_data[j]);
+                    if (string_data[offset] == NULL)
                     {
-                        harp_variable *new_variable;
-
-                        if (harp_variable_copy(weight_variable, &new_variable) != 0)
-                        {
-                            return -1;
-                        }
-                        if (harp_variable_rename(new_variable, variable->name) != 0)
-                        {
-                            harp_variable_delete(new_variable);
-                            return -1;
-                        }
-                        for (j = weight_variable->num_dimensions; j < variable->num_dimensions; j++)
+                        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)",
+                                       __FILE__, __LINE__);
+                        for (j = 0; j < offset; j++)
                         {
-                            long dim_length;
-
-                            dim_length = variable->dimension_type[j] < 0 ? variable->dimension[j] :
-                                product->dimension[variable->dimension_type[j]];
-                            if (harp_variable_add_dimension(new_variable, j, variable->dimension_type[j], dim_length) !=
-                                0)
+                            if (string_data[j] != NULL)
                             {
-                                harp_variable_delete(new_variable);
-                                return -1;
+                                free(string_data[j]);
                             }
                         }
-                        if (harp_product_add_variable(product, new_variable) != 0)
-                        {
-                            harp_variable_delete(new_variable);
-                            return -1;
-                        }
+                        free(data);
+                        return -1;
                     }
                 }
+                offset++;
+            }
+        }
+        for (i = 0; i < variable->num_elements; i++)
+        {
+            if (variable->data.string_data[i] != NULL)
+            {
+                free(variable->data.string_data[i]);
             }
         }
     }
+    else
+    {
+        offset = 0;
+        for (i = 0; i < num_runs; i++)
+        {
+            long num_bytes = run[i].length * block_size * element_size;
+
+            memcpy((char *)data + offset, (char *)source[run[i].product_index]->data.ptr +
+                   run[i].start * block_size * element_size, (size_t)num_bytes);
+            offset += num_bytes;
+        }
+    }
+
+    free(variable->data.ptr);
+    variable->data.ptr = data;
+    variable->dimension[0] = new_time_length;
+    variable->num_elements = new_num_elements;
 
     return 0;
 }
@@ -1085,9 +1528,16 @@ LIBHARP_API int harp_product_append(harp_product *product, harp_product *other_p
 {
     harp_variable *variable;
     harp_variable *other_variable;
-    harp_dimension_type dimension_type;
     int i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+    if (other_product != NULL && harp_product_load(other_product) != 0)
+    {
+        return -1;
+    }
     if (harp_product_has_variable(product, "index"))
     {
         if (harp_product_remove_variable_by_name(product, "index") != 0)
@@ -1111,90 +1561,285 @@ LIBHARP_API int harp_product_append(harp_product *product, harp_product *other_p
         return 0;
     }
 
-    if (harp_product_has_variable(other_product, "index"))
+    if (harp_product_prepare_for_append(product, other_product) != 0)
     {
-        if (harp_product_remove_variable_by_name(other_product, "index") != 0)
+        return -1;
+    }
+
+    /* append all variables */
+    for (i = 0; i < product->num_variables; i++)
+    {
+        variable = product->variable[i];
+        if (harp_product_get_variable_by_name(other_product, variable->name, &other_variable) != 0)
+        {
+            assert(0);
+            exit(1);
+        }
+        if (harp_variable_append(variable, other_variable) != 0)
         {
             return -1;
         }
     }
+    product->dimension[harp_dimension_time] += other_product->dimension[harp_dimension_time];
 
-    /* add '*_count' and '*_weight' variables where needed */
-    if (add_missing_count_and_weight_variables(product, other_product) != 0)
+    return 0;
+}
+
+/** Merge a list of products into another product, keeping the result sorted.
+ * This performs the same operation as calling harp_product_append() for each product in \a other_product, followed
+ * by harp_product_sort() on the result, but without having to sort the full concatenated product.
+ * Each product (including \a product) is first sorted on the given variables (if it is not sorted already), after
+ * which the time elements of all products are merged in a single pass (k-way merge). If the products do not overlap
+ * this reduces to a plain concatenation of all products.
+ *
+ * The merge is stable: time elements with equal keys are kept in the order of the input products (with \a product
+ * first) and in their original order within each product.
+ * All sort variables need to be one dimensional and depend on the time dimension (after the time dimension has been
+ * introduced for all variables).
+ *
+ * The products in \a other_product will be modified (as for harp_product_append()), but remain owned by the caller.
+ * \param product Product to which data should be appended.
+ * \param num_products Number of products in \a other_product.
+ * \param other_product Products that should be appended.
+ * \param num_variables Number of variables in \a variable_name.
+ * \param variable_name Names of the variables to sort on (the first variable is the primary sort key).
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_product_append_sorted(harp_product *product, int num_products, harp_product **other_product,
+                                           int num_variables, const char **variable_name)
+{
+    harp_variable ***key = NULL;
+    harp_variable **source = NULL;
+    harp_product **merge_product = NULL;
+    append_run *run = NULL;
+    long *length = NULL;
+    long num_runs;
+    long new_time_length;
+    int failed = 0;
+    int i, j;
+
+    if (product == NULL)
     {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
-    if (add_missing_count_and_weight_variables(other_product, product) != 0)
+    if (num_products < 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_products argument is negative (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (num_products > 0 && other_product == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "other_product is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (num_variables < 1 || num_variables > MAX_NUM_COMPARISON_VARIABLES)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "invalid number of variables for sorting (%d not in range [1,%d])",
+                       num_variables, MAX_NUM_COMPARISON_VARIABLES);
+        return -1;
+    }
+    if (variable_name == NULL)
     {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable_name is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    for (i = 0; i < num_products; i++)
+    {
+        if (other_product[i] == NULL)
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "other_product[%d] is NULL (%s:%u)", i, __FILE__, __LINE__);
+            return -1;
+        }
+        if (harp_product_load(other_product[i]) != 0)
+        {
+            return -1;
+        }
+    }
 
-    /* now check if both products have the same variables */
-    for (i = 0; i < product->num_variables; i++)
+    if (harp_product_append(product, NULL) != 0)
     {
-        variable = product->variable[i];
-        if (!harp_product_has_variable(other_product, variable->name))
+        return -1;
+    }
+    for (i = 0; i < num_products; i++)
+    {
+        if (harp_product_prepare_for_append(product, other_product[i]) != 0)
         {
-            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "products don't both have variable '%s'", variable->name);
             return -1;
         }
     }
-    for (i = 0; i < other_product->num_variables; i++)
+    /* the second pass makes sure that all products end up with the union of the '*_count' and '*_weight' variables
+     * and with the maximum length of each non-time dimension */
+    for (i = 0; i < num_products; i++)
     {
-        variable = other_product->variable[i];
-        if (!harp_product_has_variable(product, variable->name))
+        if (harp_product_prepare_for_append(product, other_product[i]) != 0)
         {
-            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "products don't both have variable '%s'", variable->name);
             return -1;
         }
     }
 
-    if (harp_product_make_time_dependent(other_product) != 0)
+    /* we treat 'product' as the first product of the merge */
+    merge_product = malloc((num_products + 1) * sizeof(harp_product *));
+    if (merge_product == NULL)
     {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (num_products + 1) * sizeof(harp_product *), __FILE__, __LINE__);
         return -1;
     }
+    merge_product[0] = product;
+    for (i = 0; i < num_products; i++)
+    {
+        merge_product[i + 1] = other_product[i];
+    }
+    num_products++;
 
-    /* align size of all non-time dimensions */
-    for (dimension_type = 0; dimension_type < HARP_NUM_DIM_TYPES; dimension_type++)
+    key = malloc(num_products * sizeof(harp_variable **));
+    if (key == NULL)
     {
-        if (dimension_type != harp_dimension_time)
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_products * sizeof(harp_variable **), __FILE__, __LINE__);
+        goto error;
+    }
+    for (i = 0; i < num_products; i++)
+    {
+        key[i] = NULL;
+    }
+    length = malloc(num_products * sizeof(long));
+    if (length == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_products * sizeof(long), __FILE__, __LINE__);
+        goto error;
+    }
+
+    for (i = 0; i < num_products; i++)
+    {
+        key[i] = malloc(num_variables * sizeof(harp_variable *));
+        if (key[i] == NULL)
         {
-            if (product->dimension[dimension_type] > other_product->dimension[dimension_type])
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_variables * sizeof(harp_variable *), __FILE__, __LINE__);
+            goto error;
+        }
+        for (j = 0; j < num_variables; j++)
+        {
+            if (harp_product_get_variable_by_name(merge_product[i], variable_name[j], &key[i][j]) != 0)
             {
-                if (harp_product_resize_dimension(other_product, dimension_type, product->dimension[dimension_type]) !=
-                    0)
-                {
-                    return -1;
-                }
+                goto error;
             }
-            else if (product->dimension[dimension_type] < other_product->dimension[dimension_type])
+            if (key[i][j]->num_dimensions != 1 || key[i][j]->dimension_type[0] != harp_dimension_time)
             {
-                if (harp_product_resize_dimension(product, dimension_type, other_product->dimension[dimension_type]) !=
-                    0)
-                {
-                    return -1;
-                }
+                harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable '%s' should be one dimensional and depend on "
+                               "the time dimension", variable_name[j]);
+                goto error;
+            }
+            if (key[i][j]->data_type != key[0][j]->data_type)
+            {
+                harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variables don't have the same datatype (%s)",
+                               variable_name[j]);
+                goto error;
             }
         }
+        /* this is a no-op if the product is already sorted */
+        if (harp_product_sort(merge_product[i], num_variables, variable_name) != 0)
+        {
+            goto error;
+        }
+        length[i] = merge_product[i]->dimension[harp_dimension_time];
     }
 
-    /* append all variables */
+    if (get_merge_runs(num_products, num_variables, key, length, &num_runs, &run) != 0)
+    {
+        goto error;
+    }
+    new_time_length = 0;
+    for (i = 0; i < num_products; i++)
+    {
+        new_time_length += length[i];
+    }
+
+    /* collect and verify the variables to merge before modifying anything */
+    source = malloc((size_t)product->num_variables * num_products * sizeof(harp_variable *));
+    if (source == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (size_t)product->num_variables * num_products * sizeof(harp_variable *), __FILE__, __LINE__);
+        goto error;
+    }
     for (i = 0; i < product->num_variables; i++)
     {
-        variable = product->variable[i];
-        if (harp_product_get_variable_by_name(other_product, variable->name, &other_variable) != 0)
+        harp_variable **variable_source = &source[i * num_products];
+
+        variable_source[0] = product->variable[i];
+        for (j = 1; j < num_products; j++)
         {
-            assert(0);
-            exit(1);
+            if (harp_product_get_variable_by_name(merge_product[j], product->variable[i]->name,
+                                                  &variable_source[j]) != 0)
+            {
+                goto error;
+            }
+            if (harp_variable_check_append_compatibility(variable_source[0], variable_source[j]) != 0)
+            {
+                goto error;
+            }
         }
-        if (harp_variable_append(variable, other_variable) != 0)
+    }
+
+    /* variables are independent of each other, so we merge them in parallel */
+#pragma omp parallel for reduction(|:failed) schedule(dynamic) num_threads(harp_get_num_threads())
+    for (i = 0; i < product->num_variables; i++)
+    {
+        if (merge_variable_runs(&source[i * num_products], num_runs, run, new_time_length) != 0)
         {
-            return -1;
+            failed = 1;
         }
     }
-    product->dimension[harp_dimension_time] += other_product->dimension[harp_dimension_time];
+    if (failed)
+    {
+        goto error;
+    }
+    product->dimension[harp_dimension_time] = new_time_length;
+
+    free(source);
+    free(run);
+    for (i = 0; i < num_products; i++)
+    {
+        free(key[i]);
+    }
+    free(key);
+    free(length);
+    free(merge_product);
 
     return 0;
+
+  error:
+    if (source != NULL)
+    {
+        free(source);
+    }
+    if (run != NULL)
+    {
+        free(run);
+    }
+    if (key != NULL)
+    {
+        for (i = 0; i < num_products; i++)
+        {
+            if (key[i] != NULL)
+            {
+                free(key[i]);
+            }
+        }
+        free(key);
+    }
+    if (length != NULL)
+    {
+        free(length);
+    }
+    free(merge_product);
+    return -1;
 }
 
 /** Set the source product attribute of the specified product.
@@ -1869,6 +2514,9 @@ LIBHARP_API void harp_product_print(const harp_product *product, int show_attrib
 
     if (show_data)
     {
+        /* read all data in one go; any read error gets reported per variable by harp_variable_print_data() */
+        harp_product_load((harp_product *)product);
+
         print("data:\n");
         for (i = 0; i < product->num_variables; i++)
         {
@@ -1924,6 +2572,10 @@ LIBHARP_API int harp_product_flatten_dimension(harp_product *product, harp_dimen
         /* trying to flatten a dimension that the product does not depend on is not an error */
         return 0;
     }
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
 
     /* use a more efficient approach if the length of the flattened dimension equals 1 */
     if (dim_length == 1)
@@ -2073,6 +2725,9 @@ LIBHARP_API int harp_product_flatten_dimension(harp_product *product, harp_dimen
  *
  * Only up to eight variables can be used for sorting.
  *
+ * The sort is stable (elements with equal values keep their relative order) and NaN values are put at the end.
+ * If the dimension is already sorted then the product is left untouched.
+ *
  * \param product HARP product
  * \param num_variables Number of variables to use for sorting (1 <= num_variables <= 8)
  * \param variable_name Names of the variables to use for sorting
@@ -2082,24 +2737,28 @@ LIBHARP_API int harp_product_flatten_dimension(harp_product *product, harp_dimen
  */
 LIBHARP_API int harp_product_sort(harp_product *product, int num_variables, const char **variable_name)
 {
+    harp_variable *comparison_variable[MAX_NUM_COMPARISON_VARIABLES];
     long num_elements;
     long *dim_element_ids;
     long i;
 
-    if (num_variables < 1 || num_comparison_variables > MAX_NUM_COMPARISON_VARIABLES)
+    if (num_variables < 1 || num_variables > MAX_NUM_COMPARISON_VARIABLES)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "invalid number of variables for sorting (%d not in range [1,%d])",
                        num_variables, MAX_NUM_COMPARISON_VARIABLES);
         return -1;
     }
 
-    num_comparison_variables = num_variables;
     for (i = 0; i < num_variables; i++)
     {
         if (harp_product_get_variable_by_name(product, variable_name[i], &comparison_variable[i]) != 0)
         {
             return -1;
         }
+        if (harp_variable_load(comparison_variable[i]) != 0)
+        {
+            return -1;
+        }
         if (comparison_variable[i]->num_dimensions != 1)
         {
             harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable for sorting should be a one dimensional array");
@@ -2124,6 +2783,12 @@ LIBHARP_API int harp_product_sort(harp_product *product, int num_variables, cons
         }
     }
 
+    if (harp_sort_is_sorted(num_variables, comparison_variable, num_elements))
+    {
+        /* nothing to rearrange */
+        return 0;
+    }
+
     dim_element_ids = malloc(num_elements * sizeof(long));
     if (dim_element_ids == NULL)
     {
@@ -2131,13 +2796,13 @@ LIBHARP_API int harp_product_sort(harp_product *product, int num_variables, cons
                        num_elements * sizeof(long), __FILE__, __LINE__);
         return -1;
     }
-    for (i = 0; i < num_elements; i++)
+
+    if (harp_sort_get_index(num_variables, comparison_variable, num_elements, dim_element_ids) != 0)
     {
-        dim_element_ids[i] = i;
+        free(dim_element_ids);
+        return -1;
     }
 
-    qsort(dim_element_ids, num_elements, sizeof(long), compare_variable_elements);
-
     if (harp_product_rearrange_dimension(product, comparison_variable[0]->dimension_type[0], num_elements,
                                          dim_element_ids) != 0)
     {
@@ -1284,6 +1284,24 @@ static int execute_wrap(harp_product *product, harp_operation_wrap *operation)
     return 0;
 }
 
+/* returns whether an operation only needs the data of the variables that it explicitly uses */
+static int operation_allows_lazy_data(const harp_operation *operation)
+{
+    switch (operation->type)
+    {
+        case operation_derive_variable:
+        case operation_exclude_variable:
+        case operation_keep_variable:
+        case operation_rename:
+        case operation_set:
+            return 1;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
 /* this will start with the operation at program->current_index */
 int harp_product_execute_program(harp_product *product, harp_program *program)
 {
@@ -1291,6 +1309,16 @@ int harp_product_execute_program(harp_product *product, harp_program *program)
     {
         harp_operation *operation = program->operation[program->current_index];
 
+        /* variables that were imported lazily get loaded on first use; most operations touch all variables, so for
+         * those we load all remaining data in one go */
+        if (!operation_allows_lazy_data(operation))
+        {
+            if (harp_product_load(product) != 0)
+            {
+                return -1;
+            }
+        }
+
         /* note that some consecutive filter operations can be executed together for optimization purposes */
         /* so the filter functions below may increase program->current_index itself */
         switch (operation->type)
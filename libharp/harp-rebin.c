@@ -285,26 +285,30 @@ static int get_weight_variable_for_variable(harp_product *product, harp_variable
     return 0;
 }
 
-/* get weight values for each element in the provided variable.
- * if a '<variable>_weight' or 'weight' variable exists then 'weight' will be populated and the return value will be 1.
+/* get the weight variable that applies to the provided variable.
+ * if a '<variable>_weight' or 'weight' variable exists then 'weight_variable' will be set and the return value will be 1.
+ * the weight for element i of the variable is then weight_variable[i / weight_factor].
  * if no applicable weight variable could be found then the return value will be 0.
  * the return value is -1 when an error is encountered.
  */
-static int get_weight_for_variable(harp_product *product, harp_variable *variable, binning_type *bintype, float *weight)
+static int get_weight_for_variable(harp_product *product, harp_variable *variable, binning_type *bintype,
+                                   harp_variable **weight_variable, long *weight_factor)
 {
-    harp_variable *weight_variable = NULL;
-    long i, j;
+    long i;
+
+    *weight_variable = NULL;
+    *weight_factor = 1;
 
     if (variable->num_dimensions <= 1 || variable->dimension_type[0] != harp_dimension_time)
     {
         return 0;
     }
 
-    if (get_weight_variable_for_variable(product, variable, bintype, &weight_variable) != 0)
+    if (get_weight_variable_for_variable(product, variable, bintype, weight_variable) != 0)
     {
         return -1;
     }
-    if (weight_variable == NULL)
+    if (*weight_variable == NULL)
     {
         int index;
 
@@ -320,177 +324,427 @@ static int get_weight_for_variable(harp_product *product, harp_variable *variabl
         {
             return 0;
         }
-        weight_variable = product->variable[index];
 
         /* initial dimensions should match */
-        if (weight_variable->num_dimensions > variable->num_dimensions)
+        if (product->variable[index]->num_dimensions > variable->num_dimensions)
         {
             return 0;
         }
-        for (i = 0; i < weight_variable->num_dimensions; i++)
+        for (i = 0; i < product->variable[index]->num_dimensions; i++)
         {
-            if (weight_variable->dimension_type[i] != variable->dimension_type[i] ||
-                weight_variable->dimension[i] != variable->dimension[i])
+            if (product->variable[index]->dimension_type[i] != variable->dimension_type[i] ||
+                product->variable[index]->dimension[i] != variable->dimension[i])
             {
                 return 0;
             }
         }
+        *weight_variable = product->variable[index];
     }
 
     /* this should be assured by bintype[index] not being equal to binning_remove */
-    assert(weight_variable->data_type == harp_type_float);
+    assert((*weight_variable)->data_type == harp_type_float);
 
-    /* store data into weight parameter */
-    if (variable->num_elements == weight_variable->num_elements)
+    if ((*weight_variable)->num_elements > 0)
     {
-        memcpy(weight, weight_variable->data.float_data, weight_variable->num_elements * sizeof(float));
+        *weight_factor = variable->num_elements / (*weight_variable)->num_elements;
     }
-    else
-    {
-        long num_sub_elements = variable->num_elements / weight_variable->num_elements;
 
-        for (i = 0; i < weight_variable->num_elements; i++)
-        {
-            for (j = 0; j < num_sub_elements; j++)
-            {
-                weight[i * num_sub_elements + j] = weight_variable->data.float_data[i];
-            }
-        }
+    return 1;
+}
+
+/* treat variable as a [num_blocks, dim, num_elements] array, with 'dim' the dimension of the given type */
+static void get_block_layout(const harp_variable *variable, harp_dimension_type dimension_type, long *num_blocks,
+                             long *num_elements)
+{
+    int j = 0;
+
+    *num_blocks = 1;
+    *num_elements = 1;
+    assert(variable->num_dimensions > 0);
+    while (variable->dimension_type[j] != dimension_type)
+    {
+        assert(j < variable->num_dimensions - 1);
+        *num_blocks *= variable->dimension[j];
+        j++;
     }
+    j++;        /* skip dimension that is going to be rebinned */
+    while (j < variable->num_dimensions)
+    {
+        *num_elements *= variable->dimension[j];
+        j++;
+    }
+}
 
-    return 1;
+/* Source intervals that overlap each target interval (together with the overlapping fraction of the source interval).
+ * For each (time) row of the bounds there is a map in compressed sparse row form: the entries for target interval j of
+ * map m are source_index/source_weight[offset[m * (target_length + 1) + j] .. offset[m * (target_length + 1) + j + 1]].
+ * Consecutive rows that have the same source and target bounds share the same map.
+ */
+typedef struct overlap_map_struct
+{
+    long num_rows;
+    long target_length;
+    long *row_map;      /* [num_rows] index of the map that is used for each row */
+    long num_maps;
+    long *offset;       /* [num_maps, target_length + 1] */
+    long num_entries;
+    long max_num_entries;
+    long *source_index; /* [num_entries] */
+    double *source_weight;      /* [num_entries] */
+} overlap_map;
+
+static void overlap_map_delete(overlap_map *map)
+{
+    if (map->row_map != NULL)
+    {
+        free(map->row_map);
+    }
+    if (map->offset != NULL)
+    {
+        free(map->offset);
+    }
+    if (map->source_index != NULL)
+    {
+        free(map->source_index);
+    }
+    if (map->source_weight != NULL)
+    {
+        free(map->source_weight);
+    }
+    free(map);
 }
 
-static int add_source_index(long source_index, double weight, long *cumsum_index, long **map_source_index,
-                            double **map_source_weight)
+static int overlap_map_add_entry(overlap_map *map, long source_index, double weight)
 {
-    if ((*cumsum_index) % BLOCK_SIZE == 0)
+    if (map->num_entries == map->max_num_entries)
     {
-        long *new_map_source_index;
-        double *new_map_source_weight;
+        long max_num_entries = map->max_num_entries == 0 ? BLOCK_SIZE : 2 * map->max_num_entries;
+        long *new_source_index;
+        double *new_source_weight;
 
-        new_map_source_index = realloc(*map_source_index, ((*cumsum_index) + BLOCK_SIZE) * sizeof(long));
-        if (new_map_source_index == NULL)
+        new_source_index = realloc(map->source_index, max_num_entries * sizeof(long));
+        if (new_source_index == NULL)
         {
             harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                           ((*cumsum_index) + BLOCK_SIZE) * sizeof(long), __FILE__, __LINE__);
+                           max_num_entries * sizeof(long), __FILE__, __LINE__);
             return -1;
         }
-        *map_source_index = new_map_source_index;
-        new_map_source_weight = realloc(*map_source_weight, ((*cumsum_index) + BLOCK_SIZE) * sizeof(double));
-        if (new_map_source_weight == NULL)
+        map->source_index = new_source_index;
+        new_source_weight = realloc(map->source_weight, max_num_entries * sizeof(double));
+        if (new_source_weight == NULL)
         {
             harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                           ((*cumsum_index) + BLOCK_SIZE) * sizeof(double), __FILE__, __LINE__);
+                           max_num_entries * sizeof(double), __FILE__, __LINE__);
             return -1;
         }
-        *map_source_weight = new_map_source_weight;
+        map->source_weight = new_source_weight;
+        map->max_num_entries = max_num_entries;
     }
-    (*map_source_index)[(*cumsum_index)] = source_index;
-    (*map_source_weight)[(*cumsum_index)] = weight;
-    (*cumsum_index)++;
+    map->source_index[map->num_entries] = source_index;
+    map->source_weight[map->num_entries] = weight;
+    map->num_entries++;
 
     return 0;
 }
 
-static int find_matching_intervals_for_bounds(harp_variable *target_bounds, harp_variable *source_bounds,
-                                              long **map_source_index, double **map_source_weight, long *map_offset,
-                                              long *map_length)
+/* add a map for a single row of source bounds [source_length, 2] and target bounds [target_length, 2] */
+static int overlap_map_add_map(overlap_map *map, long source_length, const double *source_data,
+                               const double *target_data)
 {
-    double *source_data = source_bounds->data.double_data;
-    double *target_data = target_bounds->data.double_data;
-    long bounds_num_time_elements = 1;
-    long source_num_dim_elements;
-    long target_num_dim_elements;
-    long cumsum_index = 0;
-    long i, j, k;
+    long *offset = &map->offset[map->num_maps * (map->target_length + 1)];
+    long j, k;
 
-    if (target_bounds->num_dimensions == 3)
-    {
-        bounds_num_time_elements = target_bounds->dimension[0];
-    }
-    else if (source_bounds->num_dimensions == 3)
+    for (j = 0; j < map->target_length; j++)
     {
-        bounds_num_time_elements = source_bounds->dimension[0];
-    }
-    source_num_dim_elements = source_bounds->dimension[source_bounds->num_dimensions - 2];
-    target_num_dim_elements = target_bounds->dimension[target_bounds->num_dimensions - 2];
+        double xminb, xmaxb;
 
-    for (i = 0; i < bounds_num_time_elements; i++)
-    {
-        long source_bounds_offset = 0;
-        long target_bounds_offset = 0;
+        offset[j] = map->num_entries;
 
-        if (source_bounds->num_dimensions == 3)
+        if (target_data[2 * j] < target_data[2 * j + 1])
         {
-            source_bounds_offset = i * source_num_dim_elements;
+            xminb = target_data[2 * j];
+            xmaxb = target_data[2 * j + 1];
         }
-        if (target_bounds->num_dimensions == 3)
+        else
         {
-            target_bounds_offset = i * target_num_dim_elements;
+            xminb = target_data[2 * j + 1];
+            xmaxb = target_data[2 * j];
         }
 
-        for (j = 0; j < target_num_dim_elements; j++)
+        for (k = 0; k < source_length; k++)
         {
-            long target_bounds_index = target_bounds_offset + 2 * j;
-            long map_index = i * target_num_dim_elements + j;
-            double xminb, xmaxb;
+            double xmina, xmaxa;
 
-            map_length[map_index] = 0;
-
-            if (target_data[target_bounds_index] < target_data[target_bounds_index + 1])
+            if (source_data[2 * k] < source_data[2 * k + 1])
             {
-                xminb = target_data[target_bounds_index];
-                xmaxb = target_data[target_bounds_index + 1];
+                xmina = source_data[2 * k];
+                xmaxa = source_data[2 * k + 1];
             }
             else
             {
-                xminb = target_data[target_bounds_index + 1];
-                xmaxb = target_data[target_bounds_index];
+                xmina = source_data[2 * k + 1];
+                xmaxa = source_data[2 * k];
+            }
+
+            if (!(xmina >= xmaxb || xminb >= xmaxa))
+            {
+                double xminc, xmaxc;
+
+                /* there is overlap and interval A is not empty */
+
+                /* calculate intersection interval C of intervals A and B */
+                xminc = xmina < xminb ? xminb : xmina;
+                xmaxc = xmaxa > xmaxb ? xmaxb : xmaxa;
+
+                if (overlap_map_add_entry(map, k, (xmaxc - xminc) / (xmaxa - xmina)) != 0)
+                {
+                    return -1;
+                }
             }
+        }
+    }
+    offset[map->target_length] = map->num_entries;
+    map->num_maps++;
+
+    return 0;
+}
+
+/* determine which source intervals match each target interval (and associated weight) for each of the 'num_rows'
+ * (time) rows of the bounds; 2D bounds are used for all rows.
+ */
+static int overlap_map_new(const harp_variable *target_bounds, const harp_variable *source_bounds, long num_rows,
+                           overlap_map **new_map)
+{
+    const double *source_data = source_bounds->data.double_data;
+    const double *target_data = target_bounds->data.double_data;
+    long source_length = source_bounds->dimension[source_bounds->num_dimensions - 2];
+    long target_length = target_bounds->dimension[target_bounds->num_dimensions - 2];
+    long source_row_size = source_bounds->num_dimensions == 3 ? 2 * source_length : 0;
+    long target_row_size = target_bounds->num_dimensions == 3 ? 2 * target_length : 0;
+    overlap_map *map;
+    long i;
+
+    map = (overlap_map *)malloc(sizeof(overlap_map));
+    if (map == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(overlap_map), __FILE__, __LINE__);
+        return -1;
+    }
+    map->num_rows = num_rows;
+    map->target_length = target_length;
+    map->row_map = NULL;
+    map->num_maps = 0;
+    map->offset = NULL;
+    map->num_entries = 0;
+    map->max_num_entries = 0;
+    map->source_index = NULL;
+    map->source_weight = NULL;
 
-            for (k = 0; k < source_num_dim_elements; k++)
+    if (num_rows > 0)
+    {
+        map->row_map = (long *)malloc(num_rows * (size_t)sizeof(long));
+        if (map->row_map == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_rows * sizeof(long), __FILE__, __LINE__);
+            overlap_map_delete(map);
+            return -1;
+        }
+        map->offset = (long *)malloc(num_rows * (target_length + 1) * (size_t)sizeof(long));
+        if (map->offset == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_rows * (target_length + 1) * sizeof(long), __FILE__, __LINE__);
+            overlap_map_delete(map);
+            return -1;
+        }
+    }
+
+    for (i = 0; i < num_rows; i++)
+    {
+        const double *source_row = &source_data[i * source_row_size];
+        const double *target_row = &target_data[i * target_row_size];
+
+        if (i > 0 && memcmp(source_row, source_row - source_row_size, source_row_size * sizeof(double)) == 0 &&
+            memcmp(target_row, target_row - target_row_size, target_row_size * sizeof(double)) == 0)
+        {
+            /* same bounds as the previous row */
+            map->row_map[i] = map->row_map[i - 1];
+            continue;
+        }
+        map->row_map[i] = map->num_maps;
+        if (overlap_map_add_map(map, source_length, source_row, target_row) != 0)
+        {
+            overlap_map_delete(map);
+            return -1;
+        }
+    }
+
+    *new_map = map;
+
+    return 0;
+}
+
+/* rebin block 'block' of a variable with layout [num_blocks, source_length, num_elements] using map 'map_index'.
+ * the result is stored in the first target_length elements of the rebinned dimension.
+ * 'valuesum' and 'weightsum' should each have room for target_length * num_elements values.
+ */
+static void rebin_block(harp_variable *variable, binning_type bintype, const harp_variable *weight_variable,
+                        long weight_factor, const overlap_map *map, long map_index, long source_length,
+                        long num_elements, long block, double *valuesum, double *weightsum)
+{
+    const long *offset = &map->offset[map_index * (map->target_length + 1)];
+    long block_offset = block * source_length * num_elements;
+    double nan_value = harp_nan();
+    long j, l, m;
+
+    for (j = 0; j < map->target_length; j++)
+    {
+        double *target_valuesum = &valuesum[j * num_elements];
+        double *target_weightsum = &weightsum[j * num_elements];
+
+        for (l = 0; l < num_elements; l++)
+        {
+            target_valuesum[l] = 0;
+            target_weightsum[l] = 0;
+        }
+        for (m = offset[j]; m < offset[j + 1]; m++)
+        {
+            long index = block_offset + map->source_index[m] * num_elements;
+            double map_weight = map->source_weight[m];
+
+            for (l = 0; l < num_elements; l++)
             {
-                long source_bounds_index = source_bounds_offset + 2 * k;
-                double xmina, xmaxa;
+                double w = map_weight;
+                double value;
 
-                if (source_data[source_bounds_index] < source_data[source_bounds_index + 1])
+                if (variable->data_type == harp_type_float)
                 {
-                    xmina = source_data[source_bounds_index];
-                    xmaxa = source_data[source_bounds_index + 1];
+                    value = variable->data.float_data[index + l];
                 }
                 else
                 {
-                    xmina = source_data[source_bounds_index + 1];
-                    xmaxa = source_data[source_bounds_index];
+                    value = variable->data.double_data[index + l];
+                }
+                if (weight_variable != NULL)
+                {
+                    w = weight_variable->data.float_data[(index + l) / weight_factor] * map_weight;
                 }
 
-                if (!(xmina >= xmaxb || xminb >= xmaxa))
+                if (!harp_isnan(value))
                 {
-                    double xminc, xmaxc, weight;
+                    target_valuesum[l] += w * value;
+                    target_weightsum[l] += w;
+                }
+            }
+        }
+    }
 
-                    /* there is overlap and interval A is not empty */
+    for (j = 0; j < map->target_length * num_elements; j++)
+    {
+        double value;
 
-                    /* calculate intersection interval C of intervals A and B */
-                    xminc = xmina < xminb ? xminb : xmina;
-                    xmaxc = xmaxa > xmaxb ? xmaxb : xmaxa;
+        if (weightsum[j] != 0)
+        {
+            value = valuesum[j];
+            if (bintype == binning_average || bintype == binning_angle || bintype == binning_weight)
+            {
+                value /= weightsum[j];
+            }
+        }
+        else
+        {
+            value = bintype == binning_weight ? 0 : nan_value;
+        }
+        if (variable->data_type == harp_type_float)
+        {
+            variable->data.float_data[block_offset + j] = (float)value;
+        }
+        else
+        {
+            variable->data.double_data[block_offset + j] = value;
+        }
+    }
+}
 
-                    weight = (xmaxc - xminc) / (xmaxa - xmina);
+/* rebin time samples [sample_offset, sample_offset + num_samples) of all variables that need rebinning.
+ * variables without a time dimension (or when rebinning the time dimension itself) are handled as part of sample 0.
+ * weight variables are rebinned last, since they are used for the rebinning of the other variables.
+ */
+static int rebin_samples(harp_product *product, harp_dimension_type dimension_type, const binning_type *bintype,
+                         harp_variable **weight_variable, const long *weight_factor, const overlap_map *map,
+                         long source_length, long total_num_samples, long sample_offset, long num_samples,
+                         long buffer_size)
+{
+    double *valuesum;
+    double *weightsum;
+    int weight_pass;
+    long t;
+    int k;
 
-                    if (map_length[map_index] == 0)
-                    {
-                        map_offset[map_index] = cumsum_index;
-                    }
-                    if (add_source_index(k, weight, &cumsum_index, map_source_index, map_source_weight) != 0)
+    valuesum = (double *)malloc(2 * buffer_size * (size_t)sizeof(double));
+    if (valuesum == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       2 * buffer_size * sizeof(double), __FILE__, __LINE__);
+        return -1;
+    }
+    weightsum = &valuesum[buffer_size];
+
+    for (t = sample_offset; t < sample_offset + num_samples; t++)
+    {
+        for (weight_pass = 0; weight_pass <= 1; weight_pass++)
+        {
+            for (k = 0; k < product->num_variables; k++)
+            {
+                harp_variable *variable = product->variable[k];
+                long first_block, last_block;
+                long num_blocks;
+                long num_elements;
+                long map_index;
+                long i;
+
+                if (bintype[k] == binning_skip || bintype[k] == binning_remove ||
+                    (bintype[k] == binning_weight) != weight_pass)
+                {
+                    continue;
+                }
+
+                get_block_layout(variable, dimension_type, &num_blocks, &num_elements);
+                if (dimension_type != harp_dimension_time && variable->dimension_type[0] == harp_dimension_time)
+                {
+                    first_block = t * (num_blocks / total_num_samples);
+                    last_block = first_block + num_blocks / total_num_samples;
+                    map_index = map->num_rows > 1 ? t : 0;
+                }
+                else
+                {
+                    if (t > 0)
                     {
-                        return -1;
+                        continue;
                     }
-                    map_length[map_index]++;
+                    first_block = 0;
+                    last_block = num_blocks;
+                    map_index = 0;
+                }
+                if (first_block == last_block)
+                {
+                    continue;
+                }
+                map_index = map->row_map[map_index];
+
+                for (i = first_block; i < last_block; i++)
+                {
+                    rebin_block(variable, bintype[k], weight_variable[k], weight_factor[k], map, map_index,
+                                source_length, num_elements, i, valuesum, weightsum);
                 }
             }
         }
     }
 
+    free(valuesum);
+
     return 0;
 }
 
@@ -521,7 +775,8 @@ static int find_matching_intervals_for_bounds(harp_variable *target_bounds, harp
  * Variables that depend on the rebinned dimenion but have no unit (or use a string data type) will be removed.
  * Any existing count variables that depend on the given dimension will also be removed.
  *
- * All variables that are rebinned (except existing weight variables) are converted to a double data type.
+ * All variables that are rebinned (except existing weight variables) are converted to a double data type, unless they
+ * have a float data type and harp_set_option_keep_float() is enabled (angle variables are always converted).
  * Bins that have no overlapping source boundaries will end up with a NaN value.
  *
  * \param product Product to rebin.
@@ -541,19 +796,26 @@ LIBHARP_API int harp_product_rebin_with_axis_bounds_variable(harp_product *produ
     harp_variable *variable;
     long variable_name_length = (long)strlen(target_bounds->name);
     long weight_size = 0;
-    long i, j, k, l;
+    long buffer_size = 1;
+    long num_samples = 1;
+    int num_slices;
+    int failed = 0;
+    long i, k;
 
     /* owned memory */
     harp_variable *source_bounds = NULL;
     harp_variable *local_target_bounds = NULL;
     binning_type *bintype = NULL;
-    long *map_source_index = NULL;      /* [num_map_elements] flat index into [dim] source array */
-    double *map_source_weight = NULL;   /* [num_map_elements] weight for each [dim] source array */
-    long *map_offset = NULL;    /* [(time,) dim] offset index into map_source_index/map_weight for target array */
-    long *map_length = NULL;    /* [(time,) dim] number of elements in map_source_index/map_weight for target array */
-    double *buffer = NULL;
+    overlap_map *map = NULL;
+    harp_variable **weight_variable = NULL;     /* [num_variables] weight variable to use for each variable */
+    long *weight_factor = NULL; /* [num_variables] number of variable elements per weight variable element */
     float *weight = NULL;
 
+    if (harp_product_load(product) != 0 || harp_variable_load(target_bounds) != 0)
+    {
+        return -1;
+    }
+
     if (variable_name_length < 7 || strcmp(&target_bounds->name[variable_name_length - 7], "_bounds") != 0)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "axis variable is not a boundaries variable");
@@ -697,32 +959,8 @@ LIBHARP_API int harp_product_rebin_with_axis_bounds_variable(harp_product *produ
         }
     }
 
-    /* allocate memory for map_offset, map_length, and buffer */
-    map_offset = (long *)malloc(bounds_num_time_elements * target_num_dim_elements * (size_t)sizeof(long));
-    if (map_offset == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       bounds_num_time_elements * target_num_dim_elements * sizeof(long), __FILE__, __LINE__);
-        goto error;
-    }
-    map_length = (long *)malloc(bounds_num_time_elements * target_num_dim_elements * (size_t)sizeof(long));
-    if (map_length == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       bounds_num_time_elements * target_num_dim_elements * sizeof(long), __FILE__, __LINE__);
-        goto error;
-    }
-    buffer = (double *)malloc(target_num_dim_elements * (size_t)sizeof(double));
-    if (buffer == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       target_num_dim_elements * sizeof(double), __FILE__, __LINE__);
-        goto error;
-    }
-
     /* determine which source intervals match each target interval (and associated weight) */
-    if (find_matching_intervals_for_bounds(local_target_bounds, source_bounds, &map_source_index, &map_source_weight,
-                                           map_offset, map_length) != 0)
+    if (overlap_map_new(local_target_bounds, source_bounds, bounds_num_time_elements, &map) != 0)
     {
         goto error;
     }
@@ -767,8 +1005,9 @@ LIBHARP_API int harp_product_rebin_with_axis_bounds_variable(harp_product *produ
 
         variable = product->variable[k];
 
-        /* convert variables to double */
-        if (bintype[k] != binning_weight)
+        /* convert variables to double (except for float variables if those should be kept as float) */
+        if (bintype[k] != binning_weight &&
+            (variable->data_type != harp_type_float || !harp_get_option_keep_float() || bintype[k] == binning_angle))
         {
             if (harp_variable_convert_data_type(variable, harp_type_double) != 0)
             {
@@ -851,196 +1090,76 @@ LIBHARP_API int harp_product_rebin_with_axis_bounds_variable(harp_product *produ
         }
     }
 
-    /* regrid each variable */
+    /* determine the weight variable (if any) that applies to each variable and the size of the rebin buffers */
+    weight_variable = (harp_variable **)malloc(product->num_variables * sizeof(harp_variable *));
+    if (weight_variable == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       product->num_variables * sizeof(harp_variable *), __FILE__, __LINE__);
+        goto error;
+    }
+    weight_factor = (long *)malloc(product->num_variables * sizeof(long));
+    if (weight_factor == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       product->num_variables * sizeof(long), __FILE__, __LINE__);
+        goto error;
+    }
     for (k = 0; k < product->num_variables; k++)
     {
-        long target_bounds_time_index;
         long num_blocks;
         long num_elements;
-        int result = 0;
 
-        variable = product->variable[k];
+        weight_variable[k] = NULL;
+        weight_factor[k] = 1;
 
-        if (bintype[k] == binning_skip || bintype[k] == binning_remove || bintype[k] == binning_weight)
+        if (bintype[k] == binning_skip || bintype[k] == binning_remove)
         {
             continue;
         }
 
-        if (bintype[k] != binning_angle)
+        if (bintype[k] != binning_angle && bintype[k] != binning_weight)
         {
-            result = get_weight_for_variable(product, variable, bintype, weight);
-            if (result < 0)
+            if (get_weight_for_variable(product, product->variable[k], bintype, &weight_variable[k],
+                                        &weight_factor[k]) < 0)
             {
                 goto error;
             }
         }
-        if (result == 0)
-        {
-            /* if there is no pre-existing weight variable then set all weights to 1 */
-            for (i = 0; i < variable->num_elements; i++)
-            {
-                weight[i] = 1;
-            }
-        }
 
-        /* treat variable as a [num_blocks, source_max_dim_elements, num_elements] array with indices [i,j,l] */
-        num_blocks = 1;
-        num_elements = 1;
-        i = 0;
-        assert(variable->num_dimensions > 0);
-        while (variable->dimension_type[i] != dimension_type)
+        get_block_layout(product->variable[k], dimension_type, &num_blocks, &num_elements);
+        if (target_num_dim_elements * num_elements > buffer_size)
         {
-            assert(i < variable->num_dimensions - 1);
-            num_blocks *= variable->dimension[i];
-            i++;
+            buffer_size = target_num_dim_elements * num_elements;
         }
-        i++;    /* skip dimension that is going to be regridded */
-        while (i < variable->num_dimensions)
-        {
-            num_elements *= variable->dimension[i];
-            i++;
-        }
-
-        /* rebin the data of the variable over the given dimension */
-        /* keep track of time index separately since num_blocks can capture more than just the time dimension */
-        target_bounds_time_index = 0;
-        for (i = 0; i < num_blocks; i++)
-        {
-            /* keep track of time index for 2D grids */
-            if (i % (num_blocks / bounds_num_time_elements) == 0)
-            {
-                if (target_bounds->num_dimensions == 3 && i > 0)
-                {
-                    target_bounds_time_index++;
-                }
-            }
-
-            for (l = 0; l < num_elements; l++)
-            {
-                for (j = 0; j < target_num_dim_elements; j++)
-                {
-                    long offset = map_offset[target_bounds_time_index * target_num_dim_elements + j];
-                    double weightsum = 0;
-                    double valuesum = 0;
-                    long m;
-
-                    for (m = 0; m < map_length[target_bounds_time_index * target_num_dim_elements + j]; m++)
-                    {
-                        long source_index = i * source_num_dim_elements + map_source_index[offset + m];
-                        double w = weight[source_index * num_elements + l] * map_source_weight[offset + m];
-                        double value = variable->data.double_data[source_index * num_elements + l];
-
-                        if (!harp_isnan(value))
-                        {
-                            valuesum += w * value;
-                            weightsum += w;
-                        }
-                    }
+    }
 
-                    if (weightsum != 0)
-                    {
-                        buffer[j] = valuesum;
-                        if (bintype[k] == binning_average || bintype[k] == binning_angle)
-                        {
-                            buffer[j] /= weightsum;
-                        }
-                    }
-                    else
-                    {
-                        buffer[j] = nan_value;
-                    }
-                }
-                for (j = 0; j < target_num_dim_elements; j++)
-                {
-                    variable->data.double_data[(i * source_num_dim_elements + j) * num_elements + l] = buffer[j];
-                }
-            }
-        }
+    /* rebin all variables, processing time samples in parallel (each sample only touches its own part of the data) */
+    if (dimension_type != harp_dimension_time && product->dimension[harp_dimension_time] > 0)
+    {
+        num_samples = product->dimension[harp_dimension_time];
     }
-    /* do the same, but now only for the weight variables */
-    for (k = 0; k < product->num_variables; k++)
+    num_slices = harp_get_num_threads();
+    if (num_slices > num_samples)
     {
-        long target_bounds_time_index;
-        long num_blocks;
-        long num_elements;
-
-        variable = product->variable[k];
-
-        if (bintype[k] != binning_weight)
-        {
-            continue;
-        }
-
-        /* treat variable as a [num_blocks, source_max_dim_elements, num_elements] array with indices [i,j,l] */
-        num_blocks = 1;
-        num_elements = 1;
-        i = 0;
-        assert(variable->num_dimensions > 0);
-        while (variable->dimension_type[i] != dimension_type)
-        {
-            assert(i < variable->num_dimensions - 1);
-            num_blocks *= variable->dimension[i];
-            i++;
-        }
-        i++;    /* skip dimension that is going to be regridded */
-        while (i < variable->num_dimensions)
-        {
-            num_elements *= variable->dimension[i];
-            i++;
-        }
+        num_slices = (int)num_samples;
+    }
+#pragma omp parallel for reduction(|:failed) schedule(static) num_threads(num_slices)
+    for (i = 0; i < num_slices; i++)
+    {
+        long offset = num_samples * i / num_slices;
+        long length = num_samples * (i + 1) / num_slices - offset;
 
-        /* rebin the data of the variable over the given dimension */
-        /* keep track of time index separately since num_blocks can capture more than just the time dimension */
-        target_bounds_time_index = 0;
-        for (i = 0; i < num_blocks; i++)
+        if (rebin_samples(product, dimension_type, bintype, weight_variable, weight_factor, map,
+                          source_num_dim_elements, num_samples, offset, length, buffer_size) != 0)
         {
-            /* keep track of time index for 2D grids */
-            if (i % (num_blocks / bounds_num_time_elements) == 0)
-            {
-                if (target_bounds->num_dimensions == 3 && i > 0)
-                {
-                    target_bounds_time_index++;
-                }
-            }
-
-            for (l = 0; l < num_elements; l++)
-            {
-                for (j = 0; j < target_num_dim_elements; j++)
-                {
-                    long offset = map_offset[target_bounds_time_index * target_num_dim_elements + j];
-                    double weightsum = 0;
-                    double valuesum = 0;
-                    long m;
-
-                    for (m = 0; m < map_length[target_bounds_time_index * target_num_dim_elements + j]; m++)
-                    {
-                        long source_index = i * source_num_dim_elements + map_source_index[offset + m];
-                        double w = map_source_weight[offset + m];
-                        double value = variable->data.float_data[source_index * num_elements + l];
-
-                        if (!harp_isnan(value))
-                        {
-                            valuesum += w * value;
-                            weightsum += w;
-                        }
-                    }
-
-                    if (weightsum != 0)
-                    {
-                        buffer[j] = valuesum / weightsum;
-                    }
-                    else
-                    {
-                        buffer[j] = 0;
-                    }
-                }
-                for (j = 0; j < target_num_dim_elements; j++)
-                {
-                    variable->data.float_data[(i * source_num_dim_elements + j) * num_elements + l] = buffer[j];
-                }
-            }
+            failed |= 1;
         }
     }
+    if (failed)
+    {
+        goto error;
+    }
 
     /* Resize the dimension in the target product to minimal size */
     if (target_num_dim_elements < source_num_dim_elements)
@@ -1129,12 +1248,10 @@ LIBHARP_API int harp_product_rebin_with_axis_bounds_variable(harp_product *produ
     /* cleanup */
     harp_variable_delete(source_bounds);
     harp_variable_delete(local_target_bounds);
-    free(map_source_index);
-    free(map_source_weight);
-    free(map_offset);
-    free(map_length);
+    overlap_map_delete(map);
+    free(weight_variable);
+    free(weight_factor);
     free(bintype);
-    free(buffer);
     free(weight);
 
     return 0;
@@ -1142,30 +1259,22 @@ LIBHARP_API int harp_product_rebin_with_axis_bounds_variable(harp_product *produ
   error:
     harp_variable_delete(source_bounds);
     harp_variable_delete(local_target_bounds);
-    if (map_source_index != NULL)
+    if (map != NULL)
     {
-        free(map_source_index);
+        overlap_map_delete(map);
     }
-    if (map_source_weight != NULL)
+    if (weight_variable != NULL)
     {
-        free(map_source_weight);
+        free(weight_variable);
     }
-    if (map_offset != NULL)
+    if (weight_factor != NULL)
     {
-        free(map_offset);
-    }
-    if (map_length != NULL)
-    {
-        free(map_length);
+        free(weight_factor);
     }
     if (bintype != NULL)
     {
         free(bintype);
     }
-    if (buffer != NULL)
-    {
-        free(buffer);
-    }
     if (weight != NULL)
     {
         free(weight);
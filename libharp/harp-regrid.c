@@ -172,6 +172,54 @@ static int needs_interval_resample(harp_product *product, harp_dimension_type di
     return 0;
 }
 
+/* Determine the layout of a variable as a [num_blocks, max_dim_elements, num_elements] array, where the middle
+ * dimension is the dimension that is regridded.
+ */
+static void get_block_layout(const harp_variable *variable, harp_dimension_type dimension_type, long *num_blocks,
+                             long *num_elements)
+{
+    int j = 0;
+
+    *num_blocks = 1;
+    *num_elements = 1;
+    assert(variable->num_dimensions > 0);
+    while (variable->dimension_type[j] != dimension_type)
+    {
+        assert(j < variable->num_dimensions - 1);
+        *num_blocks *= variable->dimension[j];
+        j++;
+    }
+    j++;        /* skip dimension that is going to be regridded */
+    while (j < variable->num_dimensions)
+    {
+        *num_elements *= variable->dimension[j];
+        j++;
+    }
+}
+
+static int get_interpolation_weights(resample_type type, long source_length, const double *source_grid,
+                                     const double *source_bounds, long target_length, const double *target_grid,
+                                     const double *target_bounds, int out_of_bound_flag,
+                                     harp_interpolation_weights **weights)
+{
+    switch (type)
+    {
+        case resample_linear:
+            return harp_interpolation_weights_new_linear(source_length, source_grid, target_length, target_grid,
+                                                         out_of_bound_flag, weights);
+        case resample_loglog:
+            return harp_interpolation_weights_new_logloglinear(source_length, source_grid, target_length,
+                                                               target_grid, out_of_bound_flag, weights);
+        case resample_interval:
+            return harp_interpolation_weights_new_interval(source_length, source_bounds, target_length,
+                                                           target_bounds, weights);
+        default:
+            /* other resampling methods are not supported, but should also never be set */
+            assert(0);
+            exit(1);
+    }
+}
+
 static int resize_dimension(harp_product *product, harp_dimension_type dimension_type, long num_elements)
 {
     int i;
@@ -854,6 +902,9 @@ static int regrid_with_multi_dim_source_axis(harp_product *product, harp_variabl
  * The source grid (and bounds) are determined by performing a variable derivation on the product (using the variable
  * name of the target_grid variable).
  *
+ * All variables that are resampled are converted to a double data type, unless they have a float data type and
+ * harp_set_option_keep_float() is enabled.
+ *
  * \param product Product to resample.
  * \param target_grid Target grid variable.
  * \param target_bounds Target grid boundaries variable (optional).
@@ -874,18 +925,30 @@ LIBHARP_API int harp_product_regrid_with_axis_variable(harp_product *product, ha
     long grid_num_time_elements = 1;
     int source_grid_num_dims = 1;
     int target_grid_num_dims;
+    long max_num_elements = 1;
     int out_of_bound_flag;
     harp_variable *variable;
-    long i;
+    long i, k, t;
 
     /* owned memory */
     harp_variable *source_grid = NULL;
     harp_variable *source_bounds = NULL;
     harp_variable *local_target_grid = NULL;
     harp_variable *local_target_bounds = NULL;
+    harp_interpolation_weights *weights[resample_interval + 1] = { NULL, NULL, NULL, NULL, NULL };
+    resample_type *variable_type = NULL;
     double *source_buffer = NULL;
     double *target_buffer = NULL;
 
+    if (harp_product_load(product) != 0 || harp_variable_load(target_grid) != 0)
+    {
+        return -1;
+    }
+    if (target_bounds != NULL && harp_variable_load(target_bounds) != 0)
+    {
+        return -1;
+    }
+
     out_of_bound_flag = harp_get_option_regrid_out_of_bounds();
 
     if (target_grid->data_type != harp_type_double)
@@ -1089,47 +1152,41 @@ LIBHARP_API int harp_product_regrid_with_axis_variable(harp_product *product, ha
         }
     }
 
-    /* allocate the buffers for the interpolation */
-    source_buffer = (double *)malloc(source_grid_max_dim_elements * (size_t)sizeof(double));
-    if (source_buffer == NULL)
+    /* determine the resample type of each variable and make the variables ready for regridding */
+    if (product->num_variables > 0)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       source_grid_max_dim_elements * sizeof(double), __FILE__, __LINE__);
-        goto error;
-    }
-    target_buffer = (double *)malloc(target_grid_max_dim_elements * (size_t)sizeof(double));
-    if (target_buffer == NULL)
-    {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       target_grid_max_dim_elements * sizeof(double), __FILE__, __LINE__);
-        goto error;
+        variable_type = (resample_type *)malloc(product->num_variables * sizeof(resample_type));
+        if (variable_type == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           product->num_variables * sizeof(resample_type), __FILE__, __LINE__);
+            goto error;
+        }
     }
-
-    /* regrid each variable */
     for (i = 0; i < product->num_variables; i++)
     {
-        resample_type type;
-        long source_time_index;
-        long target_time_index;
-        long num_blocks;
         long num_elements;
         long j;
 
         variable = product->variable[i];
 
         /* Check if we can resample this kind of variable */
-        type = get_resample_type(variable, dimension_type);
+        variable_type[i] = get_resample_type(variable, dimension_type);
 
-        assert(type != resample_remove);
-        if (type == resample_skip)
+        assert(variable_type[i] != resample_remove);
+        if (variable_type[i] == resample_skip)
         {
             continue;
         }
 
-        /* Ensure that the variable data consists of doubles */
-        if (variable->data_type != harp_type_double && harp_variable_convert_data_type(variable, harp_type_double) != 0)
+        /* Ensure that the variable data consists of doubles (or floats, if those should be kept) */
+        if (variable->data_type != harp_type_double &&
+            (variable->data_type != harp_type_float || !harp_get_option_keep_float()))
         {
-            goto error;
+            if (harp_variable_convert_data_type(variable, harp_type_double) != 0)
+            {
+                goto error;
+            }
         }
 
         /* Make time independent variables time dependent if source grid or target grid is 2D (i.e. time dependent) */
@@ -1144,110 +1201,166 @@ LIBHARP_API int harp_product_regrid_with_axis_variable(harp_product *product, ha
             }
         }
 
-        /* treat variable as a [num_blocks, max_dim_elements, num_elements] array with indices [j,k,l] */
-        num_blocks = 1;
-        num_elements = 1;
-        j = 0;
-        assert(variable->num_dimensions > 0);
-        while (variable->dimension_type[j] != dimension_type)
+        get_block_layout(variable, dimension_type, &j, &num_elements);
+        if (num_elements > max_num_elements)
         {
-            assert(j < variable->num_dimensions - 1);
-            num_blocks *= variable->dimension[j];
-            j++;
+            max_num_elements = num_elements;
         }
-        j++;    /* skip dimension that is going to be regridded */
-        while (j < variable->num_dimensions)
+    }
+
+    /* allocate the buffers for the interpolation */
+    source_buffer = (double *)malloc(source_grid_max_dim_elements * max_num_elements * (size_t)sizeof(double));
+    if (source_buffer == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       source_grid_max_dim_elements * max_num_elements * sizeof(double), __FILE__, __LINE__);
+        goto error;
+    }
+    target_buffer = (double *)malloc(target_grid_max_dim_elements * max_num_elements * (size_t)sizeof(double));
+    if (target_buffer == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       target_grid_max_dim_elements * max_num_elements * sizeof(double), __FILE__, __LINE__);
+        goto error;
+    }
+
+    /* regrid the variables one time element at a time (there is only one iteration if both grids are time
+     * independent). The interpolation weights for a source/target grid combination are only determined once and are
+     * then used for all variables. They are also kept for the next time element if its grids are the same.
+     */
+    source_grid_num_dim_elements = 0;
+    target_grid_num_dim_elements = 0;
+    for (t = 0; t < grid_num_time_elements; t++)
+    {
+        long source_time_index = (source_grid_num_dims == 2) ? t : 0;
+        long target_time_index = (target_grid_num_dims == 2) ? t : 0;
+        const double *source_grid_data = &source_grid->data.double_data[source_time_index *
+                                                                          source_grid_max_dim_elements];
+        const double *target_grid_data = &local_target_grid->data.double_data[target_time_index *
+                                                                                target_grid_max_dim_elements];
+        const double *source_bounds_data = NULL;
+        const double *target_bounds_data = NULL;
+        int same_grid = (t > 0);
+
+        if (source_bounds != NULL)
         {
-            num_elements *= variable->dimension[j];
-            j++;
+            source_bounds_data = &source_bounds->data.double_data[source_time_index * source_grid_max_dim_elements * 2];
+        }
+        if (local_target_bounds != NULL)
+        {
+            target_bounds_data =
+                &local_target_bounds->data.double_data[target_time_index * target_grid_max_dim_elements * 2];
         }
 
-        /* interpolate the data of the variable over the given dimension */
-        /* keep track of time index separately since num_blocks can capture more than just the time dimension */
-        source_time_index = 0;
-        target_time_index = 0;
-        source_grid_num_dim_elements = get_unpadded_length(source_grid->data.double_data, source_grid_max_dim_elements);
-        target_grid_num_dim_elements = get_unpadded_length(target_grid->data.double_data, target_grid_max_dim_elements);
-        for (j = 0; j < num_blocks; j++)
+        if (t == 0 || source_grid_num_dims == 2)
         {
-            long k, l;
+            long num_dim_elements = get_unpadded_length(&source_grid->data.double_data[source_time_index *
+                                                                                       source_grid_max_dim_elements],
+                                                        source_grid_max_dim_elements);
 
-            /* keep track of time index for 2D grids */
-            if (j % (num_blocks / grid_num_time_elements) == 0)
+            if (same_grid)
             {
-                if (source_grid_num_dims == 2 && j > 0)
-                {
-                    source_time_index++;
-                    source_grid_num_dim_elements =
-                        get_unpadded_length(&source_grid->data.double_data[source_time_index *
-                                                                           source_grid_max_dim_elements],
-                                            source_grid_max_dim_elements);
-                }
-                if (target_grid_num_dims == 2 && j > 0)
-                {
-                    target_time_index++;
-                    target_grid_num_dim_elements =
-                        get_unpadded_length(&target_grid->data.double_data[target_time_index *
-                                                                           target_grid_max_dim_elements],
-                                            target_grid_max_dim_elements);
-                }
+                same_grid = (num_dim_elements == source_grid_num_dim_elements &&
+                             memcmp(source_grid_data, source_grid_data - source_grid_max_dim_elements,
+                                    num_dim_elements * sizeof(double)) == 0 &&
+                             (source_bounds_data == NULL ||
+                              memcmp(source_bounds_data, source_bounds_data - 2 * source_grid_max_dim_elements,
+                                     2 * num_dim_elements * sizeof(double)) == 0));
             }
+            source_grid_num_dim_elements = num_dim_elements;
+        }
+        if (t == 0 || target_grid_num_dims == 2)
+        {
+            long num_dim_elements = get_unpadded_length(&target_grid->data.double_data[target_time_index *
+                                                                                       target_grid_max_dim_elements],
+                                                        target_grid_max_dim_elements);
 
-            if (source_grid_num_dim_elements <= 1 && target_grid_num_dim_elements > 0)
+            if (same_grid)
             {
-                harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
-                               "dimension length for %s needs to be > 1 to allow regridding", target_grid->name);
-                goto error;
+                same_grid = (num_dim_elements == target_grid_num_dim_elements &&
+                             memcmp(target_grid_data, target_grid_data - target_grid_max_dim_elements,
+                                    num_dim_elements * sizeof(double)) == 0 &&
+                             (target_bounds_data == NULL ||
+                              memcmp(target_bounds_data, target_bounds_data - 2 * target_grid_max_dim_elements,
+                                     2 * num_dim_elements * sizeof(double)) == 0));
             }
+            target_grid_num_dim_elements = num_dim_elements;
+        }
+        if (!same_grid)
+        {
+            for (k = 0; k <= resample_interval; k++)
+            {
+                harp_interpolation_weights_delete(weights[k]);
+                weights[k] = NULL;
+            }
+        }
 
-            for (l = 0; l < num_elements; l++)
+        for (i = 0; i < product->num_variables; i++)
+        {
+            resample_type type = variable_type[i];
+            long num_blocks_per_time;
+            long num_elements;
+            long j;
+
+            if (type == resample_skip)
             {
-                /* we need to regrid by taking a slice for each sub element 'l' */
-                for (k = 0; k < source_grid_num_dim_elements; k++)
-                {
-                    source_buffer[k] = variable->data.double_data[(j * max_dim_elements + k) * num_elements + l];
-                }
-                if (type == resample_linear)
-                {
-                    harp_interpolate_array_linear
-                        (source_grid_num_dim_elements,
-                         &source_grid->data.double_data[source_time_index * source_grid_max_dim_elements],
-                         source_buffer, target_grid_num_dim_elements,
-                         &local_target_grid->data.double_data[target_time_index * target_grid_max_dim_elements],
-                         out_of_bound_flag, target_buffer);
-                }
-                else if (type == resample_loglog)
-                {
-                    harp_interpolate_array_logloglinear
-                        (source_grid_num_dim_elements,
-                         &source_grid->data.double_data[source_time_index * source_grid_max_dim_elements],
-                         source_buffer, target_grid_num_dim_elements,
-                         &local_target_grid->data.double_data[target_time_index * target_grid_max_dim_elements],
-                         out_of_bound_flag, target_buffer);
-                }
-                else if (type == resample_interval)
+                continue;
+            }
+            variable = product->variable[i];
+
+            if (weights[type] == NULL)
+            {
+                if (source_grid_num_dim_elements <= 1 && target_grid_num_dim_elements > 0)
                 {
-                    harp_interval_interpolate_array_linear
-                        (source_grid_num_dim_elements,
-                         &source_bounds->data.double_data[source_time_index * source_grid_max_dim_elements * 2],
-                         source_buffer, target_grid_num_dim_elements,
-                         &local_target_bounds->data.double_data[target_time_index * target_grid_max_dim_elements * 2],
-                         target_buffer);
+                    harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
+                                   "dimension length for %s needs to be > 1 to allow regridding", target_grid->name);
+                    goto error;
                 }
-                else
+                if (get_interpolation_weights(type, source_grid_num_dim_elements, source_grid_data,
+                                              source_bounds_data, target_grid_num_dim_elements, target_grid_data,
+                                              target_bounds_data, out_of_bound_flag, &weights[type]) != 0)
                 {
-                    /* other resampling methods are not supported, but should also never be set */
-                    assert(0);
-                    exit(1);
+                    goto error;
                 }
+            }
+
+            /* treat variable as a [num_blocks, max_dim_elements, num_elements] array with indices [j,k,l] */
+            get_block_layout(variable, dimension_type, &num_blocks_per_time, &num_elements);
+            num_blocks_per_time /= grid_num_time_elements;
+
+            for (j = t * num_blocks_per_time; j < (t + 1) * num_blocks_per_time; j++)
+            {
+                long offset = j * max_dim_elements * num_elements;
 
-                for (k = 0; k < target_grid_num_dim_elements; k++)
+                /* interpolate all sub elements 'l' of the block at once */
+                if (variable->data_type == harp_type_float)
                 {
-                    variable->data.double_data[(j * max_dim_elements + k) * num_elements + l] = target_buffer[k];
+                    for (k = 0; k < source_grid_num_dim_elements * num_elements; k++)
+                    {
+                        source_buffer[k] = variable->data.float_data[offset + k];
+                    }
+                    harp_interpolation_weights_apply(weights[type], num_elements, source_buffer, target_buffer);
+                    for (k = 0; k < target_grid_num_dim_elements * num_elements; k++)
+                    {
+                        variable->data.float_data[offset + k] = (float)target_buffer[k];
+                    }
+                    for (k = target_grid_num_dim_elements * num_elements;
+                         k < target_grid_max_dim_elements * num_elements; k++)
+                    {
+                        variable->data.float_data[offset + k] = (float)harp_nan();
+                    }
                 }
-                for (k = target_grid_num_dim_elements; k < target_grid_max_dim_elements; k++)
+                else
                 {
-                    variable->data.double_data[(j * max_dim_elements + k) * num_elements + l] = harp_nan();
+                    memcpy(source_buffer, &variable->data.double_data[offset],
+                           source_grid_num_dim_elements * num_elements * sizeof(double));
+                    harp_interpolation_weights_apply(weights[type], num_elements, source_buffer,
+                                                     &variable->data.double_data[offset]);
+                    for (k = target_grid_num_dim_elements * num_elements;
+                         k < target_grid_max_dim_elements * num_elements; k++)
+                    {
+                        variable->data.double_data[offset + k] = harp_nan();
+                    }
                 }
             }
         }
@@ -1313,6 +1426,14 @@ LIBHARP_API int harp_product_regrid_with_axis_variable(harp_product *product, ha
     harp_variable_delete(source_bounds);
     harp_variable_delete(local_target_grid);
     harp_variable_delete(local_target_bounds);
+    for (k = 0; k <= resample_interval; k++)
+    {
+        harp_interpolation_weights_delete(weights[k]);
+    }
+    if (variable_type != NULL)
+    {
+        free(variable_type);
+    }
     free(source_buffer);
     free(target_buffer);
 
@@ -1323,6 +1444,14 @@ LIBHARP_API int harp_product_regrid_with_axis_variable(harp_product *product, ha
     harp_variable_delete(source_bounds);
     harp_variable_delete(local_target_grid);
     harp_variable_delete(local_target_bounds);
+    for (k = 0; k <= resample_interval; k++)
+    {
+        harp_interpolation_weights_delete(weights[k]);
+    }
+    if (variable_type != NULL)
+    {
+        free(variable_type);
+    }
     if (source_buffer != NULL)
     {
         free(source_buffer);
@@ -1367,6 +1496,11 @@ LIBHARP_API int harp_product_regrid_with_collocated_product(harp_product *produc
     harp_variable *target_bounds = NULL;
     harp_variable *variable;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (dimension_type == harp_dimension_independent || dimension_type == harp_dimension_time)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "can not regrid %s dimension",
@@ -1521,6 +1655,11 @@ LIBHARP_API int harp_product_regrid_with_collocated_dataset(harp_product *produc
     harp_variable *target_bounds = NULL;
     long i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (dimension_type == harp_dimension_independent || dimension_type == harp_dimension_time)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "can not regrid %s dimension",
@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2015-2026 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "harp-internal.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Sorting of the elements of a dimension based on the values of one or more (one dimensional) key variables.
+ *
+ * All functions in this module are reentrant (no static state is used), which allows them to be used from multiple
+ * threads and from within other sort routines.
+ *
+ * The ordering that is used is: numerical ordering for numeric types (with -0 and +0 being equal and NaN values
+ * ending up after all other values) and strcmp() ordering for strings. When multiple keys are provided, the elements
+ * are ordered on the first key and ties are resolved using the next key(s). Sorting is stable, i.e. elements that
+ * compare equal for all keys keep their relative order.
+ *
+ * Numeric keys are sorted using an LSD radix sort on an order preserving unsigned integer representation of the key
+ * values. String keys are sorted using a (stable) merge sort.
+ */
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_NUM_PASSES (64 / RADIX_BITS)
+
+static int compare_double(double value_a, double value_b)
+{
+    if (harp_isnan(value_a))
+    {
+        return harp_isnan(value_b) ? 0 : 1;
+    }
+    if (harp_isnan(value_b))
+    {
+        return -1;
+    }
+    if (value_a < value_b)
+    {
+        return -1;
+    }
+    if (value_a > value_b)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+static int compare_key_elements(const harp_variable *key_a, long index_a, const harp_variable *key_b, long index_b)
+{
+    assert(key_a->data_type == key_b->data_type);
+
+    switch (key_a->data_type)
+    {
+        case harp_type_int8:
+            return (key_a->data.int8_data[index_a] > key_b->data.int8_data[index_b]) -
+                (key_a->data.int8_data[index_a] < key_b->data.int8_data[index_b]);
+        case harp_type_int16:
+            return (key_a->data.int16_data[index_a] > key_b->data.int16_data[index_b]) -
+                (key_a->data.int16_data[index_a] < key_b->data.int16_data[index_b]);
+        case harp_type_int32:
+            return (key_a->data.int32_data[index_a] > key_b->data.int32_data[index_b]) -
+                (key_a->data.int32_data[index_a] < key_b->data.int32_data[index_b]);
+        case harp_type_float:
+            return compare_double(key_a->data.float_data[index_a], key_b->data.float_data[index_b]);
+        case harp_type_double:
+            return compare_double(key_a->data.double_data[index_a], key_b->data.double_data[index_b]);
+        case harp_type_string:
+            return strcmp(key_a->data.string_data[index_a], key_b->data.string_data[index_b]);
+    }
+
+    assert(0);
+    exit(1);
+}
+
+/* Map a numeric key value to an unsigned 64-bit integer whose unsigned ordering equals the ordering of the values */
+static uint64_t get_radix_key(const harp_variable *key, long index)
+{
+    union
+    {
+        double d;
+        uint64_t u;
+    } value;
+
+    switch (key->data_type)
+    {
+        case harp_type_int8:
+            return (uint64_t)((uint32_t)(int32_t)key->data.int8_data[index] ^ 0x80000000UL);
+        case harp_type_int16:
+            return (uint64_t)((uint32_t)(int32_t)key->data.int16_data[index] ^ 0x80000000UL);
+        case harp_type_int32:
+            return (uint64_t)((uint32_t)key->data.int32_data[index] ^ 0x80000000UL);
+        case harp_type_float:
+            /* float to double conversion is exact and order preserving */
+            value.d = key->data.float_data[index];
+            break;
+        case harp_type_double:
+            value.d = key->data.double_data[index];
+            break;
+        default:
+            assert(0);
+            exit(1);
+    }
+
+    if (harp_isnan(value.d))
+    {
+        /* all NaN values (irrespective of sign or payload) end up after +Inf */
+        return ~(uint64_t)0;
+    }
+    if (value.d == 0)
+    {
+        /* map -0 to +0 */
+        value.d = 0;
+    }
+    if (value.u & ((uint64_t)1 << 63))
+    {
+        /* negative values: invert all bits (this also reverses the ordering of the magnitudes) */
+        return ~value.u;
+    }
+
+    /* positive values: set the sign bit so they end up after all negative values */
+    return value.u | ((uint64_t)1 << 63);
+}
+
+/* Stable LSD radix sort of index based on the values of a numeric key */
+static int radix_sort_index(const harp_variable *key, long num_elements, long *index)
+{
+    long (*count)[RADIX_SIZE];
+    uint64_t *key_block;
+    long *index_block;
+    uint64_t *radix_key;
+    uint64_t *target_radix_key;
+    long *source_index;
+    long *target_index;
+    long i;
+    int pass;
+
+    key_block = malloc(2 * (size_t)num_elements * sizeof(uint64_t));
+    if (key_block == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       2 * (size_t)num_elements * sizeof(uint64_t), __FILE__, __LINE__);
+        return -1;
+    }
+    index_block = malloc((size_t)num_elements * sizeof(long));
+    if (index_block == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (size_t)num_elements * sizeof(long), __FILE__, __LINE__);
+        free(key_block);
+        return -1;
+    }
+    count = calloc(RADIX_NUM_PASSES, sizeof(*count));
+    if (count == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       RADIX_NUM_PASSES * sizeof(*count), __FILE__, __LINE__);
+        free(index_block);
+        free(key_block);
+        return -1;
+    }
+
+    radix_key = key_block;
+    target_radix_key = &key_block[num_elements];
+    source_index = index;
+    target_index = index_block;
+
+    /* determine the keys and the histograms for all digits in a single pass */
+    for (i = 0; i < num_elements; i++)
+    {
+        radix_key[i] = get_radix_key(key, index[i]);
+        for (pass = 0; pass < RADIX_NUM_PASSES; pass++)
+        {
+            count[pass][(radix_key[i] >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+        }
+    }
+
+    for (pass = 0; pass < RADIX_NUM_PASSES; pass++)
+    {
+        int shift = pass * RADIX_BITS;
+        long offset = 0;
+        uint64_t *swap_key;
+        long *swap_index;
+        int digit;
+
+        /* skip digits that are the same for all elements (e.g. the sign/exponent bytes of datetime values) */
+        if (count[pass][(radix_key[0] >> shift) & (RADIX_SIZE - 1)] == num_elements)
+        {
+            continue;
+        }
+
+        /* turn the histogram into starting offsets */
+        for (digit = 0; digit < RADIX_SIZE; digit++)
+        {
+            long digit_count = count[pass][digit];
+
+            count[pass][digit] = offset;
+            offset += digit_count;
+        }
+
+        for (i = 0; i < num_elements; i++)
+        {
+            long target = count[pass][(radix_key[i] >> shift) & (RADIX_SIZE - 1)]++;
+
+            target_radix_key[target] = radix_key[i];
+            target_index[target] = source_index[i];
+        }
+
+        swap_key = radix_key;
+        radix_key = target_radix_key;
+        target_radix_key = swap_key;
+        swap_index = source_index;
+        source_index = target_index;
+        target_index = swap_index;
+    }
+
+    if (source_index != index)
+    {
+        memcpy(index, source_index, (size_t)num_elements * sizeof(long));
+    }
+
+    free(count);
+    free(index_block);
+    free(key_block);
+
+    return 0;
+}
+
+/* Stable bottom-up merge sort of index based on the values of a string key */
+static int merge_sort_index(const harp_variable *key, long num_elements, long *index)
+{
+    long *buffer;
+    long *source_index;
+    long *target_index;
+    long width;
+
+    buffer = malloc((size_t)num_elements * sizeof(long));
+    if (buffer == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (size_t)num_elements * sizeof(long), __FILE__, __LINE__);
+        return -1;
+    }
+
+    source_index = index;
+    target_index = buffer;
+    for (width = 1; width < num_elements; width *= 2)
+    {
+        long *swap_index;
+        long start;
+
+        for (start = 0; start < num_elements; start += 2 * width)
+        {
+            long middle = start + width < num_elements ? start + width : num_elements;
+            long end = start + 2 * width < num_elements ? start + 2 * width : num_elements;
+            long i = start;
+            long j = middle;
+            long k = start;
+
+            if (middle == end ||
+                strcmp(key->data.string_data[source_index[middle - 1]], key->data.string_data[source_index[middle]]) <=
+                0)
+            {
+                /* the two runs are already in order */
+                memcpy(&target_index[start], &source_index[start], (size_t)(end - start) * sizeof(long));
+                continue;
+            }
+            while (i < middle && j < end)
+            {
+                if (strcmp(key->data.string_data[source_index[j]], key->data.string_data[source_index[i]]) < 0)
+                {
+                    target_index[k++] = source_index[j++];
+                }
+                else
+                {
+                    target_index[k++] = source_index[i++];
+                }
+            }
+            while (i < middle)
+            {
+                target_index[k++] = source_index[i++];
+            }
+            while (j < end)
+            {
+                target_index[k++] = source_index[j++];
+            }
+        }
+
+        swap_index = source_index;
+        source_index = target_index;
+        target_index = swap_index;
+    }
+
+    if (source_index != index)
+    {
+        memcpy(index, source_index, (size_t)num_elements * sizeof(long));
+    }
+
+    free(buffer);
+
+    return 0;
+}
+
+/* Compare element index_a of the keys in key_a with element index_b of the keys in key_b.
+ * Both key lists should contain num_keys variables of matching data types.
+ * Returns <0, 0, or >0 if element a is ordered before, equal to, or after element b.
+ */
+int harp_sort_compare_elements(int num_keys, harp_variable **key_a, long index_a, harp_variable **key_b,
+                               long index_b)
+{
+    int i;
+
+    for (i = 0; i < num_keys; i++)
+    {
+        int result = compare_key_elements(key_a[i], index_a, key_b[i], index_b);
+
+        if (result != 0)
+        {
+            return result;
+        }
+    }
+
+    return 0;
+}
+
+/* Returns 1 if the first num_elements elements of the keys are already in sorted order and 0 otherwise. */
+int harp_sort_is_sorted(int num_keys, harp_variable **key, long num_elements)
+{
+    long i;
+
+    for (i = 1; i < num_elements; i++)
+    {
+        if (harp_sort_compare_elements(num_keys, key, i - 1, key, i) > 0)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* Determine the (stable) permutation that sorts the first num_elements elements of the keys.
+ * Each key should be a variable with at least num_elements elements.
+ * On return, index[i] will contain the original position of the element that ends up at position i.
+ * Use harp_sort_is_sorted() first to skip the sort for keys that are already in order.
+ */
+int harp_sort_get_index(int num_keys, harp_variable **key, long num_elements, long *index)
+{
+    long i;
+    int k;
+
+    for (i = 0; i < num_elements; i++)
+    {
+        index[i] = i;
+    }
+
+    /* LSD ordering over the keys: sort on the least significant key first and rely on stability for the others */
+    for (k = num_keys - 1; k >= 0; k--)
+    {
+        if (key[k]->data_type == harp_type_string)
+        {
+            if (merge_sort_index(key[k], num_elements, index) != 0)
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            if (radix_sort_index(key[k], num_elements, index) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -39,6 +39,9 @@
 
 #include "udunits2.h"
 
+/* number of values that are converted to double before the unit conversion is applied to them */
+#define UNIT_CONVERSION_BLOCK_SIZE 1024
+
 static char *harp_udunits2_xml_path = NULL;
 
 static ut_system *unit_system = NULL;
@@ -404,21 +407,87 @@ double harp_unit_converter_convert_double(const harp_unit_converter *unit_conver
 
 void harp_unit_converter_convert_array_float(const harp_unit_converter *unit_converter, long num_values, float *value)
 {
-    float *value_end;
-
-    for (value_end = value + num_values; value != value_end; value++)
+    if (num_values > 0)
     {
-        *value = cv_convert_float(unit_converter->converter, *value);
+        cv_convert_floats(unit_converter->converter, value, (size_t)num_values, value);
     }
 }
 
 void harp_unit_converter_convert_array_double(const harp_unit_converter *unit_converter, long num_values, double *value)
 {
-    double *value_end;
+    if (num_values > 0)
+    {
+        cv_convert_doubles(unit_converter->converter, value, (size_t)num_values, value);
+    }
+}
+
+/* Convert 'num_values' numeric values of type 'data_type' to double and apply the unit conversion (if
+ * 'unit_converter' is not NULL) in a single pass. The values are converted in blocks, such that the unit conversion of
+ * a block is performed while it is still in cache.
+ */
+void harp_unit_converter_convert_array_to_double(const harp_unit_converter *unit_converter, harp_data_type data_type,
+                                                 long num_values, const void *value, double *converted_value)
+{
+    long offset;
+
+    if (data_type == harp_type_double)
+    {
+        if (unit_converter != NULL && num_values > 0)
+        {
+            cv_convert_doubles(unit_converter->converter, (const double *)value, (size_t)num_values, converted_value);
+        }
+        else if (converted_value != value)
+        {
+            memcpy(converted_value, value, (size_t)num_values * sizeof(double));
+        }
+        return;
+    }
 
-    for (value_end = value + num_values; value != value_end; value++)
+    for (offset = 0; offset < num_values; offset += UNIT_CONVERSION_BLOCK_SIZE)
     {
-        *value = cv_convert_double(unit_converter->converter, *value);
+        long block_size = num_values - offset;
+        long i;
+
+        if (block_size > UNIT_CONVERSION_BLOCK_SIZE)
+        {
+            block_size = UNIT_CONVERSION_BLOCK_SIZE;
+        }
+
+        switch (data_type)
+        {
+            case harp_type_int8:
+                for (i = 0; i < block_size; i++)
+                {
+                    converted_value[offset + i] = (double)((const int8_t *)value)[offset + i];
+                }
+                break;
+            case harp_type_int16:
+                for (i = 0; i < block_size; i++)
+                {
+                    converted_value[offset + i] = (double)((const int16_t *)value)[offset + i];
+                }
+                break;
+            case harp_type_int32:
+                for (i = 0; i < block_size; i++)
+                {
+                    converted_value[offset + i] = (double)((const int32_t *)value)[offset + i];
+                }
+                break;
+            case harp_type_float:
+                for (i = 0; i < block_size; i++)
+                {
+                    converted_value[offset + i] = (double)((const float *)value)[offset + i];
+                }
+                break;
+            default:
+                assert(0);
+                exit(1);
+        }
+
+        if (unit_converter != NULL)
+        {
+            harp_unit_converter_convert_array_double(unit_converter, block_size, &converted_value[offset]);
+        }
     }
 }
 
@@ -538,6 +607,11 @@ LIBHARP_API int harp_variable_convert_unit(harp_variable *variable, const char *
         harp_add_error_message(" (in unit conversion of variable '%s')", variable->name);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        harp_unit_converter_delete(unit_converter);
+        return -1;
+    }
 
     if (variable->data_type == harp_type_float)
     {
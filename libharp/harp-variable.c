@@ -357,6 +357,10 @@ int harp_variable_rearrange_dimension(harp_variable *variable, int dim_index, lo
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
     if (num_dim_elements <= 0)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_dim_elements argument <= 0 (%s:%u)", __FILE__, __LINE__);
@@ -694,6 +698,10 @@ int harp_variable_filter_dimension(harp_variable *variable, int dim_index, const
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable argument is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
     if (mask == NULL)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "mask argument is NULL (%s:%u)", __FILE__, __LINE__);
@@ -826,6 +834,10 @@ int harp_variable_resize_dimension(harp_variable *variable, int dim_index, long
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable argument is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
     if (dim_index < 0 || dim_index >= variable->num_dimensions)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "dim_index argument (%d) is not in the range [0:%d) (%s:%u)",
@@ -969,6 +981,10 @@ int harp_variable_add_dimension(harp_variable *variable, int dim_index, harp_dim
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
     if (dim_index < 0 || dim_index > variable->num_dimensions)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "dim_index argument (%d) is not in the range [0:%d] (%s:%u)",
@@ -1143,6 +1159,10 @@ int harp_variable_squash_dimension(harp_variable *variable, int dim_index)
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable argument is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
     if (dim_index < 0 || dim_index >= variable->num_dimensions)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "dim_index argument (%d) is not in the range [0,%d) (%s:%u)",
@@ -1207,24 +1227,107 @@ int harp_variable_squash_dimension(harp_variable *variable, int dim_index)
     return harp_variable_remove_dimension(variable, dim_index, 0);
 }
 
-/** \addtogroup harp_variable
- * @{
- */
+static int allocate_variable_data(harp_variable *variable)
+{
+    size_t size = (size_t)variable->num_elements * harp_get_size_for_type(variable->data_type);
 
-/** Create new variable.
- * \param name Name of the variable.
- * \param data_type Storage type of the variable data.
- * \param num_dimensions Number of array dimensions (use '0' for scalar data).
- * \param dimension_type Array with the dimension type for each of the dimensions.
- * \param dimension Array with length for each of the dimensions.
- * \param new_variable Pointer to the C variable where the new HARP variable will be stored.
- * \return
- *   \arg \c 0, Success.
- *   \arg \c -1, Error occurred (check #harp_errno).
+    variable->data.ptr = malloc(size);
+    if (variable->data.ptr == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)", size,
+                       __FILE__, __LINE__);
+        return -1;
+    }
+    memset(variable->data.ptr, 0, size);
+
+    return 0;
+}
+
+static void free_variable_data(harp_variable *variable)
+{
+    if (variable->data.ptr != NULL)
+    {
+        if (variable->data_type == harp_type_string)
+        {
+            long i;
+
+            for (i = 0; i < variable->num_elements; i++)
+            {
+                if (variable->data.string_data[i] != NULL)
+                {
+                    free(variable->data.string_data[i]);
+                }
+            }
+        }
+        free(variable->data.ptr);
+        variable->data.ptr = NULL;
+    }
+}
+
+/* location of the data of a variable that has been imported without reading its data */
+typedef struct variable_source_struct
+{
+    harp_variable_source_format format;
+    char *filename;
+    char *name; /* name of the variable/dataset in the file (which can differ from the HARP variable name) */
+} variable_source;
+
+/* Variables are allocated together with internal state that is not part of the public harp_variable struct.
+ * The source is only set while the data of the variable has not been read yet (i.e. while data.ptr is NULL).
+ * It is only accessed by the owner of the variable or inside the 'harp_variable_load' critical section.
  */
-LIBHARP_API int harp_variable_new(const char *name, harp_data_type data_type, int num_dimensions,
-                                  const harp_dimension_type *dimension_type, const long *dimension,
-                                  harp_variable **new_variable)
+typedef struct variable_internal_struct
+{
+    harp_variable variable;     /* needs to be the first field */
+    variable_source *source;
+} variable_internal;
+
+static void variable_source_delete(variable_source *source)
+{
+    if (source != NULL)
+    {
+        if (source->filename != NULL)
+        {
+            free(source->filename);
+        }
+        if (source->name != NULL)
+        {
+            free(source->name);
+        }
+        free(source);
+    }
+}
+
+/* only valid for variables that were allocated with allocate_variable() */
+static variable_internal *get_internal(const harp_variable *variable)
+{
+    return (variable_internal *)variable;
+}
+
+static harp_variable *allocate_variable(void)
+{
+    variable_internal *internal;
+
+    internal = (variable_internal *)malloc(sizeof(variable_internal));
+    if (internal == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(variable_internal), __FILE__, __LINE__);
+        return NULL;
+    }
+    internal->source = NULL;
+
+    return &internal->variable;
+}
+
+static int variable_has_source(const harp_variable *variable)
+{
+    return variable->data.ptr == NULL && get_internal(variable)->source != NULL;
+}
+
+static int variable_new(const char *name, harp_data_type data_type, int num_dimensions,
+                        const harp_dimension_type *dimension_type, const long *dimension, int allocate_data,
+                        harp_variable **new_variable)
 {
     harp_variable *variable;
     int i;
@@ -1274,11 +1377,9 @@ LIBHARP_API int harp_variable_new(const char *name, harp_data_type data_type, in
         }
     }
 
-    variable = (harp_variable *)malloc(sizeof(harp_variable));
+    variable = allocate_variable();
     if (variable == NULL)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       sizeof(harp_variable), __FILE__, __LINE__);
         return -1;
     }
     variable->name = NULL;
@@ -1307,15 +1408,14 @@ LIBHARP_API int harp_variable_new(const char *name, harp_data_type data_type, in
         return -1;
     }
 
-    variable->data.ptr = malloc((size_t)variable->num_elements * harp_get_size_for_type(data_type));
-    if (variable->data.ptr == NULL)
+    if (allocate_data)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       variable->num_elements * harp_get_size_for_type(data_type), __FILE__, __LINE__);
-        harp_variable_delete(variable);
-        return -1;
+        if (allocate_variable_data(variable) != 0)
+        {
+            harp_variable_delete(variable);
+            return -1;
+        }
     }
-    memset(variable->data.ptr, 0, (size_t)variable->num_elements * harp_get_size_for_type(data_type));
 
     if (data_type != harp_type_string)
     {
@@ -1327,6 +1427,254 @@ LIBHARP_API int harp_variable_new(const char *name, harp_data_type data_type, in
     return 0;
 }
 
+/* Create a new variable for which the data is read from a file on first use (see harp_variable_load()).
+ * The variable will not have any data allocated until it gets loaded.
+ */
+int harp_variable_new_from_source(const char *name, harp_data_type data_type, int num_dimensions,
+                                  const harp_dimension_type *dimension_type, const long *dimension,
+                                  harp_variable_source_format format, const char *filename, const char *source_name,
+                                  harp_variable **new_variable)
+{
+    variable_source *source;
+    harp_variable *variable;
+
+    if (variable_new(name, data_type, num_dimensions, dimension_type, dimension, 0, &variable) != 0)
+    {
+        return -1;
+    }
+
+    source = (variable_source *)malloc(sizeof(variable_source));
+    if (source == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(variable_source), __FILE__, __LINE__);
+        harp_variable_delete(variable);
+        return -1;
+    }
+    source->format = format;
+    source->filename = NULL;
+    source->name = NULL;
+
+    source->filename = strdup(filename);
+    if (source->filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        variable_source_delete(source);
+        harp_variable_delete(variable);
+        return -1;
+    }
+    source->name = strdup(source_name);
+    if (source->name == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        variable_source_delete(source);
+        harp_variable_delete(variable);
+        return -1;
+    }
+
+    get_internal(variable)->source = source;
+
+    *new_variable = variable;
+    return 0;
+}
+
+/* Create a new variable that uses 'data' as its data array (the array should hold num_elements values of the given
+ * data type). On success the variable takes ownership of 'data'.
+ */
+int harp_variable_new_with_data(const char *name, harp_data_type data_type, int num_dimensions,
+                                const harp_dimension_type *dimension_type, const long *dimension, void *data,
+                                harp_variable **new_variable)
+{
+    harp_variable *variable;
+
+    if (variable_new(name, data_type, num_dimensions, dimension_type, dimension, 0, &variable) != 0)
+    {
+        return -1;
+    }
+    variable->data.ptr = data;
+
+    *new_variable = variable;
+    return 0;
+}
+
+static int import_variable_data(harp_variable_source_format format, const char *filename, int num_variables,
+                                const char **source_name, harp_variable **variable)
+{
+    switch (format)
+    {
+        case harp_variable_source_netcdf:
+            return harp_import_variable_data_netcdf(filename, num_variables, source_name, variable);
+        case harp_variable_source_hdf5:
+#ifdef HAVE_HDF5
+            return harp_import_variable_data_hdf5(filename, num_variables, source_name, variable);
+#else
+            harp_set_error(HARP_ERROR_UNSUPPORTED_PRODUCT, NULL);
+            return -1;
+#endif
+    }
+
+    assert(0);
+    exit(1);
+}
+
+static int load_from_source(int num_variables, harp_variable **variable)
+{
+    variable_source **source;
+    harp_variable *load_variable = NULL;
+    harp_variable **load_variable_ptr = NULL;
+    const char **source_name = NULL;
+    int *index = NULL;
+    int num_load_variables;
+    int result = -1;
+    int i, j, k;
+
+    source = malloc(num_variables * sizeof(variable_source *));
+    load_variable = malloc(num_variables * sizeof(harp_variable));
+    load_variable_ptr = malloc(num_variables * sizeof(harp_variable *));
+    source_name = malloc(num_variables * sizeof(char *));
+    index = malloc(num_variables * sizeof(int));
+    if (source == NULL || load_variable == NULL || load_variable_ptr == NULL || source_name == NULL || index == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_variables * sizeof(harp_variable), __FILE__, __LINE__);
+        goto error;
+    }
+
+    /* another thread may already have loaded some of the variables while we were waiting */
+    for (i = 0; i < num_variables; i++)
+    {
+        source[i] = variable[i]->data.ptr == NULL ? get_internal(variable[i])->source : NULL;
+    }
+
+    /* variables are read per file; the data is read into copies of the variables, such that other threads (that do
+     * not wait for this critical section when data.ptr is set) never see partially read data */
+    for (i = 0; i < num_variables; i++)
+    {
+        if (source[i] == NULL)
+        {
+            continue;
+        }
+        num_load_variables = 0;
+        for (j = i; j < num_variables; j++)
+        {
+            if (source[j] != NULL && source[j]->format == source[i]->format &&
+                strcmp(source[j]->filename, source[i]->filename) == 0)
+            {
+                load_variable[num_load_variables] = *variable[j];
+                load_variable_ptr[num_load_variables] = &load_variable[num_load_variables];
+                source_name[num_load_variables] = source[j]->name;
+                index[num_load_variables] = j;
+                num_load_variables++;
+            }
+        }
+
+        for (k = 0; k < num_load_variables; k++)
+        {
+            if (allocate_variable_data(&load_variable[k]) != 0)
+            {
+                break;
+            }
+        }
+        if (k < num_load_variables || import_variable_data(source[i]->format, source[i]->filename,
+                                                           num_load_variables, source_name, load_variable_ptr) != 0)
+        {
+            for (k = 0; k < num_load_variables; k++)
+            {
+                free_variable_data(&load_variable[k]);
+            }
+            goto error;
+        }
+
+        for (k = 0; k < num_load_variables; k++)
+        {
+            variable[index[k]]->data = load_variable[k].data;
+            variable_source_delete(get_internal(variable[index[k]])->source);
+            get_internal(variable[index[k]])->source = NULL;
+            source[index[k]] = NULL;
+        }
+    }
+
+    result = 0;
+
+  error:
+    if (source != NULL)
+    {
+        free(source);
+    }
+    if (load_variable != NULL)
+    {
+        free(load_variable);
+    }
+    if (load_variable_ptr != NULL)
+    {
+        free(load_variable_ptr);
+    }
+    if (source_name != NULL)
+    {
+        free(source_name);
+    }
+    if (index != NULL)
+    {
+        free(index);
+    }
+
+    return result;
+}
+
+/* Read the data for a list of variables that were imported without reading their data.
+ * Variables that are read from the same file are read together using a single open of the file.
+ * Variables that are already loaded are skipped.
+ */
+int harp_variable_load_from_source(int num_variables, harp_variable **variable)
+{
+    int result;
+    int i;
+
+    for (i = 0; i < num_variables; i++)
+    {
+        if (variable[i]->data.ptr == NULL && variable[i]->num_elements > 0)
+        {
+            break;
+        }
+    }
+    if (i == num_variables)
+    {
+        return 0;
+    }
+
+    /* the file readers are not thread-safe, so only one thread at a time may load data */
+#pragma omp critical (harp_variable_load)
+    {
+        result = load_from_source(num_variables - i, &variable[i]);
+    }
+
+    return result;
+}
+
+/** \addtogroup harp_variable
+ * @{
+ */
+
+/** Create new variable.
+ * \param name Name of the variable.
+ * \param data_type Storage type of the variable data.
+ * \param num_dimensions Number of array dimensions (use '0' for scalar data).
+ * \param dimension_type Array with the dimension type for each of the dimensions.
+ * \param dimension Array with length for each of the dimensions.
+ * \param new_variable Pointer to the C variable where the new HARP variable will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_variable_new(const char *name, harp_data_type data_type, int num_dimensions,
+                                  const harp_dimension_type *dimension_type, const long *dimension,
+                                  harp_variable **new_variable)
+{
+    return variable_new(name, data_type, num_dimensions, dimension_type, dimension, 1, new_variable);
+}
+
 /** Delete variable.
  * Remove variable and all attached attributes.
  * \param variable HARP variable
@@ -1341,22 +1689,12 @@ LIBHARP_API void harp_variable_delete(harp_variable *variable)
     {
         free(variable->name);
     }
-    if (variable->data.ptr != NULL)
+    if (get_internal(variable)->source != NULL)
     {
-        if (variable->data_type == harp_type_string)
-        {
-            long i;
-
-            for (i = 0; i < variable->num_elements; i++)
-            {
-                if (variable->data.string_data[i] != NULL)
-                {
-                    free(variable->data.string_data[i]);
-                }
-            }
-        }
-        free(variable->data.ptr);
+        /* the data of the variable was never read */
+        variable_source_delete(get_internal(variable)->source);
     }
+    free_variable_data(variable);
     if (variable->description != NULL)
     {
         free(variable->description);
@@ -1395,11 +1733,15 @@ LIBHARP_API int harp_variable_copy(const harp_variable *other_variable, harp_var
     harp_variable *variable;
     long i;
 
-    variable = (harp_variable *)malloc(sizeof(harp_variable));
+    /* loading the data does not change the content of the variable, so we allow this for a const variable */
+    if (harp_variable_load((harp_variable *)other_variable) != 0)
+    {
+        return -1;
+    }
+
+    variable = allocate_variable();
     if (variable == NULL)
     {
-        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       sizeof(harp_variable), __FILE__, __LINE__);
         return -1;
     }
     variable->name = NULL;
@@ -1509,6 +1851,21 @@ LIBHARP_API int harp_variable_copy(const harp_variable *other_variable, harp_var
     return 0;
 }
 
+/** Read the data of a variable from its source file if this has not happened yet.
+ * Variables of products that were imported with the lazy import option enabled (see harp_set_option_lazy_import())
+ * only get their data read from the file the first time the data is needed. Call this function before accessing the
+ * \a data field of such a variable directly. For variables that already have their data in memory this function does
+ * nothing.
+ * \param variable Variable for which the data should be loaded.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_variable_load(harp_variable *variable)
+{
+    return harp_variable_load_from_source(1, &variable);
+}
+
 /** Copy all attributes of a variable to a target variable.
  * This will copy all attribute information of a variable that is not available as a parameter of \a harp_variable_new.
  * \param variable Variable from which the attributes should be copied.
@@ -1538,20 +1895,12 @@ LIBHARP_API int harp_variable_copy_attributes(const harp_variable *variable, har
     return 0;
 }
 
-/** Append one variable to another.
- * Both variables need to have the 'time' dimension as first dimension.
- * And all non-time dimensions need to be the same for both variables.
- * \param variable Variable to which data should be appended.
- * \param other_variable Variable that should be appended.
- * \return
- *   \arg \c 0, Success.
- *   \arg \c -1, Error occurred (check #harp_errno).
+/* Verify that the data of 'other_variable' can be appended to 'variable'.
+ * Both variables need to have the same name, data type, unit, and enumeration values, need to have the 'time'
+ * dimension as first dimension, and need to have the same non-time dimensions.
  */
-LIBHARP_API int harp_variable_append(harp_variable *variable, const harp_variable *other_variable)
+int harp_variable_check_append_compatibility(const harp_variable *variable, const harp_variable *other_variable)
 {
-    void *data;
-    long element_size;
-    long new_num_elements;
     long i;
 
     if (strcmp(variable->name, other_variable->name) != 0)
@@ -1608,6 +1957,38 @@ LIBHARP_API int harp_variable_append(harp_variable *variable, const harp_variabl
         }
     }
 
+    return 0;
+}
+
+/** Append one variable to another.
+ * Both variables need to have the 'time' dimension as first dimension.
+ * And all non-time dimensions need to be the same for both variables.
+ * \param variable Variable to which data should be appended.
+ * \param other_variable Variable that should be appended.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_variable_append(harp_variable *variable, const harp_variable *other_variable)
+{
+    void *data;
+    long element_size;
+    long new_num_elements;
+    long i;
+
+    if (harp_variable_check_append_compatibility(variable, other_variable) != 0)
+    {
+        return -1;
+    }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
+    if (harp_variable_load((harp_variable *)other_variable) != 0)
+    {
+        return -1;
+    }
+
     element_size = harp_get_size_for_type(variable->data_type);
     new_num_elements = variable->num_elements + other_variable->num_elements;
     data = realloc(variable->data.ptr, (size_t)new_num_elements * element_size);
@@ -1891,6 +2272,10 @@ LIBHARP_API int harp_variable_set_string_data_element(harp_variable *variable, l
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
     if (variable->data_type != harp_type_string)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "variable is of type '%s'; expected '%s' (%s:%u)",
@@ -1966,6 +2351,10 @@ LIBHARP_API int harp_variable_convert_data_type(harp_variable *variable, harp_da
                        "conversion from numerical value to string is not possible for variable '%s'", variable->name);
         return -1;
     }
+    if (harp_variable_load(variable) != 0)
+    {
+        return -1;
+    }
     if (variable->num_elements == 0 || variable->data.ptr == NULL)
     {
         /* nothing to convert */
@@ -2548,7 +2937,7 @@ LIBHARP_API int harp_variable_verify(const harp_variable *variable)
 
     }
 
-    if (variable->num_elements > 0 && variable->data.ptr == NULL)
+    if (variable->num_elements > 0 && variable->data.ptr == NULL && !variable_has_source(variable))
     {
         harp_set_error(HARP_ERROR_INVALID_VARIABLE, "number of elements is > 0, but variable contains no data");
         return -1;
@@ -2734,6 +3123,11 @@ LIBHARP_API void harp_variable_print_data(harp_variable *variable, int (*print)(
 {
     print("%s", variable->name);
     print(" = ");
+    if (harp_variable_load(variable) != 0)
+    {
+        print("<%s>\n\n", harp_errno_to_string(harp_errno));
+        return;
+    }
     if (variable->num_dimensions <= 1)
     {
         write_array(variable->data, variable->data_type, variable->num_elements, 1, print);
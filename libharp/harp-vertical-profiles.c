@@ -948,6 +948,15 @@ LIBHARP_API int harp_variable_smooth_vertical(harp_variable *variable, harp_vari
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "avk is NULL (%s:%u)", __FILE__, __LINE__);
         return -1;
     }
+    if (harp_variable_load(variable) != 0 || harp_variable_load(averaging_kernel) != 0)
+    {
+        return -1;
+    }
+    if ((apriori != NULL && harp_variable_load(apriori) != 0) ||
+        (vertical_axis != NULL && harp_variable_load(vertical_axis) != 0))
+    {
+        return -1;
+    }
     if (variable->data_type != harp_type_double)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "invalid data type for variable");
@@ -1153,6 +1162,11 @@ LIBHARP_API int harp_product_smooth_vertical_with_collocated_product(harp_produc
     harp_variable *temp_variable = NULL;
     int i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (product->dimension[harp_dimension_vertical] == 0)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product has no vertical dimension");
@@ -1286,6 +1300,12 @@ LIBHARP_API int harp_product_smooth_vertical_with_collocated_product(harp_produc
         snprintf(apriori_name, MAX_NAME_LENGTH, "%s_apriori", smooth_variables[i]);
 
         harp_product_get_variable_by_name(product, smooth_variables[i], &variable);
+        /* the regridding may have kept the variable as float (see harp_set_option_keep_float()) */
+        if (harp_variable_convert_data_type(variable, harp_type_double) != 0)
+        {
+            harp_product_delete(temp_product);
+            return -1;
+        }
         harp_product_get_variable_by_name(temp_product, avk_name, &avk);
         apriori = NULL;
         if (harp_product_has_variable(temp_product, apriori_name))
@@ -1342,6 +1362,11 @@ LIBHARP_API int harp_product_smooth_vertical_with_collocated_dataset(harp_produc
     harp_variable *apriori = NULL;
     long i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (product->dimension[harp_dimension_vertical] == 0)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product has no vertical dimension");
@@ -1523,6 +1548,13 @@ LIBHARP_API int harp_product_smooth_vertical_with_collocated_dataset(harp_produc
         snprintf(apriori_name, MAX_NAME_LENGTH, "%s_apriori", smooth_variables[i]);
 
         harp_product_get_variable_by_name(product, smooth_variables[i], &variable);
+        /* the regridding may have kept the variable as float (see harp_set_option_keep_float()) */
+        if (harp_variable_convert_data_type(variable, harp_type_double) != 0)
+        {
+            harp_product_delete(merged_product);
+            harp_collocation_result_shallow_delete(filtered_collocation_result);
+            return -1;
+        }
         harp_product_get_variable_by_name(merged_product, avk_name, &avk);
         apriori = NULL;
         if (harp_product_has_variable(merged_product, apriori_name))
@@ -1578,6 +1610,11 @@ LIBHARP_API int harp_product_get_smoothed_column(harp_product *product, const ch
     long num_vertical_elements;
     long i, j;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (product->dimension[harp_dimension_vertical] == 0)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product has no vertical dimension");
@@ -1788,6 +1825,11 @@ LIBHARP_API int harp_product_get_smoothed_column_using_collocated_product(harp_p
     harp_variable *temp_variable = NULL;
     int i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (num_dimensions == 0 || dimension_type[0] != harp_dimension_time)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
@@ -1966,6 +2008,11 @@ LIBHARP_API int harp_product_get_smoothed_column_using_collocated_dataset(harp_p
     harp_variable *apriori = NULL;
     long i;
 
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
     if (num_dimensions == 0 || dimension_type[0] != harp_dimension_time)
     {
         harp_set_error(HARP_ERROR_INVALID_ARGUMENT,
@@ -42,6 +42,9 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "coda.h"
 
@@ -55,6 +58,12 @@ int harp_option_create_collocation_datetime = 0;
 int harp_option_enable_aux_afgl86 = 0;
 int harp_option_enable_aux_usstd76 = 0;
 int harp_option_hdf5_compression = 0;
+long harp_option_hdf5_chunk_size = 0;
+int harp_option_hdf5_shuffle = 0;
+int harp_option_keep_float = 0;
+int harp_option_lazy_import = 0;
+int harp_option_metadata_cache = 0;
+int harp_option_num_threads = 0;
 int harp_option_propagate_uncertainty = 0;
 int harp_option_regrid_out_of_bounds = 0;
 
@@ -66,6 +75,22 @@ typedef enum file_format_enum
     format_netcdf
 } file_format;
 
+struct harp_export_stream_struct
+{
+    file_format format;
+    char *filename;
+    harp_product *reference;    /* variable definitions of the exported product (with a time dimension of length 1) */
+    int has_datetime_range;
+    double datetime_range[2];
+#ifdef HAVE_HDF4
+    harp_hdf4_stream *hdf4_stream;
+#endif
+#ifdef HAVE_HDF5
+    harp_hdf5_stream *hdf5_stream;
+#endif
+    harp_netcdf_stream *netcdf_stream;
+};
+
 static file_format format_from_string(const char *format)
 {
     if (strcasecmp(format, "hdf4") == 0)
@@ -451,6 +476,243 @@ LIBHARP_API int harp_get_option_hdf5_compression(void)
     return harp_option_hdf5_compression;
 }
 
+/** Set the target size (in bytes) of a chunk for storing variables in HDF5 files.
+ * This option is only used for variables that are stored using a chunked layout (i.e. when compression is enabled).
+ * For time dependent variables each chunk will cover the full extent of all non-time dimensions and as many time
+ * elements as fit within the given number of bytes (with a minimum of one time element). This allows reading a
+ * range of time elements from a compressed file without having to decompress the full variable.
+ * Variables that do not depend on time are stored as a single chunk.
+ * \param num_bytes The target number of bytes per chunk or 0 to use a single chunk for each variable (the default).
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_set_option_hdf5_chunk_size(long num_bytes)
+{
+    if (num_bytes < 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_bytes argument (%ld) is not valid (%s:%u)", num_bytes,
+                       __FILE__, __LINE__);
+        return -1;
+    }
+
+    harp_option_hdf5_chunk_size = num_bytes;
+
+    return 0;
+}
+
+/** Retrieve the target size (in bytes) of a chunk for storing variables in HDF5 files.
+ * \see harp_set_option_hdf5_chunk_size()
+ * \return target number of bytes per chunk (0=single chunk for each variable)
+ */
+LIBHARP_API long harp_get_option_hdf5_chunk_size(void)
+{
+    return harp_option_hdf5_chunk_size;
+}
+
+/** Enable/disable the use of the shuffle filter for storing variables in HDF5 files.
+ * The shuffle filter reorders the bytes of the data before compression, which generally improves the compression ratio
+ * for numerical data. This option only has an effect if compression is enabled.
+ * \param enable
+ *   \arg 0: Disable the shuffle filter (default).
+ *   \arg 1: Enable the shuffle filter.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_set_option_hdf5_shuffle(int enable)
+{
+    if (enable != 0 && enable != 1)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "enable argument (%d) is not valid (%s:%u)", enable, __FILE__,
+                       __LINE__);
+        return -1;
+    }
+
+    harp_option_hdf5_shuffle = enable;
+
+    return 0;
+}
+
+/** Retrieve the current setting for the use of the shuffle filter for storing variables in HDF5 files.
+ * \see harp_set_option_hdf5_shuffle()
+ * \return
+ *   \arg \c 0, The shuffle filter is disabled.
+ *   \arg \c 1, The shuffle filter is enabled.
+ */
+LIBHARP_API int harp_get_option_hdf5_shuffle(void)
+{
+    return harp_option_hdf5_shuffle;
+}
+
+/** Enable/disable keeping float variables as float in regridding and rebinning operations.
+ * By default, all variables that are regridded (see harp_product_regrid_with_axis_variable()) or rebinned (see
+ * harp_product_rebin_with_axis_bounds_variable()) are converted to double. With this option enabled, variables that
+ * use a float data type keep this data type, which halves the memory needed for these variables.
+ * The interpolation and the summation of values is still performed in double precision; only the stored results are
+ * rounded to float (i.e. the results equal the rounded results of a regridding/rebinning without this option).
+ * The option only applies to regridding and rebinning. Variables that are smoothed (see
+ * harp_product_smooth_vertical_with_collocated_product()), binned (see harp_product_bin()), or derived are still
+ * converted to double.
+ * \param enable
+ *   \arg 0: Convert float variables to double (default).
+ *   \arg 1: Keep float variables as float.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_set_option_keep_float(int enable)
+{
+    if (enable != 0 && enable != 1)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "enable argument (%d) is not valid (%s:%u)", enable, __FILE__,
+                       __LINE__);
+        return -1;
+    }
+
+    harp_option_keep_float = enable;
+
+    return 0;
+}
+
+/** Retrieve the current setting for keeping float variables as float in regridding and rebinning operations.
+ * \see harp_set_option_keep_float()
+ * \return
+ *   \arg \c 0, Float variables are converted to double.
+ *   \arg \c 1, Float variables are kept as float.
+ */
+LIBHARP_API int harp_get_option_keep_float(void)
+{
+    return harp_option_keep_float;
+}
+
+/** Enable/disable lazy loading of variable data for products imported by harp_import().
+ * With lazy loading enabled, the data of variables of netCDF-3 and HDF5 products in the HARP format is only read from
+ * the file when the data is first needed. Users that access the \a data field of a variable directly should first
+ * call harp_variable_load() (or harp_product_load()) for such products.
+ * Note that the file needs to remain available (and unmodified) until all data is loaded or the product is deleted.
+ * Operations that are passed to harp_import() will always only read the variables that they need, regardless of this
+ * option.
+ * \param enable
+ *   \arg 0: Read the data of all variables as part of the import (default).
+ *   \arg 1: Read the data of variables on first use.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_set_option_lazy_import(int enable)
+{
+    if (enable != 0 && enable != 1)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "enable argument (%d) is not valid (%s:%u)", enable, __FILE__,
+                       __LINE__);
+        return -1;
+    }
+
+    harp_option_lazy_import = enable;
+
+    return 0;
+}
+
+/** Retrieve the current setting for lazy loading of variable data for imported products.
+ * \see harp_set_option_lazy_import()
+ * \return
+ *   \arg \c 0, Data of all variables is read as part of the import.
+ *   \arg \c 1, Data of variables is read on first use.
+ */
+LIBHARP_API int harp_get_option_lazy_import(void)
+{
+    return harp_option_lazy_import;
+}
+
+/** Enable/disable the metadata cache for directories that are added to a dataset.
+ * With the metadata cache enabled, harp_dataset_import() stores the metadata of all products of a directory in a
+ * '.harp_metadata_cache.csv' file in that directory. When the directory is imported again (by the same HARP version
+ * and with the same ingestion options), the metadata of products whose filename, size, and modification time did not
+ * change is taken from this cache instead of from the product itself. The cache is only (re)written if it is out of
+ * date. If the cache file cannot be written (e.g. because the directory is read-only) a warning is given (only for the
+ * first failure).
+ * \param enable
+ *   \arg 0: Always retrieve the metadata from the products themselves (default).
+ *   \arg 1: Use (and update) the metadata cache of each directory.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_set_option_metadata_cache(int enable)
+{
+    if (enable != 0 && enable != 1)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "enable argument (%d) is not valid (%s:%u)", enable, __FILE__,
+                       __LINE__);
+        return -1;
+    }
+
+    harp_option_metadata_cache = enable;
+
+    return 0;
+}
+
+/** Retrieve the current setting for the metadata cache for directories that are added to a dataset.
+ * \see harp_set_option_metadata_cache()
+ * \return
+ *   \arg \c 0, The metadata cache is not used.
+ *   \arg \c 1, The metadata cache is used.
+ */
+LIBHARP_API int harp_get_option_metadata_cache(void)
+{
+    return harp_option_metadata_cache;
+}
+
+/** Set the number of threads that HARP uses for multithreaded processing.
+ * This applies to all parts of HARP that process data in parallel, such as the derivation of variables and the
+ * compression of HDF5 variables. It has no effect if HARP was built without OpenMP support.
+ * \param num_threads
+ *   \arg 0: Use the OpenMP default (e.g. as set by the OMP_NUM_THREADS environment variable) (default).
+ *   \arg >0: Use at most this number of threads.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_set_option_num_threads(int num_threads)
+{
+    if (num_threads < 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "num_threads argument (%d) is not valid (%s:%u)", num_threads,
+                       __FILE__, __LINE__);
+        return -1;
+    }
+
+    harp_option_num_threads = num_threads;
+
+    return 0;
+}
+
+/** Retrieve the current setting for the number of threads that HARP uses for multithreaded processing.
+ * \see harp_set_option_num_threads()
+ * \return
+ *   \arg \c 0, The OpenMP default number of threads is used.
+ *   \arg \c >0, The maximum number of threads that is used.
+ */
+LIBHARP_API int harp_get_option_num_threads(void)
+{
+    return harp_option_num_threads;
+}
+
+/* Number of threads to use for a parallel region (always 1 if HARP is built without OpenMP) */
+int harp_get_num_threads(void)
+{
+#ifdef _OPENMP
+    if (harp_option_num_threads > 0)
+    {
+        return harp_option_num_threads;
+    }
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
 /** Set how to propagate uncertainty.
  * This is only applicable for operations that support propagation of uncertainties. And then only if there is a choice.
  * The propagation can either assume uncertainties to be fully uncorrelated (the default) or fully correlated.
@@ -619,6 +881,7 @@ LIBHARP_API int harp_import(const char *filename, const char *operations, const
 {
     harp_product *imported_product;
     file_format format;
+    int lazy;
     int result;
 
     if (determine_file_format(filename, &format) != 0)
@@ -626,6 +889,10 @@ LIBHARP_API int harp_import(const char *filename, const char *operations, const
         return -1;
     }
 
+    /* only defer reading the data if the user asked for this, or if operations may not need all data (at the cost of
+     * opening the file a second time for the remaining data) */
+    lazy = harp_option_lazy_import || operations != NULL;
+
     switch (format)
     {
         case format_hdf4:
@@ -638,14 +905,14 @@ LIBHARP_API int harp_import(const char *filename, const char *operations, const
             break;
         case format_hdf5:
 #ifdef HAVE_HDF5
-            result = harp_import_hdf5(filename, &imported_product);
+            result = harp_import_hdf5(filename, lazy, &imported_product);
 #else
             harp_set_error(HARP_ERROR_UNSUPPORTED_PRODUCT, NULL);
             result = -1;
 #endif
             break;
         case format_netcdf:
-            result = harp_import_netcdf(filename, &imported_product);
+            result = harp_import_netcdf(filename, lazy, &imported_product);
             break;
         default:
             harp_set_error(HARP_ERROR_UNSUPPORTED_PRODUCT, NULL);
@@ -691,6 +958,17 @@ LIBHARP_API int harp_import(const char *filename, const char *operations, const
                 return -1;
             }
         }
+
+        /* the operations will only have read the data that they needed; read the remaining data unless the user
+         * asked to defer this until first use */
+        if (!harp_option_lazy_import)
+        {
+            if (harp_product_load(imported_product) != 0)
+            {
+                harp_product_delete(imported_product);
+                return -1;
+            }
+        }
     }
 
     *product = imported_product;
@@ -738,14 +1016,14 @@ LIBHARP_API int harp_import_test(const char *filename, int (*print)(const char *
             break;
         case format_hdf5:
 #ifdef HAVE_HDF5
-            result = harp_import_hdf5(filename, &product);
+            result = harp_import_hdf5(filename, 0, &product);
 #else
             harp_set_error(HARP_ERROR_UNSUPPORTED_PRODUCT, NULL);
             result = -1;
 #endif
             break;
         case format_netcdf:
-            result = harp_import_netcdf(filename, &product);
+            result = harp_import_netcdf(filename, 0, &product);
             break;
         default:
             harp_set_error(HARP_ERROR_UNSUPPORTED_PRODUCT, NULL);
@@ -891,6 +1169,12 @@ LIBHARP_API int harp_export(const char *filename, const char *export_format, con
         return -1;
     }
 
+    /* loading the data does not change the content of the product, so we allow this for a const product */
+    if (harp_product_load((harp_product *)product) != 0)
+    {
+        return -1;
+    }
+
     switch (format)
     {
         case format_hdf4:
@@ -917,6 +1201,368 @@ LIBHARP_API int harp_export(const char *filename, const char *export_format, con
     return 0;
 }
 
+/* Create a product containing the variables of 'product' reduced to a single time element.
+ * This product is used to verify that products that are appended to an export stream are compatible.
+ */
+static int create_stream_reference_product(const harp_product *product, harp_product **new_reference)
+{
+    harp_product *reference;
+    int i;
+
+    if (harp_product_new(&reference) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < product->num_variables; i++)
+    {
+        harp_variable *variable;
+
+        if (harp_variable_copy(product->variable[i], &variable) != 0)
+        {
+            harp_product_delete(reference);
+            return -1;
+        }
+        if (harp_variable_resize_dimension(variable, 0, 1) != 0)
+        {
+            harp_variable_delete(variable);
+            harp_product_delete(reference);
+            return -1;
+        }
+        if (harp_product_add_variable(reference, variable) != 0)
+        {
+            harp_variable_delete(variable);
+            harp_product_delete(reference);
+            return -1;
+        }
+    }
+
+    *new_reference = reference;
+
+    return 0;
+}
+
+/* Verify that 'product' can be appended to the exported product without changing its structure.
+ * 'product' will be updated in the same way as harp_product_append() would do (i.e. remove 'index', add 'time'
+ * dimension, add missing '*_count'/'*_weight' variables and extend non-time dimensions).
+ * The reference product of the stream is left untouched (also if the product is rejected).
+ */
+static int prepare_stream_product(harp_export_stream *stream, harp_product *product)
+{
+    harp_product *reference;
+    int i;
+
+    /* harp_product_prepare_for_append() would extend the reference if the exported product needs to be extended, so
+     * use a copy (the reference only has a single time element) and compare the result with the original */
+    if (harp_product_copy(stream->reference, &reference) != 0)
+    {
+        return -1;
+    }
+    if (harp_product_prepare_for_append(reference, product) != 0)
+    {
+        harp_product_delete(reference);
+        return -1;
+    }
+    if (reference->num_variables != stream->reference->num_variables)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product has variables that are not part of the exported product");
+        harp_product_delete(reference);
+        return -1;
+    }
+    for (i = 0; i < HARP_NUM_DIM_TYPES; i++)
+    {
+        if (i != harp_dimension_time && reference->dimension[i] != stream->reference->dimension[i])
+        {
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "length of dimension '%s' (%ld) exceeds that of the exported "
+                           "product (%ld)", harp_get_dimension_type_name((harp_dimension_type)i),
+                           reference->dimension[i], stream->reference->dimension[i]);
+            harp_product_delete(reference);
+            return -1;
+        }
+    }
+    for (i = 0; i < reference->num_variables; i++)
+    {
+        harp_variable *variable;
+
+        if (harp_product_get_variable_by_name(product, reference->variable[i]->name, &variable) != 0)
+        {
+            harp_product_delete(reference);
+            return -1;
+        }
+        if (harp_variable_check_append_compatibility(reference->variable[i], variable) != 0)
+        {
+            harp_product_delete(reference);
+            return -1;
+        }
+    }
+    harp_product_delete(reference);
+
+    return 0;
+}
+
+/** Open a stream for incrementally exporting a product to a file.
+ * \ingroup harp_product
+ * With an export stream, products can be appended one by one to a file (using harp_export_stream_append()) without
+ * having to keep the full (merged) product in memory. The result is the same as when all products would have been
+ * merged using harp_product_append() and the result exported using harp_export().
+ *
+ * The file is created when the first non-empty product is appended. That product determines the structure of the
+ * exported product: the 'time' dimension is stored as an extendible dimension (netCDF record dimension, HDF4 unlimited
+ * dimension, or chunked HDF5 dataset with unlimited maximum size), but all other dimensions (including the string
+ * lengths of string variables) are fixed. Subsequent products can therefore not have longer non-time dimensions or
+ * longer strings than the first product.
+ *
+ * The stream needs to be closed with harp_export_stream_close().
+ * \param filename Path to the file to which the product is to be exported.
+ * \param export_format Either "hdf4", "hdf5", or "netcdf".
+ * \param new_stream Pointer to the C variable where the new export stream will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_export_stream_open(const char *filename, const char *export_format,
+                                        harp_export_stream **new_stream)
+{
+    harp_export_stream *stream;
+    file_format format;
+
+    if (filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "filename is NULL");
+        return -1;
+    }
+
+    format = format_from_string(export_format);
+    switch (format)
+    {
+        case format_hdf4:
+#ifndef HAVE_HDF4
+            harp_set_error(HARP_ERROR_NO_HDF4_SUPPORT, NULL);
+            return -1;
+#endif
+            break;
+        case format_hdf5:
+#ifndef HAVE_HDF5
+            harp_set_error(HARP_ERROR_NO_HDF5_SUPPORT, NULL);
+            return -1;
+#endif
+            break;
+        case format_netcdf:
+            break;
+        default:
+            harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "unsupported export format '%s'", export_format);
+            return -1;
+    }
+
+    stream = malloc(sizeof(harp_export_stream));
+    if (stream == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(harp_export_stream), __FILE__, __LINE__);
+        return -1;
+    }
+    stream->format = format;
+    stream->filename = NULL;
+    stream->reference = NULL;
+    stream->has_datetime_range = 0;
+    stream->datetime_range[0] = harp_plusinf();
+    stream->datetime_range[1] = harp_mininf();
+#ifdef HAVE_HDF4
+    stream->hdf4_stream = NULL;
+#endif
+#ifdef HAVE_HDF5
+    stream->hdf5_stream = NULL;
+#endif
+    stream->netcdf_stream = NULL;
+
+    stream->filename = strdup(filename);
+    if (stream->filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        free(stream);
+        return -1;
+    }
+
+    *new_stream = stream;
+
+    return 0;
+}
+
+/** Append a product to an export stream.
+ * \ingroup harp_product
+ * The product will be modified in the same way as the 'other_product' argument of harp_product_append() (i.e. the
+ * 'index' variable is removed, all variables are made time dependent, etc.) and its data is then written to file.
+ * The product remains owned by the caller and can be deleted once this function returns.
+ * Empty products are ignored.
+ * \param stream Export stream.
+ * \param product Product that should be appended to the exported product.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_export_stream_append(harp_export_stream *stream, harp_product *product)
+{
+    double datetime_start;
+    double datetime_stop;
+    int result = 0;
+
+    if (stream == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "stream is NULL");
+        return -1;
+    }
+    if (product == NULL)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "product is NULL");
+        return -1;
+    }
+
+    if (harp_product_is_empty(product))
+    {
+        return 0;
+    }
+    if (harp_product_load(product) != 0)
+    {
+        return -1;
+    }
+
+    if (stream->reference == NULL)
+    {
+        /* the first product determines the structure of the exported product */
+        if (harp_product_append(product, NULL) != 0)
+        {
+            return -1;
+        }
+        switch (stream->format)
+        {
+            case format_hdf4:
+#ifdef HAVE_HDF4
+                result = harp_export_hdf4_stream_open(stream->filename, product, &stream->hdf4_stream);
+#endif
+                break;
+            case format_hdf5:
+#ifdef HAVE_HDF5
+                result = harp_export_hdf5_stream_open(stream->filename, product, &stream->hdf5_stream);
+#endif
+                break;
+            case format_netcdf:
+                result = harp_export_netcdf_stream_open(stream->filename, product, &stream->netcdf_stream);
+                break;
+            default:
+                assert(0);
+                exit(1);
+        }
+        if (result != 0)
+        {
+            return -1;
+        }
+        if (create_stream_reference_product(product, &stream->reference) != 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        if (prepare_stream_product(stream, product) != 0)
+        {
+            return -1;
+        }
+        switch (stream->format)
+        {
+            case format_hdf4:
+#ifdef HAVE_HDF4
+                result = harp_export_hdf4_stream_append(stream->hdf4_stream, product);
+#endif
+                break;
+            case format_hdf5:
+#ifdef HAVE_HDF5
+                result = harp_export_hdf5_stream_append(stream->hdf5_stream, product);
+#endif
+                break;
+            case format_netcdf:
+                result = harp_export_netcdf_stream_append(stream->netcdf_stream, product);
+                break;
+            default:
+                assert(0);
+                exit(1);
+        }
+        if (result != 0)
+        {
+            harp_add_error_message(" (%s)", stream->filename);
+            return -1;
+        }
+    }
+
+    if (harp_product_get_datetime_range(product, &datetime_start, &datetime_stop) == 0)
+    {
+        if (datetime_start < stream->datetime_range[0])
+        {
+            stream->datetime_range[0] = datetime_start;
+        }
+        if (datetime_stop > stream->datetime_range[1])
+        {
+            stream->datetime_range[1] = datetime_stop;
+        }
+        stream->has_datetime_range = 1;
+    }
+
+    return 0;
+}
+
+/** Close an export stream.
+ * \ingroup harp_product
+ * This finalizes the exported file (e.g. by writing the datetime_start and datetime_stop attributes) and frees the
+ * stream. If no (non-empty) product was appended to the stream then no file will have been created.
+ * \param stream Export stream.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #harp_errno).
+ */
+LIBHARP_API int harp_export_stream_close(harp_export_stream *stream)
+{
+    const double *datetime_range = NULL;
+    int result = 0;
+
+    if (stream == NULL)
+    {
+        return 0;
+    }
+
+    if (stream->has_datetime_range)
+    {
+        datetime_range = stream->datetime_range;
+    }
+#ifdef HAVE_HDF4
+    if (stream->hdf4_stream != NULL)
+    {
+        result = harp_export_hdf4_stream_close(stream->hdf4_stream, datetime_range);
+    }
+#endif
+#ifdef HAVE_HDF5
+    if (stream->hdf5_stream != NULL)
+    {
+        result = harp_export_hdf5_stream_close(stream->hdf5_stream, datetime_range);
+    }
+#endif
+    if (stream->netcdf_stream != NULL)
+    {
+        result = harp_export_netcdf_stream_close(stream->netcdf_stream, datetime_range);
+    }
+    if (result != 0)
+    {
+        harp_add_error_message(" (%s)", stream->filename);
+    }
+
+    if (stream->reference != NULL)
+    {
+        harp_product_delete(stream->reference);
+    }
+    free(stream->filename);
+    free(stream);
+
+    return result;
+}
+
 /**
  * Return a string describing the dimension type.
  */
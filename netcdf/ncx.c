@@ -90,6 +90,17 @@ static const char nada[X_ALIGN] = {0, 0, 0, 0};
 		(((a) >>  8) & 0x0000ff00) | \
 		(((a) >> 24) & 0x000000ff) )
 
+/*
+ * With gcc and clang the swapn?b() routines swap whole words using the
+ * byte swap builtins. These element loops are simple enough for the
+ * compiler to turn them into vector byte shuffles. memcpy() is used to
+ * load and store the words since external data need not be aligned.
+ */
+#if (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8)))) && \
+	SIZEOF_SHORT == 2 && SIZEOF_INT == 4
+#define HAVE_BSWAP_BUILTINS 1
+#endif
+
 
 static void
 swapn2b(void *dst, const void *src, size_t nn)
@@ -97,6 +108,17 @@ swapn2b(void *dst, const void *src, size_t nn)
 	char *op = dst;
 	const char *ip = src;
 
+#ifdef HAVE_BSWAP_BUILTINS
+	size_t i;
+
+	for(i = 0; i < nn; i++)
+	{
+		unsigned short v;
+		(void) memcpy(&v, ip + 2 * i, 2);
+		v = __builtin_bswap16(v);
+		(void) memcpy(op + 2 * i, &v, 2);
+	}
+#else
 /* unroll the following to reduce loop overhead
  *
  *	while(nn-- != 0)
@@ -122,6 +144,7 @@ swapn2b(void *dst, const void *src, size_t nn)
 		*op++ = *(++ip);
 		*op++ = *(ip++ -1);
 	}
+#endif
 }
 
 # ifndef vax
@@ -143,6 +166,17 @@ swapn4b(void *dst, const void *src, size_t nn)
 	char *op = dst;
 	const char *ip = src;
 
+#ifdef HAVE_BSWAP_BUILTINS
+	size_t i;
+
+	for(i = 0; i < nn; i++)
+	{
+		unsigned int v;
+		(void) memcpy(&v, ip + 4 * i, 4);
+		v = __builtin_bswap32(v);
+		(void) memcpy(op + 4 * i, &v, 4);
+	}
+#else
 /* unroll the following to reduce loop overhead
  *	while(nn-- != 0)
  *	{
@@ -185,6 +219,7 @@ swapn4b(void *dst, const void *src, size_t nn)
 		op += 4;
 		ip += 4;
 	}
+#endif
 }
 
 # ifndef vax
@@ -222,6 +257,21 @@ swapn8b(void *dst, const void *src, size_t nn)
 	char *op = dst;
 	const char *ip = src;
 
+#if defined(HAVE_BSWAP_BUILTINS) && !defined(FLOAT_WORDS_BIGENDIAN)
+	size_t i;
+
+	for(i = 0; i < nn; i++)
+	{
+		unsigned int lo;
+		unsigned int hi;
+		(void) memcpy(&lo, ip + 8 * i, 4);
+		(void) memcpy(&hi, ip + 8 * i + 4, 4);
+		lo = __builtin_bswap32(lo);
+		hi = __builtin_bswap32(hi);
+		(void) memcpy(op + 8 * i, &hi, 4);
+		(void) memcpy(op + 8 * i + 4, &lo, 4);
+	}
+#else
 /* unroll the following to reduce loop overhead
  *	while(nn-- != 0)
  *	{
@@ -288,6 +338,7 @@ swapn8b(void *dst, const void *src, size_t nn)
 		ip += 8;
 	}
 #  endif
+#endif
 }
 # endif /* !vax */
 
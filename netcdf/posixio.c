@@ -27,6 +27,10 @@
 #define SEEK_END 2
 #endif
 
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#endif
+
 #include "ncio.h"
 #include "fbits.h"
 #include "rnd.h"
@@ -1341,6 +1345,237 @@ ncio_spx_init(ncio *const nciop)
 }
 
 
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+/* Begin mmx */
+
+/* The mmx functions are for posix systems that support mmap(), when
+   the file is opened read-only and NC_SHARE is not in effect.
+
+   The whole file is mapped into memory and get() hands out pointers
+   directly into the mapping. The conversion routines in ncx.c then
+   byte-swap from the mapping straight into the destination buffer,
+   without the intermediate copy into a px buffer.
+*/
+
+/* Extents of at least this size get a MADV_WILLNEED hint so the
+   kernel starts reading the whole region ahead of the conversion. */
+#define MMX_WILLNEED_EXTENT 65536
+
+/* This struct is for POSIX systems with mmap(), for read-only opens
+   without NC_SHARE.
+
+   base - start of the mapping of the file.
+   size - size of the file (and of the mapping) in bytes.
+   bf_base - buffer used for regions that extend beyond the end of the
+   file (the tail of such a region is zero filled, as px_pgin does).
+   bf_extent - size of the bf_base buffer.
+*/
+typedef struct ncio_mmx {
+	void	*base;
+	size_t	size;
+	void	*bf_base;
+	size_t	bf_extent;
+} ncio_mmx;
+
+
+/*ARGSUSED*/
+/* Release a region. Regions are never modified, so this is a no-op.
+*/
+static int
+ncio_mmx_rel(ncio *const nciop, off_t offset, int rflags)
+{
+	(void)nciop;
+	(void)offset;
+
+	if(fIsSet(rflags, RGN_MODIFIED))
+		return EPERM; /* attempt to write readonly file */
+
+	return ENOERR;
+}
+
+
+/* Request that the region (offset, extent) be made available through
+   *vpp.
+
+   For regions that lie within the file this returns a pointer into
+   the mapping. Large regions get a MADV_WILLNEED hint for the pages
+   they cover. Regions that extend beyond the end of the file are
+   copied into a zero padded buffer.
+
+   nciop - pointer to ncio struct for this file.
+   offset - offset from the beginning of the file.
+   extent - the number of bytes we want.
+   rflags - One of the RGN_* flags defined in ncio.h.
+   vpp - handle to point at the data.
+*/
+static int
+ncio_mmx_get(ncio *const nciop,
+		off_t offset, size_t extent,
+		int rflags,
+		void **const vpp)
+{
+	ncio_mmx *const mxp = (ncio_mmx *)nciop->pvt;
+	size_t navail;
+
+	if(fIsSet(rflags, RGN_WRITE))
+		return EPERM; /* attempt to write readonly file */
+
+	assert(extent != 0);
+	assert(extent < X_INT_MAX); /* sanity check */
+
+	if(offset < 0)
+		return EINVAL;
+
+	if((size_t)offset <= mxp->size && extent <= mxp->size - (size_t)offset)
+	{
+		char *vp = (char *)mxp->base + offset;
+
+		if(extent >= MMX_WILLNEED_EXTENT)
+		{
+			const size_t pgsz = pagesize();
+			const size_t pgoffset = (size_t)offset % pgsz;
+
+			(void) madvise(vp - pgoffset, extent + pgoffset,
+				MADV_WILLNEED);
+		}
+		*vpp = vp;
+		return ENOERR;
+	}
+
+	if(mxp->bf_extent < extent)
+	{
+		if(mxp->bf_base != NULL)
+		{
+			free(mxp->bf_base);
+			mxp->bf_base = NULL;
+			mxp->bf_extent = 0;
+		}
+		mxp->bf_base = malloc(extent);
+		if(mxp->bf_base == NULL)
+			return ENOMEM;
+		mxp->bf_extent = extent;
+	}
+
+	navail = 0;
+	if((size_t)offset < mxp->size)
+	{
+		navail = mxp->size - (size_t)offset;
+		(void) memcpy(mxp->bf_base, (char *)mxp->base + offset,
+			navail);
+	}
+	(void) memset((char *)mxp->bf_base + navail, 0, extent - navail);
+
+	*vpp = mxp->bf_base;
+	return ENOERR;
+}
+
+
+/*ARGSUSED*/
+/* Moving data requires write access, which a read-only open never
+   has.
+*/
+static int
+ncio_mmx_move(ncio *const nciop, off_t to, off_t from,
+			size_t nbytes, int rflags)
+{
+	(void)nciop;
+	(void)to;
+	(void)from;
+	(void)nbytes;
+	(void)rflags;
+
+	return EPERM; /* attempt to write readonly file */
+}
+
+
+/*ARGSUSED*/
+/* Nothing is buffered, so this is a no-op.
+*/
+static int
+ncio_mmx_sync(ncio *const nciop)
+{
+	(void)nciop;
+	/* NOOP */
+	return ENOERR;
+}
+
+
+/* Internal function called at close to unmap the file and
+   free up anything hanging off pvt.
+*/
+static void
+ncio_mmx_free(void *const pvt)
+{
+	ncio_mmx *const mxp = (ncio_mmx *)pvt;
+	if(mxp == NULL)
+		return;
+
+	if(mxp->base != NULL)
+	{
+		(void) munmap(mxp->base, mxp->size);
+		mxp->base = NULL;
+		mxp->size = 0;
+	}
+
+	if(mxp->bf_base != NULL)
+	{
+		free(mxp->bf_base);
+		mxp->bf_base = NULL;
+		mxp->bf_extent = 0;
+	}
+}
+
+
+/* Map the opened file and, on success, switch the ncio struct over to
+   the mmx functions. Since variables are mostly read front to back the
+   mapping gets a MADV_SEQUENTIAL hint.
+
+   If the file can not be mapped (e.g. because it is empty or lives on
+   a file system that does not support mmap) the ncio struct is left
+   untouched and an error is returned, so the caller can fall back to
+   the px functions.
+
+   nciop - pointer to the ncio struct. File has been opened.
+*/
+static int
+ncio_mmx_init2(ncio *const nciop)
+{
+	ncio_mmx *const mxp = (ncio_mmx *)nciop->pvt;
+	struct stat sb;
+	void *base;
+
+	assert(nciop->fd >= 0);
+
+	if(fstat(nciop->fd, &sb) < 0)
+		return errno;
+	if(sb.st_size <= 0 || (off_t)(size_t)sb.st_size != sb.st_size)
+		return EINVAL;
+
+	base = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_SHARED,
+		nciop->fd, 0);
+	if(base == MAP_FAILED)
+		return errno;
+
+	(void) madvise(base, (size_t)sb.st_size, MADV_SEQUENTIAL);
+
+	*((ncio_relfunc **)&nciop->rel) = ncio_mmx_rel; /* cast away const */
+	*((ncio_getfunc **)&nciop->get) = ncio_mmx_get; /* cast away const */
+	*((ncio_movefunc **)&nciop->move) = ncio_mmx_move; /* cast away const */
+	*((ncio_syncfunc **)&nciop->sync) = ncio_mmx_sync; /* cast away const */
+	*((ncio_freefunc **)&nciop->free) = ncio_mmx_free; /* cast away const */
+
+	mxp->base = base;
+	mxp->size = (size_t)sb.st_size;
+	mxp->bf_base = NULL;
+	mxp->bf_extent = 0;
+
+	return ENOERR;
+}
+
+/* End mmx */
+#endif /* HAVE_MMAP && HAVE_SYS_MMAN_H */
+
+
 /* */
 
 /* This will call whatever free function is attached to the free
@@ -1381,6 +1616,11 @@ ncio_new(const char *path, int ioflags)
 		sz_ncio_pvt = sizeof(ncio_spx);
 	else
 		sz_ncio_pvt = sizeof(ncio_px);
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+	/* read-only opens may switch to ncio_mmx in ncio_open */
+	if(sz_ncio_pvt < sizeof(ncio_mmx))
+		sz_ncio_pvt = sizeof(ncio_mmx);
+#endif
 
 	nciop = (ncio *) malloc(sz_ncio + sz_path + sz_ncio_pvt);
 	if(nciop == NULL)
@@ -1615,6 +1855,11 @@ ncio_open(const char *path,
 
 	if(fIsSet(nciop->ioflags, NC_SHARE))
 		status = ncio_spx_init2(nciop, sizehintp);
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+	else if(!fIsSet(nciop->ioflags, NC_WRITE) &&
+		ncio_mmx_init2(nciop) == ENOERR)
+		status = ENOERR;
+#endif
 	else
 		status = ncio_px_init2(nciop, sizehintp, 0);
 
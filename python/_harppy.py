@@ -958,6 +958,12 @@ def _import_product_metadata(c_metadata):
     if c_metadata.history:
         metadata['history'] = _decode_string(_ffi.string(c_metadata.history))
 
+    if not numpy.isnan(c_metadata.latitude_min):
+        metadata['latitude_min'] = c_metadata.latitude_min
+        metadata['latitude_max'] = c_metadata.latitude_max
+        metadata['longitude_min'] = c_metadata.longitude_min
+        metadata['longitude_max'] = c_metadata.longitude_max
+
     return metadata
 
 
@@ -1370,6 +1376,8 @@ def import_product_metadata(filename, options=""):
     - datetime_stop
     - dimension lengths for time, latitude, longitude, vertical, and spectral
     - source_product
+    - latitude_min, latitude_max, longitude_min, longitude_max (bounding box;
+      only if it is known)
 
     If the file is not stored using the HARP format then it will try to import
     the metadata using one of the available ingestion modules.
@@ -1393,7 +1401,8 @@ def import_product_metadata(filename, options=""):
         _lib.harp_product_metadata_delete(c_metadata_ptr[0])
 
 
-def export_product(product, filename, file_format="netcdf", operations="", hdf5_compression=0):
+def export_product(product, filename, file_format="netcdf", operations="", hdf5_compression=0, hdf5_chunk_size=0,
+                   hdf5_shuffle=False):
     """Export a HARP compliant product.
 
     Arguments:
@@ -1403,6 +1412,10 @@ def export_product(product, filename, file_format="netcdf", operations="", hdf5_
     operations       -- Actions to apply as part of the export; should be specified as a
                         semi-colon separated string of operations.
     hdf5_compression -- Compression level when exporting to hdf5 (0=disabled, 1=low, ..., 9=high).
+    hdf5_chunk_size  -- Target number of bytes per chunk when exporting to hdf5 with compression;
+                        time dependent variables are chunked along the time dimension
+                        (0=use a single chunk per variable).
+    hdf5_shuffle     -- Apply the shuffle filter before compression when exporting to hdf5.
 
     """
     if not isinstance(product, Product):
@@ -1433,7 +1446,12 @@ def export_product(product, filename, file_format="netcdf", operations="", hdf5_
 
         # Export the C product to a file.
         if file_format == 'hdf5':
-            _lib.harp_set_option_hdf5_compression(int(hdf5_compression))
+            if _lib.harp_set_option_hdf5_compression(int(hdf5_compression)) != 0:
+                raise CLibraryError()
+            if _lib.harp_set_option_hdf5_chunk_size(int(hdf5_chunk_size)) != 0:
+                raise CLibraryError()
+            if _lib.harp_set_option_hdf5_shuffle(1 if hdf5_shuffle else 0) != 0:
+                raise CLibraryError()
         if _lib.harp_export(_encode_path(filename), _encode_string(file_format), c_product_ptr[0]) != 0:
             raise CLibraryError()
 
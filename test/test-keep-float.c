@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2015-2026 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Regression test for harp_set_option_keep_float(): with the option enabled, regridding and rebinning need to give
+ * exactly the (double precision) results of the default mode rounded to float.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "harp.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_TIME 7
+#define NUM_SOURCE_LEVELS 40
+#define NUM_TARGET_LEVELS 23
+
+static int create_product(harp_product **new_product)
+{
+    harp_dimension_type dimension_type[3] = { harp_dimension_time, harp_dimension_vertical,
+        harp_dimension_independent
+    };
+    long dimension[3] = { NUM_TIME, NUM_SOURCE_LEVELS, 2 };
+    harp_variable *altitude;
+    harp_variable *altitude_bounds;
+    harp_variable *temperature;
+    harp_product *product;
+    long i, j;
+
+    if (harp_product_new(&product) != 0)
+    {
+        return -1;
+    }
+    if (harp_variable_new("altitude", harp_type_double, 2, dimension_type, dimension, &altitude) != 0 ||
+        harp_product_add_variable(product, altitude) != 0 || harp_variable_set_unit(altitude, "km") != 0)
+    {
+        harp_product_delete(product);
+        return -1;
+    }
+    if (harp_variable_new("altitude_bounds", harp_type_double, 3, dimension_type, dimension, &altitude_bounds) != 0 ||
+        harp_product_add_variable(product, altitude_bounds) != 0 ||
+        harp_variable_set_unit(altitude_bounds, "km") != 0)
+    {
+        harp_product_delete(product);
+        return -1;
+    }
+    if (harp_variable_new("temperature", harp_type_float, 2, dimension_type, dimension, &temperature) != 0 ||
+        harp_product_add_variable(product, temperature) != 0 || harp_variable_set_unit(temperature, "K") != 0)
+    {
+        harp_product_delete(product);
+        return -1;
+    }
+    for (i = 0; i < NUM_TIME; i++)
+    {
+        for (j = 0; j < NUM_SOURCE_LEVELS; j++)
+        {
+            long index = i * NUM_SOURCE_LEVELS + j;
+            double bottom = 0.1 * i + 1.3 * j;
+
+            altitude->data.double_data[index] = bottom + 0.65;
+            altitude_bounds->data.double_data[2 * index] = bottom;
+            altitude_bounds->data.double_data[2 * index + 1] = bottom + 1.3;
+            temperature->data.float_data[index] = (float)(220.0 + 40.0 * sin(0.37 * j + 0.11 * i) + 1.0 / (j + 3));
+        }
+    }
+
+    *new_product = product;
+
+    return 0;
+}
+
+static int create_target_grid(harp_variable **new_grid, harp_variable **new_bounds)
+{
+    harp_dimension_type dimension_type[2] = { harp_dimension_vertical, harp_dimension_independent };
+    long dimension[2] = { NUM_TARGET_LEVELS, 2 };
+    harp_variable *grid;
+    harp_variable *bounds;
+    long j;
+
+    if (harp_variable_new("altitude", harp_type_double, 1, dimension_type, dimension, &grid) != 0)
+    {
+        return -1;
+    }
+    if (harp_variable_new("altitude_bounds", harp_type_double, 2, dimension_type, dimension, &bounds) != 0)
+    {
+        harp_variable_delete(grid);
+        return -1;
+    }
+    if (harp_variable_set_unit(grid, "km") != 0 || harp_variable_set_unit(bounds, "km") != 0)
+    {
+        harp_variable_delete(grid);
+        harp_variable_delete(bounds);
+        return -1;
+    }
+    for (j = 0; j < NUM_TARGET_LEVELS; j++)
+    {
+        grid->data.double_data[j] = 1.1 + 2.2 * j;
+        bounds->data.double_data[2 * j] = 2.2 * j;
+        bounds->data.double_data[2 * j + 1] = 2.2 * (j + 1);
+    }
+
+    *new_grid = grid;
+    *new_bounds = bounds;
+
+    return 0;
+}
+
+/* returns the number of elements of 'float_variable' that differ from the float rounded values of 'double_variable' */
+static long compare(const char *test_name, const harp_variable *double_variable, const harp_variable *float_variable)
+{
+    long num_differences = 0;
+    long i;
+
+    if (double_variable->data_type != harp_type_double || float_variable->data_type != harp_type_float ||
+        double_variable->num_elements != float_variable->num_elements)
+    {
+        printf("%s: unexpected data type or number of elements of variable '%s'\n", test_name,
+               float_variable->name);
+        return 1;
+    }
+    for (i = 0; i < double_variable->num_elements; i++)
+    {
+        double value = double_variable->data.double_data[i];
+        float float_value = float_variable->data.float_data[i];
+
+        if (harp_isnan(value) ? !harp_isnan(float_value) : float_value != (float)value)
+        {
+            if (num_differences == 0)
+            {
+                printf("%s: element %ld of variable '%s' is %.9g (expected %.9g)\n", test_name, i,
+                       float_variable->name, float_value, (float)value);
+            }
+            num_differences++;
+        }
+    }
+
+    return num_differences;
+}
+
+/* perform the operation on the product with and without the keep_float option and compare the results */
+static int run_test(const char *test_name, int rebin)
+{
+    harp_product *product[2] = { NULL, NULL };
+    harp_variable *temperature[2];
+    harp_variable *grid;
+    harp_variable *bounds;
+    int result = -1;
+    int k;
+
+    if (create_target_grid(&grid, &bounds) != 0)
+    {
+        return -1;
+    }
+    for (k = 0; k < 2; k++)
+    {
+        if (create_product(&product[k]) != 0)
+        {
+            goto done;
+        }
+        harp_set_option_keep_float(k);
+        if (rebin)
+        {
+            if (harp_product_rebin_with_axis_bounds_variable(product[k], bounds) != 0)
+            {
+                goto done;
+            }
+        }
+        else if (harp_product_regrid_with_axis_variable(product[k], grid, bounds) != 0)
+        {
+            goto done;
+        }
+        if (harp_product_get_variable_by_name(product[k], "temperature", &temperature[k]) != 0)
+        {
+            goto done;
+        }
+    }
+    harp_set_option_keep_float(0);
+
+    result = compare(test_name, temperature[0], temperature[1]) == 0 ? 0 : 1;
+    printf("%s: %s\n", test_name, result == 0 ? "ok" : "FAILED");
+
+  done:
+    harp_set_option_keep_float(0);
+    for (k = 0; k < 2; k++)
+    {
+        if (product[k] != NULL)
+        {
+            harp_product_delete(product[k]);
+        }
+    }
+    harp_variable_delete(grid);
+    harp_variable_delete(bounds);
+
+    return result;
+}
+
+int main(void)
+{
+    int num_failures = 0;
+    int result;
+
+    if (harp_init() != 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", harp_errno_to_string(harp_errno));
+        exit(1);
+    }
+
+    result = run_test("regrid", 0);
+    if (result < 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", harp_errno_to_string(harp_errno));
+        harp_done();
+        exit(1);
+    }
+    num_failures += result;
+    result = run_test("rebin", 1);
+    if (result < 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", harp_errno_to_string(harp_errno));
+        harp_done();
+        exit(1);
+    }
+    num_failures += result;
+
+    harp_done();
+
+    return num_failures == 0 ? 0 : 1;
+}
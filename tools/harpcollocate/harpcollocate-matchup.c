@@ -36,13 +36,28 @@
 #include "harp.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <locale.h>
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <sys/stat.h>
+#ifdef WIN32
+#include <io.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#endif
 
-int resample_nearest_a(harp_collocation_result *collocation_result, int difference_index);
-int resample_nearest_b(harp_collocation_result *collocation_result, int difference_index);
+#define CHECKPOINT_LINE_LENGTH 4096
+#define BLOCK_SIZE 1024
 
 typedef struct collocation_criterium_struct
 {
@@ -63,6 +78,32 @@ typedef struct cache_variables_struct
     harp_variable **criterium;  /* references */
 } cache_variables;
 
+/* nearest pair per sample of a product for the -nx/-ny nearest neighbour filters */
+typedef struct nearest_table_struct
+{
+    long num_samples;
+    long first_product_a;       /* position in sorted_index_a of the product from dataset A that was compared first */
+    long *other_position;       /* sample position in the product of the other dataset (-1 if there is no pair) */
+    long *product_index_a;      /* index of the product in dataset A */
+    long *sample_index_a;       /* value of the 'index' variable of the sample from dataset A */
+    long *product_index_b;      /* index of the product in dataset B */
+    long *sample_index_b;       /* value of the 'index' variable of the sample from dataset B */
+    double *difference; /* [num_samples, num_criteria] */
+} nearest_table;
+
+/* state of a thread that compares a range of samples */
+typedef struct match_slice_struct
+{
+    double *difference; /* [num_criteria] */
+    long num_pairs;     /* pairs found by this slice (only used when there is no nearest neighbour filter) */
+    long max_pairs;
+    long *index_a;      /* sample positions in product A */
+    long *index_b;      /* sample positions in product B */
+    double *pair_difference;    /* [max_pairs, num_criteria] */
+    long error_index_a; /* sample positions of the comparison that failed */
+    long error_index_b;
+} match_slice;
+
 typedef struct collocation_info_struct
 {
     /* options */
@@ -85,23 +126,41 @@ typedef struct collocation_info_struct
     int nearest_neighbour_x_criterium_index;
     char *nearest_neighbour_y_variable_name;
     int nearest_neighbour_y_criterium_index;
+    int resume;
+    const char *cache_directory_b;
+    int64_t max_memory_b;       /* maximum size in bytes of the loaded products of dataset B (-1 for no limit) */
 
     /* result */
-    harp_collocation_result *collocation_result;
+    harp_collocation_result *collocation_result;        /* only contains the pairs not yet written to file */
+    const char *output_filename;
+    char *checkpoint_filename;
+    long next_collocation_index;        /* collocation index following the last pair written to file */
 
     /* state */
+    double delta_time;  /* time criterium to efficiently filter for products that could have matching pairs */
+    long num_products_a_done;   /* number of products (from sorted_index_a) that have been compared */
+    long num_products_a_emitted;        /* number of products (from sorted_index_a) with a final nearest table */
+    nearest_table **nearest_a;  /* nearest pair per sample for each product in dataset A (only for -nx) */
+    nearest_table **nearest_b;  /* nearest pair per sample for each product in dataset B (only for -ny) */
     long *sorted_index_a;       /* indices of products sorted by datetime_start/datetime_stop */
     long *sorted_index_b;
     long product_a_index;
     harp_product *product_a;    /* we only have one product of dataset A loaded at any moment */
     harp_product **product_b;   /* for dataset B we may have multiple products loaded */
+    int64_t *product_b_size;    /* size in bytes of each loaded product of dataset B */
+    long *product_b_lru_prev;   /* list of loaded products of dataset B, ordered from least to most recently used */
+    long *product_b_lru_next;
+    long product_b_lru_first;   /* least recently used loaded product of dataset B (-1 if none are loaded) */
+    long product_b_lru_last;    /* most recently used loaded product of dataset B (-1 if none are loaded) */
+    int64_t loaded_size_b;      /* total size in bytes of the loaded products of dataset B */
     harp_dataset *dataset_a;
     harp_dataset *dataset_b;
 
     cache_variables variables_a;
     cache_variables variables_b;
 
-    double *difference;
+    int num_slices;
+    match_slice *slice;
 } collocation_info;
 
 static void collocation_criterium_delete(collocation_criterium *criterium)
@@ -227,6 +286,101 @@ static int collocation_criterium_set_unit(collocation_criterium *criterium, cons
     return 0;
 }
 
+static void nearest_table_delete(nearest_table *table)
+{
+    if (table != NULL)
+    {
+        if (table->other_position != NULL)
+        {
+            free(table->other_position);
+        }
+        if (table->product_index_a != NULL)
+        {
+            free(table->product_index_a);
+        }
+        if (table->sample_index_a != NULL)
+        {
+            free(table->sample_index_a);
+        }
+        if (table->product_index_b != NULL)
+        {
+            free(table->product_index_b);
+        }
+        if (table->sample_index_b != NULL)
+        {
+            free(table->sample_index_b);
+        }
+        if (table->difference != NULL)
+        {
+            free(table->difference);
+        }
+        free(table);
+    }
+}
+
+static int nearest_table_new(long num_samples, int num_criteria, long first_product_a, nearest_table **new_table)
+{
+    nearest_table *table;
+    long i;
+
+    assert(num_samples > 0);
+
+    table = (nearest_table *)malloc(sizeof(nearest_table));
+    if (table == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(nearest_table), __FILE__, __LINE__);
+        return -1;
+    }
+    table->num_samples = num_samples;
+    table->first_product_a = first_product_a;
+    table->other_position = malloc(num_samples * sizeof(long));
+    table->product_index_a = malloc(num_samples * sizeof(long));
+    table->sample_index_a = malloc(num_samples * sizeof(long));
+    table->product_index_b = malloc(num_samples * sizeof(long));
+    table->sample_index_b = malloc(num_samples * sizeof(long));
+    table->difference = malloc(num_samples * num_criteria * sizeof(double));
+    if (table->other_position == NULL || table->product_index_a == NULL || table->sample_index_a == NULL ||
+        table->product_index_b == NULL || table->sample_index_b == NULL || table->difference == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_samples * (5 * sizeof(long) + num_criteria * sizeof(double)), __FILE__, __LINE__);
+        nearest_table_delete(table);
+        return -1;
+    }
+    for (i = 0; i < num_samples; i++)
+    {
+        table->other_position[i] = -1;
+    }
+
+    *new_table = table;
+
+    return 0;
+}
+
+/* Store the pair as the pair for the sample at 'position', unless the table already has a pair for that sample
+ * that is at least as near (using the difference at 'criterium_index').
+ */
+static void nearest_table_add(nearest_table *table, long position, long other_position, int criterium_index,
+                              int num_criteria, long product_index_a, long sample_index_a, long product_index_b,
+                              long sample_index_b, const double *difference)
+{
+    assert(position >= 0 && position < table->num_samples);
+
+    if (table->other_position[position] >= 0 &&
+        fabs(table->difference[position * num_criteria + criterium_index]) <= fabs(difference[criterium_index]))
+    {
+        /* existing pair is nearer -> ignore the new pair */
+        return;
+    }
+    table->other_position[position] = other_position;
+    table->product_index_a[position] = product_index_a;
+    table->sample_index_a[position] = sample_index_a;
+    table->product_index_b[position] = product_index_b;
+    table->sample_index_b[position] = sample_index_b;
+    memcpy(&table->difference[position * num_criteria], difference, num_criteria * sizeof(double));
+}
+
 static void collocation_info_delete(collocation_info *info)
 {
     int i;
@@ -256,6 +410,10 @@ static void collocation_info_delete(collocation_info *info)
         {
             harp_collocation_result_delete(info->collocation_result);
         }
+        if (info->checkpoint_filename != NULL)
+        {
+            free(info->checkpoint_filename);
+        }
         if (info->sorted_index_a != NULL)
         {
             free(info->sorted_index_a);
@@ -268,6 +426,22 @@ static void collocation_info_delete(collocation_info *info)
         {
             harp_product_delete(info->product_a);
         }
+        if (info->nearest_a != NULL)
+        {
+            for (i = 0; i < info->dataset_a->num_products; i++)
+            {
+                nearest_table_delete(info->nearest_a[i]);
+            }
+            free(info->nearest_a);
+        }
+        if (info->nearest_b != NULL)
+        {
+            for (i = 0; i < info->dataset_b->num_products; i++)
+            {
+                nearest_table_delete(info->nearest_b[i]);
+            }
+            free(info->nearest_b);
+        }
         if (info->product_b != NULL)
         {
             assert(info->dataset_b != NULL);
@@ -280,6 +454,18 @@ static void collocation_info_delete(collocation_info *info)
             }
             free(info->product_b);
         }
+        if (info->product_b_size != NULL)
+        {
+            free(info->product_b_size);
+        }
+        if (info->product_b_lru_prev != NULL)
+        {
+            free(info->product_b_lru_prev);
+        }
+        if (info->product_b_lru_next != NULL)
+        {
+            free(info->product_b_lru_next);
+        }
         if (info->dataset_a != NULL)
         {
             harp_dataset_delete(info->dataset_a);
@@ -328,9 +514,28 @@ static void collocation_info_delete(collocation_info *info)
         {
             free(info->variables_b.criterium);
         }
-        if (info->difference != NULL)
+        if (info->slice != NULL)
         {
-            free(info->difference);
+            for (i = 0; i < info->num_slices; i++)
+            {
+                if (info->slice[i].difference != NULL)
+                {
+                    free(info->slice[i].difference);
+                }
+                if (info->slice[i].index_a != NULL)
+                {
+                    free(info->slice[i].index_a);
+                }
+                if (info->slice[i].index_b != NULL)
+                {
+                    free(info->slice[i].index_b);
+                }
+                if (info->slice[i].pair_difference != NULL)
+                {
+                    free(info->slice[i].pair_difference);
+                }
+            }
+            free(info->slice);
         }
         free(info);
     }
@@ -366,12 +571,29 @@ static int collocation_info_new(collocation_info **new_info)
     info->nearest_neighbour_x_criterium_index = -1;
     info->nearest_neighbour_y_variable_name = NULL;
     info->nearest_neighbour_y_criterium_index = -1;
+    info->resume = 0;
+    info->cache_directory_b = NULL;
+    info->max_memory_b = -1;
     info->collocation_result = NULL;
+    info->output_filename = NULL;
+    info->checkpoint_filename = NULL;
+    info->next_collocation_index = 0;
+    info->delta_time = 0;
+    info->num_products_a_done = 0;
+    info->num_products_a_emitted = 0;
+    info->nearest_a = NULL;
+    info->nearest_b = NULL;
     info->sorted_index_a = NULL;
     info->sorted_index_b = NULL;
     info->product_a_index = -1;
     info->product_a = NULL;
     info->product_b = NULL;
+    info->product_b_size = NULL;
+    info->product_b_lru_prev = NULL;
+    info->product_b_lru_next = NULL;
+    info->product_b_lru_first = -1;
+    info->product_b_lru_last = -1;
+    info->loaded_size_b = 0;
     info->dataset_a = NULL;
     info->dataset_b = NULL;
     info->variables_a.index = NULL;
@@ -386,7 +608,8 @@ static int collocation_info_new(collocation_info **new_info)
     info->variables_b.latitude_bounds = NULL;
     info->variables_b.longitude_bounds = NULL;
     info->variables_b.criterium = NULL;
-    info->difference = NULL;
+    info->num_slices = 0;
+    info->slice = NULL;
 
     if (harp_dataset_new(&info->dataset_a) != 0)
     {
@@ -699,9 +922,63 @@ static int collocation_info_update(collocation_info *info)
                            info->dataset_b->num_products * sizeof(harp_product *), __FILE__, __LINE__);
             return -1;
         }
+        info->product_b_size = malloc(info->dataset_b->num_products * sizeof(int64_t));
+        if (info->product_b_size == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           info->dataset_b->num_products * sizeof(int64_t), __FILE__, __LINE__);
+            return -1;
+        }
+        info->product_b_lru_prev = malloc(info->dataset_b->num_products * sizeof(long));
+        if (info->product_b_lru_prev == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           info->dataset_b->num_products * sizeof(long), __FILE__, __LINE__);
+            return -1;
+        }
+        info->product_b_lru_next = malloc(info->dataset_b->num_products * sizeof(long));
+        if (info->product_b_lru_next == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           info->dataset_b->num_products * sizeof(long), __FILE__, __LINE__);
+            return -1;
+        }
         for (i = 0; i < info->dataset_b->num_products; i++)
         {
             info->product_b[i] = NULL;
+            info->product_b_size[i] = 0;
+            info->product_b_lru_prev[i] = -1;
+            info->product_b_lru_next[i] = -1;
+        }
+    }
+
+    /* initialize the nearest neighbour tables (these are created per product once the product is compared) */
+    if (info->nearest_neighbour_x_criterium_index >= 0 && info->dataset_a->num_products > 0)
+    {
+        info->nearest_a = malloc(info->dataset_a->num_products * sizeof(nearest_table *));
+        if (info->nearest_a == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           info->dataset_a->num_products * sizeof(nearest_table *), __FILE__, __LINE__);
+            return -1;
+        }
+        for (i = 0; i < info->dataset_a->num_products; i++)
+        {
+            info->nearest_a[i] = NULL;
+        }
+    }
+    if (info->nearest_neighbour_y_criterium_index >= 0 && info->dataset_b->num_products > 0)
+    {
+        info->nearest_b = malloc(info->dataset_b->num_products * sizeof(nearest_table *));
+        if (info->nearest_b == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           info->dataset_b->num_products * sizeof(nearest_table *), __FILE__, __LINE__);
+            return -1;
+        }
+        for (i = 0; i < info->dataset_b->num_products; i++)
+        {
+            info->nearest_b[i] = NULL;
         }
     }
 
@@ -785,29 +1062,44 @@ static int collocation_info_update(collocation_info *info)
         info->variables_b.criterium[i] = NULL;
     }
 
-    /* initialize array in which the differences are stored */
-    info->difference = malloc(info->num_criteria * sizeof(double));
-    if (info->difference == NULL)
+    /* initialize the state per thread (including the array in which the differences are stored) */
+    info->num_slices = 1;
+#ifdef _OPENMP
+    info->num_slices = harp_get_option_num_threads() > 0 ? harp_get_option_num_threads() : omp_get_max_threads();
+#endif
+    info->slice = malloc(info->num_slices * sizeof(match_slice));
+    if (info->slice == NULL)
     {
         harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       (info->num_criteria) * sizeof(double), __FILE__, __LINE__);
+                       info->num_slices * sizeof(match_slice), __FILE__, __LINE__);
+        info->num_slices = 0;
         return -1;
     }
-
-    return 0;
-}
-
-static void reindex_collocation_indices(harp_collocation_result *collocation_result)
-{
-    long i;
-
-    for (i = 0; i < collocation_result->num_pairs; i++)
+    for (i = 0; i < info->num_slices; i++)
     {
-        collocation_result->pair[i]->collocation_index = i;
+        info->slice[i].num_pairs = 0;
+        info->slice[i].max_pairs = 0;
+        info->slice[i].index_a = NULL;
+        info->slice[i].index_b = NULL;
+        info->slice[i].pair_difference = NULL;
+        info->slice[i].error_index_a = -1;
+        info->slice[i].error_index_b = -1;
+        info->slice[i].difference = malloc(info->num_criteria * sizeof(double));
+        if (info->slice[i].difference == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (info->num_criteria) * sizeof(double), __FILE__, __LINE__);
+            return -1;
+        }
     }
+
+    return 0;
 }
 
-static int perform_matchup_on_measurements(collocation_info *info, long index_a, long product_b_index, long index_b)
+/* Returns 1 if the measurements match, 0 if they do not match, and -1 on error. The differences for all criteria are
+ * stored in 'difference'.
+ */
+static int match_measurements(collocation_info *info, long index_a, long index_b, double *difference)
 {
     double *longitude_bounds_a;
     double *latitude_bounds_a;
@@ -817,7 +1109,6 @@ static int perform_matchup_on_measurements(collocation_info *info, long index_a,
     double longitude_a;
     double latitude_b;
     double longitude_b;
-    long collocation_index;
     int num_vertices_a;
     int num_vertices_b;
     int i;
@@ -831,43 +1122,43 @@ static int perform_matchup_on_measurements(collocation_info *info, long index_a,
             latitude_b = info->variables_b.latitude->data.double_data[index_b];
             longitude_b = info->variables_b.longitude->data.double_data[index_b];
 
-            if (harp_geometry_get_point_distance(latitude_a, longitude_a, latitude_b, longitude_b, &info->difference[i])
+            if (harp_geometry_get_point_distance(latitude_a, longitude_a, latitude_b, longitude_b, &difference[i])
                 != 0)
             {
                 return -1;
             }
-            info->difference[i] *= info->point_distance_conversion_factor;
+            difference[i] *= info->point_distance_conversion_factor;
         }
         else
         {
-            info->difference[i] = info->variables_a.criterium[i]->data.double_data[index_a] -
+            difference[i] = info->variables_a.criterium[i]->data.double_data[index_a] -
                 info->variables_b.criterium[i]->data.double_data[index_b];
             if (i == info->datetime_index)
             {
-                info->difference[i] *= info->datetime_conversion_factor;
+                difference[i] *= info->datetime_conversion_factor;
             }
         }
         if (info->criterium[i]->use_modulo)
         {
-            while (info->difference[i] > info->criterium[i]->modulo_value)
+            while (difference[i] > info->criterium[i]->modulo_value)
             {
-                info->difference[i] -= info->criterium[i]->modulo_value;
+                difference[i] -= info->criterium[i]->modulo_value;
             }
-            if (info->difference[i] > info->criterium[i]->modulo_value / 2)
+            if (difference[i] > info->criterium[i]->modulo_value / 2)
             {
-                info->difference[i] = info->criterium[i]->modulo_value - info->difference[i];
+                difference[i] = info->criterium[i]->modulo_value - difference[i];
             }
-            while (info->difference[i] < -info->criterium[i]->modulo_value)
+            while (difference[i] < -info->criterium[i]->modulo_value)
             {
-                info->difference[i] += info->criterium[i]->modulo_value;
+                difference[i] += info->criterium[i]->modulo_value;
             }
-            if (info->difference[i] < -info->criterium[i]->modulo_value / 2)
+            if (difference[i] < -info->criterium[i]->modulo_value / 2)
             {
-                info->difference[i] = -info->criterium[i]->modulo_value - info->difference[i];
+                difference[i] = -info->criterium[i]->modulo_value - difference[i];
             }
         }
         /* we use !(x<=y) instead of x>y so a NaN value for the difference will also result in a mismatch */
-        if (!(fabs(info->difference[i]) <= info->criterium[i]->value))
+        if (!(fabs(difference[i]) <= info->criterium[i]->value))
         {
             return 0;
         }
@@ -933,136 +1224,205 @@ static int perform_matchup_on_measurements(collocation_info *info, long index_a,
         }
     }
 
-    if (info->nearest_neighbour_x_criterium_index >= 0 || info->nearest_neighbour_y_criterium_index >= 0)
+    return 1;
+}
+
+static int add_slice_pair(match_slice *slice, int num_criteria, long index_a, long index_b)
+{
+    if (slice->num_pairs == slice->max_pairs)
     {
-        long product_index;
-        long sample_index;
+        long max_pairs = (slice->max_pairs == 0 ? BLOCK_SIZE : 2 * slice->max_pairs);
+        double *pair_difference;
+        long *index;
 
-        /* replace any pair that is not closer for the first nearest neighbour criterium */
-        /* since we apply a nearest filter there can only be at most one pair in the collocation result matching */
-        /* the index we are looking for */
-        if (info->perform_nearest_neighbour_x_first)
+        index = realloc(slice->index_a, max_pairs * sizeof(long));
+        if (index == NULL)
         {
-            /* select nearest x */
-            assert(info->nearest_neighbour_x_criterium_index >= 0);
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           max_pairs * sizeof(long), __FILE__, __LINE__);
+            return -1;
+        }
+        slice->index_a = index;
+        index = realloc(slice->index_b, max_pairs * sizeof(long));
+        if (index == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           max_pairs * sizeof(long), __FILE__, __LINE__);
+            return -1;
+        }
+        slice->index_b = index;
+        pair_difference = realloc(slice->pair_difference, max_pairs * num_criteria * sizeof(double));
+        if (pair_difference == NULL)
+        {
+            harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           max_pairs * num_criteria * sizeof(double), __FILE__, __LINE__);
+            return -1;
+        }
+        slice->pair_difference = pair_difference;
+        slice->max_pairs = max_pairs;
+    }
+    slice->index_a[slice->num_pairs] = index_a;
+    slice->index_b[slice->num_pairs] = index_b;
+    memcpy(&slice->pair_difference[slice->num_pairs * num_criteria], slice->difference,
+           num_criteria * sizeof(double));
+    slice->num_pairs++;
+
+    return 0;
+}
+
+static int perform_matchup_on_measurements(collocation_info *info, match_slice *slice, long index_a,
+                                           long product_b_index, long index_b)
+{
+    int result;
+
+    result = match_measurements(info, index_a, index_b, slice->difference);
+    if (result <= 0)
+    {
+        return result;
+    }
+
+    if (info->perform_nearest_neighbour_x_first)
+    {
+        /* only keep the nearest sample from dataset B for each sample from dataset A */
+        nearest_table_add(info->nearest_a[info->product_a_index], index_a, index_b,
+                          info->nearest_neighbour_x_criterium_index, info->num_criteria, info->product_a_index,
+                          info->variables_a.index->data.int32_data[index_a], product_b_index,
+                          info->variables_b.index->data.int32_data[index_b], slice->difference);
+        return 0;
+    }
+    if (info->nearest_neighbour_y_criterium_index >= 0)
+    {
+        /* only keep the nearest sample from dataset A for each sample from dataset B */
+        nearest_table_add(info->nearest_b[product_b_index], index_b, index_a,
+                          info->nearest_neighbour_y_criterium_index, info->num_criteria, info->product_a_index,
+                          info->variables_a.index->data.int32_data[index_a], product_b_index,
+                          info->variables_b.index->data.int32_data[index_b], slice->difference);
+        return 0;
+    }
+
+    return add_slice_pair(slice, info->num_criteria, index_a, index_b);
+}
+
+/* Compare a range of samples against all samples of the other product.
+ * The range is taken from dataset B if the first nearest neighbour filter selects per sample of dataset B and from
+ * dataset A otherwise, such that each slice only updates its own entries of the nearest tables.
+ */
+static int perform_matchup_on_slice(collocation_info *info, match_slice *slice, long product_b_index, int split_on_b,
+                                    long offset, long length)
+{
+    long num_samples_a = info->product_a->dimension[harp_dimension_time];
+    long num_samples_b = info->product_b[product_b_index]->dimension[harp_dimension_time];
+    long i, j;
 
-            if (harp_dataset_has_product(info->collocation_result->dataset_a, info->product_a->source_product))
+    slice->num_pairs = 0;
+    slice->error_index_a = -1;
+    slice->error_index_b = -1;
+    if (split_on_b)
+    {
+        for (j = offset; j < offset + length; j++)
+        {
+            for (i = 0; i < num_samples_a; i++)
             {
-                if (harp_dataset_get_index_from_source_product(info->collocation_result->dataset_a,
-                                                               info->product_a->source_product, &product_index) != 0)
+                if (perform_matchup_on_measurements(info, slice, i, product_b_index, j) != 0)
                 {
+                    slice->error_index_a = i;
+                    slice->error_index_b = j;
                     return -1;
                 }
-                sample_index = info->variables_a.index->data.int32_data[index_a];
-
-                for (i = 0; i < info->collocation_result->num_pairs; i++)
-                {
-                    harp_collocation_pair *pair = info->collocation_result->pair[i];
-
-                    if (pair->product_index_a == product_index && pair->sample_index_a == sample_index)
-                    {
-                        if (fabs(pair->difference[info->nearest_neighbour_x_criterium_index]) <=
-                            fabs(info->difference[info->nearest_neighbour_x_criterium_index]))
-                        {
-                            /* existing pair is closer -> ignore the new pair */
-                            return 0;
-                        }
-                        /* new pair is closer, remove existing one */
-                        if (harp_collocation_result_remove_pair_at_index(info->collocation_result, i) != 0)
-                        {
-                            return -1;
-                        }
-                        /* stop the search and immediately continue with adding the new pair */
-                        break;
-                    }
-                }
             }
         }
-        else
+    }
+    else
+    {
+        for (i = offset; i < offset + length; i++)
         {
-            /* select nearest y */
-            assert(info->nearest_neighbour_y_criterium_index >= 0);
-
-            if (harp_dataset_has_product(info->collocation_result->dataset_b,
-                                         info->product_b[product_b_index]->source_product))
+            for (j = 0; j < num_samples_b; j++)
             {
-                if (harp_dataset_get_index_from_source_product(info->collocation_result->dataset_b,
-                                                               info->product_b[product_b_index]->source_product,
-                                                               &product_index) != 0)
+                if (perform_matchup_on_measurements(info, slice, i, product_b_index, j) != 0)
                 {
+                    slice->error_index_a = i;
+                    slice->error_index_b = j;
                     return -1;
                 }
-                sample_index = info->variables_b.index->data.int32_data[index_b];
-
-                for (i = 0; i < info->collocation_result->num_pairs; i++)
-                {
-                    harp_collocation_pair *pair = info->collocation_result->pair[i];
-
-                    if (pair->product_index_b == product_index && pair->sample_index_b == sample_index)
-                    {
-                        if (fabs(pair->difference[info->nearest_neighbour_y_criterium_index]) <=
-                            fabs(info->difference[info->nearest_neighbour_y_criterium_index]))
-                        {
-                            /* existing pair is closer -> ignore the new pair */
-                            return 0;
-                        }
-                        /* new pair is closer, remove existing one */
-                        if (harp_collocation_result_remove_pair_at_index(info->collocation_result, i) != 0)
-                        {
-                            return -1;
-                        }
-                        /* stop the search and immediately continue with adding the new pair */
-                        break;
-                    }
-                }
             }
         }
-        /* the second nearest neighbour criterium, if it exists, can only be avaluated at the end of the collocation */
     }
 
-    /* add new pair to result */
-    if (info->collocation_result->num_pairs == 0)
-    {
-        collocation_index = 0;
-    }
-    else
+    return 0;
+}
+
+/* The samples are split over the available threads. Pairs found by a slice are added to the collocation result in
+ * slice order afterwards, so the result (including the collocation indices) does not depend on the number of threads.
+ */
+static int perform_matchup_on_products(collocation_info *info, long product_b_index)
+{
+    int split_on_b = !info->perform_nearest_neighbour_x_first && info->nearest_neighbour_y_criterium_index >= 0;
+    long num_samples;
+    int num_slices;
+    int failed = 0;
+    int i;
+
+    num_samples = (split_on_b ? info->product_b[product_b_index] : info->product_a)->dimension[harp_dimension_time];
+    if (num_samples == 0)
     {
-        collocation_index =
-            info->collocation_result->pair[info->collocation_result->num_pairs - 1]->collocation_index + 1;
+        /* nothing to match (and OpenMP does not allow a team of zero threads) */
+        return 0;
     }
-    if (harp_collocation_result_add_pair(info->collocation_result, collocation_index, info->product_a->source_product,
-                                         info->variables_a.index->data.int32_data[index_a],
-                                         info->product_b[product_b_index]->source_product,
-                                         info->variables_b.index->data.int32_data[index_b], info->num_criteria,
-                                         info->difference) != 0)
+    num_slices = info->num_slices;
+    if (num_slices > num_samples)
     {
-        return -1;
+        num_slices = (int)num_samples;
     }
 
-    return 0;
-}
+#pragma omp parallel for reduction(|:failed) schedule(static) num_threads(num_slices)
+    for (i = 0; i < num_slices; i++)
+    {
+        long offset = num_samples * i / num_slices;
+        long length = num_samples * (i + 1) / num_slices - offset;
 
-static int perform_matchup_on_products(collocation_info *info, long product_b_index)
-{
-    long i, j;
+        if (perform_matchup_on_slice(info, &info->slice[i], product_b_index, split_on_b, offset, length) != 0)
+        {
+            failed |= 1;
+        }
+    }
 
-    for (i = 0; i < info->product_a->dimension[harp_dimension_time]; i++)
+    for (i = 0; i < num_slices; i++)
     {
-        for (j = 0; j < info->product_b[product_b_index]->dimension[harp_dimension_time]; j++)
+        match_slice *slice = &info->slice[i];
+        long j;
+
+        if (failed)
         {
-            if (perform_matchup_on_measurements(info, i, product_b_index, j) != 0)
+            if (slice->error_index_a >= 0)
             {
                 harp_add_error_message(" (comparing %s [index=%ld] against %s [index=%ld])",
                                        info->dataset_a->metadata[info->product_a_index]->filename,
-                                       info->variables_a.index->data.int32_data[i],
+                                       info->variables_a.index->data.int32_data[slice->error_index_a],
                                        info->dataset_b->metadata[product_b_index]->filename,
-                                       info->variables_b.index->data.int32_data[j]);
+                                       info->variables_b.index->data.int32_data[slice->error_index_b]);
+                return -1;
+            }
+            continue;
+        }
+
+        /* add the pairs of this slice to the result */
+        for (j = 0; j < slice->num_pairs; j++)
+        {
+            if (harp_collocation_result_add_pair(info->collocation_result, info->next_collocation_index,
+                                                 info->product_a->source_product,
+                                                 info->variables_a.index->data.int32_data[slice->index_a[j]],
+                                                 info->product_b[product_b_index]->source_product,
+                                                 info->variables_b.index->data.int32_data[slice->index_b[j]],
+                                                 info->num_criteria, &slice->pair_difference[j * info->num_criteria])
+                != 0)
+            {
                 return -1;
             }
+            info->next_collocation_index++;
         }
     }
 
-    return 0;
+    return failed ? -1 : 0;
 }
 
 static int remove_unused_variables(collocation_info *info, harp_product *product, int include_latlon,
@@ -1280,50 +1640,450 @@ static int filter_product(collocation_info *info, harp_product *product, int is_
     return 0;
 }
 
-static int assign_variables(collocation_info *info, cache_variables *cache, harp_product *product)
+static int string_append(char **string, long *length, const char *part)
 {
-    harp_dimension_type dimension_type[2] = { harp_dimension_time, harp_dimension_independent };
-    harp_data_type data_type = harp_type_double;
-    long i;
+    long part_length = (long)strlen(part);
+    char *new_string;
 
-    if (harp_product_get_variable_by_name(product, "index", &cache->index) != 0)
+    new_string = realloc(*string, *length + part_length + 1);
+    if (new_string == NULL)
     {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       *length + part_length + 1, __FILE__, __LINE__);
         return -1;
     }
+    memcpy(&new_string[*length], part, part_length + 1);
+    *string = new_string;
+    *length += part_length;
 
-    if (harp_product_has_variable(product, "latitude"))
+    return 0;
+}
+
+/* The cache key of a product from dataset B identifies the source file (path, size, modification time), the
+ * ingestion options and operations, and the set of variables that is kept by filter_product().
+ */
+static int get_cache_key(collocation_info *info, long index_b, char **new_key)
+{
+    const char *filename = info->dataset_b->metadata[index_b]->filename;
+    struct stat statbuf;
+    char buffer[100];
+    char *key = NULL;
+    long length = 0;
+    int i;
+
+    if (stat(filename, &statbuf) != 0)
     {
-        if (cache->latitude != NULL)
-        {
-            harp_variable_delete(cache->latitude);
-        }
-        if (cache->longitude != NULL)
-        {
-            harp_variable_delete(cache->longitude);
-        }
-        if (harp_product_get_derived_variable(product, "latitude", &data_type, HARP_UNIT_LATITUDE, 1, dimension_type,
-                                              &cache->latitude) != 0)
-        {
-            return -1;
-        }
-        if (harp_product_get_derived_variable(product, "longitude", &data_type, HARP_UNIT_LONGITUDE, 1, dimension_type,
-                                              &cache->longitude) != 0)
-        {
-            return -1;
-        }
+        harp_set_error(HARP_ERROR_FILE_NOT_FOUND, "could not find %s", filename);
+        return -1;
     }
-    if (harp_product_has_variable(product, "latitude_bounds"))
+
+    sprintf(buffer, "\nsize=%ld\nmtime=%ld\noptions=", (long)statbuf.st_size, (long)statbuf.st_mtime);
+    if (string_append(&key, &length, "file=") != 0 || string_append(&key, &length, filename) != 0 ||
+        string_append(&key, &length, buffer) != 0 ||
+        string_append(&key, &length, info->ingest_options_b == NULL ? "" : info->ingest_options_b) != 0 ||
+        string_append(&key, &length, "\noperations=") != 0 ||
+        string_append(&key, &length, info->operations_b == NULL ? "" : info->operations_b) != 0)
     {
-        if (cache->latitude_bounds != NULL)
-        {
-            harp_variable_delete(cache->latitude_bounds);
-        }
-        if (cache->longitude_bounds != NULL)
+        if (key != NULL)
         {
-            harp_variable_delete(cache->longitude_bounds);
+            free(key);
         }
-        if (harp_product_get_derived_variable(product, "latitude_bounds", &data_type, HARP_UNIT_LATITUDE, 2,
-                                              dimension_type, &cache->latitude_bounds) != 0)
+        return -1;
+    }
+    for (i = 0; i < info->num_criteria; i++)
+    {
+        if (string_append(&key, &length, "\ncriterium=") != 0 ||
+            string_append(&key, &length, info->criterium[i]->variable_name) != 0 ||
+            string_append(&key, &length, " [") != 0 ||
+            string_append(&key, &length, info->criterium[i]->unit == NULL ? "" : info->criterium[i]->unit) != 0 ||
+            string_append(&key, &length, "]") != 0)
+        {
+            free(key);
+            return -1;
+        }
+    }
+    sprintf(buffer, "\nlatlon=%d\nlatlon_bounds=%d\n", info->point_distance_index >= 0 || info->filter_point_in_area_yx,
+            info->filter_area_intersects || info->filter_point_in_area_xy);
+    if (string_append(&key, &length, buffer) != 0)
+    {
+        free(key);
+        return -1;
+    }
+
+    *new_key = key;
+
+    return 0;
+}
+
+/* Base name (without extension) of the cache files for a key, based on a 64-bit FNV-1a hash of the key */
+static void get_cache_name(const char *key, char *name)
+{
+    uint64_t hash = ((uint64_t)0xCBF29CE4UL << 32) | 0x84222325UL;
+    uint64_t prime = ((uint64_t)0x100UL << 32) | 0x000001B3UL;
+
+    while (*key != '\0')
+    {
+        hash ^= (unsigned char)*key;
+        hash *= prime;
+        key++;
+    }
+
+    sprintf(name, "%08lx%08lx", (unsigned long)(hash >> 32), (unsigned long)(hash & 0xFFFFFFFFUL));
+}
+
+/* Returns 1 if the cache contains an entry for the key, 0 if not, and -1 on error.
+ * The key file ends with a line that records whether the cached product was empty (in which case there is no product
+ * file). The key file is written last when storing an entry, so a matching key file implies a complete product file.
+ */
+static int has_cache_entry(const char *key_filename, const char *key, int *is_empty)
+{
+    long key_length = (long)strlen(key);
+    char *buffer;
+    FILE *file;
+    long length;
+
+    file = fopen(key_filename, "rb");
+    if (file == NULL)
+    {
+        return 0;
+    }
+    buffer = malloc(key_length + 10);
+    if (buffer == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       key_length + 10, __FILE__, __LINE__);
+        fclose(file);
+        return -1;
+    }
+    length = (long)fread(buffer, 1, key_length + 9, file);
+    fclose(file);
+    if (length != key_length + 8 || memcmp(buffer, key, key_length) != 0)
+    {
+        /* different product with the same hash or a different version of the same product */
+        free(buffer);
+        return 0;
+    }
+    if (memcmp(&buffer[key_length], "empty=0\n", 8) == 0)
+    {
+        *is_empty = 0;
+    }
+    else if (memcmp(&buffer[key_length], "empty=1\n", 8) == 0)
+    {
+        *is_empty = 1;
+    }
+    else
+    {
+        free(buffer);
+        return 0;
+    }
+    free(buffer);
+
+    return 1;
+}
+
+/* Store the reduced product in the cache. Failures are reported as a warning since the cache is only an optimization.
+ * Both files are first written under a process specific name and then renamed, so concurrent runs that share a cache
+ * directory never see partially written entries.
+ */
+static void store_cache_entry(const char *product_filename, const char *key_filename, const char *key,
+                              const harp_product *product)
+{
+    char *tmp_filename;
+    FILE *file;
+
+    tmp_filename = malloc(strlen(product_filename) + 32);
+    if (tmp_filename == NULL)
+    {
+        harp_report_warning("could not store product in cache (out of memory)");
+        return;
+    }
+
+    /* remove any stale key first, so the entry is never considered valid while the product file is replaced */
+    remove(key_filename);
+
+    if (harp_product_is_empty(product))
+    {
+        /* don't leave the product file of a previous entry behind */
+        remove(product_filename);
+    }
+    else
+    {
+        sprintf(tmp_filename, "%s.%ld.tmp", product_filename, (long)getpid());
+        if (harp_export(tmp_filename, "netcdf", product) != 0)
+        {
+            harp_report_warning("could not store product in cache (%s)", harp_errno_to_string(harp_errno));
+            remove(tmp_filename);
+            free(tmp_filename);
+            return;
+        }
+        remove(product_filename);
+        if (rename(tmp_filename, product_filename) != 0)
+        {
+            harp_report_warning("could not store product in cache (could not rename %s)", tmp_filename);
+            remove(tmp_filename);
+            free(tmp_filename);
+            return;
+        }
+    }
+
+    sprintf(tmp_filename, "%s.%ld.tmp", key_filename, (long)getpid());
+    file = fopen(tmp_filename, "wb");
+    if (file == NULL)
+    {
+        harp_report_warning("could not store product in cache (could not create %s)", tmp_filename);
+        free(tmp_filename);
+        return;
+    }
+    if (fwrite(key, 1, strlen(key), file) != strlen(key) ||
+        fputs(harp_product_is_empty(product) ? "empty=1\n" : "empty=0\n", file) == EOF || fclose(file) != 0)
+    {
+        harp_report_warning("could not store product in cache (could not write %s)", tmp_filename);
+        remove(tmp_filename);
+        free(tmp_filename);
+        return;
+    }
+    remove(key_filename);
+    if (rename(tmp_filename, key_filename) != 0)
+    {
+        harp_report_warning("could not store product in cache (could not rename %s)", tmp_filename);
+        remove(tmp_filename);
+    }
+    free(tmp_filename);
+}
+
+/* Import a product from dataset B and reduce it to the variables needed for the collocation.
+ * If a cache directory is set, the reduced product is taken from the cache (and stored there if it was not).
+ * An empty product is cached as a key file (that records that the product was empty) without product file.
+ */
+static int import_product_b(collocation_info *info, long index_b)
+{
+    char cache_name[17];
+    char *product_filename;
+    char *key_filename;
+    char *key;
+    int is_empty;
+    int result;
+
+    if (info->cache_directory_b == NULL)
+    {
+        if (harp_import(info->dataset_b->metadata[index_b]->filename, info->operations_b, info->ingest_options_b,
+                        &info->product_b[index_b]) != 0)
+        {
+            return -1;
+        }
+        if (harp_product_is_empty(info->product_b[index_b]))
+        {
+            return 0;
+        }
+        return filter_product(info, info->product_b[index_b], 0);
+    }
+
+    if (get_cache_key(info, index_b, &key) != 0)
+    {
+        return -1;
+    }
+    product_filename = malloc(strlen(info->cache_directory_b) + 21);
+    key_filename = malloc(strlen(info->cache_directory_b) + 22);
+    if (product_filename == NULL || key_filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(strlen(info->cache_directory_b) + 22), __FILE__, __LINE__);
+        if (product_filename != NULL)
+        {
+            free(product_filename);
+        }
+        if (key_filename != NULL)
+        {
+            free(key_filename);
+        }
+        free(key);
+        return -1;
+    }
+    get_cache_name(key, cache_name);
+    sprintf(product_filename, "%s/%s.nc", info->cache_directory_b, cache_name);
+    sprintf(key_filename, "%s/%s.key", info->cache_directory_b, cache_name);
+
+    result = has_cache_entry(key_filename, key, &is_empty);
+    if (result == 1)
+    {
+        if (is_empty)
+        {
+            result = harp_product_new(&info->product_b[index_b]);
+        }
+        else if (harp_import(product_filename, NULL, NULL, &info->product_b[index_b]) == 0)
+        {
+            /* a cached product has already been filtered (this only makes sure the criteria units are initialized) */
+            result = filter_product(info, info->product_b[index_b], 0);
+        }
+        else
+        {
+            result = -1;
+        }
+    }
+    else if (result == 0)
+    {
+        if (harp_import(info->dataset_b->metadata[index_b]->filename, info->operations_b, info->ingest_options_b,
+                        &info->product_b[index_b]) != 0)
+        {
+            result = -1;
+        }
+        else if (!harp_product_is_empty(info->product_b[index_b]) &&
+                 filter_product(info, info->product_b[index_b], 0) != 0)
+        {
+            result = -1;
+        }
+        else
+        {
+            store_cache_entry(product_filename, key_filename, key, info->product_b[index_b]);
+        }
+    }
+
+    free(product_filename);
+    free(key_filename);
+    free(key);
+
+    return result;
+}
+
+static int64_t get_product_size(const harp_product *product)
+{
+    int64_t size = 0;
+    int i;
+
+    for (i = 0; i < product->num_variables; i++)
+    {
+        size += product->variable[i]->num_elements * harp_get_size_for_type(product->variable[i]->data_type);
+    }
+
+    return size;
+}
+
+static void lru_remove_product_b(collocation_info *info, long index_b)
+{
+    long prev = info->product_b_lru_prev[index_b];
+    long next = info->product_b_lru_next[index_b];
+
+    if (prev == -1)
+    {
+        info->product_b_lru_first = next;
+    }
+    else
+    {
+        info->product_b_lru_next[prev] = next;
+    }
+    if (next == -1)
+    {
+        info->product_b_lru_last = prev;
+    }
+    else
+    {
+        info->product_b_lru_prev[next] = prev;
+    }
+    info->product_b_lru_prev[index_b] = -1;
+    info->product_b_lru_next[index_b] = -1;
+}
+
+static void lru_append_product_b(collocation_info *info, long index_b)
+{
+    info->product_b_lru_prev[index_b] = info->product_b_lru_last;
+    info->product_b_lru_next[index_b] = -1;
+    if (info->product_b_lru_last == -1)
+    {
+        info->product_b_lru_first = index_b;
+    }
+    else
+    {
+        info->product_b_lru_next[info->product_b_lru_last] = index_b;
+    }
+    info->product_b_lru_last = index_b;
+}
+
+static void unload_product_b(collocation_info *info, long index_b)
+{
+    lru_remove_product_b(info, index_b);
+    harp_product_delete(info->product_b[index_b]);
+    info->product_b[index_b] = NULL;
+    info->loaded_size_b -= info->product_b_size[index_b];
+    info->product_b_size[index_b] = 0;
+}
+
+/* Make sure that the product from dataset B is loaded and mark it as most recently used.
+ * If the total size of the loaded products exceeds the memory limit, the least recently used products are unloaded
+ * (they will be imported again if they are needed for a later product from dataset A).
+ */
+static int load_product_b(collocation_info *info, long index_b)
+{
+    if (info->product_b[index_b] != NULL)
+    {
+        lru_remove_product_b(info, index_b);
+        lru_append_product_b(info, index_b);
+        return 0;
+    }
+
+    if (import_product_b(info, index_b) != 0)
+    {
+        return -1;
+    }
+    info->product_b_size[index_b] = get_product_size(info->product_b[index_b]);
+    info->loaded_size_b += info->product_b_size[index_b];
+    lru_append_product_b(info, index_b);
+
+    if (info->max_memory_b >= 0)
+    {
+        /* the product that was just loaded is the most recently used one and is never unloaded */
+        while (info->loaded_size_b > info->max_memory_b && info->product_b_lru_first != index_b)
+        {
+            unload_product_b(info, info->product_b_lru_first);
+        }
+    }
+
+    return 0;
+}
+
+static int assign_variables(collocation_info *info, cache_variables *cache, harp_product *product)
+{
+    harp_dimension_type dimension_type[2] = { harp_dimension_time, harp_dimension_independent };
+    harp_data_type data_type = harp_type_double;
+    long i;
+
+    if (harp_product_get_variable_by_name(product, "index", &cache->index) != 0)
+    {
+        return -1;
+    }
+
+    if (harp_product_has_variable(product, "latitude"))
+    {
+        if (cache->latitude != NULL)
+        {
+            harp_variable_delete(cache->latitude);
+        }
+        if (cache->longitude != NULL)
+        {
+            harp_variable_delete(cache->longitude);
+        }
+        if (harp_product_get_derived_variable(product, "latitude", &data_type, HARP_UNIT_LATITUDE, 1, dimension_type,
+                                              &cache->latitude) != 0)
+        {
+            return -1;
+        }
+        if (harp_product_get_derived_variable(product, "longitude", &data_type, HARP_UNIT_LONGITUDE, 1, dimension_type,
+                                              &cache->longitude) != 0)
+        {
+            return -1;
+        }
+    }
+    if (harp_product_has_variable(product, "latitude_bounds"))
+    {
+        if (cache->latitude_bounds != NULL)
+        {
+            harp_variable_delete(cache->latitude_bounds);
+        }
+        if (cache->longitude_bounds != NULL)
+        {
+            harp_variable_delete(cache->longitude_bounds);
+        }
+        if (harp_product_get_derived_variable(product, "latitude_bounds", &data_type, HARP_UNIT_LATITUDE, 2,
+                                              dimension_type, &cache->latitude_bounds) != 0)
         {
             return -1;
         }
@@ -1349,18 +2109,386 @@ static int assign_variables(collocation_info *info, cache_variables *cache, harp
     return 0;
 }
 
+static int get_file_size(const char *filename, long *size)
+{
+    FILE *file;
+
+    file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        harp_set_error(HARP_ERROR_FILE_OPEN, "error opening collocation result file '%s'", filename);
+        return -1;
+    }
+    if (fseek(file, 0, SEEK_END) != 0)
+    {
+        harp_set_error(HARP_ERROR_FILE_READ, "error positioning in collocation result file '%s'", filename);
+        fclose(file);
+        return -1;
+    }
+    *size = ftell(file);
+    fclose(file);
+
+    return 0;
+}
+
+static int truncate_file(const char *filename, long size)
+{
+    FILE *file;
+    long file_size;
+    int result;
+
+    if (get_file_size(filename, &file_size) != 0)
+    {
+        return -1;
+    }
+    if (file_size < size)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "collocation result file '%s' is smaller than recorded in "
+                       "checkpoint (%ld < %ld)", filename, file_size, size);
+        return -1;
+    }
+
+    file = fopen(filename, "r+b");
+    if (file == NULL)
+    {
+        harp_set_error(HARP_ERROR_FILE_OPEN, "error opening collocation result file '%s'", filename);
+        return -1;
+    }
+#ifdef WIN32
+    result = _chsize(_fileno(file), size);
+#else
+    result = ftruncate(fileno(file), size);
+#endif
+    if (result != 0)
+    {
+        harp_set_error(HARP_ERROR_FILE_WRITE, "could not truncate collocation result file '%s' (%s)", filename,
+                       strerror(errno));
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+
+    return 0;
+}
+
+/* The checkpoint file contains a single line with: the number of products from dataset A (in the order in which they
+ * are processed) for which all pairs have been written, the next collocation index, the size of the collocation result
+ * file after these pairs were written, and the source product name of the last completed product from dataset A.
+ */
+static int write_checkpoint(collocation_info *info)
+{
+    FILE *file;
+    long size;
+
+    assert(info->num_products_a_done > 0);
+
+    if (get_file_size(info->output_filename, &size) != 0)
+    {
+        return -1;
+    }
+
+    file = fopen(info->checkpoint_filename, "w");
+    if (file == NULL)
+    {
+        harp_set_error(HARP_ERROR_FILE_OPEN, "error opening checkpoint file '%s'", info->checkpoint_filename);
+        return -1;
+    }
+    fprintf(file, "%ld %ld %ld %s\n", info->num_products_a_done, info->next_collocation_index, size,
+            info->dataset_a->metadata[info->sorted_index_a[info->num_products_a_done - 1]]->source_product);
+    if (fclose(file) != 0)
+    {
+        harp_set_error(HARP_ERROR_FILE_CLOSE, "error closing checkpoint file '%s'", info->checkpoint_filename);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int read_checkpoint(collocation_info *info, long *size)
+{
+    char line[CHECKPOINT_LINE_LENGTH + 1];
+    const char *source_product;
+    long num_products_a_done;
+    long next_collocation_index;
+    long length;
+    FILE *file;
+    int n;
+
+    file = fopen(info->checkpoint_filename, "r");
+    if (file == NULL)
+    {
+        /* no checkpoint -> start from the beginning */
+        return 0;
+    }
+    if (fgets(line, CHECKPOINT_LINE_LENGTH + 1, file) == NULL)
+    {
+        harp_set_error(HARP_ERROR_FILE_READ, "error reading checkpoint file '%s'", info->checkpoint_filename);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+
+    /* trim end-of-line */
+    length = (long)strlen(line);
+    while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == '\n'))
+    {
+        length--;
+    }
+    line[length] = '\0';
+
+    if (sscanf(line, "%ld %ld %ld %n", &num_products_a_done, &next_collocation_index, size, &n) != 3 ||
+        num_products_a_done < 1 || num_products_a_done > info->dataset_a->num_products || next_collocation_index < 0 ||
+        *size < 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_FORMAT, "invalid checkpoint file '%s'", info->checkpoint_filename);
+        return -1;
+    }
+    source_product = &line[n];
+    if (strcmp(source_product,
+               info->dataset_a->metadata[info->sorted_index_a[num_products_a_done - 1]]->source_product) != 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "checkpoint file '%s' does not match dataset A (product '%s' "
+                       "not found at position %ld)", info->checkpoint_filename, source_product, num_products_a_done);
+        return -1;
+    }
+
+    info->num_products_a_done = num_products_a_done;
+    info->num_products_a_emitted = num_products_a_done;
+    info->next_collocation_index = next_collocation_index;
+
+    return 0;
+}
+
+/* Create an empty output file or, when resuming, restore the output file to the state of the last checkpoint */
+static int prepare_output(collocation_info *info)
+{
+    long size = 0;
+    FILE *file;
+
+    info->checkpoint_filename = malloc(strlen(info->output_filename) + 12);
+    if (info->checkpoint_filename == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(strlen(info->output_filename) + 12), __FILE__, __LINE__);
+        return -1;
+    }
+    strcpy(info->checkpoint_filename, info->output_filename);
+    strcat(info->checkpoint_filename, ".checkpoint");
+
+    if (info->resume)
+    {
+        if (read_checkpoint(info, &size) != 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        /* remove any stale checkpoint from a previous run */
+        remove(info->checkpoint_filename);
+    }
+
+    if (info->num_products_a_done > 0)
+    {
+        return truncate_file(info->output_filename, size);
+    }
+
+    file = fopen(info->output_filename, "w");
+    if (file == NULL)
+    {
+        harp_set_error(HARP_ERROR_FILE_OPEN, "error opening collocation result file '%s'", info->output_filename);
+        return -1;
+    }
+    fclose(file);
+
+    return 0;
+}
+
+/* A product from dataset B is final once no remaining product from dataset A can overlap with it in time */
+static int is_final_product_b(collocation_info *info, long index_b)
+{
+    double datetime_start_a;
+
+    if (info->num_products_a_done == info->dataset_a->num_products)
+    {
+        return 1;
+    }
+    datetime_start_a = info->dataset_a->metadata[info->sorted_index_a[info->num_products_a_done]]->datetime_start;
+
+    return info->dataset_b->metadata[index_b]->datetime_stop + info->delta_time < datetime_start_a;
+}
+
+static int add_pair(collocation_info *info, long product_index_a, long sample_index_a, long product_index_b,
+                    long sample_index_b, const double *difference)
+{
+    if (harp_collocation_result_add_pair(info->collocation_result, info->next_collocation_index,
+                                         info->dataset_a->metadata[product_index_a]->source_product, sample_index_a,
+                                         info->dataset_b->metadata[product_index_b]->source_product, sample_index_b,
+                                         info->num_criteria, difference) != 0)
+    {
+        return -1;
+    }
+    info->next_collocation_index++;
+
+    return 0;
+}
+
+/* Pass the pairs of a final nearest table on to the table of the second nearest neighbour filter (if there is one),
+ * or add them to the collocation result.
+ */
+static int emit_nearest_table(collocation_info *info, nearest_table *table, int is_dataset_a)
+{
+    int has_second_filter;
+    long i;
+
+    has_second_filter = info->nearest_neighbour_x_criterium_index >= 0 &&
+        info->nearest_neighbour_y_criterium_index >= 0 && is_dataset_a == info->perform_nearest_neighbour_x_first;
+
+    for (i = 0; i < table->num_samples; i++)
+    {
+        const double *difference = &table->difference[i * info->num_criteria];
+
+        if (table->other_position[i] < 0)
+        {
+            continue;
+        }
+        if (!has_second_filter)
+        {
+            if (add_pair(info, table->product_index_a[i], table->sample_index_a[i], table->product_index_b[i],
+                         table->sample_index_b[i], difference) != 0)
+            {
+                return -1;
+            }
+        }
+        else if (is_dataset_a)
+        {
+            assert(info->nearest_b[table->product_index_b[i]] != NULL);
+            nearest_table_add(info->nearest_b[table->product_index_b[i]], table->other_position[i], i,
+                              info->nearest_neighbour_y_criterium_index, info->num_criteria,
+                              table->product_index_a[i], table->sample_index_a[i], table->product_index_b[i],
+                              table->sample_index_b[i], difference);
+        }
+        else
+        {
+            assert(info->nearest_a[table->product_index_a[i]] != NULL);
+            nearest_table_add(info->nearest_a[table->product_index_a[i]], table->other_position[i], i,
+                              info->nearest_neighbour_x_criterium_index, info->num_criteria,
+                              table->product_index_a[i], table->sample_index_a[i], table->product_index_b[i],
+                              table->sample_index_b[i], difference);
+        }
+    }
+
+    return 0;
+}
+
+/* Called after a product from dataset A has been compared against all products from dataset B.
+ * Nearest tables that have become final are emitted, the collocation result is appended to the output file, and the
+ * checkpoint is updated if there are no more pending nearest tables.
+ */
+static int complete_product_a(collocation_info *info)
+{
+    long first_pending_product_a = info->num_products_a_done;
+    long num_pending = 0;
+    long index_a;
+    long i;
+
+    if (info->perform_nearest_neighbour_x_first)
+    {
+        /* the nearest samples from dataset B for the samples of this product A are now known */
+        index_a = info->sorted_index_a[info->num_products_a_done - 1];
+        if (info->nearest_a[index_a] != NULL)
+        {
+            if (emit_nearest_table(info, info->nearest_a[index_a], 1) != 0)
+            {
+                return -1;
+            }
+            nearest_table_delete(info->nearest_a[index_a]);
+            info->nearest_a[index_a] = NULL;
+        }
+        info->num_products_a_emitted = info->num_products_a_done;
+    }
+    if (info->nearest_b != NULL)
+    {
+        for (i = 0; i < info->dataset_b->num_products; i++)
+        {
+            long index_b = info->sorted_index_b[i];
+
+            if (info->nearest_b[index_b] == NULL)
+            {
+                continue;
+            }
+            if (is_final_product_b(info, index_b))
+            {
+                if (emit_nearest_table(info, info->nearest_b[index_b], 0) != 0)
+                {
+                    return -1;
+                }
+                nearest_table_delete(info->nearest_b[index_b]);
+                info->nearest_b[index_b] = NULL;
+            }
+            else
+            {
+                if (info->nearest_b[index_b]->first_product_a < first_pending_product_a)
+                {
+                    first_pending_product_a = info->nearest_b[index_b]->first_product_a;
+                }
+                num_pending++;
+            }
+        }
+    }
+    if (info->nearest_a != NULL && !info->perform_nearest_neighbour_x_first)
+    {
+        /* a product from dataset A is final once all products from dataset B it was compared with are final */
+        while (info->num_products_a_emitted < first_pending_product_a)
+        {
+            index_a = info->sorted_index_a[info->num_products_a_emitted];
+            if (info->nearest_a[index_a] != NULL)
+            {
+                if (emit_nearest_table(info, info->nearest_a[index_a], 1) != 0)
+                {
+                    return -1;
+                }
+                nearest_table_delete(info->nearest_a[index_a]);
+                info->nearest_a[index_a] = NULL;
+            }
+            info->num_products_a_emitted++;
+        }
+        num_pending += info->num_products_a_done - info->num_products_a_emitted;
+    }
+
+    if (info->collocation_result->num_pairs > 0)
+    {
+        if (harp_collocation_result_append(info->output_filename, info->collocation_result,
+                                           info->collocation_result->num_pairs) != 0)
+        {
+            return -1;
+        }
+        /* all pairs have been written; keep the allocated pair arrays for the next product */
+        info->collocation_result->num_pairs = 0;
+    }
+    if (num_pending == 0)
+    {
+        /* everything up to and including the last processed product from dataset A has been written */
+        if (write_checkpoint(info) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 /* Collocate two datasets */
 static int perform_matchup(collocation_info *info)
 {
     long i, j;
-    double delta_time;  /* time criterium to efficiently filter for products that could have matching pairs */
 
     if (info->datetime_index >= 0)
     {
-        delta_time = info->criterium[info->datetime_index]->value;
+        info->delta_time = info->criterium[info->datetime_index]->value;
 
         /* the datetime start/stop in the metadata is provided in days since 2000-01-01 */
-        if (harp_convert_unit(info->criterium[info->datetime_index]->unit, "days", 1, &delta_time) != 0)
+        if (harp_convert_unit(info->criterium[info->datetime_index]->unit, "days", 1, &info->delta_time) != 0)
         {
             return -1;
         }
@@ -1368,11 +2496,11 @@ static int perform_matchup(collocation_info *info)
     else
     {
         /* set delta_time to infinite, so we match everything */
-        delta_time = harp_plusinf();
+        info->delta_time = harp_plusinf();
     }
 
-    /* loop over products in dataset A */
-    for (i = 0; i < info->dataset_a->num_products; i++)
+    /* loop over products in dataset A (skipping the products that were completed before a resume) */
+    for (i = info->num_products_a_done; i < info->dataset_a->num_products; i++)
     {
         long index_a = info->sorted_index_a[i];
         double datetime_start_a = info->dataset_a->metadata[index_a]->datetime_start;
@@ -1389,6 +2517,11 @@ static int perform_matchup(collocation_info *info)
         {
             harp_product_delete(info->product_a);
             info->product_a = NULL;
+            info->num_products_a_done = i + 1;
+            if (complete_product_a(info) != 0)
+            {
+                return -1;
+            }
             continue;
         }
         if (filter_product(info, info->product_a, 1) != 0)
@@ -1399,6 +2532,14 @@ static int perform_matchup(collocation_info *info)
         {
             return -1;
         }
+        if (info->nearest_a != NULL)
+        {
+            if (nearest_table_new(info->product_a->dimension[harp_dimension_time], info->num_criteria, i,
+                                  &info->nearest_a[index_a]) != 0)
+            {
+                return -1;
+            }
+        }
 
         for (j = 0; j < info->dataset_b->num_products; j++)
         {
@@ -1406,26 +2547,15 @@ static int perform_matchup(collocation_info *info)
             double datetime_start_b = info->dataset_b->metadata[index_b]->datetime_start;
             double datetime_stop_b = info->dataset_b->metadata[index_b]->datetime_stop;
 
-            if (datetime_start_a <= datetime_stop_b + delta_time && datetime_start_b - delta_time <= datetime_stop_a)
+            if (datetime_start_a <= datetime_stop_b + info->delta_time &&
+                datetime_start_b - info->delta_time <= datetime_stop_a)
             {
                 /* overlap */
-                if (info->product_b[index_b] == NULL)
+                if (load_product_b(info, index_b) != 0)
                 {
-                    if (harp_import(info->dataset_b->metadata[index_b]->filename, info->operations_b,
-                                    info->ingest_options_b, &info->product_b[index_b]) != 0)
-                    {
-                        return -1;
-                    }
-                    if (harp_product_is_empty(info->product_b[index_b]))
-                    {
-                        continue;
-                    }
-                    if (filter_product(info, info->product_b[index_b], 0) != 0)
-                    {
-                        return -1;
-                    }
+                    return -1;
                 }
-                else if (harp_product_is_empty(info->product_b[index_b]))
+                if (harp_product_is_empty(info->product_b[index_b]))
                 {
                     continue;
                 }
@@ -1434,6 +2564,14 @@ static int perform_matchup(collocation_info *info)
                 {
                     return -1;
                 }
+                if (info->nearest_b != NULL && info->nearest_b[index_b] == NULL)
+                {
+                    if (nearest_table_new(info->product_b[index_b]->dimension[harp_dimension_time], info->num_criteria,
+                                          i, &info->nearest_b[index_b]) != 0)
+                    {
+                        return -1;
+                    }
+                }
 
                 if (perform_matchup_on_products(info, index_b) != 0)
                 {
@@ -1442,17 +2580,65 @@ static int perform_matchup(collocation_info *info)
             }
             else if (info->product_b[index_b] != NULL)
             {
-                harp_product_delete(info->product_b[index_b]);
-                info->product_b[index_b] = NULL;
+                unload_product_b(info, index_b);
             }
         }
         harp_product_delete(info->product_a);
         info->product_a = NULL;
+
+        info->num_products_a_done = i + 1;
+        if (complete_product_a(info) != 0)
+        {
+            return -1;
+        }
     }
 
     return 0;
 }
 
+/* parse a size in bytes with an optional 'k', 'M', or 'G' suffix (using powers of 1024) */
+static int parse_memory_size(const char *str, int64_t *size)
+{
+    double value;
+    char *endptr;
+
+    errno = 0;
+    value = strtod(str, &endptr);
+    if (errno != 0 || endptr == str || value < 0)
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "invalid memory size '%s'", str);
+        return -1;
+    }
+    switch (*endptr)
+    {
+        case 'k':
+        case 'K':
+            value *= 1024.0;
+            endptr++;
+            break;
+        case 'm':
+        case 'M':
+            value *= 1024.0 * 1024.0;
+            endptr++;
+            break;
+        case 'g':
+        case 'G':
+            value *= 1024.0 * 1024.0 * 1024.0;
+            endptr++;
+            break;
+        default:
+            break;
+    }
+    if (*endptr != '\0')
+    {
+        harp_set_error(HARP_ERROR_INVALID_ARGUMENT, "invalid memory size '%s'", str);
+        return -1;
+    }
+    *size = (int64_t)value;
+
+    return 0;
+}
+
 int matchup(int argc, char *argv[])
 {
     collocation_info *info = NULL;
@@ -1545,6 +2731,37 @@ int matchup(int argc, char *argv[])
             info->operations_a = argv[i + 1];
             i++;
         }
+        else if (strcmp(argv[i], "--cache-b") == 0 && i + 1 < argc && argv[i + 1][0] != '-')
+        {
+            info->cache_directory_b = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--max-memory") == 0 && i + 1 < argc && argv[i + 1][0] != '-')
+        {
+            if (parse_memory_size(argv[i + 1], &info->max_memory_b) != 0)
+            {
+                collocation_info_delete(info);
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--metadata-cache") == 0)
+        {
+            harp_set_option_metadata_cache(1);
+        }
+        else if (strcmp(argv[i], "--resume") == 0)
+        {
+            info->resume = 1;
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc && argv[i + 1][0] != '-')
+        {
+            if (harp_set_option_num_threads(atoi(argv[i + 1])) != 0)
+            {
+                collocation_info_delete(info);
+                return -1;
+            }
+            i++;
+        }
         else if ((strcmp(argv[i], "-ab") == 0 || strcmp(argv[i], "--operations_b") == 0) && i + 1 < argc
                  && argv[i + 1][0] != '-')
         {
@@ -1590,47 +2807,31 @@ int matchup(int argc, char *argv[])
         return -1;
     }
 
-    if (info->dataset_a->num_products > 0 && info->dataset_b->num_products > 0)
+    /* pairs are written to the output file as soon as they are final */
+    info->output_filename = argv[argc - 1];
+    if (prepare_output(info) != 0)
     {
-        if (perform_matchup(info) != 0)
-        {
-            collocation_info_delete(info);
-            return -1;
-        }
+        collocation_info_delete(info);
+        return -1;
     }
 
-    if (info->nearest_neighbour_x_criterium_index >= 0 && info->nearest_neighbour_y_criterium_index >= 0)
+    if (info->dataset_a->num_products > 0 && info->dataset_b->num_products > 0)
     {
-        /* perform the second nearest neighbour filtering using a filter on the collocation results */
-        if (info->perform_nearest_neighbour_x_first)
-        {
-            if (resample_nearest_b(info->collocation_result, info->nearest_neighbour_y_criterium_index) != 0)
-            {
-                collocation_info_delete(info);
-                return -1;
-            }
-        }
-        else
-        {
-            if (resample_nearest_a(info->collocation_result, info->nearest_neighbour_x_criterium_index) != 0)
-            {
-                collocation_info_delete(info);
-                return -1;
-            }
-        }
-        if (harp_collocation_result_sort_by_collocation_index(info->collocation_result) != 0)
+        if (perform_matchup(info) != 0)
         {
             collocation_info_delete(info);
             return -1;
         }
-        reindex_collocation_indices(info->collocation_result);
     }
 
-    if (harp_collocation_result_write(argv[argc - 1], info->collocation_result) != 0)
+    /* write any remaining pairs (this also makes sure the header is written if there were no pairs) */
+    if (harp_collocation_result_append(info->output_filename, info->collocation_result,
+                                       info->collocation_result->num_pairs) != 0)
     {
         collocation_info_delete(info);
         return -1;
     }
+    remove(info->checkpoint_filename);
 
     collocation_info_delete(info);
 
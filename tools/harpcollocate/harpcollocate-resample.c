@@ -150,6 +150,7 @@ static int resample_info_update(resample_info *info)
 
 int resample_nearest_a(harp_collocation_result *collocation_result, int difference_index)
 {
+    int num_differences = collocation_result->num_differences;
     long i;
 
     if (harp_collocation_result_sort_by_a(collocation_result) != 0)
@@ -158,11 +159,11 @@ int resample_nearest_a(harp_collocation_result *collocation_result, int differen
     }
     for (i = collocation_result->num_pairs - 1; i > 0; i--)
     {
-        if (collocation_result->pair[i]->product_index_a == collocation_result->pair[i - 1]->product_index_a &&
-            collocation_result->pair[i]->sample_index_a == collocation_result->pair[i - 1]->sample_index_a)
+        if (collocation_result->product_index_a[i] == collocation_result->product_index_a[i - 1] &&
+            collocation_result->sample_index_a[i] == collocation_result->sample_index_a[i - 1])
         {
-            if (fabs(collocation_result->pair[i]->difference[difference_index]) >=
-                fabs(collocation_result->pair[i - 1]->difference[difference_index]))
+            if (fabs(collocation_result->difference[i * num_differences + difference_index]) >=
+                fabs(collocation_result->difference[(i - 1) * num_differences + difference_index]))
             {
                 if (harp_collocation_result_remove_pair_at_index(collocation_result, i) != 0)
                 {
@@ -184,6 +185,7 @@ int resample_nearest_a(harp_collocation_result *collocation_result, int differen
 
 int resample_nearest_b(harp_collocation_result *collocation_result, int difference_index)
 {
+    int num_differences = collocation_result->num_differences;
     long i;
 
     if (harp_collocation_result_sort_by_b(collocation_result) != 0)
@@ -192,11 +194,11 @@ int resample_nearest_b(harp_collocation_result *collocation_result, int differen
     }
     for (i = collocation_result->num_pairs - 1; i > 0; i--)
     {
-        if (collocation_result->pair[i]->product_index_b == collocation_result->pair[i - 1]->product_index_b &&
-            collocation_result->pair[i]->sample_index_b == collocation_result->pair[i - 1]->sample_index_b)
+        if (collocation_result->product_index_b[i] == collocation_result->product_index_b[i - 1] &&
+            collocation_result->sample_index_b[i] == collocation_result->sample_index_b[i - 1])
         {
-            if (fabs(collocation_result->pair[i]->difference[difference_index]) >=
-                fabs(collocation_result->pair[i - 1]->difference[difference_index]))
+            if (fabs(collocation_result->difference[i * num_differences + difference_index]) >=
+                fabs(collocation_result->difference[(i - 1) * num_differences + difference_index]))
             {
                 if (harp_collocation_result_remove_pair_at_index(collocation_result, i) != 0)
                 {
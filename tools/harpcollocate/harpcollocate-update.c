@@ -55,7 +55,7 @@ static long get_index_for_collocation_index(const harp_collocation_result *collo
         long pivot_index = lower_index + ((upper_index - lower_index) / 2);
 
         /* If the pivot equals the index to be found, terminate early. */
-        if (collocation_result->pair[pivot_index]->collocation_index == collocation_index)
+        if (collocation_result->collocation_index[pivot_index] == collocation_index)
         {
             return pivot_index;
         }
@@ -63,7 +63,7 @@ static long get_index_for_collocation_index(const harp_collocation_result *collo
         /* If the pivot is smaller than the index to be found, search the upper sub array, otherwise search the lower
          * sub array.
          */
-        if (collocation_result->pair[pivot_index]->collocation_index < collocation_index)
+        if (collocation_result->collocation_index[pivot_index] < collocation_index)
         {
             lower_index = pivot_index + 1;
         }
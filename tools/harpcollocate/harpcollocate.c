@@ -122,6 +122,35 @@ static void print_help(void)
     printf("            -ab, --operations-b <operation list>\n");
     printf("                List of operations to apply to each product of the second\n");
     printf("                dataset before collocating (see above).\n");
+    printf("            -j <num_threads>\n");
+    printf("                Number of threads to use for comparing samples (and for\n");
+    printf("                deriving variables). By default all available processors are\n");
+    printf("                used. The result does not depend on the number of threads.\n");
+    printf("            --cache-b <directory>\n");
+    printf("                Directory in which the products of the second dataset are\n");
+    printf("                stored after ingestion and reduction to the variables that\n");
+    printf("                are needed for the collocation. Repeated collocations against\n");
+    printf("                the same dataset reuse these products as long as the file\n");
+    printf("                (path, size, modification time), the ingestion options,\n");
+    printf("                the operations, and the criteria remain the same.\n");
+    printf("                The directory should already exist.\n");
+    printf("            --max-memory <size>\n");
+    printf("                Maximum amount of memory to use for keeping products of the\n");
+    printf("                second dataset loaded (in bytes, or with a k/M/G suffix).\n");
+    printf("                When the limit is exceeded, the least recently used products\n");
+    printf("                are unloaded and will be ingested again when needed.\n");
+    printf("                By default there is no limit.\n");
+    printf("            --metadata-cache\n");
+    printf("                Keep the metadata of the products of each dataset directory\n");
+    printf("                in a '.harp_metadata_cache.csv' file in that directory, so\n");
+    printf("                products that did not change do not need to be opened again\n");
+    printf("                to determine the list of products on a next run.\n");
+    printf("            --resume\n");
+    printf("                Continue an interrupted collocation from the last checkpoint.\n");
+    printf("                Pairs are written to the output file as soon as they are\n");
+    printf("                final and progress (in terms of completed products from\n");
+    printf("                dataset A) is recorded in <outputpath>.checkpoint.\n");
+    printf("                The checkpoint file is removed once the collocation finishes.\n");
     printf("        The order in which -nx and -ny are provided determines the order in\n");
     printf("        which the nearest filters are executed.\n");
     printf("        When '[unit]' is not specified, the unit of the variable of the\n");
@@ -89,6 +89,21 @@ static void print_help(void)
     printf("                Set data compression level for storing in HDF5 format.\n");
     printf("                0=disabled, 1=low, ..., 9=high.\n");
     printf("\n");
+    printf("            --hdf5-chunk-size <bytes>\n");
+    printf("                Set the target number of bytes per chunk for storing in HDF5\n");
+    printf("                format with compression. Time dependent variables are chunked\n");
+    printf("                along the time dimension. 0=single chunk per variable (default).\n");
+    printf("\n");
+    printf("            --hdf5-shuffle\n");
+    printf("                Apply the shuffle filter before compression when storing in\n");
+    printf("                HDF5 format.\n");
+    printf("\n");
+    printf("            --keep-float\n");
+    printf("                Keep float variables as float in regridding and rebinning\n");
+    printf("                operations (instead of converting them to double).\n");
+    printf("                Other operations (e.g. smoothing and binning) still convert\n");
+    printf("                float variables to double.\n");
+    printf("\n");
     printf("            --no-history\n");
     printf("                Do not update the global history attribute.\n");
     printf("\n");
@@ -177,6 +192,24 @@ static int convert(int argc, char *argv[])
             }
             i++;
         }
+        else if (strcmp(argv[i], "--hdf5-chunk-size") == 0 && i + 1 < argc && argv[i + 1][0] != '-')
+        {
+            if (harp_set_option_hdf5_chunk_size(atol(argv[i + 1])) != 0)
+            {
+                fprintf(stderr, "ERROR: invalid hdf5 chunk size argument: '%s'\n", argv[i]);
+                print_help();
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--hdf5-shuffle") == 0)
+        {
+            harp_set_option_hdf5_shuffle(1);
+        }
+        else if (strcmp(argv[i], "--keep-float") == 0)
+        {
+            harp_set_option_keep_float(1);
+        }
         else if (strcmp(argv[i], "--no-history") == 0)
         {
             update_history = 0;
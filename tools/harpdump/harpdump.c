@@ -180,7 +180,11 @@ static int list_derivations(int argc, char *argv[])
         return harp_doc_list_conversions(NULL, variable_name, printf);
     }
 
-    /* Import the product */
+    /* Import the product (listing conversions does not require the data of the variables) */
+    if (harp_set_option_lazy_import(1) != 0)
+    {
+        return -1;
+    }
     if (harp_import(input_filename, operations, options, &product) != 0)
     {
         return -1;
@@ -301,6 +305,15 @@ static int dump(int argc, char *argv[])
         return -1;
     }
 
+    if (!data || list)
+    {
+        /* we will not print any data, so only read the data that the operations need */
+        if (harp_set_option_lazy_import(1) != 0)
+        {
+            return -1;
+        }
+    }
+
     if (harp_import(argv[argc - 1], operations, options, &product) != 0)
     {
         return -1;
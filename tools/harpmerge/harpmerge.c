@@ -88,6 +88,35 @@ static void print_help(void)
     printf("                See the 'operations' section of the HARP documentation for\n");
     printf("                more details.\n");
     printf("\n");
+    printf("            -bs, --bin-spatial <lat_edge_length>,<lat_edge_offset>,<lat_edge_step>,\n");
+    printf("                               <lon_edge_length>,<lon_edge_offset>,<lon_edge_step>\n");
+    printf("                Spatially bin the samples of all products into a single\n");
+    printf("                lat/lon grid (with a time dimension of length 1) that is\n");
+    printf("                defined by the given number, offset, and step of the latitude\n");
+    printf("                and longitude edges (as for the bin_spatial() operation).\n");
+    printf("                Only the sums per grid cell are kept in memory, which is much\n");
+    printf("                more efficient than using bin_spatial() and bin() as reduce\n");
+    printf("                operations. Cannot be combined with sorted merging, reduce\n");
+    printf("                operations, or streaming. As for a regular merge, all\n");
+    printf("                products need to have the same variables.\n");
+    printf("\n");
+    printf("            -s, --sorted <variable>\n");
+    printf("                Merge the products such that the merged product is sorted by\n");
+    printf("                the given time dependent variable (e.g. datetime).\n");
+    printf("                Each product is sorted first (if needed) after which all\n");
+    printf("                products are merged in a single pass. This is faster than\n");
+    printf("                using a sort() post operation, especially if the products\n");
+    printf("                do not overlap. Cannot be combined with reduce operations or\n");
+    printf("                spatial binning.\n");
+    printf("\n");
+    printf("            --stream\n");
+    printf("                Write each product to the output file directly after it has\n");
+    printf("                been imported instead of keeping the merged product in memory.\n");
+    printf("                The first product determines the length of all non-time\n");
+    printf("                dimensions (and string lengths) of the output product.\n");
+    printf("                Cannot be combined with sorted merging, reduce operations,\n");
+    printf("                spatial binning, or post operations.\n");
+    printf("\n");
     printf("            -o, --options <option list>\n");
     printf("                List of options to pass to the ingestion module.\n");
     printf("                Only applicable if an input product is not in HARP format.\n");
@@ -95,6 +124,12 @@ static void print_help(void)
     printf("                of an <option name>=<value> pair. An option list needs to be\n");
     printf("                provided as a single expression.\n");
     printf("\n");
+    printf("            --metadata-cache\n");
+    printf("                Keep the metadata of the products of each input directory in\n");
+    printf("                a '.harp_metadata_cache.csv' file in that directory, so\n");
+    printf("                products that did not change do not need to be opened again\n");
+    printf("                to determine the list of products on a next run.\n");
+    printf("\n");
     printf("            -l, --list\n");
     printf("                Print to stdout each filename that is currently being merged.\n");
     printf("\n");
@@ -108,6 +143,21 @@ static void print_help(void)
     printf("                Set data compression level for storing in HDF5 format.\n");
     printf("                0=disabled, 1=low, ..., 9=high.\n");
     printf("\n");
+    printf("            --hdf5-chunk-size <bytes>\n");
+    printf("                Set the target number of bytes per chunk for storing in HDF5\n");
+    printf("                format with compression. Time dependent variables are chunked\n");
+    printf("                along the time dimension. 0=single chunk per variable (default).\n");
+    printf("\n");
+    printf("            --hdf5-shuffle\n");
+    printf("                Apply the shuffle filter before compression when storing in\n");
+    printf("                HDF5 format.\n");
+    printf("\n");
+    printf("            --keep-float\n");
+    printf("                Keep float variables as float in regridding and rebinning\n");
+    printf("                operations (instead of converting them to double).\n");
+    printf("                Other operations (e.g. smoothing and binning) still convert\n");
+    printf("                float variables to double.\n");
+    printf("\n");
     printf("            --no-history\n");
     printf("                Do not update the global history attribute.\n");
     printf("\n");
@@ -180,6 +230,221 @@ int merge_dataset(harp_product **merged_product, harp_dataset *dataset, const ch
     return 0;
 }
 
+static int collect_dataset(int *num_products, harp_product ***product_list, harp_dataset *dataset,
+                           const char *operations, const char *options, int verbose)
+{
+    int i;
+
+    for (i = 0; i < dataset->num_products; i++)
+    {
+        harp_product *product;
+        int index;
+
+        /* add products in sorted order (sorted by source_product value) */
+        index = dataset->sorted_index[i];
+
+        if (verbose)
+        {
+            printf("%s\n", dataset->metadata[index]->filename);
+        }
+        if (harp_import(dataset->metadata[index]->filename, operations, options, &product) != 0)
+        {
+            harp_add_error_message(" (while merging '%s')", dataset->metadata[index]->filename);
+            return -1;
+        }
+        if (harp_product_is_empty(product))
+        {
+            harp_product_delete(product);
+        }
+        else
+        {
+            harp_product **new_product_list;
+
+            new_product_list = realloc(*product_list, (*num_products + 1) * sizeof(harp_product *));
+            if (new_product_list == NULL)
+            {
+                harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               (*num_products + 1) * sizeof(harp_product *), __FILE__, __LINE__);
+                harp_product_delete(product);
+                return -1;
+            }
+            *product_list = new_product_list;
+            (*product_list)[*num_products] = product;
+            (*num_products)++;
+        }
+    }
+
+    return 0;
+}
+
+static int stream_dataset(harp_export_stream *stream, int *num_appended, harp_dataset *dataset,
+                          const char *operations, const char *options, int update_history, int argc, char *argv[],
+                          int verbose)
+{
+    int i;
+
+    for (i = 0; i < dataset->num_products; i++)
+    {
+        harp_product *product;
+        int index;
+
+        /* add products in sorted order (sorted by source_product value) */
+        index = dataset->sorted_index[i];
+
+        if (verbose)
+        {
+            printf("%s\n", dataset->metadata[index]->filename);
+        }
+        if (harp_import(dataset->metadata[index]->filename, operations, options, &product) != 0)
+        {
+            harp_add_error_message(" (while merging '%s')", dataset->metadata[index]->filename);
+            return -1;
+        }
+        if (!harp_product_is_empty(product))
+        {
+            if (*num_appended == 0 && update_history)
+            {
+                /* the history attribute of the exported product is taken from the first product */
+                if (harp_product_update_history(product, "harpmerge", argc, argv) != 0)
+                {
+                    harp_product_delete(product);
+                    return -1;
+                }
+            }
+            if (harp_export_stream_append(stream, product) != 0)
+            {
+                harp_add_error_message(" (while merging '%s')", dataset->metadata[index]->filename);
+                harp_product_delete(product);
+                return -1;
+            }
+            (*num_appended)++;
+        }
+        harp_product_delete(product);
+    }
+
+    return 0;
+}
+
+static int bin_spatial_dataset(harp_spatial_grid *grid, int *num_added, harp_dataset *dataset, const char *operations,
+                               const char *options, int verbose)
+{
+    int i;
+
+    for (i = 0; i < dataset->num_products; i++)
+    {
+        harp_product *product;
+        int index;
+
+        /* add products in sorted order (sorted by source_product value) */
+        index = dataset->sorted_index[i];
+
+        if (verbose)
+        {
+            printf("%s\n", dataset->metadata[index]->filename);
+        }
+        if (harp_import(dataset->metadata[index]->filename, operations, options, &product) != 0)
+        {
+            harp_add_error_message(" (while merging '%s')", dataset->metadata[index]->filename);
+            return -1;
+        }
+        if (!harp_product_is_empty(product))
+        {
+            if (harp_spatial_grid_add_product(grid, product) != 0)
+            {
+                harp_add_error_message(" (while merging '%s')", dataset->metadata[index]->filename);
+                harp_product_delete(product);
+                return -1;
+            }
+            (*num_added)++;
+        }
+        harp_product_delete(product);
+    }
+
+    return 0;
+}
+
+/* create a spatial binning accumulator from a '<lat_edge_length>,<lat_edge_offset>,<lat_edge_step>,
+ * <lon_edge_length>,<lon_edge_offset>,<lon_edge_step>' grid definition
+ */
+static int new_spatial_grid(const char *grid_definition, harp_spatial_grid **grid)
+{
+    double *latitude_edges;
+    double *longitude_edges;
+    double latitude_offset, latitude_step;
+    double longitude_offset, longitude_step;
+    long num_latitude_edges, num_longitude_edges;
+    long i;
+    int length = 0;
+
+    if (sscanf(grid_definition, "%ld,%lf,%lf,%ld,%lf,%lf%n", &num_latitude_edges, &latitude_offset, &latitude_step,
+               &num_longitude_edges, &longitude_offset, &longitude_step, &length) != 6 ||
+        grid_definition[length] != '\0' || num_latitude_edges < 2 || num_longitude_edges < 2)
+    {
+        fprintf(stderr, "ERROR: invalid spatial binning grid definition: '%s'\n", grid_definition);
+        return -1;
+    }
+    latitude_edges = malloc(num_latitude_edges * sizeof(double));
+    if (latitude_edges == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_latitude_edges * sizeof(double), __FILE__, __LINE__);
+        return -1;
+    }
+    longitude_edges = malloc(num_longitude_edges * sizeof(double));
+    if (longitude_edges == NULL)
+    {
+        harp_set_error(HARP_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_longitude_edges * sizeof(double), __FILE__, __LINE__);
+        free(latitude_edges);
+        return -1;
+    }
+    for (i = 0; i < num_latitude_edges; i++)
+    {
+        latitude_edges[i] = latitude_offset + i * latitude_step;
+    }
+    for (i = 0; i < num_longitude_edges; i++)
+    {
+        longitude_edges[i] = longitude_offset + i * longitude_step;
+    }
+    if (harp_spatial_grid_new(num_latitude_edges, latitude_edges, num_longitude_edges, longitude_edges, grid) != 0)
+    {
+        free(latitude_edges);
+        free(longitude_edges);
+        return -1;
+    }
+    free(latitude_edges);
+    free(longitude_edges);
+
+    return 0;
+}
+
+/* close the export stream and remove the partially written output file (if it was created) */
+static void abort_stream(harp_export_stream *stream, int num_appended, const char *filename)
+{
+    if (stream != NULL)
+    {
+        harp_export_stream_close(stream);
+        if (num_appended > 0)
+        {
+            remove(filename);
+        }
+    }
+}
+
+static void delete_product_list(int num_products, harp_product **product_list)
+{
+    int i;
+
+    if (product_list != NULL)
+    {
+        for (i = 0; i < num_products; i++)
+        {
+            harp_product_delete(product_list[i]);
+        }
+        free(product_list);
+    }
+}
+
 static int merge(int argc, char *argv[])
 {
     harp_product *merged_product = NULL;
@@ -189,6 +454,13 @@ static int merge(int argc, char *argv[])
     const char *options = NULL;
     const char *output_filename = NULL;
     const char *output_format = "netcdf";
+    const char *sort_variable = NULL;
+    const char *grid_definition = NULL;
+    harp_product **product_list = NULL;
+    harp_export_stream *stream = NULL;
+    harp_spatial_grid *grid = NULL;
+    int num_products = 0;
+    int use_stream = 0;
     int update_history = 1;
     int verbose = 0;
     int i;
@@ -214,6 +486,22 @@ static int merge(int argc, char *argv[])
             post_operations = argv[i + 1];
             i++;
         }
+        else if ((strcmp(argv[i], "-bs") == 0 || strcmp(argv[i], "--bin-spatial") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            grid_definition = argv[i + 1];
+            i++;
+        }
+        else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--sorted") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            sort_variable = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--stream") == 0)
+        {
+            use_stream = 1;
+        }
         else if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--options") == 0) && i + 1 < argc &&
                  argv[i + 1][0] != '-')
         {
@@ -226,6 +514,10 @@ static int merge(int argc, char *argv[])
             output_format = argv[i + 1];
             i++;
         }
+        else if (strcmp(argv[i], "--metadata-cache") == 0)
+        {
+            harp_set_option_metadata_cache(1);
+        }
         else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--list") == 0)
         {
             verbose = 1;
@@ -240,6 +532,24 @@ static int merge(int argc, char *argv[])
             }
             i++;
         }
+        else if (strcmp(argv[i], "--hdf5-chunk-size") == 0 && i + 1 < argc && argv[i + 1][0] != '-')
+        {
+            if (harp_set_option_hdf5_chunk_size(atol(argv[i + 1])) != 0)
+            {
+                fprintf(stderr, "ERROR: invalid hdf5 chunk size argument: '%s'\n", argv[i]);
+                print_help();
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--hdf5-shuffle") == 0)
+        {
+            harp_set_option_hdf5_shuffle(1);
+        }
+        else if (strcmp(argv[i], "--keep-float") == 0)
+        {
+            harp_set_option_keep_float(1);
+        }
         else if (strcmp(argv[i], "--no-history") == 0)
         {
             update_history = 0;
@@ -263,27 +573,98 @@ static int merge(int argc, char *argv[])
         print_help();
         return -1;
     }
+    if (sort_variable != NULL && reduce_operations != NULL)
+    {
+        fprintf(stderr, "ERROR: sorted merge cannot be combined with reduce operations\n");
+        print_help();
+        return -1;
+    }
+    if (use_stream && (sort_variable != NULL || reduce_operations != NULL || post_operations != NULL))
+    {
+        fprintf(stderr, "ERROR: streamed merge cannot be combined with sorted merge, reduce operations, or post "
+                "operations\n");
+        print_help();
+        return -1;
+    }
+    if (grid_definition != NULL && (sort_variable != NULL || reduce_operations != NULL || use_stream))
+    {
+        fprintf(stderr, "ERROR: spatial binning cannot be combined with sorted merge, reduce operations, or "
+                "streamed merge\n");
+        print_help();
+        return -1;
+    }
     output_filename = argv[argc - 1];
 
+    if (grid_definition != NULL)
+    {
+        if (new_spatial_grid(grid_definition, &grid) != 0)
+        {
+            return -1;
+        }
+    }
+
+    if (use_stream)
+    {
+        /* the output file only gets created once the first non-empty product is appended */
+        if (harp_export_stream_open(output_filename, output_format, &stream) != 0)
+        {
+            return -1;
+        }
+    }
+
     while (i < argc - 1)
     {
         harp_dataset *dataset;
 
         if (harp_dataset_new(&dataset) != 0)
         {
+            abort_stream(stream, num_products, output_filename);
+            harp_spatial_grid_delete(grid);
             return -1;
         }
         if (harp_dataset_import(dataset, argv[i], options) != 0)
         {
+            abort_stream(stream, num_products, output_filename);
+            harp_spatial_grid_delete(grid);
             harp_dataset_delete(dataset);
             return -1;
         }
         if (harp_dataset_prefilter(dataset, operations) != 0)
         {
+            abort_stream(stream, num_products, output_filename);
+            harp_spatial_grid_delete(grid);
             harp_dataset_delete(dataset);
             return -1;
         }
-        if (merge_dataset(&merged_product, dataset, operations, options, reduce_operations, verbose) != 0)
+        if (grid != NULL)
+        {
+            if (bin_spatial_dataset(grid, &num_products, dataset, operations, options, verbose) != 0)
+            {
+                harp_spatial_grid_delete(grid);
+                harp_dataset_delete(dataset);
+                return -1;
+            }
+        }
+        else if (use_stream)
+        {
+            if (stream_dataset(stream, &num_products, dataset, operations, options, update_history, argc, argv,
+                               verbose) != 0)
+            {
+                abort_stream(stream, num_products, output_filename);
+                harp_dataset_delete(dataset);
+                return -1;
+            }
+        }
+        else if (sort_variable != NULL)
+        {
+            if (collect_dataset(&num_products, &product_list, dataset, operations, options, verbose) != 0)
+            {
+                delete_product_list(num_products, product_list);
+                harp_dataset_delete(dataset);
+                return -1;
+            }
+        }
+        else if (merge_dataset(&merged_product, dataset, operations, options, reduce_operations, verbose) != 0)
         {
             harp_product_delete(merged_product);
             harp_dataset_delete(dataset);
@@ -293,6 +674,51 @@ static int merge(int argc, char *argv[])
         i++;
     }
 
+    if (use_stream)
+    {
+        if (harp_export_stream_close(stream) != 0)
+        {
+            if (num_products > 0)
+            {
+                remove(output_filename);
+            }
+            return -1;
+        }
+        if (num_products == 0)
+        {
+            return -2;
+        }
+        return 0;
+    }
+
+    if (grid != NULL)
+    {
+        if (num_products > 0)
+        {
+            if (harp_spatial_grid_get_product(grid, &merged_product) != 0)
+            {
+                harp_spatial_grid_delete(grid);
+                return -1;
+            }
+        }
+        harp_spatial_grid_delete(grid);
+    }
+    else if (num_products > 0)
+    {
+        /* merge all products in a single pass */
+        if (harp_product_append_sorted(product_list[0], num_products - 1, &product_list[1], 1, &sort_variable) != 0)
+        {
+            delete_product_list(num_products, product_list);
+            return -1;
+        }
+        merged_product = product_list[0];
+        for (i = 1; i < num_products; i++)
+        {
+            harp_product_delete(product_list[i]);
+        }
+        free(product_list);
+    }
+
     if (merged_product == NULL)
     {
         return -2;